@@ -0,0 +1,208 @@
+#!/bin/sh
+# Copyright 2012 Peter Bašista
+#
+# This file is part of the stc.
+#
+# stc is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# The benchmark suite run by "make bench".
+#
+# It generates the standard stress texts by the sttg, runs the construction
+# benchmark (-b C) of every valid combination of the implementation type,
+# the algorithm, its variation and the collision resolution technique
+# of the st and the stsw on each of them and writes one CSV line per run.
+#
+# The following environment variables can be used to configure it:
+# BENCH_SIZES	the space-separated lengths of the texts in characters
+# BENCH_DIR	the directory for the generated texts and the results
+# BENCH_CSV	the name of the CSV file with the results
+# BENCH_SEED	the seed of the text generator
+# BENCH_BLOCK	the block size of the sliding window of the stsw
+# BENCH_TIMEOUT	the time limit of a single run in seconds
+# 		(only if the timeout utility is available)
+
+BENCH_SIZES=${BENCH_SIZES:-1000000}
+BENCH_DIR=${BENCH_DIR:-bench}
+BENCH_CSV=${BENCH_CSV:-$BENCH_DIR/results.csv}
+BENCH_SEED=${BENCH_SEED:-1}
+BENCH_BLOCK=${BENCH_BLOCK:-65536}
+BENCH_TIMEOUT=${BENCH_TIMEOUT:-600}
+
+ST=./st/st
+STSW=./stsw/stsw
+STTG=./sttg/sttg
+
+# The stress texts: the name, the alphabet size and the sttg arguments
+CORPORA='uniform2 2 -g U -a 2
+uniform4 4 -g U -a 4
+uniform26 26 -g U -a 26
+uniform256 256 -g U -a 256
+fibonacci 2 -g F
+thuemorse 2 -g T
+runs 4 -g R -a 4
+dna 4 -g D
+zipf 28 -g Z'
+
+# The st configurations: the type, the algorithm with the variation
+# and the collision resolution technique (- if not applicable)
+ST_CONFIGS='SL A -
+SL M -
+SL MB -
+SL B -
+SL U -
+SL UB -
+SH A C
+SH A D
+SH M C
+SH M D
+SH MB C
+SH MB D
+SH B C
+SH B D
+SH U C
+SH U D
+SH UB C
+SH UB D
+LA P -'
+
+# The stsw configurations in the same format
+STSW_CONFIGS='SL U -
+SL UB -
+SH U C
+SH U D
+SH UB C
+SH UB D'
+
+for program in "$ST" "$STSW" "$STTG"; do
+	if [ ! -x "$program" ]; then
+		echo "$program has not been built, run make first!" >&2
+		exit 1
+	fi
+done
+
+# The alphabets with more than 94 characters contain non-ASCII characters,
+# which can not be converted to the internal encoding of the char type
+if "$ST" -h | grep -q 'character_type is char$'; then
+	MAX_SIGMA=94
+else
+	MAX_SIGMA=256
+fi
+
+if hash timeout 2>/dev/null; then
+	TIMEOUT="timeout $BENCH_TIMEOUT"
+else
+	TIMEOUT=
+fi
+
+mkdir -p "$BENCH_DIR" || exit 1
+LOG="$BENCH_DIR/run.log"
+PROFILE="$BENCH_DIR/run.json"
+
+echo "program,corpus,length,type,algorithm,crt,status,construction_ms,\
+total_ms,user_ms,max_rss_bytes,ns_per_char,bytes_per_char" > "$BENCH_CSV" ||
+	exit 1
+
+# run_one program corpus length text type algorithm crt [options]
+#
+# Runs a single construction benchmark and appends its results to the CSV.
+run_one () {
+	program=$1
+	corpus=$2
+	length=$3
+	text=$4
+	type=$5
+	algorithm=$6
+	crt=$7
+	shift 7
+	if [ "$crt" = "-" ]; then
+		crt_option=
+	else
+		crt_option="-r $crt"
+	fi
+	rm -f "$PROFILE"
+	# shellcheck disable=SC2086
+	$TIMEOUT "$program" -t "$type" -a "$algorithm" -b C $crt_option \
+		-J "$PROFILE" "$@" "$text" > "$LOG" 2>&1
+	retval=$?
+	if [ $retval -eq 0 ] && [ -f "$PROFILE" ]; then
+		status=ok
+	elif [ $retval -eq 124 ]; then
+		status=timeout
+	else
+		status=failed
+	fi
+	awk -v program="$(basename "$program")" -v corpus="$corpus" \
+		-v characters="$length" -v type="$type" \
+		-v algorithm="$algorithm" -v crt="$crt" \
+		-v status="$status" '
+		FILENAME != logfile && /"wall_ms":/ {
+			line = $0
+			sub(/.*"wall_ms":/, "", line)
+			sub(/,.*/, "", line)
+			total += line
+			if ($0 ~ /"name":"construction"/) {
+				construction = line
+			}
+		}
+		FILENAME == logfile && /CPU user time:/ {
+			user = $(NF - 3)
+		}
+		FILENAME == logfile && /maximum resident set size:/ {
+			rss = $(NF - 3)
+		}
+		END {
+			if (status != "ok") {
+				printf("%s,%s,%s,%s,%s,%s,%s,,,,,,\n",
+					program, corpus, characters, type,
+					algorithm, crt, status)
+				exit
+			}
+			printf("%s,%s,%s,%s,%s,%s,%s,%.3f,%.3f,%s,%s,",
+				program, corpus, characters, type, algorithm,
+				crt, status, construction, total, user, rss)
+			printf("%.3f,%.3f\n", construction * 1e6 / characters,
+				rss / characters)
+		}' logfile="$LOG" "$LOG" $([ "$status" = ok ] && echo "$PROFILE") \
+		>> "$BENCH_CSV"
+	echo "$(basename "$program") $type $algorithm $crt: $status"
+}
+
+for length in $BENCH_SIZES; do
+	echo "$CORPORA" | while read -r corpus sigma arguments; do
+		if [ "$sigma" -gt "$MAX_SIGMA" ]; then
+			echo "Skipping $corpus, whose alphabet is too large" \
+				"for the character_type char"
+			continue
+		fi
+		text="$BENCH_DIR/$corpus-$length.txt"
+		# shellcheck disable=SC2086
+		if ! "$STTG" $arguments -n "$length" -s "$BENCH_SEED" \
+				-d "$text"; then
+			echo "Could not generate $text!" >&2
+			exit 1
+		fi
+		echo "Benchmarking $corpus of $length characters"
+		echo "$ST_CONFIGS" | while read -r type algorithm crt; do
+			run_one "$ST" "$corpus" "$length" "$text" \
+				"$type" "$algorithm" "$crt"
+		done
+		echo "$STSW_CONFIGS" | while read -r type algorithm crt; do
+			run_one "$STSW" "$corpus" "$length" "$text" \
+				"$type" "$algorithm" "$crt" -k "$BENCH_BLOCK"
+		done
+	done || exit 1
+done
+
+rm -f "$LOG" "$PROFILE"
+echo "The results have been written to $BENCH_CSV"
@@ -0,0 +1,118 @@
+#!/bin/sh
+# Copyright 2012 Peter Bašista
+#
+# This file is part of the stc.
+#
+# stc is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# The regression checks run by "make check".
+#
+# It generates a DNA-like stress text by the sttg and for each of the st
+# configurations below it checks, that the traversal log of the suffix tree
+# allocated from the arena is the same as of the one allocated by the malloc
+# and that the repeated runs over the arena with the parallel traversal
+# succeed, which requires the arena not to give up its address space
+# to the thread stacks. Finally, it checks that the substring lookups
+# in the compact encoding of the LA suffix tree agree with the ones
+# in its table tnode (-b L -z).
+#
+# The following environment variables can be used to configure it:
+# CHECK_SIZE	the length of the text in characters
+# CHECK_DIR	the directory for the generated text and the logs
+# CHECK_SEED	the seed of the text generator
+# CHECK_TIMEOUT	the time limit of a single run in seconds
+# 		(only if the timeout utility is available)
+
+CHECK_SIZE=${CHECK_SIZE:-100000}
+CHECK_DIR=${CHECK_DIR:-check}
+CHECK_SEED=${CHECK_SEED:-1}
+CHECK_TIMEOUT=${CHECK_TIMEOUT:-600}
+
+ST=./st/st
+STTG=./sttg/sttg
+
+# The st configurations: the type, the algorithm with the variation
+# and the collision resolution technique (- if not applicable)
+ST_CONFIGS='SL U -
+SH U C
+SH U D
+LA P -'
+
+for program in "$ST" "$STTG"; do
+	if [ ! -x "$program" ]; then
+		echo "$program has not been built, run make first!" >&2
+		exit 1
+	fi
+done
+
+if hash timeout 2>/dev/null; then
+	TIMEOUT="timeout $CHECK_TIMEOUT"
+else
+	TIMEOUT=
+fi
+
+mkdir -p "$CHECK_DIR" || exit 1
+TEXT="$CHECK_DIR/dna-$CHECK_SIZE.txt"
+LOG="$CHECK_DIR/run.log"
+
+if ! "$STTG" -g D -n "$CHECK_SIZE" -s "$CHECK_SEED" -d "$TEXT" \
+		> "$LOG" 2>&1; then
+	echo "Could not generate $TEXT!" >&2
+	exit 1
+fi
+
+failures=$(echo "$ST_CONFIGS" | while read -r type algorithm crt; do
+	if [ "$crt" = "-" ]; then
+		crt_option=
+	else
+		crt_option="-r $crt"
+	fi
+	name="$type $algorithm $crt"
+	for allocator in malloc arena; do
+		# shellcheck disable=SC2086
+		if ! $TIMEOUT "$ST" -t "$type" -a "$algorithm" $crt_option \
+				-b T -s -x "$allocator" \
+				-d "$CHECK_DIR/$allocator.dump" "$TEXT" \
+				> "$LOG" 2>&1; then
+			echo "$name -x $allocator: failed" >&2
+			echo x
+		fi
+	done
+	if ! cmp -s "$CHECK_DIR/malloc.dump" "$CHECK_DIR/arena.dump"; then
+		echo "$name: the traversal logs differ" >&2
+		echo x
+	fi
+	# shellcheck disable=SC2086
+	if ! $TIMEOUT "$ST" -t "$type" -a "$algorithm" $crt_option -b T -s \
+			-x arena -N 2 -j 4 "$TEXT" > "$LOG" 2>&1; then
+		echo "$name -x arena -N 2 -j 4: failed" >&2
+		echo x
+	fi
+	echo "$name: done" >&2
+done | wc -l)
+
+# shellcheck disable=SC2086
+if ! $TIMEOUT "$ST" -t LA -a P -b L -z "$TEXT" > "$LOG" 2>&1; then
+	echo "LA P - -b L -z: failed" >&2
+	failures=$((failures + 1))
+else
+	echo "LA P - -b L -z: done" >&2
+fi
+
+rm -f "$LOG" "$CHECK_DIR/malloc.dump" "$CHECK_DIR/arena.dump"
+if [ "$failures" -gt 0 ]; then
+	echo "$failures checks have failed!" >&2
+	exit 1
+fi
+echo "All the checks have passed"
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ *
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The table allocator-related declarations.
+ * This file contains the declarations of the functions,
+ * which allocate the tables of the suffix trees (such as the tleaf,
+ * the tbranch, the tedge, the tnode, the hash settings
+ * and the PWOTD construction data). By default, they are allocated
+ * by the standard library. Alternatively, they can be allocated
+ * from an arena, which reserves a large range of the virtual memory
+ * once, allocates the tables from it by bumping a pointer,
+ * moves the grown tables by remapping their pages instead of copying them
+ * and releases all of them by a single munmap.
+ */
+#ifndef	ARENA_HEADER
+#define	ARENA_HEADER
+
+#include <stdio.h>
+
+/*
+ * if the the macro _POSIX_C_SOURCE is defined,
+ * either by the compiler or explicitly
+ */
+#ifdef	_POSIX_C_SOURCE
+/*
+ * We need to check if the supported POSIX features
+ * conform at least to the IEEE Std 1003.1c-1995
+ */
+#if	(_POSIX_C_SOURCE - 0) >= 199506L
+
+/* we can use the POSIX threads */
+#define	ARENA_USE_PTHREAD
+
+#endif
+
+#endif
+
+/* constants */
+
+extern const size_t arena_default_reserve;
+
+/* functions */
+
+int arena_open (size_t reserve);
+int arena_reset (void);
+void arena_close (void);
+void *arena_calloc (size_t count, size_t size);
+void *arena_realloc (void *pointer, size_t size);
+void arena_free (void *pointer);
+size_t arena_measure_peak (void);
+int arena_print_stats (FILE *stream);
+
+#endif /* ARENA_HEADER */
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The phase profile-related declarations.
+ * This file contains the declarations of the functions,
+ * which record the wall-clock time, the resident set size
+ * and the hardware performance counters separately
+ * for the consecutive phases of a benchmark, such as the reading
+ * of the text, the construction, the traversal and the deletion
+ * of the suffix tree.
+ */
+#ifndef	PHASE_PROFILE_HEADER
+#define	PHASE_PROFILE_HEADER
+
+#include <stdio.h>
+
+/*
+ * if the the macro _POSIX_C_SOURCE is defined,
+ * either by the compiler or explicitly
+ */
+#ifdef	_POSIX_C_SOURCE
+/*
+ * We need to check if the supported POSIX features
+ * conform at least to the IEEE Std 1003.1c-1995
+ */
+#if	(_POSIX_C_SOURCE - 0) >= 199506L
+
+/* we can use the POSIX threads */
+#define	PHASE_PROFILE_USE_PTHREAD
+#include <pthread.h>
+
+#endif
+
+#endif
+
+/* constants */
+
+extern const size_t phase_profile_counters;
+extern const unsigned long long phase_profile_unavailable;
+
+/* struct typedefs */
+
+/**
+ * A struct which stores the time and the memory usage
+ * of a single finished phase.
+ */
+typedef struct phase_record_struct {
+	/** the name of the phase */
+	const char *name;
+	/** the beginning of the phase in nanoseconds since the opening */
+	unsigned long long start;
+	/** the wall-clock duration of the phase in nanoseconds */
+	unsigned long long duration;
+	/** the peak resident set size observed during the phase in bytes */
+	size_t peak_rss;
+	/** the resident set size at the end of the phase in bytes */
+	size_t end_rss;
+} phase_record;
+
+/**
+ * A struct which stores a single sample of the resident set size.
+ */
+typedef struct phase_sample_struct {
+	/** the time of the sample in nanoseconds since the opening */
+	unsigned long long time;
+	/** the resident set size in bytes */
+	size_t rss;
+} phase_sample;
+
+/**
+ * A struct which stores the finished phases of a benchmark
+ * together with the hardware performance counters
+ * and the samples of the resident set size.
+ */
+typedef struct phase_profile_struct {
+	/**
+	 * the file descriptors of the opened counters,
+	 * (-1) for the counters, which are unavailable,
+	 * or NULL if the counters have not been requested
+	 */
+	int *descriptors;
+	/** the values of the counters at the beginning of the current phase */
+	unsigned long long *start_values;
+	/** the finished phases */
+	phase_record *records;
+	/**
+	 * the values of the counters in the finished phases,
+	 * phase_profile_counters values for each of them
+	 */
+	unsigned long long *values;
+	/** the number of the finished phases */
+	size_t phases;
+	/** the number of the phases, for which the memory is allocated */
+	size_t size;
+	/** the name of the current phase, or NULL outside of the phases */
+	const char *current;
+	/** the number of the counters, which could be opened */
+	size_t available;
+	/** the monotonic time of the opening in nanoseconds */
+	unsigned long long origin;
+	/** the beginning of the current phase in nanoseconds */
+	unsigned long long start;
+	/** the peak resident set size observed during the current phase */
+	size_t current_peak;
+	/** the samples of the resident set size taken by the sampler */
+	phase_sample *samples;
+	/** the number of the samples taken */
+	size_t sample_count;
+	/** the number of the samples, for which the memory is allocated */
+	size_t sample_size;
+	/**
+	 * the interval between the samples in milliseconds,
+	 * zero (0) if the sampler is not running
+	 */
+	size_t interval;
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+	/** the thread sampling the resident set size */
+	pthread_t sampler;
+	/** the mutex protecting the samples and the current peak */
+	pthread_mutex_t mutex;
+	/** the condition variable used to stop the sampler */
+	pthread_cond_t stop_cv;
+	/** if this variable evaluates to true, the sampler has to stop */
+	int stopping;
+#endif
+} phase_profile;
+
+/* functions */
+
+int phase_profile_open (int counters,
+		size_t interval,
+		phase_profile *profile);
+void phase_profile_begin (const char *name, phase_profile *profile);
+void phase_profile_end (phase_profile *profile);
+void phase_profile_finish (phase_profile *profile);
+int phase_profile_print (FILE *stream, const phase_profile *profile);
+int phase_profile_print_summary (FILE *stream,
+		const phase_profile *profile);
+int phase_profile_write_json (const char *filename,
+		const phase_profile *profile);
+void phase_profile_close (phase_profile *profile);
+int phase_profile_pin (size_t cpu);
+unsigned long long phase_profile_clock (void);
+
+#endif /* PHASE_PROFILE_HEADER */
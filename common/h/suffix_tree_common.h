@@ -83,6 +83,96 @@ typedef unsigned int unsigned_integral_type;
  */
 typedef int signed_integral_type;
 
+/* structures */
+
+/**
+ * A struct representing a single frame of the explicit stack
+ * used by the iterative suffix tree traversals.
+ * Each frame corresponds to a branching node on the path
+ * from the starting node to the node currently being visited.
+ * The meaning of the individual members depends slightly
+ * on the suffix tree representation, which uses the stack.
+ */
+typedef struct traversal_frame_struct {
+	/** the branching node this frame belongs to */
+	signed_integral_type node;
+	/**
+	 * the child of the node, at which the traversal
+	 * of its children continues, or the last visited one
+	 */
+	signed_integral_type child;
+	/** the offset of the node in the array-based representations */
+	size_t offset;
+	/** the string depth of the node */
+	unsigned_integral_type depth;
+} traversal_frame;
+
+/**
+ * A struct representing the explicit stack of the iterative
+ * suffix tree traversals. It lives on the heap and grows on demand,
+ * so that the depth of the traversed tree is not limited
+ * by the size of the call stack.
+ * A zeroed struct is an empty stack. Once allocated, the stack
+ * can be reused by another traversal just by resetting its top.
+ */
+typedef struct traversal_stack_struct {
+	/** the frames of the stack */
+	traversal_frame *frames;
+	/** the number of frames currently allocated */
+	size_t size;
+	/** the number of frames currently on the stack */
+	size_t top;
+} traversal_stack;
+
+/**
+ * A struct representing the buffered output of the suffix tree traversals.
+ * The edges are formatted directly into a large aligned buffer,
+ * which is written to the stream only when it is full
+ * or when the output is flushed. The conversion descriptor,
+ * which converts the edge labels from the internal text encoding,
+ * is opened only once for the whole traversal.
+ *
+ * In the binary format (tf_binary), the output is a sequence of chunks.
+ * Each chunk starts with a four-byte magic. A note chunk ("STCN")
+ * holds a varint length followed by the text to be printed verbatim.
+ * A traversal chunk ("STCT") holds a version byte, followed
+ * by the varints of the traversal type, the character size,
+ * the length and the bytes of the internal text encoding,
+ * the two printing alignments, the size of the circular text window
+ * (zero if the text does not wrap), the number of the characters
+ * of the text and their raw bytes. The edges follow,
+ * each of them starting with a varint tag (0 for an edge,
+ * 1 for an edge ending with the terminating character),
+ * which is followed by the zigzag varints of the parent, the child
+ * and the suffix link and by the varints of the parent's depth,
+ * the edge label length and the child's offset. The tag 2 terminates
+ * the traversal chunk. All the varints are little-endian base 128.
+ */
+typedef struct traversal_output_struct {
+	/**
+	 * the stream to which the output is written,
+	 * or NULL if the output is kept in the memory
+	 */
+	FILE *stream;
+	/** the format of the output, either tf_text or tf_binary */
+	int format;
+	/** the internal character encoding of the text */
+	const char *encoding;
+	/** the conversion descriptor used for the edge labels */
+	iconv_t cd;
+	/** the buffer holding the output not written yet */
+	char *buffer;
+	/** the size of the buffer in bytes */
+	size_t size;
+	/** the number of bytes currently held in the buffer */
+	size_t top;
+	/**
+	 * if this variable evaluates to true, writing to the stream
+	 * has failed and all the subsequent output is discarded
+	 */
+	int failed;
+} traversal_output;
+
 /* constants */
 
 /* the terminating character ($) */
@@ -101,9 +191,91 @@ extern const int tt_detailed;
 
 extern const int tt_simple;
 
+/* the human readable text traversal format */
+
+extern const int tf_text;
+
+/* the compact binary traversal format */
+
+extern const int tf_binary;
+
+/* the magic of the note chunk of the binary traversal format */
+
+extern const char tf_note_magic[];
+
+/* the magic of the traversal chunk of the binary traversal format */
+
+extern const char tf_traversal_magic[];
+
+/* the version of the binary traversal format */
+
+extern const unsigned char tf_version;
+
 /* common helping functions */
 
 int print_human_readable_size (FILE *stream, size_t size);
 int print_human_readable_time (FILE *stream, size_t time);
+int traversal_stack_push (traversal_stack *stack,
+		signed_integral_type node,
+		signed_integral_type child,
+		size_t offset,
+		unsigned_integral_type depth);
+void traversal_stack_free (traversal_stack *stack);
+int traversal_output_open (FILE *stream,
+		int format,
+		const char *internal_character_encoding,
+		traversal_output *output);
+int traversal_output_flush (traversal_output *output);
+char *traversal_output_reserve (size_t bytes,
+		traversal_output *output);
+void traversal_output_string (const char *string,
+		traversal_output *output);
+void traversal_output_unsigned (size_t value,
+		size_t width,
+		traversal_output *output);
+void traversal_output_signed (signed_integral_type value,
+		size_t width,
+		traversal_output *output);
+int traversal_output_text (const character_type *text,
+		size_t length,
+		traversal_output *output);
+void traversal_output_varint (unsigned long long value,
+		traversal_output *output);
+void traversal_output_fixed (unsigned long long value,
+		size_t width,
+		traversal_output *output);
+int traversal_output_window_text (const character_type *text,
+		size_t window_size,
+		size_t offset,
+		size_t length,
+		traversal_output *output);
+int traversal_output_begin (int traversal_type,
+		size_t log10bn,
+		size_t log10l,
+		const character_type *text,
+		size_t text_size,
+		size_t window_size,
+		traversal_output *output);
+int traversal_output_edge (int print_terminating_character,
+		signed_integral_type parent,
+		signed_integral_type child,
+		signed_integral_type childs_suffix_link,
+		unsigned_integral_type parents_depth,
+		unsigned_integral_type childs_depth,
+		size_t log10bn,
+		size_t log10l,
+		size_t childs_offset,
+		const character_type *text,
+		size_t window_size,
+		traversal_output *output);
+int traversal_output_end (int traversal_type,
+		traversal_output *output);
+int traversal_output_close (traversal_output *output);
+int traversal_output_append (const traversal_output *part,
+		traversal_output *output);
+int traversal_output_note (FILE *stream,
+		int format,
+		const char *format_string,
+		...);
 
 #endif /* SUFFIX_TREE_VERY_COMMON_HEADER */
@@ -0,0 +1,825 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ *
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The table allocator-related functions implementation.
+ * This file contains the implementation of the functions,
+ * which allocate the tables of the suffix trees either by the standard
+ * library, or from an arena. The arena is a single large range
+ * of the virtual memory, which is reserved without committing it,
+ * so its pages are only backed by the physical memory once touched.
+ * The tables are allocated from it by bumping the top of the arena,
+ * so they are zero-filled without clearing them explicitly.
+ * The tables spanning whole pages are page-aligned, so that they can be
+ * moved to the top of the arena by the mremap (on Linux) when they grow
+ * and their pages can be returned to the system when they are freed.
+ * The returned pages are mapped again as inaccessible, so the arena
+ * never gives up any part of its address space, which could otherwise
+ * be handed out to the unrelated mappings (such as the thread stacks).
+ * The arena never reuses its address space, until all of it is torn down
+ * by a single mmap over it. Both the allocators record the statistics
+ * of the allocations, so that their effects can be compared.
+ */
+
+/* if we are on the Linux platform */
+#ifdef	__linux__
+
+#ifndef	_GNU_SOURCE
+
+/**
+ * This macro is necessary for the function mremap
+ * and its flags MREMAP_MAYMOVE and MREMAP_FIXED
+ */
+#define	_GNU_SOURCE
+
+#endif
+
+#endif
+
+#include "arena.h"
+#include "suffix_tree_common.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef	ARENA_USE_PTHREAD
+#include <pthread.h>
+#endif
+
+/* the anonymous mappings are called differently on some platforms */
+#ifndef	MAP_ANONYMOUS
+#define	MAP_ANONYMOUS	MAP_ANON
+#endif
+
+/* the address space can only be reserved on some platforms */
+#ifndef	MAP_NORESERVE
+#define	MAP_NORESERVE	0
+#endif
+
+/* struct typedefs */
+
+/**
+ * A struct which stores a single allocated table.
+ */
+typedef struct arena_block_struct {
+	/** the address of the table */
+	char *pointer;
+	/** the requested size of the table in bytes */
+	size_t size;
+	/**
+	 * the size of the address space of the arena occupied
+	 * by the table, or zero (0) if it has been allocated
+	 * by the standard library
+	 */
+	size_t span;
+} arena_block;
+
+/**
+ * A struct which stores the state and the statistics of the allocator.
+ */
+typedef struct arena_state_struct {
+	/** the beginning of the arena, or NULL if it is not used */
+	char *base;
+	/** the size of the reserved address space in bytes */
+	size_t reserve;
+	/** the offset of the first unused byte of the arena */
+	size_t top;
+	/** the peak offset of the first unused byte of the arena */
+	size_t peak_top;
+	/** the size of the memory page */
+	size_t page_size;
+	/**
+	 * the open addressing hash table of the tables,
+	 * which have not been freed yet, indexed by their addresses
+	 */
+	arena_block *blocks;
+	/** the number of the tables, which have not been freed yet */
+	size_t block_count;
+	/** the number of the cells of the hash table (a power of two) */
+	size_t block_size;
+	/** the number of the allocations */
+	size_t allocations;
+	/** the number of the reallocations */
+	size_t reallocations;
+	/** the number of the tables grown at the top of the arena */
+	size_t in_place;
+	/** the number of the tables moved by remapping their pages */
+	size_t remapped;
+	/** the number of the tables moved by copying them */
+	size_t copied;
+	/** the number of the frees */
+	size_t frees;
+	/**
+	 * the number of the tables, which did not fit into the arena
+	 * and have been allocated by the standard library instead
+	 */
+	size_t fallbacks;
+	/** the time spent in the allocator in nanoseconds */
+	unsigned long long time;
+	/** the total size of the tables, which have not been freed yet */
+	size_t live;
+	/**
+	 * the peak total size of the tables, which have not been freed,
+	 * including both the copies of a table being moved by copying
+	 */
+	size_t peak_live;
+	/** the peak total size of the tables since the last measurement */
+	size_t measured_peak;
+	/** the size of the pages returned to the system by the frees */
+	size_t released;
+} arena_state;
+
+/* constants */
+
+/**
+ * The size of the address space reserved for the arena by default.
+ * If it can not be reserved, the arena tries the smaller sizes.
+ */
+const size_t arena_default_reserve = sizeof (size_t) > 4 ?
+	(size_t)(1) << 36 : (size_t)(1) << 30;
+
+/** The smallest size of the address space, which is worth reserving. */
+static const size_t arena_minimum_reserve = (size_t)(1) << 24;
+
+/** The alignment of the tables, which are smaller than a page. */
+static const size_t arena_alignment = 64;
+
+/** The initial number of the cells of the hash table of the tables. */
+static const size_t arena_initial_blocks = 64;
+
+/* variables */
+
+/** The state of the allocator shared by all the threads. */
+static arena_state arena = {.base = NULL};
+
+#ifdef	ARENA_USE_PTHREAD
+/** The mutex protecting the state of the allocator. */
+static pthread_mutex_t arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* table allocator functions */
+
+/**
+ * A function which locks the state of the allocator.
+ */
+static void arena_lock (void) {
+#ifdef	ARENA_USE_PTHREAD
+	pthread_mutex_lock(&arena_mutex);
+#endif
+}
+
+/**
+ * A function which unlocks the state of the allocator.
+ */
+static void arena_unlock (void) {
+#ifdef	ARENA_USE_PTHREAD
+	pthread_mutex_unlock(&arena_mutex);
+#endif
+}
+
+/**
+ * A function which returns the current value of the monotonic clock.
+ *
+ * @return	The current value of the monotonic clock in nanoseconds.
+ */
+static unsigned long long arena_clock (void) {
+	struct timespec now = {0, 0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((unsigned long long)(now.tv_sec) * 1000000000ULL +
+			(unsigned long long)(now.tv_nsec));
+}
+
+/**
+ * A function which rounds the provided size up to a multiple
+ * of the provided alignment, which needs to be a power of two.
+ *
+ * @param
+ * size		the size to round
+ * @param
+ * alignment	the alignment
+ *
+ * @return	The rounded size.
+ */
+static size_t arena_round (size_t size, size_t alignment) {
+	return ((size + alignment - 1) & ~(alignment - 1));
+}
+
+/**
+ * A function which maps the provided range of the arena
+ * as fresh zero-filled pages, either accessible or inaccessible.
+ * The range replaces the pages mapped there before, so the arena
+ * keeps its address space.
+ *
+ * @param
+ * start	the beginning of the range, or NULL to reserve
+ * 		the address space of the whole arena anywhere
+ * @param
+ * size		the size of the range
+ * @param
+ * accessible	if this variable evaluates to true, the pages
+ * 		can be read and written, otherwise they can not be accessed
+ *
+ * @return	If the range has been mapped, its beginning is returned.
+ * 		Otherwise, NULL is returned.
+ */
+static char *arena_map (void *start, size_t size, int accessible) {
+	void *mapping = mmap(start, size, accessible != 0 ?
+			PROT_READ | PROT_WRITE : PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE |
+			(start != NULL ? MAP_FIXED : 0), -1, 0);
+	if (mapping == MAP_FAILED) {
+		/* resetting the errno */
+		errno = 0;
+		return (NULL);
+	}
+	return (mapping);
+}
+
+/**
+ * A function which computes the cell of the hash table
+ * of the tables, at which the search for the table starts.
+ *
+ * @param
+ * pointer	the address of the table
+ *
+ * @return	The index of the cell in the arena.blocks.
+ */
+static size_t arena_hash (const void *pointer) {
+	/* the tables are aligned, so the lowest bits carry no information */
+	uintptr_t key = (uintptr_t)(pointer) >> 4;
+	return ((size_t)(key * (uintptr_t)(2654435761U)) &
+			(arena.block_size - 1));
+}
+
+/**
+ * A function which finds the table at the provided address.
+ *
+ * @param
+ * pointer	the address of the table
+ *
+ * @return	The table in the arena.blocks, or NULL if it is not there.
+ */
+static arena_block *arena_find (const void *pointer) {
+	size_t i = 0;
+	if (arena.block_size == 0) {
+		return (NULL);
+	}
+	for (i = arena_hash(pointer); arena.blocks[i].pointer != NULL;
+			i = (i + 1) & (arena.block_size - 1)) {
+		if (arena.blocks[i].pointer == pointer) {
+			return (arena.blocks + i);
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * A function which updates the peak total sizes of the tables.
+ *
+ * @param
+ * size		the current total size of the tables
+ */
+static void arena_account (size_t size) {
+	if (size > arena.peak_live) {
+		arena.peak_live = size;
+	}
+	if (size > arena.measured_peak) {
+		arena.measured_peak = size;
+	}
+}
+
+/**
+ * A function which stores the table into the hash table of the tables,
+ * which needs to have at least one empty cell.
+ *
+ * @param
+ * block	the table to store
+ */
+static void arena_insert (const arena_block *block) {
+	size_t i = arena_hash(block->pointer);
+	while (arena.blocks[i].pointer != NULL) {
+		i = (i + 1) & (arena.block_size - 1);
+	}
+	arena.blocks[i] = (*block);
+	++arena.block_count;
+}
+
+/**
+ * A function which rebuilds the hash table of the tables
+ * with the provided number of the cells. Optionally,
+ * it forgets the tables allocated from the arena.
+ *
+ * @param
+ * block_size	the new number of the cells (a power of two)
+ * @param
+ * keep_arena	if this variable evaluates to true, the tables
+ * 		allocated from the arena are kept, otherwise
+ * 		only the tables allocated by the standard library are kept
+ *
+ * @return	If the hash table has been rebuilt, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned
+ * 		and the hash table is left untouched.
+ */
+static int arena_rehash (size_t block_size, int keep_arena) {
+	arena_block *old_blocks = arena.blocks;
+	size_t old_size = arena.block_size;
+	size_t i = 0;
+	arena_block *blocks = calloc(block_size, sizeof (arena_block));
+	if (blocks == NULL) {
+		perror("calloc(arena.blocks)");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	arena.blocks = blocks;
+	arena.block_size = block_size;
+	arena.block_count = 0;
+	for (i = 0; i < old_size; ++i) {
+		if (old_blocks[i].pointer == NULL) {
+			continue;
+		}
+		if ((keep_arena != 0) || (old_blocks[i].span == 0)) {
+			arena_insert(old_blocks + i);
+		} else {
+			arena.live -= old_blocks[i].size;
+		}
+	}
+	free(old_blocks);
+	return (0);
+}
+
+/**
+ * A function which starts tracking the newly allocated table.
+ * If the memory for the tracking could not be allocated,
+ * the table is still valid, but its size is not accounted for.
+ *
+ * @param
+ * pointer	the address of the table
+ * @param
+ * size		the requested size of the table
+ * @param
+ * span		the size of the address space of the arena
+ * 		occupied by the table, or zero (0)
+ */
+static void arena_track (void *pointer, size_t size, size_t span) {
+	arena_block block = {.pointer = pointer, .size = size, .span = span};
+	/* the hash table is kept at most half full */
+	if ((2 * (arena.block_count + 1) > arena.block_size) &&
+			(arena_rehash(arena.block_size == 0 ?
+				arena_initial_blocks : 2 * arena.block_size,
+				1) > 0)) {
+		return;
+	}
+	arena_insert(&block);
+	arena.live += size;
+	arena_account(arena.live);
+}
+
+/**
+ * A function which stops tracking the table.
+ *
+ * @param
+ * block	the table in the arena.blocks
+ */
+static void arena_untrack (arena_block *block) {
+	size_t hole = (size_t)(block - arena.blocks);
+	size_t i = hole;
+	size_t home = 0;
+	arena.live -= block->size;
+	--arena.block_count;
+	/* the following tables are shifted back to keep them reachable */
+	for (;;) {
+		i = (i + 1) & (arena.block_size - 1);
+		if (arena.blocks[i].pointer == NULL) {
+			break;
+		}
+		home = arena_hash(arena.blocks[i].pointer);
+		/* if the hole lies cyclically between the home and the cell */
+		if (((i - home) & (arena.block_size - 1)) >=
+				((i - hole) & (arena.block_size - 1))) {
+			arena.blocks[hole] = arena.blocks[i];
+			hole = i;
+		}
+	}
+	arena.blocks[hole].pointer = NULL;
+	arena.blocks[hole].size = 0;
+	arena.blocks[hole].span = 0;
+}
+
+/**
+ * A function which allocates the address space for a table
+ * at the top of the arena. The tables of at least a page
+ * are page-aligned and occupy whole pages.
+ *
+ * @param
+ * size		the requested size of the table
+ * @param
+ * span		the size of the occupied address space
+ * 		will be stored here
+ *
+ * @return	The address of the table, or NULL if it does not fit.
+ */
+static char *arena_bump (size_t size, size_t *span) {
+	size_t alignment = size < arena.page_size ? arena_alignment :
+		arena.page_size;
+	size_t start = arena_round(arena.top, alignment);
+	if (size == 0) {
+		size = 1;
+	}
+	if ((start > arena.reserve) || (size > arena.reserve - start) ||
+			(arena_round(size, alignment) >
+			 arena.reserve - start)) {
+		return (NULL);
+	}
+	(*span) = arena_round(size, alignment);
+	arena.top = start + (*span);
+	if (arena.top > arena.peak_top) {
+		arena.peak_top = arena.top;
+	}
+	return (arena.base + start);
+}
+
+/**
+ * A function which returns the pages occupied only by the provided range
+ * of the arena back to the system. The pages stay reserved,
+ * but they can not be accessed and they are not reused afterwards.
+ *
+ * @param
+ * pointer	the beginning of the range
+ * @param
+ * span		the size of the range
+ */
+static void arena_release (char *pointer, size_t span) {
+	uintptr_t start = arena_round((uintptr_t)(pointer), arena.page_size);
+	uintptr_t end = ((uintptr_t)(pointer) + span) &
+		~((uintptr_t)(arena.page_size) - 1);
+	if (end > start) {
+		if (arena_map((void *)(start), end - start, 0) == NULL) {
+			perror("mmap(arena)");
+			/* resetting the errno */
+			errno = 0;
+			return;
+		}
+		arena.released += end - start;
+	}
+}
+
+/**
+ * A function which starts allocating the tables from a new arena.
+ * The tables allocated before remain valid.
+ *
+ * @param
+ * reserve	the size of the address space to reserve in bytes,
+ * 		or zero (0) for the arena_default_reserve. If it can not
+ * 		be reserved, the smaller sizes are tried.
+ *
+ * @return	If the arena has been opened, zero (0) is returned.
+ * 		If the address space could not be reserved,
+ * 		a positive error number is returned
+ * 		and the tables are allocated by the standard library.
+ */
+int arena_open (size_t reserve) {
+	long page_size = sysconf(_SC_PAGESIZE);
+	arena_lock();
+	if (arena.base != NULL) {
+		arena_unlock();
+		return (0);
+	}
+	arena.page_size = page_size > 0 ? (size_t)(page_size) : 4096;
+	arena.reserve = arena_round(reserve == 0 ? arena_default_reserve :
+			reserve, arena.page_size);
+	while ((arena.base = arena_map(NULL, arena.reserve, 1)) == NULL) {
+		if (arena.reserve / 2 < arena_minimum_reserve) {
+			fprintf(stderr, "Error: Could not reserve the address "
+					"space for the arena!\n");
+			arena.reserve = 0;
+			arena_unlock();
+			return (1);
+		}
+		arena.reserve /= 2;
+	}
+	arena.top = 0;
+	arena_unlock();
+	return (0);
+}
+
+/**
+ * A function which tears down all the tables allocated from the arena
+ * at once by a single mmap of fresh pages over the whole arena,
+ * so that the next tables are allocated at the same offsets.
+ * The tables allocated by the standard library are not affected.
+ *
+ * @return	If the arena has been reset or it is not used,
+ * 		zero (0) is returned. If the address space could not
+ * 		be mapped again, a positive error number is returned
+ * 		and the tables are allocated by the standard library.
+ */
+int arena_reset (void) {
+	int retval = 0;
+	arena_lock();
+	if (arena.base == NULL) {
+		arena_unlock();
+		return (0);
+	}
+	/* forgetting the tables, which have not been freed */
+	if ((arena.block_size > 0) &&
+			(arena_rehash(arena.block_size, 0) > 0)) {
+		retval = 1;
+	}
+	if (arena_map(arena.base, arena.reserve, 1) == NULL) {
+		perror("mmap(arena)");
+		/* resetting the errno */
+		errno = 0;
+		fprintf(stderr, "Error: Could not map the address "
+				"space of the arena again!\n");
+		/* the arena keeps its address space until it is closed */
+		arena.top = arena.reserve;
+		retval = 1;
+	} else {
+		arena.top = 0;
+	}
+	arena_unlock();
+	return (retval);
+}
+
+/**
+ * A function which tears down the arena, if it is used,
+ * and forgets all the statistics. The tables allocated
+ * by the standard library need to be freed before.
+ */
+void arena_close (void) {
+	arena_lock();
+	if ((arena.base != NULL) &&
+			(munmap(arena.base, arena.reserve) != 0)) {
+		perror("munmap(arena)");
+		/* resetting the errno */
+		errno = 0;
+	}
+	free(arena.blocks);
+	memset(&arena, 0, sizeof (arena_state));
+	arena_unlock();
+}
+
+/**
+ * A function which allocates a zero-filled table
+ * like the calloc of the standard library.
+ *
+ * @param
+ * count	the number of the records of the table
+ * @param
+ * size		the size of a single record
+ *
+ * @return	The address of the table, or NULL if it could not
+ * 		be allocated.
+ */
+void *arena_calloc (size_t count, size_t size) {
+	unsigned long long start = arena_clock();
+	char *pointer = NULL;
+	size_t span = 0;
+	if ((size != 0) && (count > SIZE_MAX / size)) {
+		return (NULL);
+	}
+	arena_lock();
+	if (arena.base != NULL) {
+		pointer = arena_bump(count * size, &span);
+		if (pointer == NULL) {
+			++arena.fallbacks;
+		}
+	}
+	if (pointer == NULL) {
+		pointer = calloc(count, size);
+	}
+	if (pointer != NULL) {
+		++arena.allocations;
+		arena_track(pointer, count * size, span);
+	}
+	arena.time += arena_clock() - start;
+	arena_unlock();
+	return (pointer);
+}
+
+/**
+ * A function which changes the size of a table
+ * like the realloc of the standard library. The table is grown
+ * in place, if it is at the top of the arena. Otherwise,
+ * it is moved to the top by remapping its pages, if possible,
+ * or by copying it. The grown part of a table allocated
+ * from the arena is zero-filled.
+ *
+ * @param
+ * pointer	the address of the table, or NULL
+ * @param
+ * size		the new size of the table
+ *
+ * @return	The new address of the table, or NULL if it could not
+ * 		be reallocated. In that case, the original table
+ * 		is left untouched.
+ */
+void *arena_realloc (void *pointer, size_t size) {
+	unsigned long long start = arena_clock();
+	arena_block *block = NULL;
+	arena_block old_block = {.pointer = NULL};
+	char *new_pointer = NULL;
+	size_t span = 0;
+	if (pointer == NULL) {
+		return (arena_calloc(size, (size_t)(1)));
+	}
+	arena_lock();
+	++arena.reallocations;
+	block = arena_find(pointer);
+	if ((block == NULL) || (block->span == 0)) {
+		/* the standard library might need to copy the table */
+		arena_account(arena.live + size);
+		new_pointer = realloc(pointer, size);
+		if ((new_pointer != NULL) && (block != NULL)) {
+			arena_untrack(block);
+			arena_track(new_pointer, size, 0);
+		}
+		arena.time += arena_clock() - start;
+		arena_unlock();
+		return (new_pointer);
+	}
+	old_block = (*block);
+	/*
+	 * The part of the address space of the table after its size
+	 * might still contain the data from before it has been shrunk.
+	 */
+	if (size > old_block.size) {
+		memset(old_block.pointer + old_block.size, 0,
+				(size < old_block.span ? size :
+				 old_block.span) - old_block.size);
+	}
+	if (size <= old_block.span) {
+		/* the table still fits into its address space */
+		new_pointer = pointer;
+		span = old_block.span;
+	} else if (old_block.pointer + old_block.span ==
+			arena.base + arena.top) {
+		/* the table is at the top of the arena */
+		arena.top = (size_t)(old_block.pointer - arena.base);
+		new_pointer = arena_bump(size, &span);
+		if (new_pointer == old_block.pointer) {
+			++arena.in_place;
+		} else {
+			/* the table did not fit, or it needs to be aligned */
+			arena.top = (size_t)(old_block.pointer - arena.base) +
+				old_block.span;
+			new_pointer = NULL;
+		}
+	}
+	if (new_pointer == NULL) {
+		new_pointer = arena_bump(size, &span);
+		if (new_pointer == NULL) {
+			++arena.fallbacks;
+			new_pointer = calloc(size, (size_t)(1));
+			span = 0;
+			if (new_pointer == NULL) {
+				arena.time += arena_clock() - start;
+				arena_unlock();
+				return (NULL);
+			}
+		}
+#ifdef	__linux__
+		if ((span != 0) &&
+				(old_block.span % arena.page_size == 0) &&
+				((size_t)(old_block.pointer - arena.base) %
+				 arena.page_size == 0) &&
+				(mremap(old_block.pointer, old_block.span, span,
+					MREMAP_MAYMOVE | MREMAP_FIXED,
+					new_pointer) != MAP_FAILED)) {
+			/* the moved pages leave a hole in the arena */
+			if (arena_map(old_block.pointer, old_block.span,
+						0) == NULL) {
+				perror("mmap(arena)");
+				/* resetting the errno */
+				errno = 0;
+			}
+			++arena.remapped;
+		} else
+#endif
+		{
+			/* resetting the errno */
+			errno = 0;
+			arena_account(arena.live + size);
+			memcpy(new_pointer, old_block.pointer, old_block.size);
+			arena_release(old_block.pointer, old_block.span);
+			++arena.copied;
+		}
+	}
+	arena_untrack(block);
+	arena_track(new_pointer, size, span);
+	arena.time += arena_clock() - start;
+	arena_unlock();
+	return (new_pointer);
+}
+
+/**
+ * A function which frees a table like the free of the standard library.
+ * The pages occupied only by a table allocated from the arena
+ * are returned to the system immediately.
+ *
+ * @param
+ * pointer	the address of the table, or NULL
+ */
+void arena_free (void *pointer) {
+	unsigned long long start = arena_clock();
+	arena_block *block = NULL;
+	if (pointer == NULL) {
+		return;
+	}
+	arena_lock();
+	++arena.frees;
+	block = arena_find(pointer);
+	if ((block == NULL) || (block->span == 0)) {
+		free(pointer);
+	} else {
+		arena_release(block->pointer, block->span);
+	}
+	if (block != NULL) {
+		arena_untrack(block);
+	}
+	arena.time += arena_clock() - start;
+	arena_unlock();
+}
+
+/**
+ * A function which measures the peak total size of the tables
+ * since the previous call of this function (or since the start),
+ * including both the copies of a table being moved by copying,
+ * and starts the next measurement.
+ *
+ * @return	The peak total size of the tables in bytes.
+ */
+size_t arena_measure_peak (void) {
+	size_t peak = 0;
+	arena_lock();
+	peak = arena.measured_peak;
+	arena.measured_peak = arena.live;
+	arena_unlock();
+	return (peak);
+}
+
+/**
+ * A function which prints the statistics of the allocator.
+ *
+ * @param
+ * stream	the FILE * type stream, to which the statistics are printed
+ *
+ * @return	This function always returns zero (0).
+ */
+int arena_print_stats (FILE *stream) {
+	arena_lock();
+	fprintf(stream, "Table allocator: ");
+	if (arena.base != NULL) {
+		fprintf(stream, "arena of ");
+		print_human_readable_size(stream, arena.reserve);
+		fprintf(stream, " of the address space\n");
+	} else {
+		fprintf(stream, "standard library\n");
+	}
+	fprintf(stream, "Allocations: %zu, reallocations: %zu, frees: %zu\n",
+			arena.allocations, arena.reallocations, arena.frees);
+	if (arena.base != NULL) {
+		fprintf(stream, "Reallocations in place: %zu, "
+				"by remapping: %zu, by copying: %zu\n",
+				arena.in_place, arena.remapped, arena.copied);
+		fprintf(stream, "Tables, which did not fit "
+				"into the arena: %zu\n", arena.fallbacks);
+	}
+	fprintf(stream, "Time spent in the allocator: %.3f ms\n",
+			(double)(arena.time) / 1e6);
+	fprintf(stream, "Peak size of the tables: ");
+	print_human_readable_size(stream, arena.peak_live);
+	fprintf(stream, "\n");
+	if (arena.base != NULL) {
+		fprintf(stream, "Peak address space of the arena used: ");
+		print_human_readable_size(stream, arena.peak_top);
+		fprintf(stream, ", returned to the system: ");
+		print_human_readable_size(stream, arena.released);
+		fprintf(stream, "\n");
+	}
+	arena_unlock();
+	return (0);
+}
@@ -0,0 +1,1015 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The phase profile-related functions implementation.
+ * This file contains the implementation of the functions,
+ * which record the wall-clock time, the resident set size
+ * and the hardware performance counters separately
+ * for the consecutive phases of a benchmark.
+ * The counters are read by the perf_event_open system call
+ * and the resident set size from the /proc/self/statm,
+ * so they are only available on Linux. Elsewhere, or when the kernel
+ * does not permit their use, they are reported as unavailable.
+ */
+
+/* if we are on the Linux platform */
+#ifdef	__linux__
+
+#ifndef	_GNU_SOURCE
+
+/**
+ * This macro is necessary for the function sched_setaffinity
+ * and the related CPU_* macros
+ */
+#define	_GNU_SOURCE
+
+#endif
+
+#endif
+
+#include "phase_profile.h"
+#include "suffix_tree_common.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef	__linux__
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+/* struct typedefs */
+
+/**
+ * A struct which describes a single hardware performance counter.
+ */
+typedef struct phase_counter_struct {
+	/** the name of the counter printed in the table */
+	const char *name;
+	/** the key of the counter in the JSON output */
+	const char *key;
+	/** the type of the perf event */
+	unsigned int type;
+	/** the type-specific configuration of the perf event */
+	unsigned long long config;
+} phase_counter;
+
+/* constants */
+
+#ifdef	__linux__
+
+/**
+ * The hardware performance counters recorded for each phase.
+ * The cache events count the read misses only.
+ */
+static const phase_counter phase_counter_table[] = {
+	{"cycles", "cycles",
+		PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{"instructions", "instructions",
+		PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{"L1d misses", "l1d_misses",
+		PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+		(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		(PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+	{"LLC misses", "llc_misses",
+		PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+		(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		(PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+	{"dTLB misses", "dtlb_misses",
+		PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+		(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		(PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+	{"branch misses", "branch_misses",
+		PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+#else
+
+/**
+ * The names of the counters, which are never available
+ * on this platform.
+ */
+static const phase_counter phase_counter_table[] = {
+	{"cycles", "cycles", 0, 0},
+	{"instructions", "instructions", 0, 0},
+	{"L1d misses", "l1d_misses", 0, 0},
+	{"LLC misses", "llc_misses", 0, 0},
+	{"dTLB misses", "dtlb_misses", 0, 0},
+	{"branch misses", "branch_misses", 0, 0}
+};
+
+#endif
+
+/**
+ * The number of the hardware performance counters recorded for each phase.
+ */
+const size_t phase_profile_counters = sizeof (phase_counter_table) /
+	sizeof (phase_counter_table[0]);
+
+/**
+ * The value of a counter, which could not be read.
+ */
+const unsigned long long phase_profile_unavailable = ~0ULL;
+
+/**
+ * The number of the phases, for which the memory is initially allocated.
+ * It is doubled on demand.
+ */
+static const size_t phase_profile_initial_size = 8;
+
+/**
+ * The number of the samples of the resident set size,
+ * for which the memory is initially allocated. It is doubled on demand.
+ */
+static const size_t phase_profile_initial_samples = 1024;
+
+/**
+ * The width of a column of the printed table.
+ */
+static const int phase_profile_column_width = 14;
+
+/* phase profile functions */
+
+/**
+ * A function which reads the current values of all the counters.
+ * The values of the multiplexed counters are scaled by the fraction
+ * of the time, in which they were actually running.
+ *
+ * @param
+ * values	the array of phase_profile_counters values,
+ * 		to which the values of the counters are stored
+ * @param
+ * profile	the phase profile
+ */
+static void phase_profile_read (unsigned long long *values,
+		const phase_profile *profile) {
+	size_t i = 0;
+#ifdef	__linux__
+	/* the value, the time enabled and the time running */
+	unsigned long long data[3] = {0};
+	for (i = 0; i < phase_profile_counters; ++i) {
+		values[i] = phase_profile_unavailable;
+		if ((profile->descriptors[i] == (-1)) ||
+				(read(profile->descriptors[i], data,
+				      sizeof (data)) !=
+				 (ssize_t)(sizeof (data)))) {
+			continue;
+		}
+		if (data[2] == 0) {
+			/* the counter has not been scheduled yet */
+			values[i] = 0;
+		} else if (data[2] < data[1]) {
+			values[i] = (unsigned long long)((double)(data[0]) *
+					(double)(data[1]) / (double)(data[2]));
+		} else {
+			values[i] = data[0];
+		}
+	}
+#else
+	(void)(profile);
+	for (i = 0; i < phase_profile_counters; ++i) {
+		values[i] = phase_profile_unavailable;
+	}
+#endif
+}
+
+/**
+ * A function which returns the current value of the monotonic clock.
+ *
+ * @return	The current value of the monotonic clock in nanoseconds.
+ */
+unsigned long long phase_profile_clock (void) {
+	struct timespec now = {0, 0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((unsigned long long)(now.tv_sec) * 1000000000ULL +
+			(unsigned long long)(now.tv_nsec));
+}
+
+/**
+ * A function which reads the current resident set size of this process.
+ *
+ * @return	The current resident set size in bytes,
+ * 		or zero (0) if it could not be determined.
+ */
+static size_t phase_profile_rss (void) {
+	FILE *statm = NULL;
+	unsigned long pages = 0;
+	unsigned long resident = 0;
+	long page_size = sysconf(_SC_PAGESIZE);
+	statm = fopen("/proc/self/statm", "r");
+	if (statm == NULL) {
+		/* resetting the errno */
+		errno = 0;
+		return (0);
+	}
+	if ((fscanf(statm, "%lu %lu", &pages, &resident) != 2) ||
+			(page_size <= 0)) {
+		resident = 0;
+	}
+	fclose(statm);
+	/* resetting the errno */
+	errno = 0;
+	return ((size_t)(resident) * (size_t)(page_size));
+}
+
+/**
+ * A function which records a sample of the resident set size
+ * and updates the peak of the current phase. If the caller
+ * runs in parallel with the sampler, it needs to hold the mutex.
+ *
+ * @param
+ * store	if this variable evaluates to true, the sample is stored
+ * 		in the timeline, otherwise it only updates the peak
+ * @param
+ * profile	the phase profile
+ *
+ * @return	The sampled resident set size in bytes.
+ */
+static size_t phase_profile_sample (int store, phase_profile *profile) {
+	phase_sample *samples = NULL;
+	size_t rss = phase_profile_rss();
+	if (rss > profile->current_peak) {
+		profile->current_peak = rss;
+	}
+	if (store == 0) {
+		return (rss);
+	}
+	if (profile->sample_count == profile->sample_size) {
+		samples = realloc(profile->samples, 2 * profile->sample_size *
+				sizeof (phase_sample));
+		if (samples == NULL) {
+			/* the timeline is truncated, but the peak is kept */
+			/* resetting the errno */
+			errno = 0;
+			return (rss);
+		}
+		profile->samples = samples;
+		profile->sample_size *= 2;
+	}
+	profile->samples[profile->sample_count].time =
+		phase_profile_clock() - profile->origin;
+	profile->samples[profile->sample_count].rss = rss;
+	++profile->sample_count;
+	return (rss);
+}
+
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+
+/**
+ * A function which is run by the sampler thread.
+ * It samples the resident set size every profile->interval milliseconds
+ * until it is told to stop.
+ *
+ * @param
+ * argument	the phase profile
+ *
+ * @return	This function always returns NULL.
+ */
+static void *phase_profile_sampler (void *argument) {
+	phase_profile *profile = (phase_profile *)(argument);
+	struct timespec deadline = {0, 0};
+	int retval = 0;
+	pthread_mutex_lock(&profile->mutex);
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	while (profile->stopping == 0) {
+		deadline.tv_sec += (time_t)(profile->interval / 1000);
+		deadline.tv_nsec += (long)(profile->interval % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L) {
+			++deadline.tv_sec;
+			deadline.tv_nsec -= 1000000000L;
+		}
+		retval = 0;
+		while ((profile->stopping == 0) && (retval != ETIMEDOUT)) {
+			retval = pthread_cond_timedwait(&profile->stop_cv,
+					&profile->mutex, &deadline);
+		}
+		if (profile->stopping == 0) {
+			phase_profile_sample(1, profile);
+		}
+	}
+	pthread_mutex_unlock(&profile->mutex);
+	return (NULL);
+}
+
+#endif
+
+/**
+ * A function which opens the phase profile. The wall-clock time
+ * and the resident set size at the beginning and at the end
+ * of each phase are always recorded.
+ *
+ * The hardware performance counters are inherited by the threads
+ * created afterwards, so the profile should be opened before any
+ * other thread is started. The events of such a thread are added
+ * to the counters when it exits, so they are attributed to the phase,
+ * in which the thread exits. If none of the counters can be opened,
+ * a warning is printed and the phases are recorded with all
+ * the counters unavailable.
+ *
+ * @param
+ * counters	if this variable evaluates to true,
+ * 		the hardware performance counters are opened
+ * @param
+ * interval	the interval in milliseconds, in which the resident
+ * 		set size is sampled by a separate thread,
+ * 		or zero (0) if it should only be read between the phases
+ * @param
+ * profile	the phase profile to open
+ *
+ * @return	If the phase profile has been opened, zero (0) is returned,
+ * 		even if none of the counters is available.
+ * 		If the memory could not be allocated,
+ * 		a positive error number is returned.
+ */
+int phase_profile_open (int counters,
+		size_t interval,
+		phase_profile *profile) {
+	size_t i = 0;
+#ifdef	__linux__
+	struct perf_event_attr attr;
+	long descriptor = 0;
+#endif
+	memset(profile, 0, sizeof (phase_profile));
+	if (counters != 0) {
+		profile->descriptors = malloc(phase_profile_counters *
+				sizeof (int));
+		if (profile->descriptors == NULL) {
+			perror("malloc(descriptors)");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
+		for (i = 0; i < phase_profile_counters; ++i) {
+			profile->descriptors[i] = (-1);
+		}
+	}
+	profile->start_values = calloc(phase_profile_counters,
+			sizeof (unsigned long long));
+	profile->records = malloc(phase_profile_initial_size *
+			sizeof (phase_record));
+	profile->values = malloc(phase_profile_initial_size *
+			phase_profile_counters * sizeof (unsigned long long));
+	if (interval > 0) {
+		profile->samples = malloc(phase_profile_initial_samples *
+				sizeof (phase_sample));
+	}
+	if ((profile->start_values == NULL) ||
+			(profile->records == NULL) ||
+			(profile->values == NULL) ||
+			((interval > 0) && (profile->samples == NULL))) {
+		perror("malloc(phase_profile)");
+		/* resetting the errno */
+		errno = 0;
+		phase_profile_close(profile);
+		return (2);
+	}
+	profile->size = phase_profile_initial_size;
+	profile->sample_size = phase_profile_initial_samples;
+	profile->origin = phase_profile_clock();
+	for (i = 0; (counters != 0) && (i < phase_profile_counters); ++i) {
+#ifdef	__linux__
+		memset(&attr, 0, sizeof (attr));
+		attr.size = sizeof (attr);
+		attr.type = phase_counter_table[i].type;
+		attr.config = phase_counter_table[i].config;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+			PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.inherit = 1;
+		/* the user space events are usually permitted */
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		descriptor = syscall(SYS_perf_event_open, &attr,
+				/* this process on any processor */
+				0, -1, -1, 0UL);
+		if (descriptor >= 0) {
+			profile->descriptors[i] = (int)(descriptor);
+			++profile->available;
+		}
+#endif
+	}
+	/* the failed perf_event_open calls are expected */
+	errno = 0;
+	if ((counters != 0) && (profile->available == 0)) {
+		fprintf(stderr, "Warning: The hardware performance counters "
+				"are not available!\n");
+	}
+	if (interval == 0) {
+		return (0);
+	}
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+	pthread_mutex_init(&profile->mutex, NULL);
+	pthread_cond_init(&profile->stop_cv, NULL);
+	profile->interval = interval;
+	if (pthread_create(&profile->sampler, NULL,
+				phase_profile_sampler, profile) != 0) {
+		perror("pthread_create(sampler)");
+		/* resetting the errno */
+		errno = 0;
+		pthread_cond_destroy(&profile->stop_cv);
+		pthread_mutex_destroy(&profile->mutex);
+		/* the resident set size is read between the phases only */
+		profile->interval = 0;
+	}
+#else
+	fprintf(stderr, "Warning: The resident set size can not be "
+			"sampled without the POSIX threads!\n");
+#endif
+	return (0);
+}
+
+/**
+ * A function which ends the current phase, if there is any,
+ * and begins a new one. If the profile is NULL, it does nothing,
+ * so that the callers need not to check whether the profiling
+ * has been requested.
+ *
+ * @param
+ * name		the name of the new phase, which needs to stay valid
+ * 		until the profile is closed
+ * @param
+ * profile	the phase profile, or NULL
+ */
+void phase_profile_begin (const char *name, phase_profile *profile) {
+	if (profile == NULL) {
+		return;
+	}
+	phase_profile_end(profile);
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+	if (profile->interval > 0) {
+		pthread_mutex_lock(&profile->mutex);
+	}
+#endif
+	profile->current_peak = 0;
+	phase_profile_sample(0, profile);
+	profile->start = phase_profile_clock();
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+	if (profile->interval > 0) {
+		pthread_mutex_unlock(&profile->mutex);
+	}
+#endif
+	profile->current = name;
+	if (profile->descriptors != NULL) {
+		phase_profile_read(profile->start_values, profile);
+	}
+}
+
+/**
+ * A function which ends the current phase and records its duration,
+ * its peak resident set size and the values of the counters
+ * accumulated during it. If there is no current phase
+ * or the profile is NULL, it does nothing.
+ *
+ * @param
+ * profile	the phase profile, or NULL
+ */
+void phase_profile_end (phase_profile *profile) {
+	unsigned long long *values = NULL;
+	phase_record *records = NULL;
+	phase_record *record = NULL;
+	unsigned long long end = 0;
+	size_t i = 0;
+	if ((profile == NULL) || (profile->current == NULL)) {
+		return;
+	}
+	if (profile->phases == profile->size) {
+		records = realloc(profile->records, 2 * profile->size *
+				sizeof (phase_record));
+		if (records != NULL) {
+			profile->records = records;
+			values = realloc(profile->values, 2 * profile->size *
+					phase_profile_counters *
+					sizeof (unsigned long long));
+		}
+		if (values == NULL) {
+			perror("realloc(phase_profile)");
+			/* resetting the errno */
+			errno = 0;
+			/* the phase is dropped */
+			profile->current = NULL;
+			return;
+		}
+		profile->values = values;
+		profile->size *= 2;
+	}
+	values = profile->values + profile->phases * phase_profile_counters;
+	if (profile->descriptors != NULL) {
+		phase_profile_read(values, profile);
+	}
+	end = phase_profile_clock();
+	record = profile->records + profile->phases;
+	record->name = profile->current;
+	record->start = profile->start - profile->origin;
+	record->duration = end - profile->start;
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+	if (profile->interval > 0) {
+		pthread_mutex_lock(&profile->mutex);
+	}
+#endif
+	record->end_rss = phase_profile_sample(0, profile);
+	record->peak_rss = profile->current_peak;
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+	if (profile->interval > 0) {
+		pthread_mutex_unlock(&profile->mutex);
+	}
+#endif
+	for (i = 0; i < phase_profile_counters; ++i) {
+		if ((profile->descriptors != NULL) &&
+				(values[i] != phase_profile_unavailable) &&
+				(profile->start_values[i] !=
+				 phase_profile_unavailable)) {
+			values[i] = values[i] > profile->start_values[i] ?
+				values[i] - profile->start_values[i] : 0;
+		} else {
+			values[i] = phase_profile_unavailable;
+		}
+	}
+	++profile->phases;
+	profile->current = NULL;
+}
+
+/**
+ * A function which ends the current phase, if there is any,
+ * and stops the sampler, so that the profile can be printed.
+ * If the profile is NULL, it does nothing.
+ *
+ * @param
+ * profile	the phase profile, or NULL
+ */
+void phase_profile_finish (phase_profile *profile) {
+	if (profile == NULL) {
+		return;
+	}
+	phase_profile_end(profile);
+#ifdef	PHASE_PROFILE_USE_PTHREAD
+	if (profile->interval > 0) {
+		pthread_mutex_lock(&profile->mutex);
+		profile->stopping = 1;
+		pthread_cond_signal(&profile->stop_cv);
+		pthread_mutex_unlock(&profile->mutex);
+		pthread_join(profile->sampler, NULL);
+		pthread_cond_destroy(&profile->stop_cv);
+		pthread_mutex_destroy(&profile->mutex);
+		profile->interval = 0;
+	}
+#endif
+}
+
+/**
+ * A function which compares two durations or two values
+ * of a counter for the qsort.
+ *
+ * @param
+ * a	the first duration
+ * @param
+ * b	the second duration
+ *
+ * @return	A negative number, zero or a positive number,
+ * 		if the first duration is shorter, equal or longer
+ * 		than the second one, respectively.
+ */
+static int phase_profile_compare (const void *a, const void *b) {
+	unsigned long long first = *(const unsigned long long *)(a);
+	unsigned long long second = *(const unsigned long long *)(b);
+	return ((first > second) - (first < second));
+}
+
+/**
+ * A function which prints the resident set size
+ * in the human readable format, or "n/a" if it is unknown.
+ *
+ * @param
+ * stream	the FILE * type stream, to which the size is printed
+ * @param
+ * rss		the resident set size in bytes
+ */
+static void phase_profile_print_rss (FILE *stream, size_t rss) {
+	if (rss == 0) {
+		fprintf(stream, "n/a");
+	} else {
+		print_human_readable_size(stream, rss);
+	}
+}
+
+/**
+ * A function which prints the wall-clock time and the memory usage
+ * of the finished phases and, if they have been requested,
+ * the table of the counters recorded for them. In the table,
+ * each row contains a single counter and each column the phases
+ * of a single name. If a phase has been repeated in the consecutive
+ * runs of a benchmark, the median of the values of each counter
+ * over the runs is printed. The unavailable values are printed as "n/a".
+ *
+ * @param
+ * stream	the FILE * type stream, to which the profile is printed
+ * @param
+ * profile	the finished phase profile
+ *
+ * @return	If the profile has been printed, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int phase_profile_print (FILE *stream, const phase_profile *profile) {
+	const unsigned long long *values = NULL;
+	/* the first phase of each name, one for each column */
+	size_t *columns = NULL;
+	/* the values of a single counter in the phases of the same name */
+	unsigned long long *repeated = NULL;
+	/* the medians of the counters, one row for each column */
+	unsigned long long *medians = NULL;
+	size_t column_count = 0;
+	size_t runs = 0;
+	size_t count = 0;
+	size_t peak_rss = 0;
+	size_t i = 0;
+	size_t j = 0;
+	size_t k = 0;
+	fprintf(stream, "Wall-clock time and memory per phase:\n");
+	for (j = 0; j < profile->phases; ++j) {
+		fprintf(stream, "%-*s %14.3f ms, peak RSS ",
+				phase_profile_column_width,
+				profile->records[j].name,
+				(double)(profile->records[j].duration) / 1e6);
+		phase_profile_print_rss(stream, profile->records[j].peak_rss);
+		fprintf(stream, ", final RSS ");
+		phase_profile_print_rss(stream, profile->records[j].end_rss);
+		fprintf(stream, "\n");
+		if (profile->records[j].peak_rss > peak_rss) {
+			peak_rss = profile->records[j].peak_rss;
+		}
+	}
+	fprintf(stream, "Peak RSS of all the phases: ");
+	phase_profile_print_rss(stream, peak_rss);
+	if (profile->samples != NULL) {
+		fprintf(stream, " (%zu samples)\n", profile->sample_count);
+	} else {
+		fprintf(stream, " (between the phases only)\n");
+	}
+	if (profile->descriptors == NULL) {
+		return (0);
+	}
+	columns = malloc(profile->phases * sizeof (size_t));
+	repeated = malloc(profile->phases * sizeof (unsigned long long));
+	medians = malloc(profile->phases * phase_profile_counters *
+			sizeof (unsigned long long));
+	if ((columns == NULL) || (repeated == NULL) || (medians == NULL)) {
+		perror("malloc(columns)");
+		/* resetting the errno */
+		errno = 0;
+		free(columns);
+		free(repeated);
+		free(medians);
+		return (1);
+	}
+	for (j = 0; j < profile->phases; ++j) {
+		/* skipping the names, which already have their column */
+		for (k = 0; k < column_count; ++k) {
+			if (strcmp(profile->records[columns[k]].name,
+					profile->records[j].name) == 0) {
+				break;
+			}
+		}
+		if (k < column_count) {
+			continue;
+		}
+		columns[column_count] = j;
+		values = medians + column_count * phase_profile_counters;
+		for (i = 0; i < phase_profile_counters; ++i) {
+			count = 0;
+			for (k = j; k < profile->phases; ++k) {
+				if (strcmp(profile->records[k].name,
+						profile->records[j].name)
+						!= 0) {
+					continue;
+				}
+				repeated[count++] = profile->values[k *
+					phase_profile_counters + i];
+			}
+			if (count > runs) {
+				runs = count;
+			}
+			qsort(repeated, count, sizeof (unsigned long long),
+					phase_profile_compare);
+			/* the unavailable values are sorted last */
+			if (repeated[count - 1] == phase_profile_unavailable) {
+				medians[column_count * phase_profile_counters +
+					i] = phase_profile_unavailable;
+			} else {
+				medians[column_count * phase_profile_counters +
+					i] = count % 2 == 1 ?
+					repeated[count / 2] :
+					(repeated[count / 2 - 1] +
+					 repeated[count / 2]) / 2;
+			}
+		}
+		++column_count;
+	}
+	if (runs > 1) {
+		fprintf(stream, "\nHardware performance counters per phase "
+				"(the median over %zu runs):\n", runs);
+	} else {
+		fprintf(stream, "\nHardware performance counters "
+				"per phase:\n");
+	}
+	fprintf(stream, "%-*s", phase_profile_column_width, "");
+	for (j = 0; j < column_count; ++j) {
+		fprintf(stream, " %*s", phase_profile_column_width,
+				profile->records[columns[j]].name);
+	}
+	fprintf(stream, "\n");
+	for (i = 0; i < phase_profile_counters; ++i) {
+		fprintf(stream, "%-*s", phase_profile_column_width,
+				phase_counter_table[i].name);
+		for (j = 0; j < column_count; ++j) {
+			values = medians + j * phase_profile_counters;
+			if (values[i] == phase_profile_unavailable) {
+				fprintf(stream, " %*s",
+						phase_profile_column_width,
+						"n/a");
+			} else {
+				fprintf(stream, " %*llu",
+						phase_profile_column_width,
+						values[i]);
+			}
+		}
+		fprintf(stream, "\n");
+	}
+	/*
+	 * the instructions per cycle, if both are available
+	 * (they are the first two counters in the table)
+	 */
+	fprintf(stream, "%-*s", phase_profile_column_width, "IPC");
+	for (j = 0; j < column_count; ++j) {
+		values = medians + j * phase_profile_counters;
+		if ((values[0] == phase_profile_unavailable) ||
+				(values[1] == phase_profile_unavailable) ||
+				(values[0] == 0)) {
+			fprintf(stream, " %*s", phase_profile_column_width,
+					"n/a");
+		} else {
+			fprintf(stream, " %*.2f", phase_profile_column_width,
+					(double)(values[1]) /
+					(double)(values[0]));
+		}
+	}
+	fprintf(stream, "\n");
+	free(columns);
+	free(repeated);
+	free(medians);
+	return (0);
+}
+
+/**
+ * A function which pins this process to the provided processor,
+ * so that all the phases of the repeated runs are measured
+ * on the same processor and do not suffer from the migrations.
+ * The threads created afterwards inherit the pinning.
+ * It requires the sched_setaffinity system call of Linux.
+ *
+ * @param
+ * cpu	the number of the processor, to which this process is pinned
+ *
+ * @return	If the process has been pinned, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int phase_profile_pin (size_t cpu) {
+#ifdef	__linux__
+	cpu_set_t set;
+	if (cpu >= (size_t)(CPU_SETSIZE)) {
+		fprintf(stderr, "Error: The processor number %zu "
+				"is too large!\n", cpu);
+		return (1);
+	}
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (sched_setaffinity(0, sizeof (cpu_set_t), &set) != 0) {
+		perror("sched_setaffinity");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	return (0);
+#else
+	fprintf(stderr, "Error: The pinning to the processor %zu "
+			"is not supported on this platform!\n", cpu);
+	return (3);
+#endif
+}
+
+/**
+ * A function which prints the statistics of the wall-clock time
+ * of the phases, which have been repeated in the consecutive runs
+ * of a benchmark. The phases of the same name are grouped together
+ * and the minimum, the median, the 95th percentile (nearest rank)
+ * and the maximum of their durations are printed,
+ * together with the largest peak resident set size among them.
+ *
+ * @param
+ * stream	the FILE * type stream, to which the statistics are printed
+ * @param
+ * profile	the finished phase profile
+ *
+ * @return	If the statistics have been printed, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int phase_profile_print_summary (FILE *stream,
+		const phase_profile *profile) {
+	unsigned long long *durations = NULL;
+	double median = 0;
+	size_t peak_rss = 0;
+	size_t count = 0;
+	size_t i = 0;
+	size_t j = 0;
+	if (profile->phases == 0) {
+		return (0);
+	}
+	durations = malloc(profile->phases * sizeof (unsigned long long));
+	if (durations == NULL) {
+		perror("malloc(durations)");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	fprintf(stream, "Wall-clock time per phase over the runs (ms):\n");
+	fprintf(stream, "%-*s %6s %12s %12s %12s %12s   peak RSS\n",
+			phase_profile_column_width, "phase", "runs",
+			"min", "median", "p95", "max");
+	for (j = 0; j < profile->phases; ++j) {
+		/* skipping the names, which have already been printed */
+		for (i = 0; i < j; ++i) {
+			if (strcmp(profile->records[i].name,
+					profile->records[j].name) == 0) {
+				break;
+			}
+		}
+		if (i < j) {
+			continue;
+		}
+		count = 0;
+		peak_rss = 0;
+		for (i = j; i < profile->phases; ++i) {
+			if (strcmp(profile->records[i].name,
+					profile->records[j].name) != 0) {
+				continue;
+			}
+			durations[count++] = profile->records[i].duration;
+			if (profile->records[i].peak_rss > peak_rss) {
+				peak_rss = profile->records[i].peak_rss;
+			}
+		}
+		qsort(durations, count, sizeof (unsigned long long),
+				phase_profile_compare);
+		if (count % 2 == 1) {
+			median = (double)(durations[count / 2]);
+		} else {
+			median = ((double)(durations[count / 2 - 1]) +
+					(double)(durations[count / 2])) / 2;
+		}
+		fprintf(stream, "%-*s %6zu %12.3f %12.3f %12.3f %12.3f   ",
+				phase_profile_column_width,
+				profile->records[j].name, count,
+				(double)(durations[0]) / 1e6, median / 1e6,
+				/* the nearest rank: ceil(0.95 * count) */
+				(double)(durations[(95 * count + 99) / 100
+					- 1]) / 1e6,
+				(double)(durations[count - 1]) / 1e6);
+		phase_profile_print_rss(stream, peak_rss);
+		fprintf(stream, "\n");
+	}
+	free(durations);
+	return (0);
+}
+
+/**
+ * A function which writes the finished phases and the samples
+ * of the resident set size into a file as a single JSON object.
+ * The times are in milliseconds since the opening of the profile,
+ * the sizes in bytes. The unknown sizes and the unavailable counters
+ * are written as null.
+ *
+ * @param
+ * filename	the name of the file, to which the profile is written
+ * @param
+ * profile	the finished phase profile
+ *
+ * @return	If the profile has been written, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int phase_profile_write_json (const char *filename,
+		const phase_profile *profile) {
+	const phase_record *record = NULL;
+	const unsigned long long *values = NULL;
+	FILE *stream = NULL;
+	size_t peak_rss = 0;
+	size_t i = 0;
+	size_t j = 0;
+	stream = fopen(filename, "w");
+	if (stream == NULL) {
+		perror("fopen(json)");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	fprintf(stream, "{\"phases\":[");
+	for (j = 0; j < profile->phases; ++j) {
+		record = profile->records + j;
+		values = profile->values + j * phase_profile_counters;
+		if (record->peak_rss > peak_rss) {
+			peak_rss = record->peak_rss;
+		}
+		fprintf(stream, "%s\n{\"name\":\"%s\",\"start_ms\":%.3f,"
+				"\"wall_ms\":%.3f,", j == 0 ? "" : ",",
+				record->name, (double)(record->start) / 1e6,
+				(double)(record->duration) / 1e6);
+		if (record->peak_rss == 0) {
+			fprintf(stream, "\"peak_rss\":null,\"end_rss\":null");
+		} else {
+			fprintf(stream, "\"peak_rss\":%zu,\"end_rss\":%zu",
+					record->peak_rss, record->end_rss);
+		}
+		if (profile->descriptors != NULL) {
+			fprintf(stream, ",\"counters\":{");
+			for (i = 0; i < phase_profile_counters; ++i) {
+				fprintf(stream, "%s\"%s\":", i == 0 ? "" : ",",
+						phase_counter_table[i].key);
+				if (values[i] == phase_profile_unavailable) {
+					fprintf(stream, "null");
+				} else {
+					fprintf(stream, "%llu", values[i]);
+				}
+			}
+			fprintf(stream, "}");
+		}
+		fprintf(stream, "}");
+	}
+	fprintf(stream, "],\n");
+	if (peak_rss == 0) {
+		fprintf(stream, "\"peak_rss\":null,\n\"samples\":[");
+	} else {
+		fprintf(stream, "\"peak_rss\":%zu,\n\"samples\":[", peak_rss);
+	}
+	for (j = 0; j < profile->sample_count; ++j) {
+		fprintf(stream, "%s[%.3f,%zu]", j == 0 ? "" :
+				(j % 8 == 0 ? ",\n" : ","),
+				(double)(profile->samples[j].time) / 1e6,
+				profile->samples[j].rss);
+	}
+	fprintf(stream, "]}\n");
+	if (fclose(stream) == EOF) {
+		perror("fclose(json)");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	return (0);
+}
+
+/**
+ * A function which stops the sampler, if it is still running,
+ * closes the hardware performance counters
+ * and frees the memory allocated by the phase profile.
+ *
+ * @param
+ * profile	the phase profile to close
+ */
+void phase_profile_close (phase_profile *profile) {
+#ifdef	__linux__
+	size_t i = 0;
+#endif
+	phase_profile_finish(profile);
+#ifdef	__linux__
+	if (profile->descriptors != NULL) {
+		for (i = 0; i < phase_profile_counters; ++i) {
+			if (profile->descriptors[i] != (-1)) {
+				close(profile->descriptors[i]);
+			}
+		}
+	}
+#endif
+	free(profile->descriptors);
+	free(profile->start_values);
+	free(profile->records);
+	free(profile->values);
+	free(profile->samples);
+	memset(profile, 0, sizeof (phase_profile));
+}
@@ -31,9 +31,39 @@
 #include <iconv.h>
 #include <limits.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* constants */
 
+/**
+ * the number of frames initially allocated for the traversal stack
+ */
+static const size_t traversal_stack_initial_size = 64;
+
+/**
+ * the size of the buffer used by the traversal output (1 MiB)
+ */
+static const size_t traversal_output_buffer_size = 1 << 20;
+
+/**
+ * the alignment of the buffer used by the traversal output
+ */
+static const size_t traversal_output_buffer_alignment = 4096;
+
+/**
+ * the initial size of the buffer used by the traversal output,
+ * which is kept in the memory (64 KiB)
+ */
+static const size_t traversal_output_memory_size = 1 << 16;
+
+/**
+ * the maximum number of bytes, into which a single character
+ * can be converted in the UTF-8 encoding
+ */
+static const size_t traversal_output_max_character_bytes = 6;
+
 /**
  * the terminating character ($)
  *
@@ -66,6 +96,34 @@ const int tt_detailed = 1;
  */
 const int tt_simple = 2;
 
+/**
+ * The constant representing the human readable text traversal format.
+ * This is the format of the traversal logs printed by default.
+ */
+const int tf_text = 1;
+
+/**
+ * The constant representing the compact binary traversal format.
+ * The edges are written as the varint-encoded records,
+ * which can be converted back to the text format by the stdr.
+ */
+const int tf_binary = 2;
+
+/**
+ * The magic of the note chunk of the binary traversal format.
+ */
+const char tf_note_magic[] = "STCN";
+
+/**
+ * The magic of the traversal chunk of the binary traversal format.
+ */
+const char tf_traversal_magic[] = "STCT";
+
+/**
+ * The version of the binary traversal format.
+ */
+const unsigned char tf_version = 1;
+
 /* common helping functions */
 
 /**
@@ -150,3 +208,845 @@ int print_human_readable_time (FILE *stream, size_t time) {
 	}
 	return (0);
 }
+
+/**
+ * A function which pushes a new frame on top of the traversal stack.
+ * If the stack is full, its size is doubled.
+ *
+ * @param
+ * stack	the traversal stack
+ * @param
+ * node		the branching node of the new frame
+ * @param
+ * child	the child of the node, at which the traversal continues
+ * @param
+ * offset	the offset of the node in the array-based representations
+ * @param
+ * depth	the string depth of the node
+ *
+ * @return	If the frame has been successfully pushed, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_stack_push (traversal_stack *stack,
+		signed_integral_type node,
+		signed_integral_type child,
+		size_t offset,
+		unsigned_integral_type depth) {
+	traversal_frame *tmp_pointer = NULL;
+	traversal_frame *frame = NULL;
+	size_t new_size = 0;
+	if (stack->top == stack->size) {
+		if (stack->size == 0) {
+			new_size = traversal_stack_initial_size;
+		} else {
+			new_size = stack->size << 1;
+		}
+		tmp_pointer = realloc(stack->frames,
+				new_size * sizeof (traversal_frame));
+		if (tmp_pointer == NULL) {
+			perror("traversal_stack_push: realloc");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		} else {
+			/*
+			 * Despite that the call to the realloc seems
+			 * to have been successful, we reset the errno,
+			 * because at least on Mac OS X
+			 * it might have changed.
+			 */
+			errno = 0;
+			stack->frames = tmp_pointer;
+		}
+		stack->size = new_size;
+	}
+	frame = stack->frames + stack->top;
+	frame->node = node;
+	frame->child = child;
+	frame->offset = offset;
+	frame->depth = depth;
+	++stack->top;
+	return (0);
+}
+
+/**
+ * A function which deallocates the memory used by the traversal stack
+ * and leaves it empty, ready to be used again.
+ *
+ * @param
+ * stack	the traversal stack to be deallocated
+ */
+void traversal_stack_free (traversal_stack *stack) {
+	free(stack->frames);
+	stack->frames = NULL;
+	stack->size = 0;
+	stack->top = 0;
+}
+
+/**
+ * A function which prepares the buffered traversal output.
+ * It allocates the aligned output buffer and for the text format,
+ * it opens the conversion descriptor from the internal character
+ * encoding to the UTF-8, which is then used for all the edge labels
+ * of the traversal. If the stream is NULL, the output is kept
+ * in the memory, its buffer grows on demand and it can later be
+ * appended to another output by the function traversal_output_append.
+ *
+ * @param
+ * stream	the FILE * type stream to which the output will be written,
+ * 		or NULL if the output should be kept in the memory
+ * @param
+ * format	the format of the output, either tf_text or tf_binary
+ * @param
+ * internal_character_encoding	The character encoding used
+ * 				in the internal representation of the text.
+ * @param
+ * output	the traversal output to be prepared
+ *
+ * @return	If the output has been successfully prepared, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_output_open (FILE *stream,
+		int format,
+		const char *internal_character_encoding,
+		traversal_output *output) {
+	void *buffer = NULL;
+	int retval = 0;
+	output->stream = stream;
+	output->format = format;
+	output->encoding = internal_character_encoding;
+	output->cd = (iconv_t)(-1);
+	output->buffer = NULL;
+	output->size = 0;
+	output->top = 0;
+	output->failed = 0;
+	if (format == tf_text && (output->cd = iconv_open("UTF-8",
+					internal_character_encoding)) ==
+			(iconv_t)(-1)) {
+		perror("traversal_output_open: iconv_open");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	if (stream == NULL) {
+		if ((output->buffer = malloc(traversal_output_memory_size)) ==
+				NULL) {
+			perror("traversal_output_open: malloc");
+			/* resetting the errno */
+			errno = 0;
+			if (output->cd != (iconv_t)(-1)) {
+				iconv_close(output->cd);
+			}
+			return (2);
+		}
+		output->size = traversal_output_memory_size;
+		return (0);
+	}
+	if ((retval = posix_memalign(&buffer,
+					traversal_output_buffer_alignment,
+					traversal_output_buffer_size)) != 0) {
+		fprintf(stderr, "traversal_output_open: posix_memalign: "
+				"%s\n", strerror(retval));
+		if (output->cd != (iconv_t)(-1)) {
+			iconv_close(output->cd);
+		}
+		return (2);
+	}
+	output->buffer = (char *)(buffer);
+	output->size = traversal_output_buffer_size;
+	return (0);
+}
+
+/**
+ * A function which writes all the buffered output to the stream.
+ * If the writing fails, the output is marked as failed
+ * and all the subsequent output is discarded.
+ * If the output is kept in the memory, its buffer is doubled instead.
+ *
+ * @param
+ * output	the traversal output to be flushed
+ *
+ * @return	If the output has been successfully written, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_output_flush (traversal_output *output) {
+	char *buffer = NULL;
+	if (output->stream == NULL) {
+		if (output->failed == 0 && (buffer = realloc(output->buffer,
+						2 * output->size)) == NULL) {
+			perror("traversal_output_flush: realloc");
+			/* resetting the errno */
+			errno = 0;
+			output->failed = 1;
+		}
+		if (output->failed != 0) {
+			output->top = 0;
+		} else {
+			output->buffer = buffer;
+			output->size *= 2;
+		}
+		return (output->failed);
+	}
+	if (output->top > 0 && output->failed == 0 &&
+			fwrite(output->buffer, 1, output->top,
+				output->stream) != output->top) {
+		perror("traversal_output_flush: fwrite");
+		/* resetting the errno */
+		errno = 0;
+		output->failed = 1;
+	}
+	output->top = 0;
+	return (output->failed);
+}
+
+/**
+ * A function which makes sure that the requested number of bytes
+ * fits into the output buffer, flushing it if necessary.
+ * The requested number of bytes must not exceed the buffer size.
+ *
+ * @param
+ * bytes	the number of bytes to be reserved
+ * @param
+ * output	the traversal output
+ *
+ * @return	the pointer to the first reserved byte of the buffer
+ */
+char *traversal_output_reserve (size_t bytes,
+		traversal_output *output) {
+	if (output->top + bytes > output->size) {
+		traversal_output_flush(output);
+	}
+	return (output->buffer + output->top);
+}
+
+/**
+ * A function which appends the null-terminated string to the output.
+ *
+ * @param
+ * string	the string to be appended
+ * @param
+ * output	the traversal output
+ */
+void traversal_output_string (const char *string,
+		traversal_output *output) {
+	for (; *string != '\0'; ++string) {
+		if (output->top == output->size) {
+			traversal_output_flush(output);
+		}
+		output->buffer[output->top++] = *string;
+	}
+}
+
+/**
+ * A function which appends the unsigned decimal number to the output.
+ * It is a faster equivalent of the printf conversion "%0*zu".
+ *
+ * @param
+ * value	the number to be appended
+ * @param
+ * width	the minimum number of digits, the missing ones
+ * 		are filled with leading zeros
+ * @param
+ * output	the traversal output
+ */
+void traversal_output_unsigned (size_t value,
+		size_t width,
+		traversal_output *output) {
+	/* the digits in the reverse order */
+	char digits[24];
+	size_t length = 0;
+	char *target = NULL;
+	do {
+		digits[length++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+	if (width < length) {
+		width = length;
+	}
+	target = traversal_output_reserve(width, output);
+	output->top += width;
+	for (; width > length; --width) {
+		*target++ = '0';
+	}
+	while (length > 0) {
+		*target++ = digits[--length];
+	}
+}
+
+/**
+ * A function which appends the signed decimal number to the output.
+ * It is a faster equivalent of the printf conversion "%0*d",
+ * so the minimum width includes the minus sign.
+ *
+ * @param
+ * value	the number to be appended
+ * @param
+ * width	the minimum width of the number
+ * @param
+ * output	the traversal output
+ */
+void traversal_output_signed (signed_integral_type value,
+		size_t width,
+		traversal_output *output) {
+	if (value < 0) {
+		traversal_output_string("-", output);
+		traversal_output_unsigned((size_t)(-(long long)(value)),
+				width > 0 ? width - 1 : 0, output);
+	} else {
+		traversal_output_unsigned((size_t)(value), width, output);
+	}
+}
+
+/**
+ * A function which converts the text to the UTF-8
+ * and appends it directly to the output buffer.
+ *
+ * @param
+ * text		the text to be converted
+ * @param
+ * length	the number of characters to be converted
+ * @param
+ * output	the traversal output
+ *
+ * @return	If the text has been successfully converted, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_output_text (const character_type *text,
+		size_t length,
+		traversal_output *output) {
+	/*
+	 * The typecast to char* is necessary,
+	 * because the text might be of the type wchar_t*
+	 */
+	char *inbuf = (char *)(text);
+	size_t inbytesleft = length * character_type_size;
+	char *outbuf = traversal_output_reserve(length *
+			traversal_output_max_character_bytes, output);
+	size_t outbytesleft = output->size - output->top;
+	/* the return value of the iconv */
+	size_t retval = 0;
+	retval = iconv(output->cd, &inbuf, &inbytesleft,
+			&outbuf, &outbytesleft);
+	/* if the iconv has encountered an error */
+	if (inbytesleft > 0 || retval != 0) {
+		perror("traversal_output_text: iconv");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	output->top = output->size - outbytesleft;
+	return (0);
+}
+
+/**
+ * A function which appends the unsigned number to the output
+ * as a little-endian base 128 varint.
+ *
+ * @param
+ * value	the number to be appended
+ * @param
+ * output	the traversal output
+ */
+void traversal_output_varint (unsigned long long value,
+		traversal_output *output) {
+	/* a 64-bit number takes at most 10 bytes */
+	char *target = traversal_output_reserve(10, output);
+	while (value > 127) {
+		*target++ = (char)((value & 127) | 128);
+		++output->top;
+		value >>= 7;
+	}
+	*target = (char)(value);
+	++output->top;
+}
+
+/**
+ * A function which appends the unsigned number to the output
+ * as a little-endian number of the fixed width.
+ *
+ * @param
+ * value	the number to be appended
+ * @param
+ * width	the width of the number in bytes (at most 8)
+ * @param
+ * output	the traversal output
+ */
+void traversal_output_fixed (unsigned long long value,
+		size_t width,
+		traversal_output *output) {
+	char *target = traversal_output_reserve(width, output);
+	size_t i = 0;
+	for (i = 0; i < width; ++i) {
+		target[i] = (char)(value & 255);
+		value >>= 8;
+	}
+	output->top += width;
+}
+
+/**
+ * A function which converts the characters of the text starting
+ * at the provided position and appends them to the output.
+ * If the text is a circular window and the characters wrap around
+ * its end, they are converted in two parts.
+ *
+ * @param
+ * text		the text containing the characters
+ * @param
+ * window_size	the size of the circular window (its positions
+ * 		start at 1), or zero if the text does not wrap
+ * @param
+ * offset	the position in the text of the first character
+ * @param
+ * length	the number of characters to be converted
+ * @param
+ * output	the traversal output
+ *
+ * @return	If the characters have been successfully converted,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int traversal_output_window_text (const character_type *text,
+		size_t window_size,
+		size_t offset,
+		size_t length,
+		traversal_output *output) {
+	/* the number of characters before the end of the window */
+	size_t first_part = length;
+	if (window_size > 0) {
+		if (offset > window_size) {
+			offset -= window_size;
+		}
+		if (offset + length - 1 > window_size) {
+			first_part = window_size - offset + 1;
+		}
+	}
+	if (traversal_output_text(text + offset, first_part, output) != 0) {
+		return (1);
+	}
+	if (first_part < length && traversal_output_text(text + 1,
+				length - first_part, output) != 0) {
+		return (2);
+	}
+	return (0);
+}
+
+/**
+ * A function which starts the traversal in the output.
+ * In the text format, it prints the traversal header line.
+ * In the binary format, it writes the header of the traversal chunk,
+ * including the whole text, which the edge labels refer to.
+ * If the writing fails, the output is marked as failed.
+ *
+ * @param
+ * traversal_type	the type of the traversal to be started
+ * @param
+ * log10bn	A ceiling of base 10 logarithm of the number
+ * 		of branching nodes. It will be used for printing alignment.
+ * @param
+ * log10l	A ceiling of base 10 logarithm of the number
+ * 		of leaves. It will be used for printing alignment.
+ * @param
+ * text		the text of the suffix tree, starting at its position 0
+ * @param
+ * text_size	the number of characters of the text, including
+ * 		the one at the position 0
+ * @param
+ * window_size	the size of the circular text window,
+ * 		or zero if the text does not wrap
+ * @param
+ * output	the traversal output
+ *
+ * @return	If the traversal has been successfully started,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int traversal_output_begin (int traversal_type,
+		size_t log10bn,
+		size_t log10l,
+		const character_type *text,
+		size_t text_size,
+		size_t window_size,
+		traversal_output *output) {
+	size_t encoding_length = strlen(output->encoding);
+	if (output->format == tf_text) {
+		if (traversal_type == tt_simple) {
+			traversal_output_string("Simple suffix tree "
+					"traversal BEGIN\n", output);
+		} else {
+			traversal_output_string("Suffix tree "
+					"traversal BEGIN\n", output);
+		}
+		return (0);
+	}
+	traversal_output_flush(output);
+	if (fwrite(tf_traversal_magic, 1, 4, output->stream) != 4 ||
+			fwrite(&tf_version, 1, 1, output->stream) != 1) {
+		perror("traversal_output_begin: fwrite");
+		/* resetting the errno */
+		errno = 0;
+		output->failed = 1;
+		return (1);
+	}
+	traversal_output_varint((unsigned long long)(traversal_type),
+			output);
+	traversal_output_varint(character_type_size, output);
+	traversal_output_varint(encoding_length, output);
+	traversal_output_flush(output);
+	if (fwrite(output->encoding, 1, encoding_length,
+				output->stream) != encoding_length) {
+		perror("traversal_output_begin: fwrite");
+		/* resetting the errno */
+		errno = 0;
+		output->failed = 1;
+		return (2);
+	}
+	traversal_output_varint(log10bn, output);
+	traversal_output_varint(log10l, output);
+	traversal_output_varint(window_size, output);
+	traversal_output_varint(text_size, output);
+	traversal_output_flush(output);
+	if (fwrite(text, character_type_size, text_size,
+				output->stream) != text_size) {
+		perror("traversal_output_begin: fwrite");
+		/* resetting the errno */
+		errno = 0;
+		output->failed = 1;
+		return (3);
+	}
+	return (output->failed);
+}
+
+/**
+ * A function which prints the edge from parent to the child
+ * within a suffix tree to the traversal output. In the text format,
+ * the edge is printed in human readable format, while in the binary
+ * format, its varint-encoded record is written.
+ *
+ * @param
+ * print_terminating_character	If this variable evaluates to true,
+ * 				this function will print the dollar sign ($)
+ * 				instead of the last non-NULL character
+ * 				at the provided edge.
+ * @param
+ * parent	the node where the given edge starts
+ * @param
+ * child	the node where the given edge ends
+ * @param
+ * childs_suffix_link	the suffix link starting from the child
+ * @param
+ * parents_depth	the depth of the parent node
+ * @param
+ * childs_depth		the depth of the child node
+ * @param
+ * log10bn	A ceiling of base 10 logarithm of the number
+ * 		of branching nodes. It will be used for printing alignment.
+ * @param
+ * log10l	A ceiling of base 10 logarithm of the number
+ * 		of leaves. It will be used for printing alignment.
+ * @param
+ * childs_offset	The position in the text of the first letter
+ * 			of the leftmost "branching occurrence" of the string
+ * 			composed of the letters on the path
+ * 			from the root to the child.
+ * @param
+ * text		the text containing the characters of the edge
+ * @param
+ * window_size	the size of the circular text window,
+ * 		or zero if the text does not wrap
+ * @param
+ * output	the traversal output
+ *
+ * @return	If we could successfully print the edge, 0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int traversal_output_edge (int print_terminating_character,
+		signed_integral_type parent,
+		signed_integral_type child,
+		signed_integral_type childs_suffix_link,
+		unsigned_integral_type parents_depth,
+		unsigned_integral_type childs_depth,
+		size_t log10bn,
+		size_t log10l,
+		size_t childs_offset,
+		const character_type *text,
+		size_t window_size,
+		traversal_output *output) {
+	/* the length of the text which forms the parent->child edge label */
+	size_t text_length = childs_depth - parents_depth;
+	if (childs_depth < parents_depth) {
+		fprintf(stderr,	"Error: Something went wrong.\n"
+				"The child (%d) has the depth of %u,\n"
+				"but its parent (%d) has the depth "
+				"of %u,\nwhich should never happen!\n",
+				child, childs_depth, parent, parents_depth);
+		fprintf(stderr,	"The traversal of this branch "
+				"is terminated here.\n");
+		return (1);
+	}
+	if (output->format == tf_binary) {
+		/* the signed values are zigzag encoded */
+		traversal_output_varint(print_terminating_character != 0 ?
+				1 : 0, output);
+		traversal_output_varint(((unsigned long long)(parent) << 1) ^
+				(unsigned long long)(-(parent < 0)), output);
+		traversal_output_varint(((unsigned long long)(child) << 1) ^
+				(unsigned long long)(-(child < 0)), output);
+		traversal_output_varint(
+				((unsigned long long)(childs_suffix_link)
+				 << 1) ^ (unsigned long long)
+				(-(childs_suffix_link < 0)), output);
+		traversal_output_varint(parents_depth, output);
+		traversal_output_varint(text_length, output);
+		traversal_output_varint(childs_offset, output);
+		return (output->failed != 0 ? 5 : 0);
+	}
+	/* at first, we can safely print the parent */
+	if (parent == 0) {
+		traversal_output_string("P(?)[", output);
+	} else {
+		traversal_output_string("P(", output);
+		traversal_output_signed(parent, log10bn, output);
+		traversal_output_string(")[", output);
+	}
+	traversal_output_unsigned(parents_depth, 0, output);
+	traversal_output_string("]--\"", output);
+	/*
+	 * we print the edge label, but we do not want
+	 * the terminating character to be printed from the memory as is,
+	 * so we print the dollar sign ($) instead
+	 */
+	if (text_length < 33) {
+		if (traversal_output_window_text(text, window_size,
+					childs_offset + parents_depth,
+					print_terminating_character == 0 ?
+					text_length : text_length - 1,
+					output) != 0) {
+			fprintf(stderr, "traversal_output_edge: "
+					"Error converting the edge label!\n");
+			return (2);
+		}
+	} else { /* text_length >= 33 */
+		if (traversal_output_window_text(text, window_size,
+					childs_offset + parents_depth,
+					15, output) != 0) {
+			fprintf(stderr, "traversal_output_edge: "
+					"Error converting the edge label "
+					"prefix!\n");
+			return (3);
+		}
+		traversal_output_string("...", output);
+		if (traversal_output_window_text(text, window_size,
+					childs_offset + childs_depth - 15,
+					print_terminating_character == 0 ?
+					15 : 14, output) != 0) {
+			fprintf(stderr, "traversal_output_edge: "
+					"Error converting the edge label "
+					"suffix!\n");
+			return (4);
+		}
+	}
+	if (print_terminating_character != 0) {
+		traversal_output_string("$", output);
+	}
+	traversal_output_string("\"(", output);
+	traversal_output_unsigned(text_length, 0, output);
+	traversal_output_string(")-->", output);
+	/* now we can safely print the child */
+	if (child == 0) {
+		traversal_output_string("C(?)[", output);
+	} else {
+		traversal_output_string("C(", output);
+		if (child > 0) {
+			traversal_output_signed(child, log10bn, output);
+		} else { /* child < 0 => child is a leaf */
+			traversal_output_signed(child, log10l, output);
+		}
+		traversal_output_string(")[", output);
+	}
+	traversal_output_unsigned(childs_depth, 0, output);
+	traversal_output_string("]", output);
+	/* and finally, we can optionally print the suffix link */
+	if (childs_suffix_link != 0) {
+		traversal_output_string("{", output);
+		traversal_output_signed(childs_suffix_link, log10bn, output);
+		traversal_output_string("}", output);
+	}
+	traversal_output_string("\n", output);
+	if (output->failed != 0) {
+		fprintf(stderr, "traversal_output_edge: "
+				"Error writing the output!\n");
+		return (5);
+	}
+	return (0);
+}
+
+/**
+ * A function which ends the traversal in the output.
+ * In the text format, it prints the traversal footer line.
+ * In the binary format, it terminates the traversal chunk.
+ *
+ * @param
+ * traversal_type	the type of the traversal to be ended
+ * @param
+ * output	the traversal output
+ *
+ * @return	If the output has not failed so far, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_output_end (int traversal_type,
+		traversal_output *output) {
+	if (output->format == tf_binary) {
+		traversal_output_varint(2, output);
+	} else if (traversal_type == tt_simple) {
+		traversal_output_string("Simple suffix tree "
+				"traversal END\n", output);
+	} else {
+		traversal_output_string("Suffix tree traversal END\n",
+				output);
+	}
+	return (output->failed);
+}
+
+/**
+ * A function which flushes the traversal output, closes its conversion
+ * descriptor and deallocates its buffer. The stream itself
+ * is left open. The output kept in the memory is just discarded.
+ *
+ * @param
+ * output	the traversal output to be closed
+ *
+ * @return	If the output has been successfully written and closed,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int traversal_output_close (traversal_output *output) {
+	int retval = 0;
+	if (output->stream != NULL && traversal_output_flush(output) != 0) {
+		retval = 1;
+	}
+	if (output->cd != (iconv_t)(-1) && iconv_close(output->cd) == -1) {
+		perror("traversal_output_close: iconv_close");
+		/* resetting the errno */
+		errno = 0;
+		retval = 2;
+	}
+	free(output->buffer);
+	output->buffer = NULL;
+	output->size = 0;
+	return (retval);
+}
+
+/**
+ * A function which appends all the contents of the output
+ * kept in the memory to another traversal output.
+ * The appended output is left unchanged.
+ *
+ * @param
+ * part		the traversal output kept in the memory to be appended
+ * @param
+ * output	the traversal output, to which the part is appended
+ *
+ * @return	If the part has been successfully appended, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_output_append (const traversal_output *part,
+		traversal_output *output) {
+	if (part->failed != 0) {
+		return (1);
+	}
+	if (output->stream == NULL) {
+		while (output->size - output->top < part->top) {
+			if (traversal_output_flush(output) != 0) {
+				return (2);
+			}
+		}
+		memcpy(output->buffer + output->top, part->buffer, part->top);
+		output->top += part->top;
+	} else if (traversal_output_flush(output) != 0) {
+		return (2);
+	} else if (part->top > 0 && fwrite(part->buffer, 1, part->top,
+				output->stream) != part->top) {
+		perror("traversal_output_append: fwrite");
+		/* resetting the errno */
+		errno = 0;
+		output->failed = 1;
+		return (2);
+	}
+	return (0);
+}
+
+/**
+ * A function which prints the note, which is not a part
+ * of any traversal, to the traversal stream. In the text format,
+ * the note is printed as is. In the binary format, it is written
+ * as a note chunk, so that the stream remains readable by the stdr.
+ *
+ * @param
+ * stream	the FILE * type stream to which the note will be written
+ * @param
+ * format	the format of the stream, either tf_text or tf_binary
+ * @param
+ * format_string	the printf-style format string of the note
+ *
+ * @return	If the note has been successfully written, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_output_note (FILE *stream,
+		int format,
+		const char *format_string,
+		...) {
+	va_list ap;
+	char *note = NULL;
+	/* the varint length of the note (at most 10 bytes) */
+	unsigned char length[10];
+	size_t length_bytes = 0;
+	size_t note_length = 0;
+	int retval = 0;
+	va_start(ap, format_string);
+	if (format != tf_binary) {
+		retval = vfprintf(stream, format_string, ap);
+		va_end(ap);
+		return (retval < 0 ? 1 : 0);
+	}
+	retval = vsnprintf(NULL, 0, format_string, ap);
+	va_end(ap);
+	if (retval < 0) {
+		perror("traversal_output_note: vsnprintf");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	note_length = (size_t)(retval);
+	note = malloc(note_length + 1);
+	if (note == NULL) {
+		perror("traversal_output_note: malloc");
+		/* resetting the errno */
+		errno = 0;
+		return (3);
+	}
+	va_start(ap, format_string);
+	vsnprintf(note, note_length + 1, format_string, ap);
+	va_end(ap);
+	retval = (int)(note_length);
+	do {
+		length[length_bytes] = (unsigned char)(retval & 127);
+		retval >>= 7;
+		if (retval > 0) {
+			length[length_bytes] |= 128;
+		}
+		++length_bytes;
+	} while (retval > 0);
+	if (fwrite(tf_note_magic, 1, 4, stream) != 4 ||
+			fwrite(length, 1, length_bytes,
+				stream) != length_bytes ||
+			fwrite(note, 1, note_length,
+				stream) != note_length) {
+		perror("traversal_output_note: fwrite");
+		/* resetting the errno */
+		errno = 0;
+		free(note);
+		return (4);
+	}
+	free(note);
+	return (0);
+}
@@ -34,6 +34,7 @@
 
 #include "suffix_tree_hash_table_common.h"
 #include "primality_test.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -102,8 +103,8 @@ int hs_update (const int verbosity_level,
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->chf_as);
-		hs->chf_as = calloc(hs->chf_number,
+		arena_free(hs->chf_as);
+		hs->chf_as = arena_calloc(hs->chf_number,
 				sizeof (unsigned_integral_type));
 		if (hs->chf_as == NULL) {
 			perror("calloc(hs->chf_as)");
@@ -118,8 +119,8 @@ int hs_update (const int verbosity_level,
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->chf_bs);
-		hs->chf_bs = calloc(hs->chf_number,
+		arena_free(hs->chf_bs);
+		hs->chf_bs = arena_calloc(hs->chf_number,
 				sizeof (unsigned_integral_type));
 		if (hs->chf_bs == NULL) {
 			perror("calloc(hs->chf_bs)");
@@ -134,8 +135,8 @@ int hs_update (const int verbosity_level,
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->cp_offsets);
-		hs->cp_offsets = calloc(hs->chf_number,
+		arena_free(hs->cp_offsets);
+		hs->cp_offsets = arena_calloc(hs->chf_number,
 				sizeof (size_t));
 		if (hs->cp_offsets == NULL) {
 			perror("calloc(hs->cp_offsets)");
@@ -150,8 +151,8 @@ int hs_update (const int verbosity_level,
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->cp_sizes);
-		hs->cp_sizes = calloc(hs->chf_number,
+		arena_free(hs->cp_sizes);
+		hs->cp_sizes = arena_calloc(hs->chf_number,
 				sizeof (size_t));
 		if (hs->cp_sizes == NULL) {
 			perror("calloc(hs->cp_sizes)");
@@ -269,27 +270,27 @@ int hs_deallocate (hash_settings *hs) {
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->chf_as);
+		arena_free(hs->chf_as);
 		hs->chf_as = NULL;
 		/*
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->chf_bs);
+		arena_free(hs->chf_bs);
 		hs->chf_bs = NULL;
 		/*
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->cp_offsets);
+		arena_free(hs->cp_offsets);
 		hs->cp_offsets = NULL;
 		/*
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(hs->cp_sizes);
+		arena_free(hs->cp_sizes);
 		hs->cp_sizes = NULL;
-		free(hs);
+		arena_free(hs);
 		hs = NULL;
 		return (0);
 	}
@@ -33,5 +33,6 @@
 #include "stree_shti.h"
 #include "stree_shti_bp.h"
 #include "stree_slai.h"
+#include "stree_slai_compact.h"
 
 #endif /* SUFFIX_TREE_HEADER */
@@ -29,12 +29,302 @@
 
 #include "suffix_tree_common.h"
 
+#include <limits.h>
+
+/* if we are on the Apple platform (Mac OS X, for example) */
+#ifdef	__APPLE__
+
+#ifndef _POSIX_C_SOURCE
+
+/**
+ * We need to define this macro by hand
+ * to enable the POSIX threads on the Apple platform
+ */
+#define	_POSIX_C_SOURCE 199506L
+
+#endif
+
+#endif
+
+/*
+ * if the the macro _POSIX_C_SOURCE is defined,
+ * either by the compiler or explicitly
+ */
+#ifdef	_POSIX_C_SOURCE
+/*
+ * We need to check if the supported POSIX features
+ * conform at least to the IEEE Std 1003.1c-1995
+ */
+#if	(_POSIX_C_SOURCE - 0) >= 199506L
+
+/* we can use the POSIX threads */
+#define	ST_USE_PTHREAD
+#include <pthread.h>
+
+#endif
+
+#endif
+
 /* constants */
 
 /* the number of extra characters allocated for the text */
 
 extern const size_t extra_allocated_characters;
 
+/* the desired number of the parallel traversal tasks per worker */
+
+extern const size_t traversal_pool_tasks_per_worker;
+
+/* the maximum number of the levels of splitting the traversal tasks */
+
+extern const size_t traversal_pool_max_levels;
+
+/* the number of the tasks per worker, which can be printed in advance */
+
+extern const size_t traversal_pool_window_per_worker;
+
+/* the initial number of the frames allocated by the repeat analysis */
+
+extern const size_t repeat_analysis_initial_size;
+
+/* struct typedefs */
+
+/**
+ * A struct representing a single task of the parallel traversal.
+ * The task prints the edge leading to its child and,
+ * unless the child has been split into the tasks of its own children,
+ * the whole subtree below the child. The tasks are ordered
+ * in the same way as the edges printed by the serial traversal,
+ * so the concatenation of their outputs is identical to its output.
+ */
+typedef struct traversal_task_struct {
+	/**
+	 * The edge printed by this task. The member node holds the parent,
+	 * the member child holds the child, the member depth holds
+	 * the depth of the parent and the member offset holds the offset
+	 * of the child in the array-based representations.
+	 */
+	traversal_frame edge;
+	/**
+	 * if this variable evaluates to true, only the edge is printed,
+	 * because the subtree below it is printed by the subsequent tasks
+	 */
+	int edge_only;
+	/** the output of this task, which is kept in the memory */
+	traversal_output output;
+	/** if this variable evaluates to true, the task has been finished */
+	int done;
+	/** the return value of the task */
+	int retval;
+} traversal_task;
+
+/**
+ * A struct containing the tasks of the parallel traversal
+ * of the suffix tree. The worker threads repeatedly take the next task,
+ * which has not been taken yet, by the atomic increment
+ * and print it into its own output kept in the memory. Meanwhile,
+ * the calling thread appends the outputs of the finished tasks
+ * to the traversal output in the original order of the tasks.
+ * The workers can only get a limited number of tasks ahead
+ * of the appended ones and the outputs of the appended tasks
+ * are reused, so the memory used by the outputs stays bounded.
+ */
+typedef struct traversal_pool_struct {
+	/** the function, which prints a single task to the output */
+	int (*process)(traversal_output *output,
+			const traversal_task *task,
+			traversal_stack *stack,
+			const struct traversal_pool_struct *pool);
+	/**
+	 * The function, which adds the tasks for all the children
+	 * of the child of the provided task to the pool.
+	 * If that child is a leaf, it adds nothing and returns (-1).
+	 */
+	int (*split)(const traversal_task *task,
+			struct traversal_pool_struct *pool);
+	/** the suffix tree to be traversed */
+	const void *stree;
+	/** the actual underlying text of the suffix tree */
+	const character_type *text;
+	/** the actual length of the underlying text in the suffix tree */
+	size_t length;
+	/** the type of the traversal to perform */
+	int traversal_type;
+	/** a ceiling of base 10 logarithm of the number of branching nodes */
+	size_t log10bn;
+	/** a ceiling of base 10 logarithm of the number of leaves */
+	size_t log10l;
+	/** the array of the tasks in the order of the serial traversal */
+	traversal_task *tasks;
+	/** the number of the tasks */
+	size_t count;
+	/** the number of the tasks allocated */
+	size_t size;
+	/** the index of the next task to be taken by a worker */
+	size_t next_task;
+	/**
+	 * if this variable evaluates to true, some task has failed
+	 * and the workers skip all the remaining tasks
+	 */
+	int failed;
+	/** the traversal output, into which the tasks are appended */
+	const traversal_output *output;
+	/** the number of the tasks already appended to the output */
+	size_t appended;
+	/** the number of the tasks, which can be taken in advance */
+	size_t window;
+	/** the outputs of the appended tasks, which can be reused */
+	traversal_output *spares;
+	/** the number of the outputs, which can be reused */
+	size_t spare_count;
+#ifdef	ST_USE_PTHREAD
+	/** the mutex protecting the tasks and the reusable outputs */
+	pthread_mutex_t mx;
+	/** the condition signalled whenever a task is finished */
+	pthread_cond_t cv;
+	/** the condition signalled whenever a task is appended */
+	pthread_cond_t appended_cv;
+#endif
+} traversal_pool;
+
+/**
+ * A struct summarizing a single branching node on the path
+ * from the root to the node currently being visited
+ * by the repeat analysis. It collects the left characters
+ * of the leaves below the node, or the characters preceding
+ * the suffixes of these leaves in the text.
+ */
+typedef struct repeat_frame_struct {
+	/** the string depth of the branching node */
+	unsigned_integral_type depth;
+	/** the position in the text of an occurrence of its string */
+	size_t position;
+	/** the left character shared by all the leaves seen so far */
+	character_type left;
+	/**
+	 * The number of the different left characters seen so far.
+	 * The value of two (2) means that there are at least two of them
+	 * and that the branching node is left-diverse.
+	 */
+	int lefts;
+	/**
+	 * if this variable evaluates to true,
+	 * all the children seen so far are leaves
+	 */
+	int only_leaves;
+} repeat_frame;
+
+/**
+ * A struct representing the state and the results of the repeat analysis
+ * of the suffix tree. The analysis visits the branching nodes bottom-up,
+ * so each of them is summarized only after all of its children.
+ *
+ * Each branching node except for the root is a right-maximal repeat.
+ * It is a maximal repeat, if it is also left-diverse.
+ * It is a supermaximal repeat, if all of its children are leaves
+ * with pairwise different left characters.
+ * A zeroed struct with the text set is ready to be used.
+ */
+typedef struct repeat_analysis_struct {
+	/** the actual underlying text of the suffix tree */
+	const character_type *text;
+	/** the frames of the branching nodes being visited */
+	repeat_frame *frames;
+	/** the number of the frames currently allocated */
+	size_t size;
+	/** the number of the frames currently in use */
+	size_t top;
+	/**
+	 * the left characters of the leaf children of the topmost
+	 * branching node, while all of its children are leaves
+	 */
+	character_type *lefts;
+	/** the number of the left characters currently allocated */
+	size_t lefts_size;
+	/** the number of the left characters currently in use */
+	size_t lefts_top;
+	/** the number of the visited branching nodes, including the root */
+	size_t branching_nodes;
+	/** the number of the visited leaves */
+	size_t leaves;
+	/** the length of the longest repeated substring */
+	unsigned_integral_type longest_depth;
+	/** the position in the text of the longest repeated substring */
+	size_t longest_position;
+	/** the number of the maximal repeats */
+	size_t maximal_repeats;
+	/** the total length of the maximal repeats */
+	size_t maximal_length;
+	/** the number of the supermaximal repeats */
+	size_t supermaximal_repeats;
+	/** the total length of the supermaximal repeats */
+	size_t supermaximal_length;
+	/**
+	 * The histogram of the string depths of the branching nodes
+	 * except for the root. The bucket i contains the depths
+	 * from 2^i up to 2^(i + 1) - 1.
+	 */
+	size_t histogram[sizeof (unsigned_integral_type) * CHAR_BIT];
+} repeat_analysis;
+
+/**
+ * A struct representing the export of the suffix array
+ * and of the LCP array of the suffix tree. Both arrays are streamed
+ * to their files as raw little-endian numbers of the same width,
+ * while the leaves are visited in the lexicographic order.
+ *
+ * The suffix array contains the zero-based starting positions
+ * of all the non-empty suffixes of the text. The terminating
+ * character ($) is considered smaller than any other character,
+ * so a suffix precedes all the suffixes it is a proper prefix of.
+ * The LCP array contains the length of the longest common prefix
+ * of each suffix with the previous one (zero for the first one).
+ */
+typedef struct array_export_struct {
+	/** the output of the suffix array */
+	traversal_output sa;
+	/** the output of the LCP array */
+	traversal_output lcp;
+	/** the width of the exported numbers in bytes, either 4 or 8 */
+	size_t width;
+	/** the actual length of the underlying text in the suffix tree */
+	size_t length;
+	/**
+	 * the length of the longest common prefix of the next suffix
+	 * with the previous one, or the minimum string depth
+	 * of the branching nodes passed since the previous leaf
+	 */
+	unsigned_integral_type pending_lcp;
+	/** the number of the suffixes exported so far */
+	size_t entries;
+} array_export;
+
+/**
+ * A struct summarizing the matching statistics of a query text
+ * against the suffix tree. The matching statistic of a position
+ * in the query is the length of the longest prefix of the suffix
+ * of the query starting there, which occurs in the text of the tree.
+ * A zeroed struct is ready to be used.
+ */
+typedef struct matching_statistics_struct {
+	/** the number of the positions of the query processed */
+	size_t positions;
+	/** the sum of the matching statistics of all the positions */
+	size_t total_length;
+	/** the length of the longest common substring */
+	size_t longest_length;
+	/** the position in the query of the longest common substring */
+	size_t query_position;
+	/** the position in the text of the longest common substring */
+	size_t text_position;
+	/**
+	 * The histogram of the matching statistics. The bucket 0
+	 * contains the zero lengths and the bucket i > 0 contains
+	 * the lengths from 2^(i - 1) up to 2^i - 1.
+	 */
+	size_t histogram[sizeof (size_t) * CHAR_BIT + 1];
+} matching_statistics;
+
 /* reading function */
 
 int text_read (const char *file_name,
@@ -45,7 +335,7 @@ int text_read (const char *file_name,
 
 /* printing functions */
 
-int st_print_edge (FILE *stream,
+int st_print_edge (traversal_output *output,
 		int print_terminating_character,
 		signed_integral_type parent,
 		signed_integral_type child,
@@ -55,7 +345,6 @@ int st_print_edge (FILE *stream,
 		size_t log10bn,
 		size_t log10l,
 		size_t childs_offset,
-		const char *internal_character_encoding,
 		const character_type *text);
 int st_print_single_suffix (FILE *stream,
 		size_t suffix_index,
@@ -76,4 +365,58 @@ int st_print_stats (size_t length,
 		size_t extra_allocated_memory_size,
 		size_t extra_used_memory_size);
 
+/* parallel traversal functions */
+
+int traversal_pool_add (signed_integral_type parent,
+		signed_integral_type child,
+		size_t offset,
+		unsigned_integral_type parents_depth,
+		traversal_pool *pool);
+int traversal_pool_split (size_t desired_tasks,
+		traversal_pool *pool);
+#ifdef	ST_USE_PTHREAD
+void *traversal_pool_worker (void *ptr);
+#endif
+int traversal_pool_run (size_t workers,
+		traversal_output *output,
+		traversal_pool *pool);
+void traversal_pool_free (traversal_pool *pool);
+int traversal_pool_traverse (size_t workers,
+		traversal_output *output,
+		traversal_pool *pool);
+
+/* repeat analysis functions */
+
+int repeat_analysis_enter (unsigned_integral_type depth,
+		size_t position,
+		repeat_analysis *analysis);
+int repeat_analysis_leaf (size_t position,
+		repeat_analysis *analysis);
+int repeat_analysis_compare (const void *a, const void *b);
+int repeat_analysis_leave (repeat_analysis *analysis);
+int repeat_analysis_print (FILE *stream,
+		const repeat_analysis *analysis);
+void repeat_analysis_free (repeat_analysis *analysis);
+
+/* suffix array export functions */
+
+int array_export_open (const char *filename,
+		size_t width,
+		size_t length,
+		array_export *export);
+void array_export_ancestor (unsigned_integral_type depth,
+		array_export *export);
+void array_export_leaf (size_t position,
+		array_export *export);
+int array_export_close (array_export *export);
+
+/* matching statistics functions */
+
+void matching_statistics_add (size_t query_position,
+		size_t length,
+		size_t text_position,
+		matching_statistics *statistics);
+int matching_statistics_print (FILE *stream,
+		const matching_statistics *statistics);
+
 #endif /* SUFFIX_TREE_IN_MEMORY_COMMON_HEADER */
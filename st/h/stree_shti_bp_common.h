@@ -96,11 +96,27 @@ int st_shti_bp_split_edge (signed_integral_type *parent,
 		const character_type *text,
 		suffix_tree_shti_bp *stree);
 
+int st_shti_bp_walk_from (signed_integral_type starting_node,
+		size_t *branching_nodes,
+		size_t *leaves,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti_bp *stree);
+int st_shti_bp_analyse_repeats (repeat_analysis *analysis,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti_bp *stree);
+int st_shti_bp_export_arrays (array_export *export,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti_bp *stree);
+
 /* handling functions */
 
 int st_shti_bp_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_shti_bp *stree);
@@ -100,14 +100,45 @@ int st_shti_split_edge (signed_integral_type *parent,
 		const character_type *text,
 		suffix_tree_shti *stree);
 
+int st_shti_walk_from (signed_integral_type starting_node,
+		size_t *branching_nodes,
+		size_t *leaves,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti *stree);
+int st_shti_analyse_repeats (repeat_analysis *analysis,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti *stree);
+int st_shti_export_arrays (array_export *export,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti *stree);
+int st_shti_matching_statistics (const character_type *query,
+		size_t query_length,
+		matching_statistics *statistics,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_shti *stree);
+int st_shti_traverse_task (traversal_output *output,
+		const traversal_task *task,
+		traversal_stack *stack,
+		const traversal_pool *pool);
+int st_shti_split_task (const traversal_task *task,
+		traversal_pool *pool);
+
 /* handling functions */
 
 int st_shti_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_shti *stree);
+int st_shti_relayout (const character_type *text,
+		suffix_tree_shti *stree);
 int st_shti_delete (suffix_tree_shti *stree);
 
 #endif /* SUFFIX_TREE_SHTI_COMMON_HEADER */
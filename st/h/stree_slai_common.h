@@ -28,6 +28,7 @@
 #define	SUFFIX_TREE_SLAI_COMMON_HEADER
 
 #include "pwotd_cdata.h"
+#include "stree_slai_sink.h"
 
 /* constants */
 
@@ -78,6 +79,18 @@ typedef struct suffix_tree_slai_struct {
 	 * will be increased in case all of its entries are used
 	 */
 	size_t tnode_size_increase;
+	/**
+	 * The number of cells of the table tnode, which have already
+	 * been streamed into the sink and whose memory has been reused.
+	 * The offsets stored in the table tnode always include them,
+	 * so they remain valid in the streamed file.
+	 */
+	size_t tnode_flushed;
+	/**
+	 * The sink, into which the completed partitions are streamed.
+	 * If it is NULL, the whole table tnode is kept in the memory.
+	 */
+	slai_tnode_sink *sink;
 	/**
 	 * the auxiliary data structures used
 	 * for the suffix tree construction
@@ -95,8 +108,39 @@ int st_slai_reallocate (size_t desired_tnode_size,
 
 /* supporting functions */
 
+int st_slai_compute_childrens_lcp (
+		unsigned_integral_type clean_parents_text_idx,
+		size_t first_node_offset,
+		size_t *childrens_lcp_size,
+		const suffix_tree_slai *stree);
+int st_slai_find (const character_type *pattern,
+		size_t pattern_length,
+		size_t *occurrence,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai *stree);
+int st_slai_walk_from (size_t starting_offset,
+		size_t *branching_nodes,
+		size_t *leaves,
+		traversal_stack *stack,
+		const suffix_tree_slai *stree);
+int st_slai_analyse_repeats (repeat_analysis *analysis,
+		traversal_stack *stack,
+		const suffix_tree_slai *stree);
+int st_slai_export_arrays (array_export *export,
+		traversal_stack *stack,
+		const suffix_tree_slai *stree);
 int st_slai_dump_tnode (FILE *stream,
 		const suffix_tree_slai *stree);
+int st_slai_traverse_task (traversal_output *output,
+		const traversal_task *task,
+		traversal_stack *stack,
+		const traversal_pool *pool);
+int st_slai_add_tasks (size_t first_child_offset,
+		unsigned_integral_type parents_depth,
+		traversal_pool *pool);
+int st_slai_split_task (const traversal_task *task,
+		traversal_pool *pool);
 
 /* handling functions */
 
@@ -135,6 +179,8 @@ int st_slai_empty_partitions_stack (const character_type *text,
 int st_slai_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_slai *stree);
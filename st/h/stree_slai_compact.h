@@ -0,0 +1,165 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * SLAI compact encoding declarations.
+ * This file contains the declarations of the functions,
+ * which convert the table tnode of the suffix tree
+ * in the implementation type SLAI into the compact
+ * variable-length encoding and which access the suffix tree
+ * stored in this encoding.
+ */
+#ifndef	SUFFIX_TREE_SLAI_COMPACT_HEADER
+#define	SUFFIX_TREE_SLAI_COMPACT_HEADER
+
+#include "stree_slai_common.h"
+
+/* constants */
+
+/* the maximum number of small nodes on the path to an explicit position */
+
+extern const size_t compact_chain_limit;
+
+/* struct typedefs */
+
+/**
+ * A struct containing the whole suffix tree
+ * in the compact variable-length encoding
+ * of the implementation type SLAI.
+ *
+ * The nodes are stored in the same order as in the table tnode.
+ * Every node starts with a single variable-byte coded value.
+ * Its least significant bit is set for the leaf nodes
+ * and the next bit marks the rightmost child of its parent.
+ *
+ * The leaf node stores nothing more. The rest of its first value
+ * is an index to the text of the beginning of the label
+ * of an edge which ends at this leaf node.
+ *
+ * The branching node has the third bit of its first value set
+ * if it is a large node and the rest of this value is the length
+ * of the label of an edge which ends at this branching node.
+ * The next value is the distance in bytes from the end of this node
+ * to its first child. The large node additionally stores
+ * an index to the text of the beginning of the label of its edge.
+ * The small node does not, because it can be derived
+ * from its first child by subtracting the edge label length.
+ */
+typedef struct suffix_tree_slai_compact_struct {
+	/** the compact linear array of the variable-byte coded nodes */
+	unsigned char *tnode;
+	/** the size of the compact linear array in bytes */
+	size_t tnode_size;
+	/** the number of branching nodes in the suffix tree */
+	size_t branching_nodes;
+	/** the number of small branching nodes */
+	size_t small_nodes;
+	/** the number of large branching nodes */
+	size_t large_nodes;
+} suffix_tree_slai_compact;
+
+/**
+ * A struct containing a single node decoded
+ * from the compact linear array.
+ */
+typedef struct slai_compact_node_struct {
+	/** if this variable evaluates to true, the node is a leaf */
+	int leaf;
+	/**
+	 * if this variable evaluates to true,
+	 * the node is the rightmost child of its parent
+	 */
+	int rightmost;
+	/**
+	 * if this variable evaluates to true,
+	 * the node is a large branching node
+	 */
+	int large;
+	/**
+	 * an index to the text of the beginning of the label of an edge,
+	 * which ends at this node (valid for the leaves and large nodes only)
+	 */
+	size_t text_idx;
+	/** the length of the edge label (valid for the branching nodes only) */
+	size_t edge_length;
+	/**
+	 * the offset in the compact linear array of the first child
+	 * (valid for the branching nodes only)
+	 */
+	size_t first_child;
+} slai_compact_node;
+
+/* supporting functions */
+
+size_t st_slai_compact_put_value (size_t value,
+		unsigned char *buffer);
+int st_slai_compact_decode_node (size_t *offset,
+		slai_compact_node *node,
+		const suffix_tree_slai_compact *ctree);
+size_t st_slai_compact_text_idx (const slai_compact_node *node,
+		const suffix_tree_slai_compact *ctree);
+int st_slai_compact_branch_once (size_t first_child,
+		character_type letter,
+		slai_compact_node *child,
+		size_t *child_text_idx,
+		const character_type *text,
+		const suffix_tree_slai_compact *ctree);
+
+int st_slai_compact_traverse_from (traversal_output *output,
+		size_t starting_offset,
+		unsigned_integral_type parents_depth,
+		size_t log10bn,
+		size_t log10l,
+		const character_type *text,
+		size_t length,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree);
+int st_slai_compact_walk_from (size_t starting_offset,
+		size_t *branching_nodes,
+		size_t *leaves,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree);
+int st_slai_compact_analyse_repeats (repeat_analysis *analysis,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree);
+int st_slai_compact_export_arrays (array_export *export,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree);
+
+/* handling functions */
+
+int st_slai_compact_create (size_t length,
+		const suffix_tree_slai *stree,
+		suffix_tree_slai_compact *ctree);
+int st_slai_compact_find (const character_type *pattern,
+		size_t pattern_length,
+		size_t *occurrence,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai_compact *ctree);
+int st_slai_compact_traverse (FILE *stream,
+		const char *internal_text_encoding,
+		int traversal_format,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai_compact *ctree);
+int st_slai_compact_delete (suffix_tree_slai_compact *ctree);
+
+#endif /* SUFFIX_TREE_SLAI_COMPACT_HEADER */
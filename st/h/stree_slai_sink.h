@@ -0,0 +1,123 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * SLAI tnode sink declarations.
+ * This file contains the declarations of the functions,
+ * which stream the completed parts of the table tnode
+ * into a file while the suffix tree is being constructed
+ * using the PWOTD algorithm and the implementation type SLAI.
+ */
+#ifndef	SUFFIX_TREE_SLAI_SINK_HEADER
+#define	SUFFIX_TREE_SLAI_SINK_HEADER
+
+#include "stree_common.h"
+
+/* constants */
+
+/* the minimum number of cells handed over to the writing thread at once */
+
+extern const size_t sink_flush_threshold;
+
+/* struct typedefs */
+
+/**
+ * A struct containing the sink, into which the completed parts
+ * of the table tnode are streamed during the PWOTD algorithm.
+ *
+ * The sink is double-buffered. The main thread fills
+ * the first buffer with the completed partition subtrees,
+ * while the writing thread writes the second buffer into the file.
+ * When the first buffer is full enough, the buffers are swapped.
+ */
+typedef struct slai_tnode_sink_struct {
+	/** the buffer currently being filled by the main thread */
+	unsigned_integral_type *fill_buffer;
+	/** the buffer currently being written by the writing thread */
+	unsigned_integral_type *flush_buffer;
+	/** the number of cells allocated for the fill buffer */
+	size_t fill_buffer_size;
+	/** the number of cells allocated for the flush buffer */
+	size_t flush_buffer_size;
+	/** the number of occupied cells in the fill buffer */
+	size_t fill_top;
+	/** the number of occupied cells in the flush buffer */
+	size_t flush_top;
+	/**
+	 * the offset in the table tnode (and in the file)
+	 * of the first cell in the fill buffer
+	 */
+	size_t fill_position;
+	/**
+	 * the offset in the table tnode (and in the file)
+	 * of the first cell in the flush buffer
+	 */
+	size_t flush_position;
+	/** the total number of bytes written into the file so far */
+	size_t bytes_written;
+	/** the number of times the buffers have been swapped */
+	size_t flushes;
+	/**
+	 * the number of cells in the table tnode,
+	 * which have been mapped back into the memory
+	 */
+	size_t mapped_cells;
+	/** the memory mapping of the file (if requested) */
+	unsigned_integral_type *mapping;
+	/**
+	 * if this variable evaluates to true, it means that
+	 * the flush buffer is waiting to be written
+	 */
+	int flush_pending;
+	/**
+	 * if this variable evaluates to true, it means that
+	 * there will be no more data for the writing thread
+	 */
+	int finished;
+	/** the first error encountered by the writing thread */
+	int error;
+	/** the read-write file descriptor associated with the output file */
+	int fd;
+	/** the name of the output file */
+	const char *file_name;
+#ifdef	ST_USE_PTHREAD
+	/** the mutex */
+	pthread_mutex_t mx;
+	/** the condition variable */
+	pthread_cond_t cv;
+	/** the writing thread */
+	pthread_t writer;
+#endif
+} slai_tnode_sink;
+
+/* handling functions */
+
+int st_slai_sink_open (const char *file_name,
+		slai_tnode_sink *sink);
+int st_slai_sink_write (const unsigned_integral_type *cells,
+		size_t count,
+		size_t position,
+		slai_tnode_sink *sink);
+int st_slai_sink_finish (slai_tnode_sink *sink);
+int st_slai_sink_map (size_t cells,
+		slai_tnode_sink *sink);
+int st_slai_sink_close (slai_tnode_sink *sink);
+
+#endif /* SUFFIX_TREE_SLAI_SINK_HEADER */
@@ -158,11 +158,24 @@ int st_slli_bp_split_edge (signed_integral_type *parent,
 		unsigned_integral_type new_head_position,
 		suffix_tree_slli_bp *stree);
 
+int st_slli_bp_walk_from (signed_integral_type starting_node,
+		size_t *branching_nodes,
+		size_t *leaves,
+		traversal_stack *stack,
+		const suffix_tree_slli_bp *stree);
+int st_slli_bp_analyse_repeats (repeat_analysis *analysis,
+		traversal_stack *stack,
+		const suffix_tree_slli_bp *stree);
+int st_slli_bp_export_arrays (array_export *export,
+		traversal_stack *stack,
+		const suffix_tree_slli_bp *stree);
+
 /* handling functions */
 
 int st_slli_bp_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_slli_bp *stree);
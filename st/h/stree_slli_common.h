@@ -158,14 +158,42 @@ int st_slli_split_edge (signed_integral_type *parent,
 		unsigned_integral_type new_head_position,
 		suffix_tree_slli *stree);
 
+int st_slli_walk_from (signed_integral_type starting_node,
+		size_t *branching_nodes,
+		size_t *leaves,
+		traversal_stack *stack,
+		const suffix_tree_slli *stree);
+int st_slli_analyse_repeats (repeat_analysis *analysis,
+		traversal_stack *stack,
+		const suffix_tree_slli *stree);
+int st_slli_export_arrays (array_export *export,
+		traversal_stack *stack,
+		const suffix_tree_slli *stree);
+int st_slli_matching_statistics (const character_type *query,
+		size_t query_length,
+		matching_statistics *statistics,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slli *stree);
+int st_slli_traverse_task (traversal_output *output,
+		const traversal_task *task,
+		traversal_stack *stack,
+		const traversal_pool *pool);
+int st_slli_split_task (const traversal_task *task,
+		traversal_pool *pool);
+
 /* handling functions */
 
 int st_slli_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_slli *stree);
+int st_slli_relayout (size_t length,
+		suffix_tree_slli *stree);
 int st_slli_delete (suffix_tree_slli *stree);
 
 #endif /* SUFFIX_TREE_SLLI_COMMON_HEADER */
@@ -24,28 +24,55 @@
  * which create and maintain the suffix tree in the memory.
  */
 
+/*
+ * This file needs to be included in advance of the other include files
+ * as well as before any changes to the feature test macros are made,
+ * because some of the files it includes might rely on the initial values
+ * of the feature test macros.
+ */
+#include "stree.h"
+#include "phase_profile.h"
+#include "arena.h"
+
 /* feature test macros */
 
+#ifndef _BSD_SOURCE
+
 /** This macro is necessary for the function srandom. */
 #define	_BSD_SOURCE
 
+#endif
+
+/* if this macro is either undefined or its value is too small */
+#if (_POSIX_C_SOURCE - 0) < 2
+
+#undef _POSIX_C_SOURCE
+
 /**
  * This macro is necessary for the function getopt
  * and variables optarg and optind.
  */
 #define	_POSIX_C_SOURCE 2
 
+#endif
+
 #ifdef	__APPLE__
+
+#ifndef _DARWIN_C_SOURCE
+
 /**
  * This macro is necessary for the ru_maxrss member
  * of the struct getrusage under Mac OS
  */
 #define	_DARWIN_C_SOURCE
+
 #endif
 
-#include "stree.h"
+#endif
 
 #include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -141,6 +168,31 @@
  * The available benchmarks are:
  * \li	@c C	create and delete the suffix tree
  * \li	@c T	create, traverse and delete the suffix tree
+ * \li	@c L	create the suffix tree, measure the substring lookups
+ * 		and the walk through the whole suffix tree
+ * 		before and after renumbering its branching nodes
+ * 		in the breadth-first order and delete it
+ * 		(SL and SH implementation types only).
+ * 		With the LA implementation type and the @c -z option,
+ * 		the lookups and the walk in the table tnode are compared
+ * 		to the ones in its compact encoding instead
+ * 		and the found occurrences are checked to agree.
+ * \li	@c W	create the suffix tree, walk through it repeatedly
+ * 		without printing anything, report the number
+ * 		of the nodes visited per second and delete it
+ * \li	@c R	create the suffix tree, analyse its repeats
+ * 		in a single bottom-up pass without printing
+ * 		the traversal log, report the longest repeated substring,
+ * 		the maximal and supermaximal repeats and the histogram
+ * 		of the string depths of the branching nodes and delete it
+ * \li	@c X	create the suffix tree, export its suffix array
+ * 		and LCP array and delete it
+ * \li	@c S	create the suffix tree, compute the matching statistics
+ * 		of the query text from the file specified by the @c -q
+ * 		option against it, report the longest common substring
+ * 		and the histogram of the match lengths and delete it
+ * 		(SL and SH implementation types, M and U algorithms
+ * 		and the default variation only)
  *
  * Additional available options are:
  *
@@ -164,6 +216,27 @@
  * 		the log from the traversal of the suffix tree
  * 		will be printed to the file @c 'dump_filename'
  * 		instead of the standard output.
+ * 		If the export benchmark is selected, the suffix array
+ * 		and the LCP array will be written to the files
+ * 		<tt>'dump_filename'.sa</tt> and
+ * 		<tt>'dump_filename'.lcp</tt> as raw little-endian
+ * 		numbers. The suffix array contains the zero-based
+ * 		starting positions of the suffixes. A suffix precedes
+ * 		all the suffixes it is a proper prefix of.
+ * \li	<tt>-n &lt;bits&gt;</tt>
+ * 		Specifies the width of the numbers exported
+ * 		by the export benchmark, either @c 32 or @c 64.
+ * 		By default, 32 bits are used if they are sufficient.
+ * \li	<tt>-q &lt;query_filename&gt;</tt>
+ * 		Specifies the file containing the query text
+ * 		for the matching statistics benchmark. It is read
+ * 		using the same character encodings as @c 'filename'.
+ * \li	<tt>-o &lt;format&gt;</tt>
+ * 		Specifies the format of the traversal log.
+ * 		The default value is @c text. The value @c bin selects
+ * 		the compact binary format, which requires the @c -d
+ * 		option and which can be converted back
+ * 		to the text format by the @c stdr.
  * \li	<tt>-e &lt;file_encoding&gt;</tt>
  * 		Specifies the character encoding of the input file
  * 		@c 'filename'. The default value is @c UTF-8.
@@ -171,6 +244,96 @@
  * \li	<tt>-i &lt;internal_encoding&gt;</tt>
  * 		Specifies the internal text tencoding to use. The default
  * 		value depends on the size of the @ref character_type.
+ * \li	<tt>-w &lt;tnode_filename&gt;</tt>
+ * 		Forces the PWOTD algorithm to stream the completed
+ * 		partitions of the table tnode into the file
+ * 		@c 'tnode_filename' while the suffix tree is being
+ * 		constructed. The peak memory used by the table tnode
+ * 		is then proportional to the largest partition.
+ * \li	@c -l	Renumbers the branching nodes in the breadth-first order
+ * 		after the construction to improve the memory locality
+ * 		of the subsequent traversal. It can only be used
+ * 		with the SL and SH implementation types.
+ * \li	<tt>-z</tt>
+ * 		Converts the table tnode into the compact variable-length
+ * 		encoding after the construction and performs the traversal
+ * 		(if requested) using this encoding. It can only be used
+ * 		with the LA implementation type and the simple traversal.
+ * \li	@c -H	Records the hardware performance counters (the cycles,
+ * 		the instructions, the L1 data cache, last level cache
+ * 		and data TLB read misses and the branch misses)
+ * 		separately for the reading of the text, the construction,
+ * 		the benchmark itself (for example, the traversal)
+ * 		and the deletion of the suffix tree and prints them
+ * 		in a table. It requires the perf_event_open system call
+ * 		of Linux. The counters, which are not available,
+ * 		are reported as @c n/a.
+ * \li	<tt>-I &lt;interval&gt;</tt>
+ * 		Samples the resident set size every @c interval
+ * 		milliseconds by a separate thread. The wall-clock time
+ * 		and the peak resident set size of each phase
+ * 		are always reported, but by default, the resident set size
+ * 		is only read between the phases.
+ * \li	<tt>-J &lt;profile_filename&gt;</tt>
+ * 		Writes the wall-clock time, the memory usage
+ * 		and the hardware performance counters (if requested)
+ * 		of each phase and the samples of the resident set size
+ * 		to the file @c 'profile_filename' as a JSON object.
+ * \li	<tt>-j &lt;workers&gt;</tt>
+ * 		Traverses the subtrees of the root (or of the deeper nodes,
+ * 		for a better balance) by the specified number
+ * 		of the worker threads in parallel. Their outputs
+ * 		are merged in the original order, so the traversal log
+ * 		is the same as the one of the serial traversal.
+ * 		It can only be used with the traverse benchmark,
+ * 		the default algorithm variation and without the @c -z.
+ * \li	<tt>-N &lt;runs&gt;</tt>
+ * 		Reads the text once and repeats the construction,
+ * 		the benchmark itself and the deletion of the suffix tree
+ * 		@c runs times in the same process. Besides the phases
+ * 		of each run, the minimum, the median, the 95th percentile
+ * 		and the maximum of the wall-clock time of each phase
+ * 		over all the runs are reported. It can not be used
+ * 		together with the @c -d option.
+ * \li	<tt>-U &lt;runs&gt;</tt>
+ * 		Precedes the measured runs by @c runs warm-up runs,
+ * 		which are not recorded in the phase profile.
+ * \li	<tt>-A &lt;cpu&gt;</tt>
+ * 		Pins this process, including the threads it creates,
+ * 		to the processor number @c cpu to avoid the migrations
+ * 		between the processors. It requires the sched_setaffinity
+ * 		system call of Linux.
+ * \li	<tt>-S &lt;seed&gt;</tt>
+ * 		Seeds the random number generator by @c seed before
+ * 		each run instead of seeding it by the current time once,
+ * 		so that the Cuckoo hash functions and the random queries
+ * 		of the benchmarks are the same in all the runs
+ * 		and in all the invocations.
+ * \li	<tt>-x &lt;allocator&gt;</tt>
+ * 		Selects the allocator of the tables of the suffix tree
+ * 		and of the PWOTD construction data. The @c malloc
+ * 		(default) allocates them by the standard library.
+ * 		The @c arena allocates them from a large range
+ * 		of the reserved virtual memory, grows them by remapping
+ * 		their pages and tears all of them down at once
+ * 		after each run. The statistics of the allocations
+ * 		are reported at the end.
+ * \li	<tt>-M &lt;bytes&gt;</tt>
+ * 		Chooses the configuration of the suffix tree
+ * 		automatically, so that it fits into the memory budget
+ * 		of @c bytes (with an optional @c K, @c M or @c G suffix).
+ * 		The @c -t and @c -a parameters are then optional.
+ * 		Each configuration allowed by the specified parameters
+ * 		(the implementation types, the algorithms
+ * 		and their variations, the collision resolution
+ * 		techniques, the numbers of the Cuckoo hash functions
+ * 		and the PWOTD prefix lengths) is constructed
+ * 		for a prefix of the text and its peak memory usage
+ * 		is extrapolated to the whole text from the peak total
+ * 		size of its tables. The fastest configuration
+ * 		on the prefix, which fits into the memory budget,
+ * 		is used. If none of them fits, the program exits
+ * 		before the construction.
  */
 
 /* helping function */
@@ -227,7 +390,20 @@ int print_help (const char *argv0) {
 	 */
 	printf("Available benchmarks are:\n"
 		"C\tcreate and delete the suffix tree\n"
-		"T\tcreate, traverse and delete the suffix tree\n\n"
+		"T\tcreate, traverse and delete the suffix tree\n"
+		"L\tcreate the suffix tree, compare the lookups\n"
+		"\tand the walk before and after the breadth-first\n"
+		"\trenumbering of its branching nodes and delete it\n"
+		"\t(with -z, before and after the compact encoding)\n"
+		"W\tcreate the suffix tree, walk through it repeatedly,\n"
+		"\treport the nodes visited per second and delete it\n"
+		"R\tcreate the suffix tree, report a summary\n"
+		"\tof its repeats and delete it\n"
+		"X\tcreate the suffix tree, export its suffix array\n"
+		"\tand LCP array and delete it\n"
+		"S\tcreate the suffix tree, compute the matching\n"
+		"\tstatistics of the query text against it\n"
+		"\tand delete it\n\n"
 		"Additional options:\n"
 		"-p <number>\t\tForces the PWOTD algorithm to use\n"
 		"\t\t\tthe specified <number> of prefix characters\n"
@@ -247,6 +423,13 @@ int print_help (const char *argv0) {
 		"\t\t\tthe log from the traversal of the suffix tree\n"
 		"\t\t\twill be printed to the file 'dump_filename'\n"
 		"\t\t\tinstead of to the standard output.\n"
+		"\t\t\tThe export benchmark writes the files\n"
+		"\t\t\t'dump_filename'.sa and 'dump_filename'.lcp.\n"
+		"-o <format>\t\tSpecifies the format of the traversal log.\n"
+		"\t\t\tThe default value is text. The value bin selects\n"
+		"\t\t\tthe compact binary format, which requires\n"
+		"\t\t\tthe -d parameter and which can be converted\n"
+		"\t\t\tback to the text format by the stdr.\n"
 		"-e <file_encoding>\tSpecifies the character encoding\n"
 		"\t\t\tof the input file 'filename'. The default value\n"
 		"\t\t\tis UTF-8. The valid encodings are all those\n"
@@ -254,6 +437,46 @@ int print_help (const char *argv0) {
 		"-i <internal_encoding>\tSpecifies the internal text "
 		"encoding to use.\n\t\t\tThe default value depends "
 		"on the size of the\n\t\t\t\"character_type\".\n");
+	printf("-w <tnode_filename>\tForces the PWOTD algorithm to stream\n"
+		"\t\t\tthe completed partitions of the table tnode\n"
+		"\t\t\tinto the file 'tnode_filename' to keep\n"
+		"\t\t\tthe memory usage bounded.\n");
+	printf("-l\t\t\tRenumbers the branching nodes\n"
+		"\t\t\tin the breadth-first order after the construction.\n");
+	printf("-z\t\t\tConverts the table tnode into the compact\n"
+		"\t\t\tencoding and traverses it instead.\n");
+	printf("-n <bits>\t\tSpecifies the width of the exported numbers,\n"
+		"\t\t\teither 32 or 64.\n");
+	printf("-q <query_filename>\tSpecifies the query text\n"
+		"\t\t\tfor the matching statistics benchmark.\n");
+	printf("-H\t\t\tRecords the hardware performance counters\n"
+		"\t\t\tfor each phase of the benchmark.\n");
+	printf("-I <interval>\t\tSamples the resident set size every\n"
+		"\t\t\t<interval> milliseconds.\n"
+		"-J <profile_filename>\tWrites the time and the memory usage\n"
+		"\t\t\tof each phase to the file 'profile_filename'\n"
+		"\t\t\tas a JSON object.\n");
+	printf("-j <workers>\t\tTraverses the subtrees of the suffix tree\n"
+		"\t\t\tby the specified number of the threads\n"
+		"\t\t\tin parallel. The traversal log stays the same.\n");
+	printf("-N <runs>\t\tRepeats the construction, the benchmark\n"
+		"\t\t\tand the deletion <runs> times over the text\n"
+		"\t\t\tread once and reports the minimum, median,\n"
+		"\t\t\t95th percentile and maximum time per phase.\n"
+		"-U <runs>\t\tPrecedes the measured runs by <runs>\n"
+		"\t\t\twarm-up runs, which are not recorded.\n"
+		"-A <cpu>\t\tPins the process to the processor <cpu>.\n"
+		"-S <seed>\t\tSeeds the random number generator\n"
+		"\t\t\tby <seed> before each run, so that the choice\n"
+		"\t\t\tof the Cuckoo hash functions is reproducible.\n");
+	printf("-x <allocator>\t\tAllocates the tables by the 'malloc'\n"
+		"\t\t\t(default) or from an 'arena' of the reserved\n"
+		"\t\t\tvirtual memory, torn down after each run.\n");
+	printf("-M <bytes>\t\tChooses the fastest configuration,\n"
+		"\t\t\twhose estimated peak memory usage fits\n"
+		"\t\t\tinto <bytes> (with an optional K, M or G\n"
+		"\t\t\tsuffix). The -t and -a become optional\n"
+		"\t\t\tand restrict the considered configurations.\n");
 	return (0);
 }
 
@@ -273,8 +496,715 @@ int print_usage (const char *argv0) {
 	return (0);
 }
 
+/**
+ * A function, which parses the size in bytes with an optional
+ * binary unit suffix (K, M or G).
+ *
+ * @param
+ * argument	the argument to parse
+ * @param
+ * size		the place where the parsed size will be stored
+ *
+ * @return	If the argument has been successfully parsed,
+ * 		zero (0) is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int parse_size_with_unit (const char *argument, size_t *size) {
+	char *endptr = NULL;
+	unsigned long long parsed = 0;
+	unsigned long long unit = 1;
+	if ((argument[0] < '0') || (argument[0] > '9')) {
+		return (1);
+	}
+	parsed = strtoull(argument, &endptr, 0);
+	if (errno != 0) {
+		perror("strtoull(size)");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	if ((endptr[0] == 'K') || (endptr[0] == 'k')) {
+		unit = 1024ULL;
+	} else if (endptr[0] == 'M') {
+		unit = 1048576ULL;
+	} else if (endptr[0] == 'G') {
+		unit = 1073741824ULL;
+	} else if (endptr[0] != '\0') {
+		return (1);
+	}
+	if ((unit > 1) && (endptr[1] != '\0')) {
+		return (1);
+	}
+	if (parsed > (unsigned long long)(SIZE_MAX) / unit) {
+		return (3);
+	}
+	(*size) = (size_t)(parsed * unit);
+	return (0);
+}
+
 /* benchmarking functions */
 
+/**
+ * The number of substrings of the text,
+ * which are looked up by the layout benchmark.
+ */
+const size_t layout_queries = 1048576; /* 2^20 */
+
+/**
+ * The maximum length of a substring of the text,
+ * which is looked up by the layout benchmark.
+ */
+const size_t layout_query_length = 64;
+
+/**
+ * The minimum processor time in milliseconds, for which the walk benchmark
+ * keeps walking through the whole suffix tree over and over again.
+ */
+const size_t walk_minimum_time = 1000;
+
+/**
+ * A function, which returns the processor time used so far.
+ *
+ * @return	This function returns the processor time used by this program
+ * 		so far in milliseconds.
+ */
+size_t cpu_time_ms (void) {
+	return ((size_t)((double)(clock()) * 1000.0 /
+				(double)(CLOCKS_PER_SEC)));
+}
+
+/**
+ * A function, which chooses the random substrings of the text
+ * to be looked up by the layout benchmark.
+ * Each substring is given by the position in the text
+ * of its beginning and by its length.
+ *
+ * @param
+ * positions	the positions in the text of the chosen substrings
+ * 		will be stored here
+ * @param
+ * depths	the lengths of the chosen substrings will be stored here
+ * @param
+ * length	the final length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ *
+ * @return	This function always returns zero (0).
+ */
+int layout_choose_queries (size_t *positions,
+		unsigned_integral_type *depths,
+		size_t length) {
+	size_t maximum_depth = 0;
+	size_t i = 0;
+	for (i = 0; i < layout_queries; ++i) {
+		positions[i] = (size_t)(random()) % length + 1;
+		maximum_depth = length + 1 - positions[i];
+		if (maximum_depth > layout_query_length) {
+			maximum_depth = layout_query_length;
+		}
+		depths[i] = (unsigned_integral_type)
+			((size_t)(random()) % maximum_depth + 1);
+	}
+	return (0);
+}
+
+/**
+ * A function, which measures the time of the substring lookups
+ * and of the walk through the whole SLLI suffix tree.
+ *
+ * @param
+ * label	the label of this measurement, which will be printed
+ * @param
+ * positions	the positions in the text of the substrings to look up
+ * @param
+ * depths	the lengths of the substrings to look up
+ * @param
+ * length	the final length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stree	the actual suffix tree
+ *
+ * @return	This function always returns zero (0).
+ */
+int layout_measure_slli (const char *label,
+		const size_t *positions,
+		const unsigned_integral_type *depths,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slli *stree) {
+	/* the explicit stack of the walk */
+	traversal_stack stack = {NULL, 0, 0};
+	signed_integral_type parent = 0;
+	size_t position = 0;
+	size_t found = 0;
+	size_t branching_nodes = 0;
+	size_t leaves = 0;
+	size_t start_time = 0;
+	size_t query_time = 0;
+	size_t walk_time = 0;
+	size_t i = 0;
+	start_time = cpu_time_ms();
+	for (i = 0; i < layout_queries; ++i) {
+		position = positions[i];
+		if (st_slli_go_down(1, &parent, depths[i], &position,
+					text, length + 1, stree) <= 0) {
+			++found;
+		}
+	}
+	query_time = cpu_time_ms() - start_time;
+	start_time = cpu_time_ms();
+	st_slli_walk_from(1, &branching_nodes, &leaves, &stack, stree);
+	walk_time = cpu_time_ms() - start_time;
+	traversal_stack_free(&stack);
+	printf("%s:\n%zu of %zu substrings found in ", label,
+			found, layout_queries);
+	print_human_readable_time(stdout, query_time);
+	printf("\n%zu leaves walked through in ", leaves);
+	print_human_readable_time(stdout, walk_time);
+	printf("\n\n");
+	return (0);
+}
+
+/**
+ * A function, which measures the time of the substring lookups
+ * and of the walk through the whole SHTI suffix tree.
+ *
+ * @param
+ * label	the label of this measurement, which will be printed
+ * @param
+ * positions	the positions in the text of the substrings to look up
+ * @param
+ * depths	the lengths of the substrings to look up
+ * @param
+ * length	the final length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stree	the actual suffix tree
+ *
+ * @return	This function always returns zero (0).
+ */
+int layout_measure_shti (const char *label,
+		const size_t *positions,
+		const unsigned_integral_type *depths,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_shti *stree) {
+	/* the explicit stack of the walk */
+	traversal_stack stack = {NULL, 0, 0};
+	signed_integral_type parent = 0;
+	size_t position = 0;
+	size_t found = 0;
+	size_t branching_nodes = 0;
+	size_t leaves = 0;
+	size_t start_time = 0;
+	size_t query_time = 0;
+	size_t walk_time = 0;
+	size_t i = 0;
+	start_time = cpu_time_ms();
+	for (i = 0; i < layout_queries; ++i) {
+		position = positions[i];
+		if (st_shti_go_down(1, &parent, depths[i], &position,
+					text, length + 1, stree) <= 0) {
+			++found;
+		}
+	}
+	query_time = cpu_time_ms() - start_time;
+	start_time = cpu_time_ms();
+	st_shti_walk_from(1, &branching_nodes, &leaves, text,
+			&stack, stree);
+	walk_time = cpu_time_ms() - start_time;
+	traversal_stack_free(&stack);
+	printf("%s:\n%zu of %zu substrings found in ", label,
+			found, layout_queries);
+	print_human_readable_time(stdout, query_time);
+	printf("\n%zu leaves walked through in ", leaves);
+	print_human_readable_time(stdout, walk_time);
+	printf("\n\n");
+	return (0);
+}
+
+/**
+ * A function, which measures the time of the substring lookups
+ * and of the walk through the whole SLAI suffix tree.
+ *
+ * @param
+ * label	the label of this measurement, which will be printed
+ * @param
+ * positions	the positions in the text of the substrings to look up
+ * @param
+ * depths	the lengths of the substrings to look up
+ * @param
+ * occurrences	the positions in the text of the found occurrences
+ * 		of the substrings, or zero (0) for those not found,
+ * 		will be stored here
+ * @param
+ * length	the final length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stree	the actual suffix tree
+ *
+ * @return	This function always returns zero (0).
+ */
+int layout_measure_slai (const char *label,
+		const size_t *positions,
+		const unsigned_integral_type *depths,
+		size_t *occurrences,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai *stree) {
+	/* the explicit stack of the walk */
+	traversal_stack stack = {NULL, 0, 0};
+	size_t found = 0;
+	size_t branching_nodes = 0;
+	size_t leaves = 0;
+	size_t start_time = 0;
+	size_t query_time = 0;
+	size_t walk_time = 0;
+	size_t i = 0;
+	start_time = cpu_time_ms();
+	for (i = 0; i < layout_queries; ++i) {
+		occurrences[i] = 0;
+		if (st_slai_find(text + positions[i], (size_t)(depths[i]),
+					&occurrences[i], text, length,
+					stree) > 0) {
+			++found;
+		}
+	}
+	query_time = cpu_time_ms() - start_time;
+	start_time = cpu_time_ms();
+	st_slai_walk_from(0, &branching_nodes, &leaves, &stack, stree);
+	walk_time = cpu_time_ms() - start_time;
+	traversal_stack_free(&stack);
+	printf("%s:\n%zu of %zu substrings found in ", label,
+			found, layout_queries);
+	print_human_readable_time(stdout, query_time);
+	printf("\n%zu leaves walked through in ", leaves);
+	print_human_readable_time(stdout, walk_time);
+	printf("\n\n");
+	return (0);
+}
+
+/**
+ * A function, which measures the time of the substring lookups
+ * and of the walk through the whole SLAI suffix tree
+ * in the compact encoding.
+ *
+ * @param
+ * label	the label of this measurement, which will be printed
+ * @param
+ * positions	the positions in the text of the substrings to look up
+ * @param
+ * depths	the lengths of the substrings to look up
+ * @param
+ * occurrences	the positions in the text of the found occurrences
+ * 		of the substrings, or zero (0) for those not found,
+ * 		will be stored here
+ * @param
+ * length	the final length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	This function always returns zero (0).
+ */
+int layout_measure_slai_compact (const char *label,
+		const size_t *positions,
+		const unsigned_integral_type *depths,
+		size_t *occurrences,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai_compact *ctree) {
+	/* the explicit stack of the walk */
+	traversal_stack stack = {NULL, 0, 0};
+	size_t found = 0;
+	size_t branching_nodes = 0;
+	size_t leaves = 0;
+	size_t start_time = 0;
+	size_t query_time = 0;
+	size_t walk_time = 0;
+	size_t i = 0;
+	start_time = cpu_time_ms();
+	for (i = 0; i < layout_queries; ++i) {
+		occurrences[i] = 0;
+		if (st_slai_compact_find(text + positions[i],
+					(size_t)(depths[i]), &occurrences[i],
+					text, length, ctree) > 0) {
+			++found;
+		}
+	}
+	query_time = cpu_time_ms() - start_time;
+	start_time = cpu_time_ms();
+	st_slai_compact_walk_from(0, &branching_nodes, &leaves,
+			&stack, ctree);
+	walk_time = cpu_time_ms() - start_time;
+	traversal_stack_free(&stack);
+	printf("%s:\n%zu of %zu substrings found in ", label,
+			found, layout_queries);
+	print_human_readable_time(stdout, query_time);
+	printf("\n%zu leaves walked through in ", leaves);
+	print_human_readable_time(stdout, walk_time);
+	printf("\n\n");
+	return (0);
+}
+
+/**
+ * A function, which checks the results of the substring lookups
+ * in the SLAI suffix tree in the compact encoding against the results
+ * of the same lookups in the table tnode. Each of the looked up
+ * substrings occurs in the text, so both of them need to find it
+ * and each reported occurrence needs to match it. The occurrences
+ * themselves might differ, because the compact encoding derives
+ * the text indices of the small branching nodes from their first children.
+ *
+ * @param
+ * positions	the positions in the text of the looked up substrings
+ * @param
+ * depths	the lengths of the looked up substrings
+ * @param
+ * occurrences	the occurrences found in the table tnode
+ * @param
+ * compact_occurrences	the occurrences found in the compact encoding
+ * @param
+ * text		the actual underlying text of the suffix tree
+ *
+ * @return	This function returns the number of the lookups,
+ * 		whose results are not correct.
+ */
+size_t layout_compare_slai (const size_t *positions,
+		const unsigned_integral_type *depths,
+		const size_t *occurrences,
+		const size_t *compact_occurrences,
+		const character_type *text) {
+	size_t mismatches = 0;
+	size_t i = 0;
+	for (i = 0; i < layout_queries; ++i) {
+		if ((occurrences[i] == 0) || (compact_occurrences[i] == 0) ||
+				(memcmp(text + occurrences[i],
+					text + positions[i],
+					(size_t)(depths[i]) *
+					sizeof (character_type)) != 0) ||
+				(memcmp(text + compact_occurrences[i],
+					text + positions[i],
+					(size_t)(depths[i]) *
+					sizeof (character_type)) != 0)) {
+			++mismatches;
+		}
+	}
+	printf("%zu of %zu lookups in the compact encoding "
+			"agree with the table tnode\n\n",
+			layout_queries - mismatches, layout_queries);
+	return (mismatches);
+}
+
+/**
+ * A function, which keeps walking through the whole suffix tree
+ * without printing anything, until the minimum time of the walk benchmark
+ * elapses, and then reports the number of the nodes visited per second.
+ * All the walks share the same explicit stack.
+ *
+ * @param
+ * kind		the representation of the suffix tree, available values:
+ * 		1 - SLLI, 2 - SHTI, 3 - SLAI, 4 - SLAI in the compact encoding,
+ * 		5 - SLLI_BP, 6 - SHTI_BP
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stree	the actual suffix tree of the given representation
+ *
+ * @return	If the walks were successful, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int walk_measure (int kind,
+		const character_type *text,
+		const void *stree) {
+	/* the explicit stack shared by all the walks */
+	traversal_stack stack = {NULL, 0, 0};
+	size_t branching_nodes = 0;
+	size_t leaves = 0;
+	size_t rounds = 0;
+	size_t start_time = 0;
+	size_t walk_time = 0;
+	int retval = 0;
+	start_time = cpu_time_ms();
+	do {
+		branching_nodes = 0;
+		leaves = 0;
+		switch (kind) {
+			case 1:
+				retval = st_slli_walk_from(1,
+						&branching_nodes, &leaves,
+						&stack, stree);
+				break;
+			case 2:
+				retval = st_shti_walk_from(1,
+						&branching_nodes, &leaves,
+						text, &stack, stree);
+				break;
+			case 3:
+				retval = st_slai_walk_from((size_t)(0),
+						&branching_nodes, &leaves,
+						&stack, stree);
+				break;
+			case 4:
+				retval = st_slai_compact_walk_from(
+						(size_t)(0),
+						&branching_nodes, &leaves,
+						&stack, stree);
+				break;
+			case 5:
+				retval = st_slli_bp_walk_from(1,
+						&branching_nodes, &leaves,
+						&stack, stree);
+				break;
+			case 6:
+				retval = st_shti_bp_walk_from(1,
+						&branching_nodes, &leaves,
+						text, &stack, stree);
+				break;
+			default:
+				retval = 1;
+				break;
+		}
+		if (retval > 0) {
+			fprintf(stderr, "Error: The walk through "
+					"the suffix tree was unsuccessful!\n");
+			traversal_stack_free(&stack);
+			return (1);
+		}
+		++rounds;
+		walk_time = cpu_time_ms() - start_time;
+	} while (walk_time < walk_minimum_time);
+	traversal_stack_free(&stack);
+	/* the walks do not count the root */
+	++branching_nodes;
+	printf("Walk through the whole suffix tree:\n"
+			"%zu branching nodes and %zu leaves "
+			"visited %zu times in ", branching_nodes,
+			leaves, rounds);
+	print_human_readable_time(stdout, walk_time);
+	printf("\n%.0f nodes visited per second\n\n",
+			(double)((branching_nodes + leaves) * rounds) *
+			1000.0 / (double)(walk_time));
+	return (0);
+}
+
+/**
+ * A function, which analyses the repeats in the whole suffix tree
+ * in a single bottom-up pass without printing the traversal log
+ * and then prints the summary of the analysis and the time it took.
+ *
+ * @param
+ * kind		the representation of the suffix tree, available values:
+ * 		1 - SLLI, 2 - SHTI, 3 - SLAI, 4 - SLAI in the compact encoding,
+ * 		5 - SLLI_BP, 6 - SHTI_BP
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stree	the actual suffix tree of the given representation
+ *
+ * @return	If the analysis was successful, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int repeat_measure (int kind,
+		const character_type *text,
+		const void *stree) {
+	/* the explicit stack of the analysis */
+	traversal_stack stack = {NULL, 0, 0};
+	repeat_analysis analysis = {.text = text};
+	size_t start_time = 0;
+	size_t analysis_time = 0;
+	int retval = 0;
+	start_time = cpu_time_ms();
+	switch (kind) {
+		case 1:
+			retval = st_slli_analyse_repeats(&analysis,
+					&stack, stree);
+			break;
+		case 2:
+			retval = st_shti_analyse_repeats(&analysis,
+					text, &stack, stree);
+			break;
+		case 3:
+			retval = st_slai_analyse_repeats(&analysis,
+					&stack, stree);
+			break;
+		case 4:
+			retval = st_slai_compact_analyse_repeats(&analysis,
+					&stack, stree);
+			break;
+		case 5:
+			retval = st_slli_bp_analyse_repeats(&analysis,
+					&stack, stree);
+			break;
+		case 6:
+			retval = st_shti_bp_analyse_repeats(&analysis,
+					text, &stack, stree);
+			break;
+		default:
+			retval = 1;
+			break;
+	}
+	analysis_time = cpu_time_ms() - start_time;
+	traversal_stack_free(&stack);
+	if (retval > 0) {
+		fprintf(stderr, "Error: The repeat analysis "
+				"of the suffix tree was unsuccessful!\n");
+		repeat_analysis_free(&analysis);
+		return (1);
+	}
+	repeat_analysis_print(stdout, &analysis);
+	printf("Repeat analysis time: ");
+	print_human_readable_time(stdout, analysis_time);
+	printf("\n\n");
+	repeat_analysis_free(&analysis);
+	return (0);
+}
+
+/**
+ * A function, which exports the suffix array and the LCP array
+ * of the whole suffix tree and then prints the time it took.
+ *
+ * @param
+ * kind		the representation of the suffix tree, available values:
+ * 		1 - SLLI, 2 - SHTI, 3 - SLAI, 4 - SLAI in the compact encoding,
+ * 		5 - SLLI_BP, 6 - SHTI_BP
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ * @param
+ * stree	the actual suffix tree of the given representation
+ *
+ * @return	If the export was successful, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int export_measure (int kind,
+		const character_type *text,
+		array_export *export,
+		const void *stree) {
+	/* the explicit stack of the export */
+	traversal_stack stack = {NULL, 0, 0};
+	size_t start_time = 0;
+	size_t export_time = 0;
+	int retval = 0;
+	start_time = cpu_time_ms();
+	switch (kind) {
+		case 1:
+			retval = st_slli_export_arrays(export, &stack, stree);
+			break;
+		case 2:
+			retval = st_shti_export_arrays(export, text,
+					&stack, stree);
+			break;
+		case 3:
+			retval = st_slai_export_arrays(export, &stack, stree);
+			break;
+		case 4:
+			retval = st_slai_compact_export_arrays(export,
+					&stack, stree);
+			break;
+		case 5:
+			retval = st_slli_bp_export_arrays(export,
+					&stack, stree);
+			break;
+		case 6:
+			retval = st_shti_bp_export_arrays(export, text,
+					&stack, stree);
+			break;
+		default:
+			retval = 1;
+			break;
+	}
+	export_time = cpu_time_ms() - start_time;
+	traversal_stack_free(&stack);
+	if (retval > 0) {
+		fprintf(stderr, "Error: The export of the suffix array "
+				"was unsuccessful!\n");
+		return (1);
+	}
+	printf("Suffix array and LCP array export:\n"
+			"%zu suffixes of %zu bytes exported in ",
+			export->entries, export->width);
+	print_human_readable_time(stdout, export_time);
+	printf("\n\n");
+	return (0);
+}
+
+/**
+ * A function, which computes the matching statistics of the query
+ * against the suffix tree and then prints their summary,
+ * the wall-clock time it took, measured by the monotonic clock
+ * of the phase profile, and the number of the query characters
+ * processed per second.
+ *
+ * @param
+ * kind		the representation of the suffix tree, available values:
+ * 		1 - SLLI, 2 - SHTI
+ * @param
+ * query	the query text
+ * @param
+ * query_length	the number of the characters of the query
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * length	the actual length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * stree	the actual suffix tree of the given representation
+ *
+ * @return	If the computation was successful, zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int matching_measure (int kind,
+		const character_type *query,
+		size_t query_length,
+		const character_type *text,
+		size_t length,
+		const void *stree) {
+	matching_statistics statistics = {.positions = 0};
+	/* the wall-clock times in nanoseconds */
+	unsigned long long start_time = 0;
+	unsigned long long matching_time = 0;
+	int retval = 0;
+	start_time = phase_profile_clock();
+	switch (kind) {
+		case 1:
+			retval = st_slli_matching_statistics(query,
+					query_length, &statistics,
+					text, length, stree);
+			break;
+		case 2:
+			retval = st_shti_matching_statistics(query,
+					query_length, &statistics,
+					text, length, stree);
+			break;
+		default:
+			retval = 1;
+			break;
+	}
+	matching_time = phase_profile_clock() - start_time;
+	if (retval > 0) {
+		fprintf(stderr, "Error: The matching statistics "
+				"of the query were not computed!\n");
+		return (1);
+	}
+	matching_statistics_print(stdout, &statistics);
+	printf("Matching statistics time: %.3f ms", (double)(matching_time) /
+			1e6);
+	/* a zero duration is counted as a single nanosecond */
+	printf(" (%.0f query characters per second)\n\n",
+			(double)(query_length) * 1e9 /
+			(double)(matching_time > 0 ? matching_time : 1));
+	return (0);
+}
+
 /**
  * A function, which tries to run the specified SLLI based benchmark
  * of the desired construction algorithm for the suffix tree.
@@ -283,6 +1213,17 @@ int print_usage (const char *argv0) {
  * stream	the FILE * type stream to which the traversal progress
  * 		will be written (if requested)
  * @param
+ * export	the export of the suffix array and of the LCP array
+ * 		(if requested)
+ * @param
+ * profile	the time, the memory usage and the hardware performance
+ * 		counters recorded per phase
+ * 		(or NULL)
+ * @param
+ * query	the query text of the matching statistics (if requested)
+ * @param
+ * query_length	the number of the characters of the query
+ * @param
  * algorithm	the desired construction algorithm to use
  * @param
  * benchmark	the requested benchmark to use
@@ -290,6 +1231,14 @@ int print_usage (const char *argv0) {
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
+ * traversal_workers	the number of the threads traversing the suffix tree
+ * @param
+ * relayout	if this variable evaluates to true, the branching nodes
+ * 		will be renumbered in the breadth-first order
+ * 		after the construction
+ * @param
  * internal_text_encoding	The character encoding used in the internal
  * 				representation of the text for the suffix tree.
  * @param
@@ -300,16 +1249,28 @@ int print_usage (const char *argv0) {
  *
  * @return	If the SL implementation technique is not compatible
  * 		with the selected algorithm, one (1) is returned.
+ * 		If the memory for the layout benchmark could not be
+ * 		allocated, two (2) is returned.
  * 		Otherwise, zero (0) is returned.
  */
 int benchmark_slli (FILE *stream,
+		array_export *export,
+		phase_profile *profile,
+		const character_type *query,
+		size_t query_length,
 		int algorithm,
 		int benchmark,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
+		int relayout,
 		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length) {
 	suffix_tree_slli stree = {.lr_size = 0};
+	size_t *positions = NULL;
+	unsigned_integral_type *depths = NULL;
+	phase_profile_begin("construction", profile);
 	switch (algorithm) {
 		case 1:
 			st_slli_create_simple_mccreight(text, length, &stree);
@@ -330,10 +1291,53 @@ int benchmark_slli (FILE *stream,
 					"the desired algorithm (PWOTD)\n");
 			return (1);
 	}
+	if (benchmark == 3) {
+		phase_profile_begin("benchmark", profile);
+		positions = calloc(layout_queries, sizeof (size_t));
+		depths = calloc(layout_queries,
+				sizeof (unsigned_integral_type));
+		if ((positions == NULL) || (depths == NULL)) {
+			perror("calloc(positions)");
+			/* resetting the errno */
+			errno = 0;
+			free(positions);
+			free(depths);
+			st_slli_delete(&stree);
+			return (2);
+		} else {
+			/* resetting the errno */
+			errno = 0;
+		}
+		layout_choose_queries(positions, depths, length);
+		layout_measure_slli("In the order of creation",
+				positions, depths, text, length, &stree);
+	}
+	if ((relayout != 0) || (benchmark == 3)) {
+		st_slli_relayout(length, &stree);
+	}
+	if ((benchmark != 1) && (benchmark != 3)) {
+		phase_profile_begin("benchmark", profile);
+	}
 	if (benchmark == 2) {
 		st_slli_traverse(stream, internal_text_encoding,
-				traversal_type, text, length, &stree);
+				traversal_type, traversal_format,
+				traversal_workers, text, length, &stree);
+	} else if (benchmark == 3) {
+		layout_measure_slli("In the breadth-first order",
+				positions, depths, text, length, &stree);
+		free(positions);
+		free(depths);
+	} else if (benchmark == 4) {
+		walk_measure(1, text, &stree);
+	} else if (benchmark == 5) {
+		repeat_measure(1, text, &stree);
+	} else if (benchmark == 6) {
+		export_measure(1, text, export, &stree);
+	} else if (benchmark == 7) {
+		matching_measure(1, query, query_length,
+				text, length, &stree);
 	}
+	phase_profile_begin("deletion", profile);
 	st_slli_delete(&stree);
 	return (0);
 }
@@ -346,6 +1350,17 @@ int benchmark_slli (FILE *stream,
  * stream	the FILE * type stream to which the traversal progress
  * 		will be written (if requested)
  * @param
+ * export	the export of the suffix array and of the LCP array
+ * 		(if requested)
+ * @param
+ * profile	the time, the memory usage and the hardware performance
+ * 		counters recorded per phase
+ * 		(or NULL)
+ * @param
+ * query	the query text of the matching statistics (if requested)
+ * @param
+ * query_length	the number of the characters of the query
+ * @param
  * algorithm	the desired construction algorithm to use
  * @param
  * benchmark	the requested benchmark to use
@@ -353,10 +1368,18 @@ int benchmark_slli (FILE *stream,
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
+ * traversal_workers	the number of the threads traversing the suffix tree
+ * @param
  * crt_type	the desired type of the collision resolution technique to use
  * @param
  * chf_number	the desired number of the Cuckoo hash functions
  * @param
+ * relayout	if this variable evaluates to true, the branching nodes
+ * 		will be renumbered in the breadth-first order
+ * 		after the construction
+ * @param
  * internal_text_encoding	The character encoding used in the internal
  * 				representation of the text for the suffix tree.
  * @param
@@ -367,20 +1390,32 @@ int benchmark_slli (FILE *stream,
  *
  * @return	If the SH implementation technique is not compatible
  * 		with the selected algorithm, one (1) is returned.
+ * 		If the memory for the layout benchmark could not be
+ * 		allocated, two (2) is returned.
  * 		Otherwise, zero (0) is returned.
  */
 int benchmark_shti (FILE *stream,
+		array_export *export,
+		phase_profile *profile,
+		const character_type *query,
+		size_t query_length,
 		int algorithm,
 		int benchmark,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
 		int crt_type,
 		size_t chf_number,
+		int relayout,
 		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length) {
 	suffix_tree_shti stree = {.hs_size = 0};
+	size_t *positions = NULL;
+	unsigned_integral_type *depths = NULL;
 	stree.crt_type = crt_type;
 	stree.chf_number = chf_number;
+	phase_profile_begin("construction", profile);
 	switch (algorithm) {
 		case 1:
 			st_shti_create_simple_mccreight(text, length, &stree);
@@ -401,10 +1436,53 @@ int benchmark_shti (FILE *stream,
 					"the desired algorithm (PWOTD)\n");
 			return (1);
 	}
+	if (benchmark == 3) {
+		phase_profile_begin("benchmark", profile);
+		positions = calloc(layout_queries, sizeof (size_t));
+		depths = calloc(layout_queries,
+				sizeof (unsigned_integral_type));
+		if ((positions == NULL) || (depths == NULL)) {
+			perror("calloc(positions)");
+			/* resetting the errno */
+			errno = 0;
+			free(positions);
+			free(depths);
+			st_shti_delete(&stree);
+			return (2);
+		} else {
+			/* resetting the errno */
+			errno = 0;
+		}
+		layout_choose_queries(positions, depths, length);
+		layout_measure_shti("In the order of creation",
+				positions, depths, text, length, &stree);
+	}
+	if ((relayout != 0) || (benchmark == 3)) {
+		st_shti_relayout(text, &stree);
+	}
+	if ((benchmark != 1) && (benchmark != 3)) {
+		phase_profile_begin("benchmark", profile);
+	}
 	if (benchmark == 2) {
 		st_shti_traverse(stream, internal_text_encoding,
-				traversal_type, text, length, &stree);
+				traversal_type, traversal_format,
+				traversal_workers, text, length, &stree);
+	} else if (benchmark == 3) {
+		layout_measure_shti("In the breadth-first order",
+				positions, depths, text, length, &stree);
+		free(positions);
+		free(depths);
+	} else if (benchmark == 4) {
+		walk_measure(2, text, &stree);
+	} else if (benchmark == 5) {
+		repeat_measure(2, text, &stree);
+	} else if (benchmark == 6) {
+		export_measure(2, text, export, &stree);
+	} else if (benchmark == 7) {
+		matching_measure(2, query, query_length,
+				text, length, &stree);
 	}
+	phase_profile_begin("deletion", profile);
 	st_shti_delete(&stree);
 	return (0);
 }
@@ -417,6 +1495,13 @@ int benchmark_shti (FILE *stream,
  * stream	the FILE * type stream to which the traversal progress
  * 		will be written (if requested)
  * @param
+ * export	the export of the suffix array and of the LCP array
+ * 		(if requested)
+ * @param
+ * profile	the time, the memory usage and the hardware performance
+ * 		counters recorded per phase
+ * 		(or NULL)
+ * @param
  * algorithm	the desired construction algorithm to use
  * @param
  * benchmark	the requested benchmark to use
@@ -427,6 +1512,18 @@ int benchmark_shti (FILE *stream,
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
+ * traversal_workers	the number of the threads traversing the suffix tree
+ * @param
+ * tnode_filename	the name of the file, into which the table tnode
+ * 			will be streamed during the construction.
+ * 			If it is NULL, the table tnode
+ * 			is kept entirely in the memory.
+ * @param
+ * compact	if this variable evaluates to true, the table tnode
+ * 		is converted into the compact encoding after the construction
+ * @param
  * internal_text_encoding	The character encoding used in the internal
  * 				representation of the text for the suffix tree.
  * @param
@@ -437,22 +1534,46 @@ int benchmark_shti (FILE *stream,
  *
  * @return	If the LA implementation technique is not compatible
  * 		with the selected algorithm, one (1) is returned.
+ * 		If the tnode sink could not be opened, two (2) is returned.
+ * 		If the compact encoding could not be created,
+ * 		three (3) is returned. If the memory for the substring
+ * 		lookups could not be allocated, four (4) is returned.
+ * 		If the lookups in the compact encoding do not agree
+ * 		with the ones in the table tnode, five (5) is returned.
  * 		Otherwise, zero (0) is returned.
  */
 int benchmark_slai (FILE *stream,
+		array_export *export,
+		phase_profile *profile,
 		int algorithm,
 		int benchmark,
 		long int prefix_length,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
+		const char *tnode_filename,
+		int compact,
 		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length) {
 	char *algorithm_names[4] = {NULL};
 	suffix_tree_slai stree = {.tnode = NULL};
+	suffix_tree_slai_compact ctree = {.tnode = NULL};
+	slai_tnode_sink sink = {.fill_buffer = NULL};
+	/* the positions in the text of the substrings to look up */
+	size_t *positions = NULL;
+	/* the lengths of the substrings to look up */
+	unsigned_integral_type *depths = NULL;
+	/* the occurrences found in the table tnode */
+	size_t *occurrences = NULL;
+	/* the occurrences found in the compact encoding */
+	size_t *compact_occurrences = NULL;
+	int retval = 0;
 	algorithm_names[0] = "simple McCreight's style";
 	algorithm_names[1] = "McCreight's";
 	algorithm_names[2] = "simple Ukkonen's style";
 	algorithm_names[3] = "Ukkonen's";
+	phase_profile_begin("construction", profile);
 	switch (algorithm) {
 		case 1:
 		case 2:
@@ -465,15 +1586,125 @@ int benchmark_slai (FILE *stream,
 					algorithm_names[algorithm - 1]);
 			return (1);
 		case 5:
+			if (tnode_filename != NULL) {
+				if (st_slai_sink_open(tnode_filename,
+							&sink) > 0) {
+					fprintf(stderr, "Error: "
+							"Could not open "
+							"the tnode sink!\n");
+					return (2);
+				}
+				stree.sink = &sink;
+			}
 			st_slai_create_pwotd(prefix_length,
 					text, length, &stree);
 			break;
 	}
+	if (benchmark == 3) {
+		phase_profile_begin("benchmark", profile);
+		positions = calloc(layout_queries, sizeof (size_t));
+		depths = calloc(layout_queries,
+				sizeof (unsigned_integral_type));
+		occurrences = calloc(layout_queries, sizeof (size_t));
+		compact_occurrences = calloc(layout_queries, sizeof (size_t));
+		if ((positions == NULL) || (depths == NULL) ||
+				(occurrences == NULL) ||
+				(compact_occurrences == NULL)) {
+			perror("calloc(positions)");
+			/* resetting the errno */
+			errno = 0;
+			free(positions);
+			free(depths);
+			free(occurrences);
+			free(compact_occurrences);
+			st_slai_delete(&stree);
+			if (stree.sink != NULL) {
+				st_slai_sink_close(&sink);
+			}
+			return (4);
+		} else {
+			/* resetting the errno */
+			errno = 0;
+		}
+		layout_choose_queries(positions, depths, length);
+		layout_measure_slai("In the table tnode", positions, depths,
+				occurrences, text, length, &stree);
+	}
+	if (compact != 0) {
+		if (st_slai_compact_create(length, &stree, &ctree) > 0) {
+			fprintf(stderr, "Error: Could not create "
+					"the compact encoding!\n");
+			free(positions);
+			free(depths);
+			free(occurrences);
+			free(compact_occurrences);
+			st_slai_delete(&stree);
+			if (stree.sink != NULL) {
+				st_slai_sink_close(&sink);
+			}
+			return (3);
+		}
+		/* the table tnode is no longer needed */
+		st_slai_delete(&stree);
+		if (stree.sink != NULL) {
+			st_slai_sink_close(&sink);
+		}
+		if ((benchmark != 1) && (benchmark != 3)) {
+			phase_profile_begin("benchmark", profile);
+		}
+		if (benchmark == 2) {
+			st_slai_compact_traverse(stream,
+					internal_text_encoding,
+					traversal_format,
+					text, length, &ctree);
+		} else if (benchmark == 3) {
+			layout_measure_slai_compact("In the compact encoding",
+					positions, depths, compact_occurrences,
+					text, length, &ctree);
+			if (layout_compare_slai(positions, depths,
+						occurrences,
+						compact_occurrences,
+						text) > 0) {
+				fprintf(stderr, "Error: The lookups "
+						"in the compact encoding "
+						"do not agree with "
+						"the table tnode!\n");
+				retval = 5;
+			}
+			free(positions);
+			free(depths);
+			free(occurrences);
+			free(compact_occurrences);
+		} else if (benchmark == 4) {
+			walk_measure(4, text, &ctree);
+		} else if (benchmark == 5) {
+			repeat_measure(4, text, &ctree);
+		} else if (benchmark == 6) {
+			export_measure(4, text, export, &ctree);
+		}
+		phase_profile_begin("deletion", profile);
+		st_slai_compact_delete(&ctree);
+		return (retval);
+	}
+	if (benchmark != 1) {
+		phase_profile_begin("benchmark", profile);
+	}
 	if (benchmark == 2) {
 		st_slai_traverse(stream, internal_text_encoding,
-				traversal_type, text, length, &stree);
+				traversal_type, traversal_format,
+				traversal_workers, text, length, &stree);
+	} else if (benchmark == 4) {
+		walk_measure(3, text, &stree);
+	} else if (benchmark == 5) {
+		repeat_measure(3, text, &stree);
+	} else if (benchmark == 6) {
+		export_measure(3, text, export, &stree);
 	}
+	phase_profile_begin("deletion", profile);
 	st_slai_delete(&stree);
+	if (stree.sink != NULL) {
+		st_slai_sink_close(&sink);
+	}
 	return (0);
 }
 
@@ -485,6 +1716,13 @@ int benchmark_slai (FILE *stream,
  * stream	the FILE * type stream to which the traversal progress
  * 		will be written (if requested)
  * @param
+ * export	the export of the suffix array and of the LCP array
+ * 		(if requested)
+ * @param
+ * profile	the time, the memory usage and the hardware performance
+ * 		counters recorded per phase
+ * 		(or NULL)
+ * @param
  * algorithm	the desired construction algorithm to use
  * @param
  * benchmark	the requested benchmark to use
@@ -492,6 +1730,8 @@ int benchmark_slai (FILE *stream,
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
  * internal_text_encoding	The character encoding used in the internal
  * 				representation of the text for the suffix tree.
  * @param
@@ -505,13 +1745,17 @@ int benchmark_slai (FILE *stream,
  * 		Otherwise, a positive error number is returned.
  */
 int benchmark_slli_bp (FILE *stream,
+		array_export *export,
+		phase_profile *profile,
 		int algorithm,
 		int benchmark,
 		int traversal_type,
+		int traversal_format,
 		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length) {
 	suffix_tree_slli_bp stree = {.lr_size = 0};
+	phase_profile_begin("construction", profile);
 	switch (algorithm) {
 		case 1:
 			fprintf(stderr, "The selected implementation "
@@ -543,10 +1787,21 @@ int benchmark_slli_bp (FILE *stream,
 					"the desired algorithm (PWOTD)\n");
 			return (3);
 	}
+	if (benchmark != 1) {
+		phase_profile_begin("benchmark", profile);
+	}
 	if (benchmark == 2) {
 		st_slli_bp_traverse(stream, internal_text_encoding,
-				traversal_type, text, length, &stree);
+				traversal_type, traversal_format,
+				text, length, &stree);
+	} else if (benchmark == 4) {
+		walk_measure(5, text, &stree);
+	} else if (benchmark == 5) {
+		repeat_measure(5, text, &stree);
+	} else if (benchmark == 6) {
+		export_measure(5, text, export, &stree);
 	}
+	phase_profile_begin("deletion", profile);
 	st_slli_bp_delete(&stree);
 	return (0);
 }
@@ -559,16 +1814,390 @@ int benchmark_slli_bp (FILE *stream,
  * stream	the FILE * type stream to which the traversal progress
  * 		will be written (if requested)
  * @param
+ * export	the export of the suffix array and of the LCP array
+ * 		(if requested)
+ * @param
+ * profile	the time, the memory usage and the hardware performance
+ * 		counters recorded per phase
+ * 		(or NULL)
+ * @param
  * algorithm	the desired construction algorithm to use
  * @param
  * benchmark	the requested benchmark to use
  * @param
- * traversal_type	the type of the suffix tree traversal,
- * 			which will be performed (if requested)
+ * traversal_type	the type of the suffix tree traversal,
+ * 			which will be performed (if requested)
+ * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
+ * crt_type	the desired type of the collision resolution technique to use
+ * @param
+ * chf_number	the desired number of the Cuckoo hash functions
+ * @param
+ * internal_text_encoding	The character encoding used in the internal
+ * 				representation of the text for the suffix tree.
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * length	the final length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ *
+ * @return	If the benchmark could be successfully started,
+ * 		zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int benchmark_shti_bp (FILE *stream,
+		array_export *export,
+		phase_profile *profile,
+		int algorithm,
+		int benchmark,
+		int traversal_type,
+		int traversal_format,
+		int crt_type,
+		size_t chf_number,
+		const char *internal_text_encoding,
+		const character_type *text,
+		size_t length) {
+	suffix_tree_shti_bp stree = {.hs_size = 0};
+	stree.crt_type = crt_type;
+	stree.chf_number = chf_number;
+	phase_profile_begin("construction", profile);
+	switch (algorithm) {
+		case 1:
+			fprintf(stderr, "The selected implementation "
+					"technique (SH) "
+					"and algorithm variation (B)\n"
+					"are not compatible with "
+					"the desired algorithm "
+					"(simple McCreight's style)\n");
+			return (1);
+		case 2:
+			st_shti_bp_create_mccreight(text, length, &stree);
+			break;
+		case 3:
+			fprintf(stderr, "The selected implementation "
+					"technique (SH) "
+					"and algorithm variation (B)\n"
+					"are not compatible with "
+					"the desired algorithm "
+					"(simple Ukkonen's style)\n");
+			return (2);
+		case 4:
+			st_shti_bp_create_ukkonen(text, length, &stree);
+			break;
+		case 5:
+			fprintf(stderr, "The selected implementation "
+					"technique (SH) "
+					"and algorithm variation (B)\n"
+					"are not compatible with "
+					"the desired algorithm (PWOTD)\n");
+			return (3);
+	}
+	if (benchmark != 1) {
+		phase_profile_begin("benchmark", profile);
+	}
+	if (benchmark == 2) {
+		st_shti_bp_traverse(stream, internal_text_encoding,
+				traversal_type, traversal_format,
+				text, length, &stree);
+	} else if (benchmark == 4) {
+		walk_measure(6, text, &stree);
+	} else if (benchmark == 5) {
+		repeat_measure(6, text, &stree);
+	} else if (benchmark == 6) {
+		export_measure(6, text, export, &stree);
+	}
+	phase_profile_begin("deletion", profile);
+	st_shti_bp_delete(&stree);
+	return (0);
+}
+
+/* memory budget functions */
+
+/**
+ * A struct which stores a single configuration of the suffix tree,
+ * which is considered by the memory budget mode.
+ */
+typedef struct budget_configuration_struct {
+	/** the implementation type (1 = SL, 2 = SH, 3 = LA) */
+	int type;
+	/** the construction algorithm */
+	int algorithm;
+	/** the algorithm variation */
+	int variation;
+	/** the collision resolution technique (SH only) */
+	int crt_type;
+	/** the number of the Cuckoo hash functions (Cuckoo hashing only) */
+	size_t chf_number;
+	/** the PWOTD prefix length (LA only) */
+	long int prefix_length;
+	/** the processor time of the construction of the sample in ms */
+	double sample_time;
+	/** the estimated peak memory usage for the whole text in bytes */
+	size_t estimate;
+} budget_configuration;
+
+/**
+ * The maximum number of the characters of the sample of the text,
+ * on which the configurations are measured by the memory budget mode.
+ */
+const size_t budget_sample_length = 131072; /* 2^17 */
+
+/**
+ * The factor, by which the memory usage of the tables extrapolated
+ * from the sample is multiplied to cover the differences
+ * between the sample and the whole text.
+ */
+const double budget_margin = 1.25;
+
+/**
+ * The implementation types, the algorithms and their variations
+ * considered by the memory budget mode.
+ */
+const int budget_algorithms[13][3] = {
+	{1, 1, 0}, {1, 2, 0}, {1, 3, 0}, {1, 4, 0}, {1, 2, 1}, {1, 4, 1},
+	{2, 1, 0}, {2, 2, 0}, {2, 3, 0}, {2, 4, 0}, {2, 2, 1}, {2, 4, 1},
+	{3, 5, 0}
+};
+
+/** The numbers of the Cuckoo hash functions tried by the memory budget mode. */
+const size_t budget_chf_numbers[3] = {2, 4, 8};
+
+/** The PWOTD prefix lengths tried by the memory budget mode. */
+const long int budget_prefix_lengths[4] = {0, 1, 2, 3};
+
+/**
+ * A function, which prints the command line options selecting
+ * the provided configuration of the suffix tree.
+ *
+ * @param
+ * stream		the FILE * type stream, to which the options
+ * 			will be printed
+ * @param
+ * configuration	the configuration to print
+ *
+ * @return	The number of the printed characters.
+ */
+int budget_print_configuration (FILE *stream,
+		const budget_configuration *configuration) {
+	const char *type_names[4] = {"", "SL", "SH", "LA"};
+	const char *algorithm_letters = " AMBUP";
+	int printed = 0;
+	printed += fprintf(stream, "-t %s -a %c%s",
+			type_names[configuration->type],
+			algorithm_letters[configuration->algorithm],
+			configuration->variation != 0 ? "B" : "");
+	if (configuration->crt_type == 1) {
+		printed += fprintf(stream, " -r C -c %zu",
+				configuration->chf_number);
+	} else if (configuration->crt_type == 2) {
+		printed += fprintf(stream, " -r D");
+	} else if (configuration->type == 3) {
+		printed += fprintf(stream, " -p %ld",
+				configuration->prefix_length);
+	}
+	return (printed);
+}
+
+/**
+ * A function, which decides if the provided configuration
+ * of the suffix tree can be used together with the other options.
+ *
+ * @param
+ * configuration	the considered configuration
+ * @param
+ * constraint	the implementation type, the algorithm, the collision
+ * 		resolution technique, the number of the Cuckoo hash
+ * 		functions and the PWOTD prefix length specified
+ * 		by the user (zero or -1 if not specified)
+ * @param
+ * benchmark	the requested benchmark
+ * @param
+ * relayout	if this variable evaluates to true, the branching nodes
+ * 		will be renumbered in the breadth-first order
+ * @param
+ * traversal_workers	the number of the threads traversing the suffix tree
+ *
+ * @return	If the configuration can be used, one (1) is returned.
+ * 		Otherwise, zero (0) is returned.
+ */
+int budget_is_allowed (const budget_configuration *configuration,
+		const budget_configuration *constraint,
+		int benchmark,
+		int relayout,
+		size_t traversal_workers) {
+	if (((constraint->type != 0) &&
+				(constraint->type != configuration->type)) ||
+			((constraint->algorithm != 0) &&
+			 ((constraint->algorithm != configuration->algorithm) ||
+			  (constraint->variation !=
+			   configuration->variation))) ||
+			((constraint->crt_type != 0) &&
+			 (constraint->crt_type != configuration->crt_type)) ||
+			((constraint->chf_number != 0) &&
+			 (configuration->crt_type != 1))) {
+		return (0);
+	}
+	/* the matching statistics need the suffix links */
+	if ((benchmark == 7) && ((configuration->type == 3) ||
+				(configuration->algorithm == 1) ||
+				(configuration->algorithm == 3) ||
+				(configuration->variation != 0))) {
+		return (0);
+	}
+	if (((relayout != 0) || (benchmark == 3)) &&
+			((configuration->type == 3) ||
+			 (configuration->variation != 0))) {
+		return (0);
+	}
+	if ((traversal_workers > 1) && (configuration->variation != 0)) {
+		return (0);
+	}
+	return (1);
+}
+
+/**
+ * A function, which constructs the suffix tree of the provided
+ * configuration for the sample of the text and measures
+ * its processor time and the peak memory usage of its tables.
+ * The progress and the warnings of the construction are not printed.
+ *
+ * @param
+ * configuration	the configuration to measure, where the measured
+ * 			processor time and the peak memory usage
+ * 			extrapolated to the whole text will be stored
+ * @param
+ * internal_text_encoding	The character encoding used in the internal
+ * 				representation of the text for the suffix tree.
+ * @param
+ * sample	the sample of the text in the same format as the text
+ * @param
+ * sample_length	the number of the "real" characters of the sample
+ * @param
+ * length	the number of the "real" characters of the whole text
+ *
+ * @return	If the suffix tree has been successfully constructed,
+ * 		zero (0) is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int budget_measure (budget_configuration *configuration,
+		const char *internal_text_encoding,
+		const character_type *sample,
+		size_t sample_length,
+		size_t length) {
+	clock_t start = 0;
+	size_t peak = 0;
+	int saved_stdout = (-1);
+	int saved_stderr = (-1);
+	int null_fd = (-1);
+	int retval = 0;
+	fflush(stdout);
+	fflush(stderr);
+	saved_stdout = dup(STDOUT_FILENO);
+	saved_stderr = dup(STDERR_FILENO);
+	null_fd = open("/dev/null", O_WRONLY);
+	if (null_fd != (-1)) {
+		if (saved_stdout != (-1)) {
+			dup2(null_fd, STDOUT_FILENO);
+		}
+		if (saved_stderr != (-1)) {
+			dup2(null_fd, STDERR_FILENO);
+		}
+		close(null_fd);
+	}
+	/* resetting the errno */
+	errno = 0;
+	arena_measure_peak();
+	start = clock();
+	if (configuration->variation == 0) {
+		switch (configuration->type) {
+			case 1:
+				retval = benchmark_slli(stdout, NULL, NULL,
+					NULL, (size_t)(0),
+					configuration->algorithm, 1,
+					tt_detailed, tf_text, (size_t)(1), 0,
+					internal_text_encoding,
+					sample, sample_length);
+				break;
+			case 2:
+				retval = benchmark_shti(stdout, NULL, NULL,
+					NULL, (size_t)(0),
+					configuration->algorithm, 1,
+					tt_detailed, tf_text, (size_t)(1),
+					configuration->crt_type,
+					configuration->chf_number, 0,
+					internal_text_encoding,
+					sample, sample_length);
+				break;
+			case 3:
+				retval = benchmark_slai(stdout, NULL, NULL,
+					configuration->algorithm, 1,
+					configuration->prefix_length,
+					tt_detailed, tf_text, (size_t)(1),
+					NULL, 0, internal_text_encoding,
+					sample, sample_length);
+				break;
+		}
+	} else if (configuration->type == 1) {
+		retval = benchmark_slli_bp(stdout, NULL, NULL,
+				configuration->algorithm, 1,
+				tt_detailed, tf_text,
+				internal_text_encoding,
+				sample, sample_length);
+	} else {
+		retval = benchmark_shti_bp(stdout, NULL, NULL,
+				configuration->algorithm, 1,
+				tt_detailed, tf_text,
+				configuration->crt_type,
+				configuration->chf_number,
+				internal_text_encoding,
+				sample, sample_length);
+	}
+	configuration->sample_time = (double)(clock() - start) * 1000.0 /
+		(double)(CLOCKS_PER_SEC);
+	peak = arena_measure_peak();
+	fflush(stdout);
+	fflush(stderr);
+	if (saved_stdout != (-1)) {
+		dup2(saved_stdout, STDOUT_FILENO);
+		close(saved_stdout);
+	}
+	if (saved_stderr != (-1)) {
+		dup2(saved_stderr, STDERR_FILENO);
+		close(saved_stderr);
+	}
+	/* the tables grow linearly with the length of the text */
+	configuration->estimate = (length + extra_allocated_characters) *
+		sizeof (character_type) + (size_t)((double)(peak) *
+				(double)(length) / (double)(sample_length) *
+				budget_margin);
+	return (retval > 0 ? 1 : 0);
+}
+
+/**
+ * A function, which measures all the configurations of the suffix tree
+ * allowed by the other options on a sample of the text and chooses
+ * the fastest one, whose estimated peak memory usage for the whole
+ * text fits into the memory budget. The peak memory usage consists
+ * of the text and of the peak total size of the tables of the suffix
+ * tree (tleaf, tbranch, tedge, tnode and the PWOTD construction data)
+ * measured by the table allocator.
+ *
+ * @param
+ * memory_budget	the memory budget in bytes
+ * @param
+ * configuration	the implementation type, the algorithm, the collision
+ * 			resolution technique, the number of the Cuckoo hash
+ * 			functions and the PWOTD prefix length specified
+ * 			by the user (zero or -1 if not specified),
+ * 			which will be replaced by the chosen configuration
+ * @param
+ * benchmark	the requested benchmark
  * @param
- * crt_type	the desired type of the collision resolution technique to use
+ * relayout	if this variable evaluates to true, the branching nodes
+ * 		will be renumbered in the breadth-first order
  * @param
- * chf_number	the desired number of the Cuckoo hash functions
+ * traversal_workers	the number of the threads traversing the suffix tree
  * @param
  * internal_text_encoding	The character encoding used in the internal
  * 				representation of the text for the suffix tree.
@@ -578,58 +2207,148 @@ int benchmark_slli_bp (FILE *stream,
  * length	the final length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  *
- * @return	If the benchmark could be successfully started,
- * 		zero (0) is returned.
- * 		Otherwise, a positive error number is returned.
+ * @return	If a configuration has been chosen, zero (0) is returned.
+ * 		If none of the configurations fits into the memory budget,
+ * 		one (1) is returned. If no configuration is allowed
+ * 		by the other options, two (2) is returned. If the memory
+ * 		for the sample could not be allocated, three (3)
+ * 		is returned.
  */
-int benchmark_shti_bp (FILE *stream,
-		int algorithm,
+int budget_choose (size_t memory_budget,
+		budget_configuration *configuration,
 		int benchmark,
-		int traversal_type,
-		int crt_type,
-		size_t chf_number,
+		int relayout,
+		size_t traversal_workers,
 		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length) {
-	suffix_tree_shti_bp stree = {.hs_size = 0};
-	stree.crt_type = crt_type;
-	stree.chf_number = chf_number;
-	switch (algorithm) {
-		case 1:
-			fprintf(stderr, "The selected implementation "
-					"technique (SH) "
-					"and algorithm variation (B)\n"
-					"are not compatible with "
-					"the desired algorithm "
-					"(simple McCreight's style)\n");
-			return (1);
-		case 2:
-			st_shti_bp_create_mccreight(text, length, &stree);
-			break;
-		case 3:
-			fprintf(stderr, "The selected implementation "
-					"technique (SH) "
-					"and algorithm variation (B)\n"
-					"are not compatible with "
-					"the desired algorithm "
-					"(simple Ukkonen's style)\n");
-			return (2);
-		case 4:
-			st_shti_bp_create_ukkonen(text, length, &stree);
-			break;
-		case 5:
-			fprintf(stderr, "The selected implementation "
-					"technique (SH) "
-					"and algorithm variation (B)\n"
-					"are not compatible with "
-					"the desired algorithm (PWOTD)\n");
+	budget_configuration constraint = (*configuration);
+	budget_configuration candidate = {.type = 0};
+	budget_configuration best = {.type = 0};
+	budget_configuration smallest = {.type = 0};
+	character_type *sample = NULL;
+	size_t sample_length = length;
+	size_t variants = 0;
+	size_t chf_count = sizeof (budget_chf_numbers) / sizeof (size_t);
+	size_t prefix_count = sizeof (budget_prefix_lengths) /
+		sizeof (long int);
+	size_t i = 0;
+	size_t j = 0;
+	int printed = 0;
+	/* the values specified by the user are the only ones tried */
+	if (constraint.chf_number != 0) {
+		chf_count = 1;
+	}
+	if (constraint.prefix_length >= 0) {
+		prefix_count = 1;
+	}
+	if (length > budget_sample_length) {
+		sample_length = budget_sample_length;
+		sample = calloc(sample_length + extra_allocated_characters,
+				sizeof (character_type));
+		if (sample == NULL) {
+			perror("calloc(sample)");
+			/* resetting the errno */
+			errno = 0;
 			return (3);
+		}
+		/* the sample is the prefix of the text */
+		memcpy(sample, text,
+				(sample_length + 1) * sizeof (character_type));
+		sample[sample_length + 1] = terminating_character;
 	}
-	if (benchmark == 2) {
-		st_shti_bp_traverse(stream, internal_text_encoding,
-				traversal_type, text, length, &stree);
+	printf("Memory budget: ");
+	print_human_readable_size(stdout, memory_budget);
+	printf("\nMeasuring the configurations on a sample "
+			"of %zu characters:\n", sample_length);
+	for (i = 0; i < sizeof (budget_algorithms) /
+			sizeof (budget_algorithms[0]); ++i) {
+		candidate.type = budget_algorithms[i][0];
+		candidate.algorithm = budget_algorithms[i][1];
+		candidate.variation = budget_algorithms[i][2];
+		candidate.crt_type = 0;
+		candidate.chf_number = 0;
+		candidate.prefix_length = (-1);
+		if (candidate.type == 2) {
+			/* the Cuckoo hashing and the double hashing */
+			variants = chf_count + 1;
+		} else if (candidate.type == 3) {
+			variants = prefix_count;
+		} else {
+			variants = 1;
+		}
+		for (j = 0; j < variants; ++j) {
+			if ((candidate.type == 2) && (j < chf_count)) {
+				candidate.crt_type = 1;
+				candidate.chf_number =
+					constraint.chf_number != 0 ?
+					constraint.chf_number :
+					budget_chf_numbers[j];
+			} else if (candidate.type == 2) {
+				candidate.crt_type = 2;
+				candidate.chf_number = 0;
+			} else if (candidate.type == 3) {
+				candidate.prefix_length =
+					constraint.prefix_length >= 0 ?
+					constraint.prefix_length :
+					budget_prefix_lengths[j];
+			}
+			if (budget_is_allowed(&candidate, &constraint,
+						benchmark, relayout,
+						traversal_workers) == 0) {
+				continue;
+			}
+			printed = budget_print_configuration(stdout,
+					&candidate);
+			printf("%*s", printed < 24 ? 24 - printed : 1, "");
+			if (budget_measure(&candidate, internal_text_encoding,
+						sample != NULL ? sample : text,
+						sample_length, length) > 0) {
+				printf("failed\n");
+				continue;
+			}
+			printf("%10.3f ms, estimated peak memory usage: ",
+					candidate.sample_time);
+			print_human_readable_size(stdout, candidate.estimate);
+			printf("\n");
+			if ((smallest.type == 0) || (candidate.estimate <
+						smallest.estimate)) {
+				smallest = candidate;
+			}
+			if ((candidate.estimate <= memory_budget) &&
+					((best.type == 0) ||
+					 (candidate.sample_time <
+					  best.sample_time))) {
+				best = candidate;
+			}
+		}
 	}
-	st_shti_bp_delete(&stree);
+	free(sample);
+	/* the tables left by the samples are torn down */
+	arena_reset();
+	if (smallest.type == 0) {
+		fprintf(stderr, "Error: None of the configurations "
+				"can be used together with the other "
+				"options!\n");
+		return (2);
+	}
+	if (best.type == 0) {
+		fprintf(stderr, "Error: None of the configurations fits "
+				"into the memory budget of ");
+		print_human_readable_size(stderr, memory_budget);
+		fprintf(stderr, "!\nThe smallest estimated peak memory usage "
+				"is ");
+		print_human_readable_size(stderr, smallest.estimate);
+		fprintf(stderr, " (");
+		budget_print_configuration(stderr, &smallest);
+		fprintf(stderr, ").\n");
+		return (1);
+	}
+	printf("Selected the fastest configuration, which fits "
+			"into the memory budget:\n");
+	budget_print_configuration(stdout, &best);
+	printf("\n\n");
+	(*configuration) = best;
 	return (0);
 }
 
@@ -688,6 +2407,69 @@ int main (int argc, char **argv) {
 	long int prefix_length = (-1);
 	/* by default, we would like the traversal to be detailed */
 	int traversal_type = tt_detailed;
+	/* by default, the traversal log is human readable */
+	int traversal_format = tf_text;
+	/* by default, the traversal is serial */
+	size_t traversal_workers = 1;
+	/*
+	 * the width of the exported numbers in bytes, where the default
+	 * value of zero means the narrowest sufficient width
+	 */
+	size_t export_width = 0;
+	/* the export of the suffix array and of the LCP array */
+	array_export export = {.width = 0};
+	/* the wall-clock time and the memory usage of each phase */
+	phase_profile profile = {.phases = 0};
+	/*
+	 * if this variable evaluates to true, the hardware performance
+	 * counters will be recorded for each phase of the benchmark
+	 */
+	int counters = 0;
+	/*
+	 * the interval in milliseconds, in which the resident set size
+	 * is sampled, where the default value of zero means that it is
+	 * only read between the phases
+	 */
+	size_t sampling_interval = 0;
+	/* the name of the file, to which the phase profile is written */
+	char *profile_filename = NULL;
+	/* the phase profile of the current run, or NULL for a warm-up run */
+	phase_profile *run_profile = NULL;
+	/* the number of the measured runs of the benchmark */
+	size_t runs = 1;
+	/* the number of the warm-up runs preceding the measured ones */
+	size_t warmup_runs = 0;
+	/* the index of the current run, including the warm-up runs */
+	size_t run = 0;
+	/* the processor, to which this process is pinned (if requested) */
+	size_t cpu = 0;
+	/*
+	 * if this variable evaluates to true, this process
+	 * will be pinned to the processor cpu
+	 */
+	int cpu_set = 0;
+	/* the seed of the random number generator (if requested) */
+	unsigned int seed = 0;
+	/*
+	 * if this variable evaluates to true, the random number generator
+	 * will be seeded by the seed before each run, otherwise it is
+	 * seeded by the current time once
+	 */
+	int seed_set = 0;
+	/*
+	 * if this variable evaluates to true, the tables
+	 * will be allocated from the arena
+	 */
+	int use_arena = 0;
+	/*
+	 * the memory budget in bytes, or zero (0) if the configuration
+	 * of the suffix tree is specified by the user
+	 */
+	size_t memory_budget = 0;
+	/* the configuration of the suffix tree for the memory budget mode */
+	budget_configuration configuration = {.type = 0};
+	/* the return value of the benchmark of a single run */
+	int retval = 0;
 	/*
 	 * The pointer to the identification string
 	 * of the internal text encoding.
@@ -702,10 +2484,29 @@ int main (int argc, char **argv) {
 	char *input_file_encoding = "UTF-8";
 	char *input_filename = NULL;
 	char *dump_filename = NULL;
+	char *tnode_filename = NULL;
+	char *query_filename = NULL;
+	/*
+	 * The identification string of the internal encoding of the query,
+	 * which needs to be the same as the one of the text.
+	 */
+	char *query_encoding = NULL;
+	/*
+	 * if this variable evaluates to true, the table tnode
+	 * will be converted into the compact encoding
+	 */
+	int compact = 0;
+	/*
+	 * if this variable evaluates to true, the branching nodes
+	 * will be renumbered in the breadth-first order
+	 */
+	int relayout = 0;
 	char *algorithm_names[5] = {NULL};
 	character_type *text = NULL;
+	character_type *query = NULL;
 	FILE *stream = stdout;
 	size_t length = 0;
+	size_t query_length = 0;
 	algorithm_names[0] = NULL;
 	algorithm_names[1] = "simple McCreight's style";
 	algorithm_names[2] = "McCreight's";
@@ -724,7 +2525,9 @@ int main (int argc, char **argv) {
 		return (EXIT_SUCCESS);
 	}
 	/* parsing the command line options */
-	while ((getopt_retval = getopt(argc, argv, "t:a:b:p:r:c:sd:e:i:h")) !=
+	while ((getopt_retval = getopt(argc, argv,
+					"t:a:b:p:r:c:sd:o:e:i:w:zj:n:q:l"
+					"HI:J:N:U:A:S:x:M:h")) !=
 			(-1)) {
 		c = (char)(getopt_retval);
 		switch (c) {
@@ -782,6 +2585,16 @@ int main (int argc, char **argv) {
 					benchmark = 1;
 				} else if (optarg[0] == 'T') {
 					benchmark = 2;
+				} else if (optarg[0] == 'L') {
+					benchmark = 3;
+				} else if (optarg[0] == 'W') {
+					benchmark = 4;
+				} else if (optarg[0] == 'R') {
+					benchmark = 5;
+				} else if (optarg[0] == 'X') {
+					benchmark = 6;
+				} else if (optarg[0] == 'S') {
+					benchmark = 7;
 				} else {
 					fprintf(stderr, "Unrecognized "
 						"argument for the -b "
@@ -838,12 +2651,169 @@ int main (int argc, char **argv) {
 			case 'd':
 				dump_filename = optarg;
 				break;
+			case 'o':
+				if (strcmp(optarg, "text") == 0) {
+					traversal_format = tf_text;
+				} else if (strcmp(optarg, "bin") == 0) {
+					traversal_format = tf_binary;
+				} else {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -o "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				break;
 			case 'e':
 				input_file_encoding = optarg;
 				break;
 			case 'i':
 				internal_text_encoding_arg = optarg;
 				break;
+			case 'w':
+				tnode_filename = optarg;
+				break;
+			case 'z':
+				compact = 1;
+				break;
+			case 'l':
+				relayout = 1;
+				break;
+			case 'H':
+				counters = 1;
+				break;
+			case 'I':
+				sampling_interval = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -I "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(sampling_interval)");
+					/* resetting the errno */
+					errno = 0;
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'J':
+				profile_filename = optarg;
+				break;
+			case 'j':
+				traversal_workers = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -j "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(traversal_workers)");
+					/* resetting the errno */
+					errno = 0;
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'n':
+				if (strcmp(optarg, "32") == 0) {
+					export_width = 4;
+				} else if (strcmp(optarg, "64") == 0) {
+					export_width = 8;
+				} else {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -n "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'q':
+				query_filename = optarg;
+				break;
+			case 'N':
+				runs = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -N "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(runs)");
+					/* resetting the errno */
+					errno = 0;
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'U':
+				warmup_runs = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -U "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(warmup_runs)");
+					/* resetting the errno */
+					errno = 0;
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'A':
+				cpu = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -A "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(cpu)");
+					/* resetting the errno */
+					errno = 0;
+					return (EXIT_FAILURE);
+				}
+				cpu_set = 1;
+				break;
+			case 'S':
+				seed = (unsigned int)(strtoul(optarg,
+							&endptr, 0));
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -S "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(seed)");
+					/* resetting the errno */
+					errno = 0;
+					return (EXIT_FAILURE);
+				}
+				seed_set = 1;
+				break;
+			case 'x':
+				if (strcmp(optarg, "arena") == 0) {
+					use_arena = 1;
+				} else if (strcmp(optarg, "malloc") == 0) {
+					use_arena = 0;
+				} else {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -x "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'M':
+				if ((parse_size_with_unit(optarg,
+						&memory_budget) > 0) ||
+						(memory_budget == 0)) {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -M "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				break;
 			case 'h':
 				print_help(argv[0]);
 				return (EXIT_SUCCESS);
@@ -863,13 +2833,13 @@ int main (int argc, char **argv) {
 		return (EXIT_FAILURE);
 	}
 	/* command line options parsing complete */
-	if (type == 0) {
+	if ((type == 0) && (memory_budget == 0)) {
 		fprintf(stderr, "The -t parameter is mandatory "
 				"and it was not specified!\n\n");
 		print_usage(argv[0]);
 		return (EXIT_FAILURE);
 	}
-	if (algorithm == 0) {
+	if ((algorithm == 0) && (memory_budget == 0)) {
 		fprintf(stderr, "The -a parameter is mandatory "
 				"and it was not specified!\n\n");
 		print_usage(argv[0]);
@@ -882,7 +2852,8 @@ int main (int argc, char **argv) {
 		return (EXIT_FAILURE);
 	}
 	if (type == 3) {
-		if (algorithm != 5) {
+		/* the algorithm might be chosen by the memory budget mode */
+		if ((algorithm != 5) && (algorithm != 0)) {
 			fprintf(stderr, "Error: The selected implementation "
 					"type (LA)\n"
 					"does not support the desired "
@@ -918,18 +2889,70 @@ int main (int argc, char **argv) {
 			return (EXIT_FAILURE);
 		}
 	}
-	if ((dump_filename != NULL) && (benchmark != 2)) {
+	if ((dump_filename != NULL) &&
+			(benchmark != 2) && (benchmark != 6)) {
 		fprintf(stderr, "The -d parameter "
 				"can only be used with the traverse (T) "
+				"and export (X) types of benchmark!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((dump_filename == NULL) && (benchmark == 6)) {
+		fprintf(stderr, "The export (X) type of benchmark "
+				"requires the -d parameter!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((export_width != 0) && (benchmark != 6)) {
+		fprintf(stderr, "The -n parameter "
+				"can only be used with the export (X) "
 				"type of benchmark!\n");
 		return (EXIT_FAILURE);
 	}
+	if ((query_filename == NULL) && (benchmark == 7)) {
+		fprintf(stderr, "The matching statistics (S) type "
+				"of benchmark requires the -q parameter!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((query_filename != NULL) && (benchmark != 7)) {
+		fprintf(stderr, "The -q parameter "
+				"can only be used with the matching "
+				"statistics (S) type of benchmark!\n");
+		return (EXIT_FAILURE);
+	}
+	/*
+	 * The matching statistics need the suffix links,
+	 * which are kept only by the McCreight's and the Ukkonen's
+	 * algorithms in the SL and SH implementation types.
+	 * The memory budget mode chooses only such configurations.
+	 */
+	if ((benchmark == 7) && (memory_budget == 0) &&
+			(((type != 1) && (type != 2)) ||
+				((algorithm != 2) && (algorithm != 4)) ||
+				(variation != 0))) {
+		fprintf(stderr, "The matching statistics (S) type "
+				"of benchmark can only be used\nwith the SL "
+				"and SH implementation types, the M and U "
+				"algorithms\nand the default algorithm "
+				"variation!\n");
+		return (EXIT_FAILURE);
+	}
 	if ((traversal_type != tt_detailed) && (benchmark != 2)) {
 		fprintf(stderr, "The -s parameter "
 				"can only be used with the traverse (T) "
 				"type of benchmark!\n");
 		return (EXIT_FAILURE);
 	}
+	if ((traversal_format != tf_text) && (benchmark != 2)) {
+		fprintf(stderr, "The -o parameter "
+				"can only be used with the traverse (T) "
+				"type of benchmark!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((traversal_format != tf_text) && (dump_filename == NULL)) {
+		fprintf(stderr, "The -o bin parameter "
+				"can only be used together "
+				"with the -d parameter!\n");
+		return (EXIT_FAILURE);
+	}
 	if ((type != 2) && (crt_type != 0)) {
 		fprintf(stderr, "The -r parameter "
 				"can only be used with the SH "
@@ -961,8 +2984,67 @@ int main (int argc, char **argv) {
 				"implementation type!\n");
 		return (EXIT_FAILURE);
 	}
+	if ((type != 3) && (tnode_filename != NULL)) {
+		fprintf(stderr, "The -w parameter "
+				"can only be used with the LA "
+				"implementation type!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((type != 3) && (compact != 0)) {
+		fprintf(stderr, "The -z parameter "
+				"can only be used with the LA "
+				"implementation type!\n");
+		return (EXIT_FAILURE);
+	}
+	if (((type == 3) || (variation != 0)) &&
+			((relayout != 0) || ((benchmark == 3) &&
+					     (compact == 0)))) {
+		fprintf(stderr, "The -l parameter and the L benchmark "
+				"can only be used with the SL and SH\n"
+				"implementation types and the default "
+				"algorithm variation!\n"
+				"The L benchmark can also be used "
+				"with the LA implementation type\n"
+				"together with the -z parameter.\n");
+		return (EXIT_FAILURE);
+	}
+	if (traversal_workers == 0) {
+		fprintf(stderr, "The argument for the -j parameter "
+				"needs to be at least 1!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((traversal_workers > 1) && ((benchmark != 2) ||
+				(variation != 0) || (compact != 0))) {
+		fprintf(stderr, "The -j parameter "
+				"can only be used with the traverse (T) "
+				"type of benchmark,\nthe default algorithm "
+				"variation and without the -z parameter!\n");
+		return (EXIT_FAILURE);
+	}
+	if (runs == 0) {
+		fprintf(stderr, "The argument for the -N parameter "
+				"needs to be at least 1!\n");
+		return (EXIT_FAILURE);
+	}
+	/*
+	 * The repeated runs would overwrite the traversal log
+	 * and the exported arrays of each other.
+	 */
+	if ((runs > 1 || warmup_runs > 0) && (dump_filename != NULL)) {
+		fprintf(stderr, "The -d parameter can not be used "
+				"together with the repeated runs "
+				"(-N and -U parameters)!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((compact != 0) && (benchmark == 2) &&
+			(traversal_type != tt_simple)) {
+		fprintf(stderr, "The -z parameter "
+				"can only be used with "
+				"the simple traversal (-s)!\n");
+		return (EXIT_FAILURE);
+	}
 #ifdef	SUFFIX_TREE_TEXT_WIDE_CHAR
-	if ((type == 2) && (benchmark == 2)) {
+	if ((type == 2) && ((benchmark == 2) || (benchmark == 4))) {
 		fprintf(stderr, "Warning:\n"
 				"========\n"
 				"This program is compiled "
@@ -1009,12 +3091,50 @@ int main (int argc, char **argv) {
 		}
 		strcpy(internal_text_encoding, internal_text_encoding_arg);
 	}
+	/* the threads started afterwards inherit the pinning */
+	if ((cpu_set != 0) && (phase_profile_pin(cpu) > 0)) {
+		return (EXIT_FAILURE);
+	}
+	/* before any other thread is started */
+	if (phase_profile_open(counters, sampling_interval, &profile) > 0) {
+		return (EXIT_FAILURE);
+	}
+	if ((use_arena != 0) && (arena_open((size_t)(0)) > 0)) {
+		return (EXIT_FAILURE);
+	}
+	phase_profile_begin("reading", &profile);
 	if (text_read(input_filename, input_file_encoding,
 				&internal_text_encoding,
 				&text, &length) > 0) {
 		return (EXIT_FAILURE);
 	}
-	if (dump_filename != NULL) {
+	if (benchmark == 7) {
+		/* the query is read into the same encoding as the text */
+		query_encoding = calloc((size_t)(64), (size_t)(1));
+		if (query_encoding == NULL) {
+			perror("calloc(query_encoding)");
+			/* resetting the errno */
+			errno = 0;
+			return (EXIT_FAILURE);
+		} else {
+			/* resetting the errno */
+			errno = 0;
+		}
+		strcpy(query_encoding, internal_text_encoding);
+		if (text_read(query_filename, input_file_encoding,
+					&query_encoding,
+					&query, &query_length) > 0) {
+			return (EXIT_FAILURE);
+		}
+		free(query_encoding);
+		query_encoding = NULL;
+	}
+	if (benchmark == 6) {
+		if (array_export_open(dump_filename, export_width,
+					length, &export) > 0) {
+			return (EXIT_FAILURE);
+		}
+	} else if (dump_filename != NULL) {
 		/* if we got here, benchmark must be set to 2 */
 		stream = fopen(dump_filename, "w");
 		if (stream == NULL) {
@@ -1022,54 +3142,151 @@ int main (int argc, char **argv) {
 			return (EXIT_FAILURE);
 		}
 	}
+	/* the reading of the text is not repeated */
+	phase_profile_end(&profile);
 	/* random number generator initialization */
-	srandom((unsigned int)(time(NULL)));
-	if (variation == 0) {
-		switch (type) {
-			case 1:
-				benchmark_slli(stream, algorithm, benchmark,
+	if (seed_set == 0) {
+		srandom((unsigned int)(time(NULL)));
+	}
+	if (memory_budget > 0) {
+		phase_profile_begin("configuration", &profile);
+		configuration.type = type;
+		configuration.algorithm = algorithm;
+		configuration.variation = variation;
+		configuration.crt_type = crt_type;
+		configuration.chf_number = chf_number;
+		configuration.prefix_length = prefix_length;
+		if (budget_choose(memory_budget, &configuration,
+					benchmark, relayout,
+					traversal_workers,
+					internal_text_encoding,
+					text, length) > 0) {
+			phase_profile_close(&profile);
+			return (EXIT_FAILURE);
+		}
+		type = configuration.type;
+		algorithm = configuration.algorithm;
+		variation = configuration.variation;
+		crt_type = configuration.crt_type;
+		chf_number = configuration.chf_number;
+		prefix_length = configuration.prefix_length;
+		phase_profile_end(&profile);
+	}
+	for (run = 0; run < warmup_runs + runs; ++run) {
+		/* the warm-up runs are not recorded */
+		run_profile = run < warmup_runs ? NULL : &profile;
+		if (warmup_runs + runs > 1) {
+			if (run < warmup_runs) {
+				printf("\nWarm-up run %zu of %zu\n",
+						run + 1, warmup_runs);
+			} else {
+				printf("\nRun %zu of %zu\n",
+						run - warmup_runs + 1, runs);
+			}
+		}
+		/*
+		 * reseeding before each run, so that all the runs
+		 * choose the same Cuckoo hash functions
+		 */
+		if (seed_set != 0) {
+			srandom(seed);
+		}
+		if (variation == 0) {
+			switch (type) {
+				case 1:
+					retval = benchmark_slli(stream,
+						&export, run_profile,
+						query, query_length,
+						algorithm, benchmark,
 						traversal_type,
+						traversal_format,
+						traversal_workers, relayout,
 						internal_text_encoding,
 						text, length);
-				break;
-			case 2:
-				benchmark_shti(stream, algorithm, benchmark,
+					break;
+				case 2:
+					retval = benchmark_shti(stream,
+						&export, run_profile,
+						query, query_length,
+						algorithm, benchmark,
 						traversal_type,
-						crt_type, chf_number,
+						traversal_format,
+						traversal_workers,
+						crt_type, chf_number, relayout,
 						internal_text_encoding,
 						text, length);
-				break;
-			case 3:
-				benchmark_slai(stream, algorithm, benchmark,
+					break;
+				case 3:
+					retval = benchmark_slai(stream,
+						&export, run_profile,
+						algorithm, benchmark,
 						prefix_length, traversal_type,
+						traversal_format,
+						traversal_workers,
+						tnode_filename, compact,
 						internal_text_encoding,
 						text, length);
-				break;
-		}
-	} else {
-		switch (type) {
-			case 1:
-				benchmark_slli_bp(stream, algorithm, benchmark,
+					break;
+			}
+		} else {
+			switch (type) {
+				case 1:
+					retval = benchmark_slli_bp(stream,
+						&export, run_profile,
+						algorithm, benchmark,
 						traversal_type,
+						traversal_format,
 						internal_text_encoding,
 						text, length);
-				break;
-			case 2:
-				benchmark_shti_bp(stream, algorithm, benchmark,
+					break;
+				case 2:
+					retval = benchmark_shti_bp(stream,
+						&export, run_profile,
+						algorithm, benchmark,
 						traversal_type,
+						traversal_format,
 						crt_type, chf_number,
 						internal_text_encoding,
 						text, length);
-				break;
-			case 3:
-				fprintf(stderr, "Error: The selected "
+					break;
+				case 3:
+					fprintf(stderr, "Error: The selected "
 						"implementation technique "
 						" (LA)\ndoes not support "
 						"the desired algorithm "
 						"variation (B)!\n");
-				break;
+					retval = 1;
+					break;
+			}
+		}
+		/* the last phase of the run ends with the run */
+		phase_profile_end(run_profile);
+		/* the tables left by the run are torn down at once */
+		if (arena_reset() > 0) {
+			retval = 1;
+		}
+		if (retval > 0) {
+			/* there is no point in repeating a failed run */
+			break;
 		}
 	}
+	phase_profile_finish(&profile);
+	printf("\n");
+	phase_profile_print(stdout, &profile);
+	if (runs > 1) {
+		printf("\n");
+		phase_profile_print_summary(stdout, &profile);
+	}
+	printf("\n");
+	arena_print_stats(stdout);
+	arena_close();
+	if ((profile_filename != NULL) &&
+			(phase_profile_write_json(profile_filename,
+						  &profile) > 0)) {
+		phase_profile_close(&profile);
+		return (EXIT_FAILURE);
+	}
+	phase_profile_close(&profile);
 	getrusage(RUSAGE_SELF, &resource_usage_struct);
 	printf("\nFinal CPU and memory statistics:\n"
 			"--------------------------------\n");
@@ -1101,7 +3318,11 @@ int main (int argc, char **argv) {
 			maximum_rss_size);
 	print_human_readable_size(stdout, maximum_rss_size);
 	printf(")\n");
-	if (dump_filename != NULL) {
+	if (benchmark == 6) {
+		if (array_export_close(&export) > 0) {
+			return (EXIT_FAILURE);
+		}
+	} else if (dump_filename != NULL) {
 		if (fclose(stream) == EOF) {
 			perror("fclose(stream)");
 			return (EXIT_FAILURE);
@@ -1109,9 +3330,14 @@ int main (int argc, char **argv) {
 	}
 	free(internal_text_encoding);
 	internal_text_encoding = NULL;
+	free(query);
+	query = NULL;
 	printf("\nTrying to free the memory allocated for the text\n");
 	free(text);
 	text = NULL;
 	printf("Successfully freed!\n");
+	if (retval > 0) {
+		return (EXIT_FAILURE);
+	}
 	return (EXIT_SUCCESS);
 }
@@ -26,6 +26,7 @@
  * using the implementation type SLAI.
  */
 #include "pwotd_cdata_common.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <iconv.h>
@@ -103,7 +104,7 @@ int pwotd_cdata_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(cdata->tsuffixes);
+	arena_free(cdata->tsuffixes);
 	cdata->tsuffixes = NULL;
 	printf("Trying to allocate memory for the table of suffixes:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -112,7 +113,7 @@ int pwotd_cdata_allocate (size_t length,
 	print_human_readable_size(stdout,
 			tsuffixes_size * cdata->s_size);
 	printf(").\n");
-	cdata->tsuffixes = calloc(tsuffixes_size, cdata->s_size);
+	cdata->tsuffixes = arena_calloc(tsuffixes_size, cdata->s_size);
 	if (cdata->tsuffixes == NULL) {
 		perror("calloc(cdata->tsuffixes)");
 		/* resetting the errno */
@@ -129,7 +130,7 @@ int pwotd_cdata_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(cdata->tsuffixes_tmp);
+	arena_free(cdata->tsuffixes_tmp);
 	/*
 	 * We do not allocate the memory for the temporary table
 	 * of suffixes here. Instead, we postpone the allocation
@@ -153,7 +154,7 @@ int pwotd_cdata_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(cdata->partitions);
+	arena_free(cdata->partitions);
 	/*
 	 * Also, the memory for the partitions will not be allocated yet,
 	 * but it will be allocated as soon as the partitioning phase begins.
@@ -193,7 +194,7 @@ int pwotd_cdata_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(cdata->partitions_tbp);
+	arena_free(cdata->partitions_tbp);
 	/*
 	 * Similarly, the memory for the entries corresponding to
 	 * all the partitions, which need to be further processed,
@@ -233,7 +234,7 @@ int pwotd_cdata_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(cdata->partitions_stack);
+	arena_free(cdata->partitions_stack);
 	/*
 	 * This pointer is also set to NULL for now.
 	 * The stack of the unevaluated ranges of partitions will be used
@@ -283,7 +284,7 @@ int pwotd_cdata_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(cdata->stack);
+	arena_free(cdata->stack);
 	cdata->stack = NULL;
 	printf("Trying to allocate the memory for the stack:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -291,7 +292,7 @@ int pwotd_cdata_allocate (size_t length,
 			stack_size * cdata->sr_size);
 	print_human_readable_size(stdout, stack_size * cdata->sr_size);
 	printf(").\n");
-	cdata->stack = calloc(stack_size, cdata->sr_size);
+	cdata->stack = arena_calloc(stack_size, cdata->sr_size);
 	if (cdata->stack == NULL) {
 		perror("calloc(cdata->stack)");
 		/* resetting the errno */
@@ -392,7 +393,7 @@ int pwotd_cdata_tsuffixes_tmp_reallocate (size_t desired_tsuffixes_tmp_size,
 		print_human_readable_size(stdout,
 				tsuffixes_tmp_size * cdata->s_size);
 		printf(").\n");
-		tmp_pointer = realloc(cdata->tsuffixes_tmp,
+		tmp_pointer = arena_realloc(cdata->tsuffixes_tmp,
 				tsuffixes_tmp_size * cdata->s_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(cdata->tsuffixes_tmp)");
@@ -420,7 +421,7 @@ int pwotd_cdata_tsuffixes_tmp_reallocate (size_t desired_tsuffixes_tmp_size,
 				"for the temporary table of suffixes: "
 				"new size:\n0 cells of %zu bytes "
 				"(totalling 0 bytes).\n", cdata->s_size);
-		free(cdata->tsuffixes_tmp);
+		arena_free(cdata->tsuffixes_tmp);
 		cdata->tsuffixes_tmp = NULL;
 		deallocated_size += cdata->tsuffixes_tmp_size * cdata->s_size;
 		printf("Successfully deallocated!\n");
@@ -503,7 +504,7 @@ int pwotd_cdata_partitions_reallocate (size_t desired_partitions_size,
 		print_human_readable_size(stdout,
 				partitions_size * cdata->pr_size);
 		printf(").\n");
-		tmp_pointer = realloc(cdata->partitions,
+		tmp_pointer = arena_realloc(cdata->partitions,
 				partitions_size * cdata->pr_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(cdata->partitions)");
@@ -543,7 +544,7 @@ int pwotd_cdata_partitions_reallocate (size_t desired_partitions_size,
 				"for the table of partitions: "
 				"new size:\n0 cells of %zu bytes "
 				"(totalling 0 bytes).\n", cdata->pr_size);
-		free(cdata->partitions);
+		arena_free(cdata->partitions);
 		cdata->partitions = NULL;
 		deallocated_size += cdata->partitions_size * cdata->pr_size;
 		printf("Successfully deallocated!\n");
@@ -631,7 +632,7 @@ int pwotd_cdata_partitions_tbp_reallocate (size_t desired_partitions_tbp_size,
 		print_human_readable_size(stdout,
 				partitions_tbp_size * cdata->ppr_size);
 		printf(").\n");
-		tmp_pointer = realloc(cdata->partitions_tbp,
+		tmp_pointer = arena_realloc(cdata->partitions_tbp,
 				partitions_tbp_size * cdata->ppr_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(cdata->partitions_tbp)");
@@ -677,7 +678,7 @@ int pwotd_cdata_partitions_tbp_reallocate (size_t desired_partitions_tbp_size,
 				"of the partitions to be processed: "
 				"new size:\n0 cells of %zu bytes "
 				"(totalling 0 bytes).\n", cdata->ppr_size);
-		free(cdata->partitions_tbp);
+		arena_free(cdata->partitions_tbp);
 		cdata->partitions_tbp = NULL;
 		deallocated_size +=
 			cdata->partitions_tbp_size * cdata->ppr_size;
@@ -767,7 +768,7 @@ int pwotd_cdata_partitions_stack_reallocate (
 		print_human_readable_size(stdout,
 				partitions_stack_size * cdata->psr_size);
 		printf(").\n");
-		tmp_pointer = realloc(cdata->partitions_stack,
+		tmp_pointer = arena_realloc(cdata->partitions_stack,
 				partitions_stack_size * cdata->psr_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(cdata->partitions_stack)");
@@ -812,7 +813,7 @@ int pwotd_cdata_partitions_stack_reallocate (
 				"of the unevaluated ranges of partitions: "
 				"new size:\n0 cells of %zu bytes "
 				"(totalling 0 bytes).\n", cdata->psr_size);
-		free(cdata->partitions_stack);
+		arena_free(cdata->partitions_stack);
 		cdata->partitions_stack = NULL;
 		deallocated_size += cdata->partitions_stack_size *
 			cdata->psr_size;
@@ -895,7 +896,7 @@ int pwotd_cdata_stack_reallocate (size_t desired_stack_size,
 		print_human_readable_size(stdout,
 				stack_size * cdata->sr_size);
 		printf(").\n");
-		tmp_pointer = realloc(cdata->stack,
+		tmp_pointer = arena_realloc(cdata->stack,
 				stack_size * cdata->sr_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(cdata->stack)");
@@ -935,7 +936,7 @@ int pwotd_cdata_stack_reallocate (size_t desired_stack_size,
 				"for the stack: new size:\n"
 				"0 cells of %zu bytes "
 				"(totalling 0 bytes).\n", cdata->sr_size);
-		free(cdata->stack);
+		arena_free(cdata->stack);
 		cdata->stack = NULL;
 		deallocated_size += cdata->stack_size * cdata->sr_size;
 		printf("Successfully deallocated!\n");
@@ -970,24 +971,24 @@ int pwotd_cdata_deallocate (pwotd_construction_data *cdata) {
 			(cdata->stack == NULL)) {
 		return (-1); /* nothing to deallocate */ }
 	printf("Deallocating the suffix tree construction data.\n");
-	free(cdata->tsuffixes);
+	arena_free(cdata->tsuffixes);
 	cdata->tsuffixes = NULL;
 	deallocated_size += cdata->tsuffixes_size * cdata->s_size;
-	free(cdata->tsuffixes_tmp);
+	arena_free(cdata->tsuffixes_tmp);
 	cdata->tsuffixes_tmp = NULL;
 	deallocated_size += cdata->tsuffixes_tmp_size * cdata->s_size;
-	free(cdata->partitions);
+	arena_free(cdata->partitions);
 	cdata->partitions = NULL;
 	deallocated_size += cdata->partitions_size * cdata->pr_size;
-	free(cdata->partitions_tbp);
+	arena_free(cdata->partitions_tbp);
 	cdata->partitions_tbp = NULL;
 	deallocated_size += cdata->partitions_tbp_size * cdata->ppr_size;
 	/* resetting the pointer to the current partition to NULL */
 	cdata->current_partition = NULL;
-	free(cdata->partitions_stack);
+	arena_free(cdata->partitions_stack);
 	cdata->partitions_stack = NULL;
 	deallocated_size += cdata->partitions_stack_size * cdata->psr_size;
-	free(cdata->stack);
+	arena_free(cdata->stack);
 	cdata->stack = NULL;
 	deallocated_size += cdata->stack_size * cdata->sr_size;
 	/*
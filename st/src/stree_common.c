@@ -24,7 +24,7 @@
  * which are used for the construction
  * of the suffix tree in the memory.
  */
-#include "suffix_tree_common.h"
+#include "stree_common.h"
 
 #include <errno.h>
 #include <fcntl.h>
@@ -48,6 +48,34 @@
  */
 const size_t extra_allocated_characters = 3;
 
+/**
+ * The desired number of the parallel traversal tasks per worker.
+ * There need to be more tasks than workers, because the sizes
+ * of the subtrees differ a lot.
+ */
+const size_t traversal_pool_tasks_per_worker = 16;
+
+/**
+ * The maximum number of the levels, to which the subtrees
+ * of the root are split into the parallel traversal tasks.
+ * It stops the splitting of the degenerated trees,
+ * which could otherwise continue almost indefinitely.
+ */
+const size_t traversal_pool_max_levels = 8;
+
+/**
+ * The number of the tasks per worker, which can be printed in advance
+ * of the task, which is to be appended to the traversal output next.
+ * It limits the memory used by the outputs of the finished tasks.
+ */
+const size_t traversal_pool_window_per_worker = 2;
+
+/**
+ * The initial number of the frames and of the left characters
+ * allocated by the repeat analysis. Both are doubled on demand.
+ */
+const size_t repeat_analysis_initial_size = 64;
+
 /* reading function */
 
 /**
@@ -469,11 +497,10 @@ int text_read (const char *file_name,
 
 /**
  * A function which prints the edge from parent to the child
- * within a suffix tree in human readable format.
+ * within a suffix tree to the traversal output.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
- * 		will be written
+ * output	the buffered output, to which the edge will be written
  * @param
  * print_terminating_character	If this variable evaluates to true,
  * 				this function will print the dollar sign ($)
@@ -501,15 +528,12 @@ int text_read (const char *file_name,
  * 			composed of the letters on the path
  * 			from the root to the child.
  * @param
- * internal_character_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  *
  * @return	If we could successfully print the edge, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_print_edge (FILE *stream,
+int st_print_edge (traversal_output *output,
 		int print_terminating_character,
 		signed_integral_type parent,
 		signed_integral_type child,
@@ -519,171 +543,12 @@ int st_print_edge (FILE *stream,
 		size_t log10bn,
 		size_t log10l,
 		size_t childs_offset,
-		const char *internal_character_encoding,
 		const character_type *text) {
-	/*
-	 * The format string buffer. Its length should never exceed 128.
-	 * All its characters (not only the first one) are initialized
-	 * to zero automatically.
-	 */
-	static char fs_buffer[128] = {0};
-	/*
-	 * The text string buffer. Its length should never exceed 512.
-	 * It has space for at least 128 4-byte UTF-8 characters,
-	 * which should be sufficient for our purposes, as the maximum
-	 * number of bytes used by any single UTF-8 character is 4.
-	 * All its characters (not only the first one) are initialized
-	 * to zero automatically.
-	 */
-	static char text_buffer[512] = {0};
-	/*
-	 * By default, we suppose that the current locale supports
-	 * the character encoding UTF-8 and that's why we print
-	 * the underlying text of the suffix tree using this encoding.
-	 */
-	static char *tocode = "UTF-8";
-	/* the length of the text which forms the parent->child edge label */
-	size_t text_length = childs_depth - parents_depth;
-	/* the conversion descriptor used by the iconv */
-	iconv_t cd = NULL; /* iconv_t is just a typedef for void* */
-	/* the variables used by the iconv */
-	char *inbuf = NULL;
-	char *outbuf = NULL;
-	size_t inbytesleft = 0;
-	size_t outbytesleft = 0;
-	/* the return value of the iconv */
-	size_t retval = 0;
-	if (childs_depth < parents_depth) {
-		fprintf(stderr,	"Error: Something went wrong.\n"
-				"The child (%d) has the depth of %u,\n"
-				"but its parent (%d) has the depth "
-				"of %u,\nwhich should never happen!\n",
-				child, childs_depth, parent, parents_depth);
-		fprintf(stderr,	"The traversal of this branch "
-				"is terminated here.\n");
-		return (1);
-	}
-	/* at first, we can safely print the parent */
-	if (parent == 0) {
-		fprintf(stream, "P(?)[%u]", parents_depth);
-	} else {
-		fprintf(stream, "P(%0*d)[%u]", (int)(log10bn), parent,
-				parents_depth);
-	}
-	/* we create the desired conversion descriptor */
-	if ((cd = iconv_open(tocode, internal_character_encoding)) ==
-			(iconv_t)(-1)) {
-		perror("st_print_edge: iconv_open");
-		/* resetting the errno */
-		errno = 0;
-		return (2);
-	}
-	/* we print the edge label */
-	if (text_length < 33) {
-		inbuf = (char *)(text + childs_offset + parents_depth);
-		if (print_terminating_character == 0) {
-			sprintf(fs_buffer, "--\"%%s\"(%zu)-->", text_length);
-			inbytesleft = text_length * character_type_size;
-		} else {
-			/*
-			 * we do not want the terminating character
-			 * to be printed from the memory as is, so
-			 * we print the dollar sign ($) instead
-			 */
-			sprintf(fs_buffer, "--\"%%s$\"(%zu)-->", text_length);
-			inbytesleft = (text_length - 1) * character_type_size;
-		}
-		outbuf = text_buffer;
-		outbytesleft = 511;
-		retval = iconv(cd, &inbuf, &inbytesleft,
-				&outbuf, &outbytesleft);
-		/* if the iconv has encountered an error */
-		if (inbytesleft > 0 || retval != 0) {
-			perror("st_print_edge: iconv 1");
-			/* resetting the errno */
-			errno = 0;
-			return (3);
-		}
-		/* we make sure that the string is safely printable */
-		(*outbuf) = 0;
-		fprintf(stream, fs_buffer, text_buffer);
-	} else { /* text_length >= 33 */
-		inbuf = (char *)(text + childs_offset + parents_depth);
-		inbytesleft = 15 * character_type_size;
-		outbuf = text_buffer;
-		outbytesleft = 255;
-		retval = iconv(cd, &inbuf, &inbytesleft,
-				&outbuf, &outbytesleft);
-		/* if the iconv has encountered an error */
-		if (inbytesleft > 0 || retval != 0) {
-			perror("st_print_edge: iconv 2");
-			/* resetting the errno */
-			errno = 0;
-			return (4);
-		}
-		/* we make sure that the string is safely printable */
-		(*outbuf) = 0;
-		inbuf = (char *)(text + childs_offset + childs_depth - 15);
-		if (print_terminating_character == 0) {
-			sprintf(fs_buffer, "--\"%%s...%%s\"(%zu)-->",
-					text_length);
-			inbytesleft = 15 * character_type_size;
-		} else {
-			/*
-			 * we do not want the terminating character
-			 * to be printed from the memory as is, so
-			 * we print the dollar sign ($) instead
-			 */
-			sprintf(fs_buffer, "--\"%%s...%%s$\"(%zu)-->",
-					text_length);
-			inbytesleft = 14 * character_type_size;
-		}
-		outbuf = text_buffer + 256;
-		outbytesleft = 255;
-		retval = iconv(cd, &inbuf, &inbytesleft,
-				&outbuf, &outbytesleft);
-		/* if the iconv has encountered an error */
-		if (inbytesleft > 0 || retval != 0) {
-			perror("st_print_edge: iconv 3");
-			/* resetting the errno */
-			errno = 0;
-			return (5);
-		}
-		/* we make sure that the string is safely printable */
-		(*outbuf) = 0;
-		fprintf(stream, fs_buffer, text_buffer, text_buffer + 256);
-	}
-	/* now we can safely print the child */
-	if (child == 0) {
-		fprintf(stream, "C(?)[%u]", childs_depth);
-	} else if (child > 0) {
-		fprintf(stream, "C(%0*d)[%u]", (int)(log10bn), child,
-				childs_depth);
-	} else { /* child < 0 => child is a leaf */
-		fprintf(stream, "C(%0*d)[%u]", (int)(log10l), child,
-				childs_depth);
-	}
-	/* and finally, we can optionally print the suffix link */
-	if (childs_suffix_link == 0) {
-		fprintf(stream, "\n");
-	} else {
-		fprintf(stream, "{%0*d}\n", (int)(log10bn),
-				childs_suffix_link);
-	}
-	/* we delete the conversion descriptor used by the iconv */
-	if (iconv_close(cd) == (-1)) {
-		perror("st_print_edge: iconv_close");
-		/* resetting the errno */
-		errno = 0;
-		return (6);
-	}
-	if (errno != 0) {
-		perror("st_print_edge: printf");
-		/* resetting the errno */
-		errno = 0;
-		return (7);
-	}
-	return (0);
+	/* the text of the in-memory suffix tree never wraps */
+	return (traversal_output_edge(print_terminating_character,
+				parent, child, childs_suffix_link,
+				parents_depth, childs_depth, log10bn, log10l,
+				childs_offset, text, (size_t)(0), output));
 }
 
 /**
@@ -985,3 +850,876 @@ int st_print_stats (size_t length,
 			(long double)(allocated_size));
 	return (0);
 }
+
+/* parallel traversal functions */
+
+/**
+ * A function which appends a new task to the end
+ * of the parallel traversal pool.
+ *
+ * @param
+ * parent	the parent of the edge printed by the task
+ * @param
+ * child	the child of the edge printed by the task
+ * @param
+ * offset	the offset of the child in the array-based representations
+ * @param
+ * parents_depth	the depth of the parent
+ * @param
+ * pool		the parallel traversal pool
+ *
+ * @return	If the task has been successfully added, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_pool_add (signed_integral_type parent,
+		signed_integral_type child,
+		size_t offset,
+		unsigned_integral_type parents_depth,
+		traversal_pool *pool) {
+	traversal_task *tasks = NULL;
+	traversal_task *task = NULL;
+	size_t size = 0;
+	if (pool->count == pool->size) {
+		size = pool->size > 0 ? 2 * pool->size :
+			traversal_pool_tasks_per_worker;
+		tasks = realloc(pool->tasks, size * sizeof (traversal_task));
+		if (tasks == NULL) {
+			perror("traversal_pool_add: realloc");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
+		pool->tasks = tasks;
+		pool->size = size;
+	}
+	task = pool->tasks + pool->count;
+	memset(task, 0, sizeof (traversal_task));
+	task->edge.node = parent;
+	task->edge.child = child;
+	task->edge.offset = offset;
+	task->edge.depth = parents_depth;
+	++pool->count;
+	return (0);
+}
+
+/**
+ * A function which splits the tasks of the parallel traversal pool
+ * level by level, until there are at least the desired number of them.
+ * Each task, whose child is a branching node, is replaced
+ * by a task printing just its edge, followed by the tasks
+ * for all the children of its child, so the order of the edges
+ * remains the same.
+ *
+ * @param
+ * desired_tasks	the desired number of the tasks
+ * @param
+ * pool		the parallel traversal pool
+ *
+ * @return	If the tasks have been successfully split, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_pool_split (size_t desired_tasks,
+		traversal_pool *pool) {
+	traversal_task *tasks = NULL;
+	size_t count = 0;
+	size_t level = 0;
+	size_t i = 0;
+	/* the index of the task printing just the edge */
+	size_t edge_task = 0;
+	int retval = 0;
+	for (level = 0; (level < traversal_pool_max_levels) &&
+			(pool->count < desired_tasks); ++level) {
+		tasks = pool->tasks;
+		count = pool->count;
+		pool->tasks = NULL;
+		pool->count = 0;
+		pool->size = 0;
+		for (i = 0; i < count; ++i) {
+			edge_task = pool->count;
+			if (traversal_pool_add(tasks[i].edge.node,
+						tasks[i].edge.child,
+						tasks[i].edge.offset,
+						tasks[i].edge.depth,
+						pool) > 0) {
+				free(tasks);
+				return (1);
+			}
+			pool->tasks[edge_task].edge_only = 1;
+			if (tasks[i].edge_only != 0) {
+				continue;
+			}
+			if ((retval = pool->split(&tasks[i], pool)) < 0) {
+				/* the child is a leaf, so it stays whole */
+				pool->tasks[edge_task].edge_only = 0;
+			} else if (retval > 0) {
+				free(tasks);
+				return (2);
+			}
+		}
+		free(tasks);
+		if (pool->count == count) {
+			/* there was nothing left to split */
+			break;
+		}
+	}
+	return (0);
+}
+
+#ifdef	ST_USE_PTHREAD
+/**
+ * A function which is run by each worker thread
+ * of the parallel traversal. It prints the tasks into their own outputs
+ * kept in the memory, until all of them have been taken.
+ * Before printing a task, it waits until the task gets
+ * into the window of the tasks, which can be printed in advance.
+ *
+ * @param
+ * ptr		the parallel traversal pool
+ *
+ * @return	This function always returns NULL.
+ */
+void *traversal_pool_worker (void *ptr) {
+	traversal_pool *pool = (traversal_pool *)(ptr);
+	/* the explicit stack of this worker */
+	traversal_stack stack = {NULL, 0, 0};
+	traversal_task *task = NULL;
+	size_t i = 0;
+	/* if this variable evaluates to true, the task has an output */
+	int reused = 0;
+	while ((i = __atomic_fetch_add(&pool->next_task, 1,
+					__ATOMIC_SEQ_CST)) < pool->count) {
+		task = pool->tasks + i;
+		reused = 0;
+		pthread_mutex_lock(&pool->mx);
+		while ((i >= pool->appended + pool->window) &&
+				(pool->failed == 0)) {
+			pthread_cond_wait(&pool->appended_cv, &pool->mx);
+		}
+		if (pool->spare_count > 0) {
+			task->output = pool->spares[--pool->spare_count];
+			reused = 1;
+		}
+		pthread_mutex_unlock(&pool->mx);
+		if (__atomic_load_n(&pool->failed, __ATOMIC_SEQ_CST) != 0) {
+			task->retval = 1;
+		} else if ((reused == 0) && (traversal_output_open(NULL,
+						pool->output->format,
+						pool->output->encoding,
+						&task->output) > 0)) {
+			task->retval = 2;
+		} else if (pool->process(&task->output, task,
+					&stack, pool) > 0) {
+			task->retval = 3;
+		}
+		if ((task->retval != 0) && ((reused != 0) ||
+					(task->retval == 3))) {
+			traversal_output_close(&task->output);
+		}
+		pthread_mutex_lock(&pool->mx);
+		if (task->retval != 0) {
+			pool->failed = 1;
+			pthread_cond_broadcast(&pool->appended_cv);
+		}
+		task->done = 1;
+		pthread_cond_signal(&pool->cv);
+		pthread_mutex_unlock(&pool->mx);
+	}
+	traversal_stack_free(&stack);
+	return (NULL);
+}
+#endif
+
+/**
+ * A function which prints all the tasks of the parallel traversal pool
+ * to the traversal output by a fixed pool of the worker threads.
+ * The outputs of the tasks are appended in the original order
+ * of the tasks, as soon as they are finished.
+ * If there is only a single worker, or if the POSIX threads
+ * are disabled, the tasks are printed one after another
+ * by the calling thread directly to the traversal output.
+ *
+ * @param
+ * workers	the desired number of the worker threads
+ * @param
+ * output	the traversal output, to which the tasks are printed
+ * @param
+ * pool		the parallel traversal pool
+ *
+ * @return	If all the tasks have been successfully printed,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int traversal_pool_run (size_t workers,
+		traversal_output *output,
+		traversal_pool *pool) {
+	/* the explicit stack of the serial traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	size_t i = 0;
+	int error = 0;
+#ifdef	ST_USE_PTHREAD
+	traversal_task *task = NULL;
+	pthread_t *threads = NULL;
+	size_t started = 0;
+	int retval = 0;
+#endif
+	pool->next_task = 0;
+	pool->failed = 0;
+	pool->output = output;
+	pool->appended = 0;
+	pool->spare_count = 0;
+	if (workers > pool->count) {
+		workers = pool->count;
+	}
+#ifdef	ST_USE_PTHREAD
+	if (workers > 1) {
+		pool->window = workers * traversal_pool_window_per_worker;
+		threads = calloc(workers, sizeof (pthread_t));
+		pool->spares = calloc(pool->window,
+				sizeof (traversal_output));
+		if ((threads == NULL) || (pool->spares == NULL)) {
+			perror("traversal_pool_run: calloc(threads)");
+			/* resetting the errno */
+			errno = 0;
+			free(threads);
+			free(pool->spares);
+			pool->spares = NULL;
+			return (1);
+		}
+		pthread_mutex_init(&pool->mx, NULL);
+		pthread_cond_init(&pool->cv, NULL);
+		pthread_cond_init(&pool->appended_cv, NULL);
+		for (i = 0; i < workers; ++i) {
+			if ((retval = pthread_create(&threads[i], NULL,
+						traversal_pool_worker,
+						pool)) != 0) {
+				fprintf(stderr, "traversal_pool_run:\n");
+				errno = retval; /* retval != 0 */
+				perror("pthread_create");
+				/* resetting the errno */
+				errno = 0;
+				break;
+			}
+			++started;
+		}
+		/*
+		 * The outputs of the tasks are appended in their order,
+		 * while the workers are still printing the next tasks.
+		 * If no worker could be started, the tasks are printed
+		 * by this thread below.
+		 */
+		for (i = 0; (started > 0) && (i < pool->count); ++i) {
+			task = pool->tasks + i;
+			pthread_mutex_lock(&pool->mx);
+			while (task->done == 0) {
+				pthread_cond_wait(&pool->cv, &pool->mx);
+			}
+			pthread_mutex_unlock(&pool->mx);
+			if ((task->retval != 0) && (error == 0)) {
+				error = 2;
+			} else if ((task->retval == 0) && (error == 0) &&
+					(traversal_output_append(
+						&task->output, output) > 0)) {
+				error = 3;
+			}
+			pthread_mutex_lock(&pool->mx);
+			if (task->retval == 0) {
+				/* the output of the task can be reused */
+				task->output.top = 0;
+				pool->spares[pool->spare_count++] =
+					task->output;
+			}
+			if (error != 0) {
+				pool->failed = 1;
+			}
+			pool->appended = i + 1;
+			pthread_cond_broadcast(&pool->appended_cv);
+			pthread_mutex_unlock(&pool->mx);
+		}
+		for (i = 0; i < started; ++i) {
+			if ((retval = pthread_join(threads[i], NULL)) != 0) {
+				fprintf(stderr, "traversal_pool_run:\n");
+				errno = retval; /* retval != 0 */
+				perror("pthread_join");
+				/* resetting the errno */
+				errno = 0;
+				error = 4;
+			}
+		}
+		while (pool->spare_count > 0) {
+			traversal_output_close(
+					&pool->spares[--pool->spare_count]);
+		}
+		pthread_cond_destroy(&pool->appended_cv);
+		pthread_cond_destroy(&pool->cv);
+		pthread_mutex_destroy(&pool->mx);
+		free(pool->spares);
+		pool->spares = NULL;
+		free(threads);
+		if (started > 0) {
+			return (error);
+		}
+	}
+#endif
+	for (i = 0; (error == 0) && (i < pool->count); ++i) {
+		if (pool->process(output, pool->tasks + i,
+					&stack, pool) > 0) {
+			error = 2;
+		}
+	}
+	traversal_stack_free(&stack);
+	return (error);
+}
+
+/**
+ * A function which deallocates the tasks of the parallel traversal pool.
+ *
+ * @param
+ * pool		the parallel traversal pool
+ */
+void traversal_pool_free (traversal_pool *pool) {
+	free(pool->tasks);
+	pool->tasks = NULL;
+	pool->count = 0;
+	pool->size = 0;
+}
+
+/**
+ * A function which performs the whole parallel traversal.
+ * The pool needs to contain the tasks for all the children
+ * of the root. These tasks are split, printed by the worker threads
+ * and then deallocated.
+ *
+ * @param
+ * workers	the desired number of the worker threads
+ * @param
+ * output	the traversal output, to which the tasks are printed
+ * @param
+ * pool		the parallel traversal pool
+ *
+ * @return	If the traversal has been successful, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int traversal_pool_traverse (size_t workers,
+		traversal_output *output,
+		traversal_pool *pool) {
+	int retval = 0;
+	if (traversal_pool_split(workers * traversal_pool_tasks_per_worker,
+				pool) > 0) {
+		retval = 1;
+	} else if (traversal_pool_run(workers, output, pool) > 0) {
+		retval = 2;
+	}
+	traversal_pool_free(pool);
+	return (retval);
+}
+
+/**
+ * A function which starts the summary of a branching node
+ * in the repeat analysis. It has to be called before visiting
+ * any of the children of the node.
+ *
+ * @param
+ * depth	the string depth of the branching node
+ * @param
+ * position	the position in the text of an occurrence
+ * 		of the string of the branching node
+ * @param
+ * analysis	the repeat analysis
+ *
+ * @return	If the summary has been successfully started, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int repeat_analysis_enter (unsigned_integral_type depth,
+		size_t position,
+		repeat_analysis *analysis) {
+	repeat_frame *tmp_pointer = NULL;
+	repeat_frame *frame = NULL;
+	size_t new_size = 0;
+	if (analysis->top > 0) {
+		analysis->frames[analysis->top - 1].only_leaves = 0;
+	}
+	if (analysis->top == analysis->size) {
+		if (analysis->size == 0) {
+			new_size = repeat_analysis_initial_size;
+		} else {
+			new_size = analysis->size << 1;
+		}
+		tmp_pointer = realloc(analysis->frames,
+				new_size * sizeof (repeat_frame));
+		if (tmp_pointer == NULL) {
+			perror("repeat_analysis_enter: realloc");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		} else {
+			/*
+			 * Despite that the call to the realloc seems
+			 * to have been successful, we reset the errno,
+			 * because at least on Mac OS X
+			 * it might have changed.
+			 */
+			errno = 0;
+			analysis->frames = tmp_pointer;
+		}
+		analysis->size = new_size;
+	}
+	frame = analysis->frames + analysis->top;
+	frame->depth = depth;
+	frame->position = position;
+	frame->left = 0;
+	frame->lefts = 0;
+	frame->only_leaves = 1;
+	++analysis->top;
+	analysis->lefts_top = 0;
+	return (0);
+}
+
+/**
+ * A function which adds a leaf to the summary
+ * of the topmost branching node in the repeat analysis.
+ *
+ * @param
+ * position	the position in the text of the suffix of the leaf
+ * @param
+ * analysis	the repeat analysis
+ *
+ * @return	If the leaf has been successfully added, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int repeat_analysis_leaf (size_t position,
+		repeat_analysis *analysis) {
+	repeat_frame *frame = analysis->frames + analysis->top - 1;
+	character_type *tmp_pointer = NULL;
+	character_type left = 0;
+	size_t new_size = 0;
+	++analysis->leaves;
+	/*
+	 * The whole text is not preceded by any character,
+	 * so it differs from the left character of any other leaf.
+	 */
+	if (position <= 1) {
+		frame->lefts = 2;
+		return (0);
+	}
+	left = analysis->text[position - 1];
+	if (frame->lefts == 0) {
+		frame->left = left;
+		frame->lefts = 1;
+	} else if ((frame->lefts == 1) && (frame->left != left)) {
+		frame->lefts = 2;
+	}
+	if (frame->only_leaves == 0) {
+		return (0);
+	}
+	if (analysis->lefts_top == analysis->lefts_size) {
+		if (analysis->lefts_size == 0) {
+			new_size = repeat_analysis_initial_size;
+		} else {
+			new_size = analysis->lefts_size << 1;
+		}
+		tmp_pointer = realloc(analysis->lefts,
+				new_size * sizeof (character_type));
+		if (tmp_pointer == NULL) {
+			perror("repeat_analysis_leaf: realloc");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		} else {
+			/*
+			 * Despite that the call to the realloc seems
+			 * to have been successful, we reset the errno,
+			 * because at least on Mac OS X
+			 * it might have changed.
+			 */
+			errno = 0;
+			analysis->lefts = tmp_pointer;
+		}
+		analysis->lefts_size = new_size;
+	}
+	analysis->lefts[analysis->lefts_top++] = left;
+	return (0);
+}
+
+/**
+ * A function which compares two characters for the qsort.
+ *
+ * @param
+ * a		the first character
+ * @param
+ * b		the second character
+ *
+ * @return	A negative number, zero or a positive number is returned,
+ * 		if the first character is less than, equal to
+ * 		or greater than the second character, respectively.
+ */
+int repeat_analysis_compare (const void *a, const void *b) {
+	character_type x = *(const character_type *)(a);
+	character_type y = *(const character_type *)(b);
+	return ((x > y) - (x < y));
+}
+
+/**
+ * A function which finishes the summary of the topmost branching node
+ * in the repeat analysis, after all of its children have been visited.
+ * It classifies the repeat represented by the node
+ * and passes its left characters to the summary of its parent.
+ *
+ * @param
+ * analysis	the repeat analysis
+ *
+ * @return	This function always returns zero (0).
+ */
+int repeat_analysis_leave (repeat_analysis *analysis) {
+	repeat_frame *frame = analysis->frames + (--analysis->top);
+	repeat_frame *parent = NULL;
+	unsigned_integral_type depth = frame->depth;
+	size_t bucket = 0;
+	size_t i = 0;
+	int distinct = 1;
+	++analysis->branching_nodes;
+	/* the root does not represent any repeat */
+	if (depth > 0) {
+		while ((depth >> (bucket + 1)) > 0) {
+			++bucket;
+		}
+		++analysis->histogram[bucket];
+		if (depth > analysis->longest_depth) {
+			analysis->longest_depth = depth;
+			analysis->longest_position = frame->position;
+		}
+		if (frame->lefts == 2) {
+			++analysis->maximal_repeats;
+			analysis->maximal_length += depth;
+		}
+		if ((frame->lefts == 2) && (frame->only_leaves != 0)) {
+			qsort(analysis->lefts, analysis->lefts_top,
+					sizeof (character_type),
+					repeat_analysis_compare);
+			for (i = 1; i < analysis->lefts_top; ++i) {
+				if (analysis->lefts[i - 1] ==
+						analysis->lefts[i]) {
+					distinct = 0;
+					break;
+				}
+			}
+			if (distinct != 0) {
+				++analysis->supermaximal_repeats;
+				analysis->supermaximal_length += depth;
+			}
+		}
+	}
+	analysis->lefts_top = 0;
+	if (analysis->top == 0) {
+		return (0);
+	}
+	parent = analysis->frames + analysis->top - 1;
+	if (frame->lefts == 2) {
+		parent->lefts = 2;
+	} else if ((frame->lefts == 1) && (parent->lefts == 0)) {
+		parent->left = frame->left;
+		parent->lefts = 1;
+	} else if ((frame->lefts == 1) && (parent->lefts == 1) &&
+			(parent->left != frame->left)) {
+		parent->lefts = 2;
+	}
+	return (0);
+}
+
+/**
+ * A function which prints the compact summary of the repeat analysis.
+ *
+ * @param
+ * stream	the FILE * type stream, to which the summary is printed
+ * @param
+ * analysis	the finished repeat analysis
+ *
+ * @return	This function always returns zero (0).
+ */
+int repeat_analysis_print (FILE *stream,
+		const repeat_analysis *analysis) {
+	size_t buckets = sizeof (analysis->histogram) /
+		sizeof (analysis->histogram[0]);
+	size_t i = 0;
+	fprintf(stream, "Repeat analysis of the suffix tree:\n"
+			"%zu branching nodes (including the root) "
+			"and %zu leaves\n", analysis->branching_nodes,
+			analysis->leaves);
+	fprintf(stream, "Longest repeated substring: %zu characters "
+			"at the position %zu\n",
+			(size_t)(analysis->longest_depth),
+			analysis->longest_position);
+	fprintf(stream, "Maximal repeats: %zu (total length %zu)\n"
+			"Supermaximal repeats: %zu (total length %zu)\n",
+			analysis->maximal_repeats,
+			analysis->maximal_length,
+			analysis->supermaximal_repeats,
+			analysis->supermaximal_length);
+	fprintf(stream, "String depths of the branching nodes "
+			"(except for the root):\n");
+	for (i = 0; i < buckets; ++i) {
+		if (analysis->histogram[i] > 0) {
+			fprintf(stream, "%10zu - %10zu: %zu\n",
+					(size_t)(1) << i,
+					((size_t)(1) << (i + 1)) - 1,
+					analysis->histogram[i]);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which deallocates the memory used by the repeat analysis.
+ *
+ * @param
+ * analysis	the repeat analysis
+ */
+void repeat_analysis_free (repeat_analysis *analysis) {
+	free(analysis->frames);
+	analysis->frames = NULL;
+	analysis->size = 0;
+	analysis->top = 0;
+	free(analysis->lefts);
+	analysis->lefts = NULL;
+	analysis->lefts_size = 0;
+	analysis->lefts_top = 0;
+}
+
+/**
+ * A function which opens the files of the exported suffix array
+ * and LCP array. Their names are created by appending the suffixes
+ * ".sa" and ".lcp" to the provided file name.
+ *
+ * @param
+ * filename	the common beginning of the names of both the files
+ * @param
+ * width	the desired width of the exported numbers in bytes,
+ * 		or zero to use 4 bytes if they are wide enough
+ * 		and 8 bytes otherwise
+ * @param
+ * length	the actual length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * export	the export to be prepared
+ *
+ * @return	If both the files have been successfully opened,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int array_export_open (const char *filename,
+		size_t width,
+		size_t length,
+		array_export *export) {
+	char *name = NULL;
+	FILE *sa_stream = NULL;
+	FILE *lcp_stream = NULL;
+	size_t filename_length = strlen(filename);
+	if (width == 0) {
+		width = (unsigned long long)(length) > 0xffffffffULL ? 8 : 4;
+	} else if ((width == 4) &&
+			((unsigned long long)(length) > 0xffffffffULL)) {
+		fprintf(stderr, "Error: The text is too long "
+				"for the 32-bit suffix array!\n");
+		return (1);
+	}
+	/* the longer suffix ".lcp" and the terminating null character */
+	if ((name = malloc(filename_length + 5)) == NULL) {
+		perror("array_export_open: malloc");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	strcpy(name, filename);
+	strcpy(name + filename_length, ".sa");
+	if ((sa_stream = fopen(name, "wb")) == NULL) {
+		perror("array_export_open: fopen(sa)");
+		/* resetting the errno */
+		errno = 0;
+		free(name);
+		return (3);
+	}
+	strcpy(name + filename_length, ".lcp");
+	if ((lcp_stream = fopen(name, "wb")) == NULL) {
+		perror("array_export_open: fopen(lcp)");
+		/* resetting the errno */
+		errno = 0;
+		free(name);
+		fclose(sa_stream);
+		return (3);
+	}
+	free(name);
+	if (traversal_output_open(sa_stream, tf_binary, NULL,
+				&export->sa) > 0) {
+		fclose(sa_stream);
+		fclose(lcp_stream);
+		return (4);
+	}
+	if (traversal_output_open(lcp_stream, tf_binary, NULL,
+				&export->lcp) > 0) {
+		traversal_output_close(&export->sa);
+		fclose(sa_stream);
+		fclose(lcp_stream);
+		return (4);
+	}
+	export->width = width;
+	export->length = length;
+	export->pending_lcp = 0;
+	export->entries = 0;
+	return (0);
+}
+
+/**
+ * A function which registers a branching node, at which the export
+ * continues with its next child. The longest common prefix
+ * of the next exported suffix with the previous one is the minimum
+ * string depth of all such branching nodes since the previous leaf.
+ *
+ * @param
+ * depth	the string depth of the branching node
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ */
+void array_export_ancestor (unsigned_integral_type depth,
+		array_export *export) {
+	if (depth < export->pending_lcp) {
+		export->pending_lcp = depth;
+	}
+}
+
+/**
+ * A function which exports the suffix of a leaf
+ * to the suffix array and to the LCP array.
+ * The suffix consisting of the terminating character ($) only
+ * is not exported.
+ *
+ * @param
+ * position	the position in the text of the suffix of the leaf
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ */
+void array_export_leaf (size_t position,
+		array_export *export) {
+	if (position > export->length) {
+		return;
+	}
+	traversal_output_fixed((unsigned long long)(position - 1),
+			export->width, &export->sa);
+	traversal_output_fixed(export->entries == 0 ? 0ULL :
+			(unsigned long long)(export->pending_lcp),
+			export->width, &export->lcp);
+	++export->entries;
+	export->pending_lcp = (unsigned_integral_type)(-1);
+}
+
+/**
+ * A function which flushes and closes the files of the exported
+ * suffix array and LCP array.
+ *
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ *
+ * @return	If both the arrays have been successfully written,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int array_export_close (array_export *export) {
+	FILE *sa_stream = export->sa.stream;
+	FILE *lcp_stream = export->lcp.stream;
+	int retval = 0;
+	if (traversal_output_close(&export->sa) > 0) {
+		retval = 1;
+	}
+	if (traversal_output_close(&export->lcp) > 0) {
+		retval = 1;
+	}
+	if (fclose(sa_stream) == EOF) {
+		perror("array_export_close: fclose(sa)");
+		/* resetting the errno */
+		errno = 0;
+		retval = 2;
+	}
+	if (fclose(lcp_stream) == EOF) {
+		perror("array_export_close: fclose(lcp)");
+		/* resetting the errno */
+		errno = 0;
+		retval = 2;
+	}
+	return (retval);
+}
+
+/**
+ * A function which adds the matching statistic
+ * of a single position of the query to the summary.
+ *
+ * @param
+ * query_position	the position in the query
+ * @param
+ * length	the matching statistic of the position, or the length
+ * 		of the longest prefix of the suffix of the query
+ * 		starting there, which occurs in the text
+ * @param
+ * text_position	the position in the text of an occurrence
+ * 			of this prefix
+ * @param
+ * statistics	the summary of the matching statistics
+ */
+void matching_statistics_add (size_t query_position,
+		size_t length,
+		size_t text_position,
+		matching_statistics *statistics) {
+	size_t bucket = 0;
+	++statistics->positions;
+	statistics->total_length += length;
+	if (length > statistics->longest_length) {
+		statistics->longest_length = length;
+		statistics->query_position = query_position;
+		statistics->text_position = text_position;
+	}
+	while ((length >> bucket) > 0) {
+		++bucket;
+	}
+	++statistics->histogram[bucket];
+}
+
+/**
+ * A function which prints the summary of the matching statistics.
+ *
+ * @param
+ * stream	the FILE * type stream, to which the summary is printed
+ * @param
+ * statistics	the summary of the matching statistics
+ *
+ * @return	This function always returns zero (0).
+ */
+int matching_statistics_print (FILE *stream,
+		const matching_statistics *statistics) {
+	size_t buckets = sizeof (statistics->histogram) /
+		sizeof (statistics->histogram[0]);
+	size_t i = 0;
+	fprintf(stream, "Matching statistics of the query:\n"
+			"%zu positions of the query, "
+			"average match length %.2f\n",
+			statistics->positions,
+			statistics->positions == 0 ? 0.0 :
+			(double)(statistics->total_length) /
+			(double)(statistics->positions));
+	fprintf(stream, "Longest common substring: %zu characters "
+			"at the position %zu of the query\n"
+			"and at the position %zu of the text\n",
+			statistics->longest_length,
+			statistics->query_position,
+			statistics->text_position);
+	fprintf(stream, "Match lengths:\n");
+	if (statistics->histogram[0] > 0) {
+		fprintf(stream, "%10zu - %10zu: %zu\n", (size_t)(0),
+				(size_t)(0), statistics->histogram[0]);
+	}
+	for (i = 1; i < buckets; ++i) {
+		if (statistics->histogram[i] > 0) {
+			fprintf(stream, "%10zu - %10zu: %zu\n",
+					(size_t)(1) << (i - 1),
+					((size_t)(1) << (i - 1)) * 2 - 1,
+					statistics->histogram[i]);
+		}
+	}
+	return (0);
+}
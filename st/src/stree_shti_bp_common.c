@@ -26,6 +26,7 @@
  * with the backward pointers.
  */
 #include "stree_shti_bp_common.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <limits.h>
@@ -80,7 +81,7 @@ int st_shti_bp_allocate (size_t length,
 	 * We allocate and clear the memory for the hash settings.
 	 * To achieve it, we simply use calloc instead of malloc.
 	 */
-	stree->hs = calloc(stree->hs_size, (size_t)(1));
+	stree->hs = arena_calloc(stree->hs_size, (size_t)(1));
 	if (stree->hs == NULL) {
 		perror("calloc(stree->hs)");
 		/* resetting the errno */
@@ -121,7 +122,7 @@ int st_shti_bp_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tbranch);
+	arena_free(stree->tbranch);
 	stree->tbranch = NULL;
 	printf("Trying to allocate memory for tbranch:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -134,7 +135,7 @@ int st_shti_bp_allocate (size_t length,
 	 * The number of actually allocated branch records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	stree->tbranch = calloc(unit_size + 1, stree->br_size);
+	stree->tbranch = arena_calloc(unit_size + 1, stree->br_size);
 	if (stree->tbranch == NULL) {
 		perror("calloc(tbranch)");
 		/* resetting the errno */
@@ -174,7 +175,7 @@ int st_shti_bp_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tedge);
+	arena_free(stree->tedge);
 	stree->tedge = NULL;
 	printf("Trying to allocate memory for tedge:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -187,7 +188,7 @@ int st_shti_bp_allocate (size_t length,
 	 * The number of edge records has already been determined,
 	 * so we just use it.
 	 */
-	stree->tedge = calloc(stree->tedge_size, stree->er_size);
+	stree->tedge = arena_calloc(stree->tedge_size, stree->er_size);
 	if (stree->tedge == NULL) {
 		perror("calloc(tedge)");
 		/* resetting the errno */
@@ -207,7 +208,7 @@ int st_shti_bp_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tleaf);
+	arena_free(stree->tleaf);
 	stree->tleaf = NULL;
 	printf("Trying to allocate memory for tleaf:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -223,7 +224,7 @@ int st_shti_bp_allocate (size_t length,
 	 * and one extra record, representing the shortest non-empty suffix
 	 * and consisting only of the terminating character ($).
 	 */
-	stree->tleaf = calloc((length + 2), stree->lr_size);
+	stree->tleaf = arena_calloc((length + 2), stree->lr_size);
 	if (stree->tleaf == NULL) {
 		perror("calloc(tleaf)");
 		/* resetting the errno */
@@ -325,7 +326,7 @@ int st_shti_bp_reallocate (size_t desired_tbranch_size,
 		 * is increased by one, because of the 0.th record,
 		 * which is never used.
 		 */
-		tmp_pointer = realloc(stree->tbranch,
+		tmp_pointer = arena_realloc(stree->tbranch,
 				(new_tbranch_size + 1) * stree->br_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(tbranch)");
@@ -1142,9 +1143,14 @@ int st_shti_bp_split_edge (signed_integral_type *parent,
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
  * This function performs a simple traversal.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack
+ * together with the last visited child of each of its nodes.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversing starts
@@ -1155,28 +1161,29 @@ int st_shti_bp_split_edge (signed_integral_type *parent,
  * log10l	A ceiling of base 10 logarithm of the number
  * 		of leaves. It will be used for printing alignment.
  * @param
- * internal_text_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stree	the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_shti_bp_simple_traverse_from (FILE *stream,
+int st_shti_bp_simple_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
-		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length,
+		traversal_stack *stack,
 		const suffix_tree_shti_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1189,84 +1196,114 @@ int st_shti_bp_simple_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	/* getting the first child of the starting_node */
-	if (st_shti_bp_quick_next_child(starting_node, &child, text, stree)
-			!= 0) {
-		fprintf(stderr,	"Error: The traversal of the current branch "
-				"is not possible,\nbecause we were not able "
-				"to advance to the next child of the parent "
-				"(%d)!\n", starting_node);
-		return (2);
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0,
+				stree->tbranch[starting_node].depth) > 0) {
+		return (5);
 	}
-	parents_depth = stree->tbranch[starting_node].depth;
-	do {
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		/*
+		 * there is quite a large overhead to move to the next child
+		 * of the current node, but it is unevitable, because of
+		 * the nature of the hash table representation.
+		 */
+		if (st_shti_bp_quick_next_child(parent, &child,
+					text, stree) != 0) {
+			if (frame->child == 0) {
+				/* getting the first child has failed */
+				fprintf(stderr,	"Error: The traversal of "
+						"the current branch "
+						"is not possible,\nbecause "
+						"we were not able "
+						"to advance to the next child "
+						"of the parent (%d)!\n",
+						parent);
+				if (stack->top == 1) {
+					return (2);
+				}
+			}
+			/* all the children of this node have been visited */
+			--stack->top;
+			continue;
+		}
+		frame->child = child;
+		parents_depth = frame->depth;
 		if (child > 0) {
 			childs_depth = stree->tbranch[child].depth;
 			childs_offset = stree->tbranch[child].head_position;
 			childs_parent = stree->tbranch[child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its branching "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 0,
+			st_print_edge(output, 0,
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
-			st_shti_bp_simple_traverse_from(stream, child,
-					log10bn, log10l,
-					internal_text_encoding, text, length,
-					stree);
+					childs_offset, text);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child, 0, 0,
+						childs_depth) > 0) {
+				return (5);
+			}
 		} else { /* child < 0 */
 			childs_depth = (unsigned_integral_type)
 				((length + 2) - (size_t)(-child));
 			childs_offset = (unsigned_integral_type)(-child);
 			childs_parent = stree->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its leaf "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (4);
+				if (stack->top == 1) {
+					return (4);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 1,
+			st_print_edge(output, 1,
 					(signed_integral_type)(0),
 					child, (signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
+					childs_offset, text);
 		}
-		/*
-		 * there is quite a large overhead to move to the next child
-		 * of the starting_node, but it is unevitable, because of
-		 * the nature of the hash table representation.
-		 */
-	} while (st_shti_bp_quick_next_child(starting_node, &child, text, stree)
-			== 0);
+	}
 	return (0);
 }
 
 /**
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack
+ * together with the last visited child of each of its nodes.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversing starts
@@ -1277,28 +1314,29 @@ int st_shti_bp_simple_traverse_from (FILE *stream,
  * log10l	A ceiling of base 10 logarithm of the number
  * 		of leaves. It will be used for printing alignment.
  * @param
- * internal_text_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stree	the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_shti_bp_traverse_from (FILE *stream,
+int st_shti_bp_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
-		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length,
+		traversal_stack *stack,
 		const suffix_tree_shti_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1312,70 +1350,277 @@ int st_shti_bp_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	/* getting the first child of the starting_node */
-	if (st_shti_bp_quick_next_child(starting_node, &child, text, stree)
-			!= 0) {
-		fprintf(stderr,	"Error: The traversal of the current branch "
-				"is not possible,\nbecause we were not able "
-				"to advance to the next child of the parent "
-				"(%d)!\n", starting_node);
-		return (2);
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0,
+				stree->tbranch[starting_node].depth) > 0) {
+		return (5);
 	}
-	parents_depth = stree->tbranch[starting_node].depth;
-	do {
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		/*
+		 * there is quite a large overhead to move to the next child
+		 * of the current node, but it is unevitable, because of
+		 * the nature of the hash table representation.
+		 */
+		if (st_shti_bp_quick_next_child(parent, &child,
+					text, stree) != 0) {
+			if (frame->child == 0) {
+				/* getting the first child has failed */
+				fprintf(stderr,	"Error: The traversal of "
+						"the current branch "
+						"is not possible,\nbecause "
+						"we were not able "
+						"to advance to the next child "
+						"of the parent (%d)!\n",
+						parent);
+				if (stack->top == 1) {
+					return (2);
+				}
+			}
+			/* all the children of this node have been visited */
+			--stack->top;
+			continue;
+		}
+		frame->child = child;
+		parents_depth = frame->depth;
 		if (child > 0) {
 			childs_suffix_link = stree->tbranch[child].suffix_link;
 			childs_depth = stree->tbranch[child].depth;
 			childs_offset = stree->tbranch[child].head_position;
 			childs_parent = stree->tbranch[child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its branching "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 0, starting_node, child,
+			st_print_edge(output, 0, parent, child,
 					childs_suffix_link, parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
-			st_shti_bp_traverse_from(stream, child, log10bn, log10l,
-					internal_text_encoding, text, length,
-					stree);
+					childs_offset, text);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child, 0, 0,
+						childs_depth) > 0) {
+				return (5);
+			}
 		} else { /* child < 0 */
 			childs_depth = (unsigned_integral_type)
 				((length + 2) - (size_t)(-child));
 			childs_offset = (unsigned_integral_type)(-child);
 			childs_parent = stree->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its leaf "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (4);
+				if (stack->top == 1) {
+					return (4);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 1, starting_node, child,
+			st_print_edge(output, 1, parent, child,
 					0, parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
+					childs_offset, text);
 		}
-		/*
-		 * there is quite a large overhead to move to the next child
-		 * of the starting_node, but it is unevitable, because of
-		 * the nature of the hash table representation.
-		 */
-	} while (st_shti_bp_quick_next_child(starting_node, &child, text, stree)
-			== 0);
+	}
+	return (0);
+}
+
+/**
+ * A function which walks through the whole subtree of the given node
+ * without printing anything and counts the visited nodes.
+ *
+ * @param
+ * starting_node	the branching node from which the walk starts
+ * @param
+ * branching_nodes	the number of the visited branching nodes,
+ * 			not including the starting node, will be added here
+ * @param
+ * leaves	the number of the visited leaves will be added here
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stack	the explicit stack to be used by the walk
+ * @param
+ * stree	the actual suffix tree which will be walked through
+ *
+ * @return	If we could successfully walk through the subtree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_bp_walk_from (signed_integral_type starting_node,
+		size_t *branching_nodes,
+		size_t *leaves,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti_bp *stree) {
+	traversal_frame *frame = NULL;
+	if (starting_node <= 0) {
+		fprintf(stderr,	"Error: The walk has to start from "
+				"a branching node, but the starting node "
+				"is %d!", starting_node);
+		return (1);
+	}
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0, 0) > 0) {
+		return (2);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		if (st_shti_bp_quick_next_child(frame->node, &frame->child,
+					text, stree) != 0) {
+			--stack->top;
+		} else if (frame->child > 0) {
+			++(*branching_nodes);
+			if (traversal_stack_push(stack, frame->child,
+						0, 0, 0) > 0) {
+				return (2);
+			}
+		} else {
+			++(*leaves);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which analyses the repeats in the whole suffix tree.
+ * It visits all the nodes without printing anything
+ * and summarizes each branching node bottom-up,
+ * after all of its children have been visited.
+ *
+ * @param
+ * analysis	the repeat analysis, which collects the results
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stack	the explicit stack to be used by the analysis
+ * @param
+ * stree	the actual suffix tree which will be analysed
+ *
+ * @return	If we could successfully analyse the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_bp_analyse_repeats (repeat_analysis *analysis,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type child = 0;
+	stack->top = 0;
+	analysis->top = 0;
+	if ((traversal_stack_push(stack, 1, 0, 0, 0) > 0) ||
+			(repeat_analysis_enter(stree->tbranch[1].depth,
+				stree->tbranch[1].head_position,
+				analysis) > 0)) {
+		return (1);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		if (st_shti_bp_quick_next_child(frame->node, &frame->child,
+					text, stree) != 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+			repeat_analysis_leave(analysis);
+			continue;
+		}
+		child = frame->child;
+		if (child > 0) {
+			if ((traversal_stack_push(stack, child,
+						0, 0, 0) > 0) ||
+					(repeat_analysis_enter(
+					stree->tbranch[child].depth,
+					stree->tbranch[child].head_position,
+					analysis) > 0)) {
+				return (1);
+			}
+		} else if (repeat_analysis_leaf((size_t)(-child),
+					analysis) > 0) {
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which exports the suffix array and the LCP array
+ * of the whole suffix tree. It visits the leaves in the lexicographic
+ * order of their suffixes and streams them to the export.
+ * The leaf, whose edge consists of the terminating character ($) only,
+ * is exported before all the other children of its parent.
+ *
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stack	the explicit stack to be used by the export
+ * @param
+ * stree	the actual suffix tree which will be exported
+ *
+ * @return	If we could successfully export the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_bp_export_arrays (array_export *export,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type node = 1;
+	signed_integral_type child = 0;
+	unsigned_integral_type depth = 0;
+	stack->top = 0;
+	while (node > 0) {
+		/* entering the branching node */
+		depth = stree->tbranch[node].depth;
+		if ((stree_shti_bp_ht_lookup(node, terminating_character,
+						&child, text, stree) == 0) &&
+				(child < 0)) {
+			array_export_ancestor(depth, export);
+			array_export_leaf((size_t)(-child), export);
+		}
+		if (traversal_stack_push(stack, node, 0, 0, depth) > 0) {
+			return (1);
+		}
+		node = 0;
+		while ((node == 0) && (stack->top > 0)) {
+			frame = stack->frames + stack->top - 1;
+			if (st_shti_bp_quick_next_child(frame->node,
+						&frame->child,
+						text, stree) != 0) {
+				/* all the children have been visited */
+				--stack->top;
+				continue;
+			}
+			child = frame->child;
+			array_export_ancestor(frame->depth, export);
+			if (child > 0) {
+				node = child;
+			} else if ((size_t)(-child) + frame->depth !=
+					export->length + 1) {
+				array_export_leaf((size_t)(-child), export);
+			}
+		}
+	}
 	return (0);
 }
 
@@ -1393,6 +1638,9 @@ int st_shti_bp_traverse_from (FILE *stream,
  * @param
  * traversal_type	the type of the traversal to perform
  * @param
+ * traversal_format	the format of the traversal output,
+ * 			either tf_text or tf_binary
+ * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
@@ -1406,9 +1654,14 @@ int st_shti_bp_traverse_from (FILE *stream,
 int st_shti_bp_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_shti_bp *stree) {
+	/* the explicit stack of the traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	/* the buffered output of the traversal */
+	traversal_output output;
 	signed_integral_type start_node = 1; /* the root */
 	/* the current number of branching nodes in the suffix tree */
 	size_t branching_nodes = stree->branching_nodes;
@@ -1449,37 +1702,54 @@ int st_shti_bp_traverse (FILE *stream,
 		printf("The traversal log is being dumped "
 				"to the specified file.\n");
 	}
+	if (traversal_output_open(stream, traversal_format,
+				internal_text_encoding, &output) > 0) {
+		fprintf(stderr, "Error: Could not prepare "
+				"the traversal output. Exiting!\n");
+		return (4);
+	}
 	if (traversal_type == tt_detailed) {
-		fprintf(stream, "Suffix tree traversal BEGIN\n");
-		if (st_shti_bp_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				text, length + 2, (size_t)(0), &output);
+		if (st_shti_bp_traverse_from(&output, start_node,
 					log10bn, log10l,
-					internal_text_encoding,
-					text, length, stree) > 0) {
+					text, length, &stack, stree) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (1);
 		}
-		fprintf(stream, "Suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else if (traversal_type == tt_simple) {
-		fprintf(stream, "Simple suffix tree traversal BEGIN\n");
-		if (st_shti_bp_simple_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				text, length + 2, (size_t)(0), &output);
+		if (st_shti_bp_simple_traverse_from(&output, start_node,
 					log10bn, log10l,
-					internal_text_encoding,
-					text, length, stree) > 0) {
+					text, length, &stack, stree) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (2);
 		}
-		fprintf(stream, "Simple suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else {
 		fprintf(stderr, "Error: Unknown traversal type (%d) "
 				"Exiting!\n", traversal_type);
+		traversal_output_close(&output);
 		return (3);
 	}
+	traversal_stack_free(&stack);
+	if (traversal_output_close(&output) > 0) {
+		fprintf(stderr, "Error: Could not write "
+				"the traversal output. Exiting!\n");
+		return (5);
+	}
 	if (stream != stdout) {
 		printf("Dump complete.\n");
 	}
@@ -1508,11 +1778,11 @@ int st_shti_bp_delete (suffix_tree_shti_bp *stree) {
 				"properly deallocated!\n");
 		return (1);
 	}
-	free(stree->tbranch);
+	arena_free(stree->tbranch);
 	stree->tbranch = NULL;
-	free(stree->tedge);
+	arena_free(stree->tedge);
 	stree->tedge = NULL;
-	free(stree->tleaf);
+	arena_free(stree->tleaf);
 	stree->tleaf = NULL;
 	/*
 	 * maintaining the suffix tree struct
@@ -25,6 +25,7 @@
  * the suffix tree in the memory using the implementation type SHTI.
  */
 #include "stree_shti_common.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <limits.h>
@@ -77,7 +78,7 @@ int st_shti_allocate (size_t length,
 	 * We allocate and clear the memory for the hash settings.
 	 * To achieve it, we simply use calloc instead of malloc.
 	 */
-	stree->hs = calloc(stree->hs_size, (size_t)(1));
+	stree->hs = arena_calloc(stree->hs_size, (size_t)(1));
 	if (stree->hs == NULL) {
 		perror("calloc(stree->hs)");
 		/* resetting the errno */
@@ -118,7 +119,7 @@ int st_shti_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tbranch);
+	arena_free(stree->tbranch);
 	stree->tbranch = NULL;
 	printf("Trying to allocate memory for tbranch:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -131,7 +132,7 @@ int st_shti_allocate (size_t length,
 	 * The number of actually allocated branch records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	stree->tbranch = calloc(unit_size + 1, stree->br_size);
+	stree->tbranch = arena_calloc(unit_size + 1, stree->br_size);
 	if (stree->tbranch == NULL) {
 		perror("calloc(tbranch)");
 		/* resetting the errno */
@@ -170,7 +171,7 @@ int st_shti_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tedge);
+	arena_free(stree->tedge);
 	stree->tedge = NULL;
 	printf("Trying to allocate memory for tedge:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -183,7 +184,7 @@ int st_shti_allocate (size_t length,
 	 * The number of edge records has already been determined,
 	 * so we just use it.
 	 */
-	stree->tedge = calloc(stree->tedge_size, stree->er_size);
+	stree->tedge = arena_calloc(stree->tedge_size, stree->er_size);
 	if (stree->tedge == NULL) {
 		perror("calloc(tedge)");
 		/* resetting the errno */
@@ -289,7 +290,7 @@ int st_shti_reallocate (size_t desired_tbranch_size,
 		 * is increased by one, because of the 0.th record,
 		 * which is never used.
 		 */
-		tmp_pointer = realloc(stree->tbranch,
+		tmp_pointer = arena_realloc(stree->tbranch,
 				(new_tbranch_size + 1) * stree->br_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(tbranch)");
@@ -1136,9 +1137,12 @@ int st_shti_split_edge (signed_integral_type *parent,
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
  * This function performs a simple traversal.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack
+ * together with the last visited child of each of its nodes.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversing starts
@@ -1149,28 +1153,28 @@ int st_shti_split_edge (signed_integral_type *parent,
  * log10l	A ceiling of base 10 logarithm of the number
  * 		of leaves. It will be used for printing alignment.
  * @param
- * internal_text_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stree	the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_shti_simple_traverse_from (FILE *stream,
+int st_shti_simple_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
-		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length,
+		traversal_stack *stack,
 		const suffix_tree_shti *stree) {
+	traversal_frame *frame = NULL;
 	signed_integral_type child = 0;
 	unsigned_integral_type parents_depth = 0;
 	unsigned_integral_type childs_depth = 0;
@@ -1181,60 +1185,79 @@ int st_shti_simple_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	/* getting the first child of the starting_node */
-	if (st_shti_quick_next_child(starting_node, &child, text, stree)
-			!= 0) {
-		fprintf(stderr,	"Error: The traversal of the current branch "
-				"is not possible,\nbecause we were not able "
-				"to advance to the next child of the parent "
-				"(%d)!\n", starting_node);
-		return (2);
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0,
+				stree->tbranch[starting_node].depth) > 0) {
+		return (3);
 	}
-	parents_depth = stree->tbranch[starting_node].depth;
-	do {
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		child = frame->child;
+		/*
+		 * there is quite a large overhead to move to the next child
+		 * of the current node, but it is unevitable, because of
+		 * the nature of the hash table representation.
+		 */
+		if (st_shti_quick_next_child(frame->node, &child,
+					text, stree) != 0) {
+			if (frame->child == 0) {
+				/* getting the first child has failed */
+				fprintf(stderr,	"Error: The traversal of "
+						"the current branch "
+						"is not possible,\nbecause "
+						"we were not able "
+						"to advance to the next child "
+						"of the parent (%d)!\n",
+						frame->node);
+				if (stack->top == 1) {
+					return (2);
+				}
+			}
+			/* all the children of this node have been visited */
+			--stack->top;
+			continue;
+		}
+		frame->child = child;
+		parents_depth = frame->depth;
 		if (child > 0) {
 			childs_depth = stree->tbranch[child].depth;
 			childs_offset = stree->tbranch[child].head_position;
-			st_print_edge(stream, 0,
+			st_print_edge(output, 0,
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
-			st_shti_simple_traverse_from(stream, child,
-					log10bn, log10l,
-					internal_text_encoding, text, length,
-					stree);
+					childs_offset, text);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child, 0, 0,
+						childs_depth) > 0) {
+				return (3);
+			}
 		} else { /* child < 0 */
 			childs_depth = (unsigned_integral_type)((length + 2)
 				- (size_t)(-child));
 			childs_offset = (unsigned_integral_type)(-child);
-			st_print_edge(stream, 1,
+			st_print_edge(output, 1,
 					(signed_integral_type)(0),
 					child, (signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
+					childs_offset, text);
 		}
-		/*
-		 * there is quite a large overhead to move to the next child
-		 * of the starting_node, but it is unevitable, because of
-		 * the nature of the hash table representation.
-		 */
-	} while (st_shti_quick_next_child(starting_node, &child, text, stree)
-			== 0);
+	}
 	return (0);
 }
 
 /**
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack
+ * together with the last visited child of each of its nodes.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversing starts
@@ -1245,28 +1268,29 @@ int st_shti_simple_traverse_from (FILE *stream,
  * log10l	A ceiling of base 10 logarithm of the number
  * 		of leaves. It will be used for printing alignment.
  * @param
- * internal_text_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stree	the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_shti_traverse_from (FILE *stream,
+int st_shti_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
-		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length,
+		traversal_stack *stack,
 		const suffix_tree_shti *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	signed_integral_type childs_suffix_link = 0;
 	unsigned_integral_type parents_depth = 0;
@@ -1278,46 +1302,453 @@ int st_shti_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	/* getting the first child of the starting_node */
-	if (st_shti_quick_next_child(starting_node, &child, text, stree)
-			!= 0) {
-		fprintf(stderr,	"Error: The traversal of the current branch "
-				"is not possible,\nbecause we were not able "
-				"to advance to the next child of the parent "
-				"(%d)!\n", starting_node);
-		return (2);
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0,
+				stree->tbranch[starting_node].depth) > 0) {
+		return (3);
 	}
-	parents_depth = stree->tbranch[starting_node].depth;
-	do {
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		/*
+		 * there is quite a large overhead to move to the next child
+		 * of the current node, but it is unevitable, because of
+		 * the nature of the hash table representation.
+		 */
+		if (st_shti_quick_next_child(parent, &child,
+					text, stree) != 0) {
+			if (frame->child == 0) {
+				/* getting the first child has failed */
+				fprintf(stderr,	"Error: The traversal of "
+						"the current branch "
+						"is not possible,\nbecause "
+						"we were not able "
+						"to advance to the next child "
+						"of the parent (%d)!\n",
+						parent);
+				if (stack->top == 1) {
+					return (2);
+				}
+			}
+			/* all the children of this node have been visited */
+			--stack->top;
+			continue;
+		}
+		frame->child = child;
+		parents_depth = frame->depth;
 		if (child > 0) {
 			childs_suffix_link = stree->tbranch[child].suffix_link;
 			childs_depth = stree->tbranch[child].depth;
 			childs_offset = stree->tbranch[child].head_position;
-			st_print_edge(stream, 0, starting_node, child,
+			st_print_edge(output, 0, parent, child,
 					childs_suffix_link, parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
-			st_shti_traverse_from(stream, child, log10bn, log10l,
-					internal_text_encoding, text, length,
-					stree);
+					childs_offset, text);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child, 0, 0,
+						childs_depth) > 0) {
+				return (3);
+			}
 		} else { /* child < 0 */
 			childs_depth = (unsigned_integral_type)((length + 2)
 				- (size_t)(-child));
 			childs_offset = (unsigned_integral_type)(-child);
-			st_print_edge(stream, 1, starting_node, child,
+			st_print_edge(output, 1, parent, child,
 					0, parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
+					childs_offset, text);
 		}
-		/*
-		 * there is quite a large overhead to move to the next child
-		 * of the starting_node, but it is unevitable, because of
-		 * the nature of the hash table representation.
-		 */
-	} while (st_shti_quick_next_child(starting_node, &child, text, stree)
-			== 0);
+	}
+	return (0);
+}
+
+/**
+ * A function which walks through the whole subtree of the given node
+ * without printing anything and counts the visited nodes.
+ * It is used to measure the cost of visiting all the nodes
+ * of the suffix tree in the current memory layout.
+ *
+ * @param
+ * starting_node	the branching node from which the walk starts
+ * @param
+ * branching_nodes	the number of the visited branching nodes,
+ * 			not including the starting node, will be added here
+ * @param
+ * leaves	the number of the visited leaves will be added here
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stack	the explicit stack to be used by the walk
+ * @param
+ * stree	the actual suffix tree which will be walked through
+ *
+ * @return	If we could successfully walk through the subtree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_walk_from (signed_integral_type starting_node,
+		size_t *branching_nodes,
+		size_t *leaves,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti *stree) {
+	traversal_frame *frame = NULL;
+	if (starting_node <= 0) {
+		fprintf(stderr,	"Error: The walk has to start from "
+				"a branching node, but the starting node "
+				"is %d!", starting_node);
+		return (1);
+	}
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0, 0) > 0) {
+		return (2);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		if (st_shti_quick_next_child(frame->node, &frame->child,
+					text, stree) != 0) {
+			--stack->top;
+		} else if (frame->child > 0) {
+			++(*branching_nodes);
+			if (traversal_stack_push(stack, frame->child,
+						0, 0, 0) > 0) {
+				return (2);
+			}
+		} else {
+			++(*leaves);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which analyses the repeats in the whole suffix tree.
+ * It visits all the nodes without printing anything
+ * and summarizes each branching node bottom-up,
+ * after all of its children have been visited.
+ *
+ * @param
+ * analysis	the repeat analysis, which collects the results
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stack	the explicit stack to be used by the analysis
+ * @param
+ * stree	the actual suffix tree which will be analysed
+ *
+ * @return	If we could successfully analyse the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_analyse_repeats (repeat_analysis *analysis,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type child = 0;
+	stack->top = 0;
+	analysis->top = 0;
+	if ((traversal_stack_push(stack, 1, 0, 0, 0) > 0) ||
+			(repeat_analysis_enter(stree->tbranch[1].depth,
+				stree->tbranch[1].head_position,
+				analysis) > 0)) {
+		return (1);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		if (st_shti_quick_next_child(frame->node, &frame->child,
+					text, stree) != 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+			repeat_analysis_leave(analysis);
+			continue;
+		}
+		child = frame->child;
+		if (child > 0) {
+			if ((traversal_stack_push(stack, child,
+						0, 0, 0) > 0) ||
+					(repeat_analysis_enter(
+					stree->tbranch[child].depth,
+					stree->tbranch[child].head_position,
+					analysis) > 0)) {
+				return (1);
+			}
+		} else if (repeat_analysis_leaf((size_t)(-child),
+					analysis) > 0) {
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which exports the suffix array and the LCP array
+ * of the whole suffix tree. It visits the leaves in the lexicographic
+ * order of their suffixes and streams them to the export.
+ * The leaf, whose edge consists of the terminating character ($) only,
+ * is exported before all the other children of its parent.
+ *
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stack	the explicit stack to be used by the export
+ * @param
+ * stree	the actual suffix tree which will be exported
+ *
+ * @return	If we could successfully export the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_export_arrays (array_export *export,
+		const character_type *text,
+		traversal_stack *stack,
+		const suffix_tree_shti *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type node = 1;
+	signed_integral_type child = 0;
+	unsigned_integral_type depth = 0;
+	stack->top = 0;
+	while (node > 0) {
+		/* entering the branching node */
+		depth = stree->tbranch[node].depth;
+		if ((stree_shti_ht_lookup(node, terminating_character,
+						&child, text, stree) == 0) &&
+				(child < 0)) {
+			array_export_ancestor(depth, export);
+			array_export_leaf((size_t)(-child), export);
+		}
+		if (traversal_stack_push(stack, node, 0, 0, depth) > 0) {
+			return (1);
+		}
+		node = 0;
+		while ((node == 0) && (stack->top > 0)) {
+			frame = stack->frames + stack->top - 1;
+			if (st_shti_quick_next_child(frame->node,
+						&frame->child,
+						text, stree) != 0) {
+				/* all the children have been visited */
+				--stack->top;
+				continue;
+			}
+			child = frame->child;
+			array_export_ancestor(frame->depth, export);
+			if (child > 0) {
+				node = child;
+			} else if ((size_t)(-child) + frame->depth !=
+					export->length + 1) {
+				array_export_leaf((size_t)(-child), export);
+			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which computes the matching statistics of the query
+ * against the suffix tree in linear time. After the longest match
+ * of a suffix of the query has been found, the match of the next suffix
+ * starts at the suffix link of the deepest branching node
+ * on its path, from which only the rest of the match is rescanned
+ * by comparing just the first letters of the edges.
+ * It requires the suffix links of all the branching nodes.
+ *
+ * @param
+ * query	the query text, its positions start at 1
+ * @param
+ * query_length	the number of the characters of the query
+ * @param
+ * statistics	the summary of the matching statistics
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * length	the actual length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * stree	the actual suffix tree
+ *
+ * @return	If the matching statistics have been computed, 0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_matching_statistics (const character_type *query,
+		size_t query_length,
+		matching_statistics *statistics,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_shti *stree) {
+	/* the deepest branching node on the path of the current match */
+	signed_integral_type node = 1;
+	/* the child, on the edge to which the current match continues */
+	signed_integral_type child = 0;
+	/* the string depth of the node */
+	size_t depth = 0;
+	/* the length of the current match */
+	size_t matched = 0;
+	/* the position in the text of an occurrence of the current match */
+	size_t start = 0;
+	size_t i = 0;
+	character_type letter = 0;
+	for (i = 1; i <= query_length; ++i) {
+		/* extending the match of the suffix starting at i */
+		while (i + matched <= query_length) {
+			letter = query[i + matched];
+			if (matched == depth) {
+				if (stree_shti_ht_lookup(node, letter, &child,
+							text, stree) > 0) {
+					child = 0;
+				}
+				if (child == 0) {
+					break;
+				}
+				start = child > 0 ?
+					stree->tbranch[child].head_position :
+					(size_t)(-child);
+			}
+			/* the terminating character ($) never matches */
+			if ((start + matched > length) ||
+					(text[start + matched] != letter)) {
+				break;
+			}
+			++matched;
+			if ((child > 0) && (matched ==
+					stree->tbranch[child].depth)) {
+				node = child;
+				depth = matched;
+			}
+		}
+		if (matched == depth) {
+			start = stree->tbranch[node].head_position;
+		}
+		matching_statistics_add(i, matched, start, statistics);
+		if (matched == 0) {
+			continue;
+		}
+		/* the match of the next suffix is shorter by one character */
+		--matched;
+		if ((node == 1) || (stree->tbranch[node].suffix_link <= 0)) {
+			node = 1;
+		} else {
+			node = stree->tbranch[node].suffix_link;
+		}
+		depth = stree->tbranch[node].depth;
+		/* rescanning the rest of the match below the node */
+		while (depth < matched) {
+			letter = query[i + 1 + depth];
+			if (stree_shti_ht_lookup(node, letter, &child,
+						text, stree) > 0) {
+				child = 0;
+			}
+			if (child == 0) {
+				fprintf(stderr, "Error: The rescanned "
+						"match is not in the suffix "
+						"tree!\n");
+				return (1);
+			}
+			if ((child > 0) && (stree->tbranch[child].depth <=
+						matched)) {
+				node = child;
+				depth = stree->tbranch[child].depth;
+			} else {
+				start = child > 0 ?
+					stree->tbranch[child].head_position :
+					(size_t)(-child);
+				break;
+			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which prints a single task of the parallel traversal.
+ * It prints the edge of the task and unless the task is limited
+ * to the edge, also the whole subtree below its child.
+ *
+ * @param
+ * output	the buffered output, to which the task will be printed
+ * @param
+ * task		the task to be printed
+ * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
+ * pool		the parallel traversal pool containing the task
+ *
+ * @return	If we could successfully print the task, 0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_traverse_task (traversal_output *output,
+		const traversal_task *task,
+		traversal_stack *stack,
+		const traversal_pool *pool) {
+	const suffix_tree_shti *stree =
+		(const suffix_tree_shti *)(pool->stree);
+	signed_integral_type child = task->edge.child;
+	/* the simple traversal prints neither the parent nor the child */
+	int detailed = (pool->traversal_type == tt_detailed);
+	signed_integral_type parent = detailed != 0 ? task->edge.node : 0;
+	if (child < 0) {
+		st_print_edge(output, 1, parent, child, 0, task->edge.depth,
+				(unsigned_integral_type)((pool->length + 2)
+					- (size_t)(-child)),
+				pool->log10bn, pool->log10l,
+				(size_t)(-child), pool->text);
+		return (0);
+	}
+	st_print_edge(output, 0, parent, detailed != 0 ? child : 0,
+			detailed != 0 ? stree->tbranch[child].suffix_link : 0,
+			task->edge.depth, stree->tbranch[child].depth,
+			pool->log10bn, pool->log10l,
+			stree->tbranch[child].head_position, pool->text);
+	if (task->edge_only != 0) {
+		return (0);
+	} else if (detailed != 0) {
+		return (st_shti_traverse_from(output, child, pool->log10bn,
+					pool->log10l, pool->text, pool->length,
+					stack, stree));
+	} else {
+		return (st_shti_simple_traverse_from(output, child,
+					pool->log10bn, pool->log10l,
+					pool->text, pool->length,
+					stack, stree));
+	}
+}
+
+/**
+ * A function which adds the tasks of the parallel traversal
+ * for all the children of the child of the provided task.
+ *
+ * @param
+ * task		the task, whose child will be split
+ * @param
+ * pool		the parallel traversal pool
+ *
+ * @return	If the tasks have been successfully added, 0 is returned.
+ * 		If the child of the task is a leaf, (-1) is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_shti_split_task (const traversal_task *task,
+		traversal_pool *pool) {
+	const suffix_tree_shti *stree =
+		(const suffix_tree_shti *)(pool->stree);
+	signed_integral_type node = task->edge.child;
+	signed_integral_type child = 0;
+	if (node < 0) {
+		return (-1);
+	}
+	/*
+	 * the children are found in the same order
+	 * as in the serial traversal
+	 */
+	while (st_shti_quick_next_child(node, &child,
+				pool->text, stree) == 0) {
+		if (traversal_pool_add(node, child, 0,
+					stree->tbranch[node].depth,
+					pool) > 0) {
+			return (1);
+		}
+	}
 	return (0);
 }
 
@@ -1335,6 +1766,13 @@ int st_shti_traverse_from (FILE *stream,
  * @param
  * traversal_type	the type of the traversal to perform
  * @param
+ * traversal_format	the format of the traversal output,
+ * 			either tf_text or tf_binary
+ * @param
+ * traversal_workers	the number of the worker threads, which traverse
+ * 			the subtrees in parallel. If it is 1,
+ * 			the traversal is serial.
+ * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
@@ -1348,9 +1786,19 @@ int st_shti_traverse_from (FILE *stream,
 int st_shti_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_shti *stree) {
+	/* the explicit stack of the traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	/* the buffered output of the traversal */
+	traversal_output output;
+	/* the tasks of the parallel traversal */
+	traversal_pool pool = {.tasks = NULL};
+	/* the task, whose child is the root */
+	traversal_task root_task = {.edge_only = 0};
 	signed_integral_type start_node = 1; /* the root */
 	/* the current number of branching nodes in the suffix tree */
 	size_t branching_nodes = stree->branching_nodes;
@@ -1391,37 +1839,77 @@ int st_shti_traverse (FILE *stream,
 		printf("The traversal log is being dumped "
 				"to the specified file.\n");
 	}
-	if (traversal_type == tt_detailed) {
-		fprintf(stream, "Suffix tree traversal BEGIN\n");
-		if (st_shti_traverse_from(stream, start_node,
+	if (traversal_output_open(stream, traversal_format,
+				internal_text_encoding, &output) > 0) {
+		fprintf(stderr, "Error: Could not prepare "
+				"the traversal output. Exiting!\n");
+		return (4);
+	}
+	if ((traversal_workers > 1) && ((traversal_type == tt_detailed) ||
+				(traversal_type == tt_simple))) {
+		pool.process = st_shti_traverse_task;
+		pool.split = st_shti_split_task;
+		pool.stree = stree;
+		pool.text = text;
+		pool.length = length;
+		pool.traversal_type = traversal_type;
+		pool.log10bn = log10bn;
+		pool.log10l = log10l;
+		root_task.edge.child = start_node;
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				text, length + 2, (size_t)(0), &output);
+		if ((st_shti_split_task(&root_task, &pool) > 0) ||
+				(traversal_pool_traverse(traversal_workers,
+					&output, &pool) > 0)) {
+			fprintf(stderr, "Error: The parallel traversal "
+					"was unsuccessful. Exiting!\n");
+			traversal_pool_free(&pool);
+			traversal_output_close(&output);
+			return (6);
+		}
+		traversal_output_end(traversal_type, &output);
+	} else if (traversal_type == tt_detailed) {
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				text, length + 2, (size_t)(0), &output);
+		if (st_shti_traverse_from(&output, start_node,
 					log10bn, log10l,
-					internal_text_encoding,
-					text, length, stree) > 0) {
+					text, length, &stack, stree) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (1);
 		}
-		fprintf(stream, "Suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else if (traversal_type == tt_simple) {
-		fprintf(stream, "Simple suffix tree traversal BEGIN\n");
-		if (st_shti_simple_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				text, length + 2, (size_t)(0), &output);
+		if (st_shti_simple_traverse_from(&output, start_node,
 					log10bn, log10l,
-					internal_text_encoding,
-					text, length, stree) > 0) {
+					text, length, &stack, stree) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (2);
 		}
-		fprintf(stream, "Simple suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else {
 		fprintf(stderr, "Error: Unknown traversal type (%d) "
 				"Exiting!\n", traversal_type);
+		traversal_output_close(&output);
 		return (3);
 	}
+	traversal_stack_free(&stack);
+	if (traversal_output_close(&output) > 0) {
+		fprintf(stderr, "Error: Could not write "
+				"the traversal output. Exiting!\n");
+		return (5);
+	}
 	if (stream != stdout) {
 		printf("Dump complete.\n");
 	}
@@ -1429,6 +1917,139 @@ int st_shti_traverse (FILE *stream,
 	return (0);
 }
 
+/**
+ * A function which renumbers the branching nodes of the already
+ * constructed suffix tree in the breadth-first order.
+ *
+ * The construction algorithms number the branching nodes
+ * in the order of their creation, so a parent and its children
+ * are usually scattered across the whole table tbranch.
+ * After the renumbering, all the branching children of a node
+ * occupy consecutive records and the nodes close to the root,
+ * which are visited by almost every query, are packed together
+ * at the beginning of the table tbranch.
+ *
+ * The suffix links are rewritten to the new numbers.
+ * Because the source node is a part of the hash key,
+ * all the edges are rewritten, too, and the hash table is rebuilt.
+ * The root keeps the number one.
+ *
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * stree	the actual suffix tree
+ *
+ * @return	If the branching nodes have been successfully renumbered,
+ * 		zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_shti_relayout (const character_type *text,
+		suffix_tree_shti *stree) {
+	/* the new numbers of the branching nodes indexed by the old ones */
+	signed_integral_type *new_numbers = NULL;
+	/* the old numbers of the branching nodes in the breadth-first order */
+	signed_integral_type *order = NULL;
+	branch_record_shti *new_tbranch = NULL;
+	signed_integral_type child = 0;
+	/* the new number of the branching node, whose children are enqueued */
+	size_t head = 0;
+	/* the new number, which will be assigned next */
+	size_t tail = 0;
+	size_t new_size = stree->tedge_size;
+	size_t i = 0;
+	printf("Renumbering the branching nodes in the breadth-first order\n");
+	new_numbers = calloc(stree->branching_nodes + 1,
+			sizeof (signed_integral_type));
+	order = calloc(stree->branching_nodes + 1,
+			sizeof (signed_integral_type));
+	if ((new_numbers == NULL) || (order == NULL)) {
+		perror("calloc(new_numbers)");
+		/* resetting the errno */
+		errno = 0;
+		free(new_numbers);
+		free(order);
+		return (1);
+	} else {
+		/* resetting the errno */
+		errno = 0;
+	}
+	/*
+	 * The number of actually allocated branch records is increased by one,
+	 * because of the 0.th record, which is never used.
+	 */
+	new_tbranch = arena_calloc(stree->tbranch_size + 1, stree->br_size);
+	if (new_tbranch == NULL) {
+		perror("calloc(new_tbranch)");
+		/* resetting the errno */
+		errno = 0;
+		free(new_numbers);
+		free(order);
+		return (2);
+	} else {
+		/* resetting the errno */
+		errno = 0;
+	}
+	/* the root keeps its number */
+	order[1] = 1;
+	new_numbers[1] = 1;
+	tail = 2;
+	for (head = 1; head < tail; ++head) {
+		child = 0;
+		while (st_shti_quick_next_child(order[head], &child,
+					text, stree) == 0) {
+			if (child > 0) {
+				order[tail] = child;
+				new_numbers[child] =
+					(signed_integral_type)(tail);
+				++tail;
+			}
+		}
+	}
+	if (tail != stree->branching_nodes + 1) {
+		fprintf(stderr, "Error: Only %zu of %zu branching nodes "
+				"are reachable from the root!\n",
+				tail - 1, stree->branching_nodes);
+		free(new_numbers);
+		free(order);
+		arena_free(new_tbranch);
+		return (3);
+	}
+	for (i = 1; i < tail; ++i) {
+		new_tbranch[i] = stree->tbranch[order[i]];
+		if (new_tbranch[i].suffix_link > 0) {
+			new_tbranch[i].suffix_link =
+				new_numbers[new_tbranch[i].suffix_link];
+		}
+	}
+	free(order);
+	arena_free(stree->tbranch);
+	stree->tbranch = new_tbranch;
+	/*
+	 * The edge records are still stored at the positions determined
+	 * by the old numbers of their source nodes, so we rewrite them
+	 * in place and then we let the rehashing move them
+	 * to their new positions.
+	 */
+	for (i = 0; i < stree->tedge_size; ++i) {
+		if (er_vacant(stree->tedge[i]) == 0) {
+			stree->tedge[i].source_node =
+				new_numbers[stree->tedge[i].source_node];
+			if (stree->tedge[i].target_node > 0) {
+				stree->tedge[i].target_node = new_numbers[
+					stree->tedge[i].target_node];
+			}
+		}
+	}
+	free(new_numbers);
+	if (stree_shti_ht_rehash(&new_size, text, stree) > 0) {
+		fprintf(stderr, "Error: Could not rebuild the hash table "
+				"after the renumbering!\n");
+		return (4);
+	}
+	printf("Successfully renumbered!\n\n");
+	return (0);
+}
+
 /**
  * A function which deallocates the memory used by the suffix tree.
  *
@@ -1450,9 +2071,9 @@ int st_shti_delete (suffix_tree_shti *stree) {
 				"properly deallocated!\n");
 		return (1);
 	}
-	free(stree->tbranch);
+	arena_free(stree->tbranch);
 	stree->tbranch = NULL;
-	free(stree->tedge);
+	arena_free(stree->tedge);
 	stree->tedge = NULL;
 	/*
 	 * maintaining the suffix tree struct
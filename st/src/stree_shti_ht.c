@@ -26,6 +26,7 @@
  * using the implementation type SHTI.
  */
 #include "stree_shti_ht.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <limits.h>
@@ -281,7 +282,7 @@ int stree_shti_ht_rehash (size_t *new_size,
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(stree->tedge);
+		arena_free(stree->tedge);
 		stree->tedge = NULL;
 		/*
 		 * And now we allocate the new, cleared memory
@@ -294,7 +295,7 @@ int stree_shti_ht_rehash (size_t *new_size,
 		 * set to NULL is equivalent to malloc,
 		 * which does not clear the memory.
 		 */
-		stree->tedge = calloc((*new_size), sizeof (edge_record));
+		stree->tedge = arena_calloc((*new_size), sizeof (edge_record));
 		if (stree->tedge == NULL) {
 			perror("calloc(stree->tedge)");
 			/* resetting the errno */
@@ -362,7 +363,7 @@ int stree_shti_ht_rehash (size_t *new_size,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(original_tedge);
+	arena_free(original_tedge);
 	original_tedge = NULL;
 	fprintf(stderr, "Current hash table size:\n%zu cells of %zu "
 			"bytes (totalling %zu bytes, ",
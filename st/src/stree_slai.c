@@ -26,8 +26,10 @@
  * using the implementation type SLAI.
  */
 #include "stree_slai.h"
+#include "arena.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 /* supporting functions */
 
@@ -89,6 +91,17 @@ int st_slai_create_pwotd (long int desired_prefix_length,
 	size_t tmp_text_length = text_length;
 	size_t extra_allocated_memory_size = 0;
 	size_t extra_used_memory_size = 0;
+	/*
+	 * The offset in the table tnode of the first cell
+	 * belonging to the partitions evaluated in the main phase.
+	 * All the cells before it form the top part of the suffix tree.
+	 */
+	size_t window_begin = 0;
+	/*
+	 * the maximum number of cells of the table tnode
+	 * occupied in the memory at any time
+	 */
+	size_t resident_records = 0;
 	partition_process_record_pwotd *ppr = NULL;
 	printf("Creating the suffix tree using the PWOTD algorithm\n\n");
 	/* we have to count also the terminating character ($) */
@@ -207,6 +220,8 @@ int st_slai_create_pwotd (long int desired_prefix_length,
 				"Exiting.\n");
 		return (8);
 	}
+	window_begin = stree->tnode_top;
+	resident_records = stree->tnode_top;
 	/*
 	 * And now we should just take the partitions one by one
 	 * and process them by evaluating all the unevaluated
@@ -218,6 +233,46 @@ int st_slai_create_pwotd (long int desired_prefix_length,
 			stree->cdata.partitions_tbp_number;
 		st_slai_process_partition(ppr->index, ppr->tnode_offset,
 				ppr->parents_depth, text, length, stree);
+		/*
+		 * If there is a sink, the subtree of the just evaluated
+		 * partition is complete and nothing will point into it
+		 * later, so we stream it out and reuse its memory.
+		 */
+		if (stree->sink != NULL) {
+			if (resident_records < stree->tnode_top) {
+				resident_records = stree->tnode_top;
+			}
+			if (st_slai_sink_write(stree->tnode + window_begin,
+					stree->tnode_top - window_begin,
+					window_begin + stree->tnode_flushed,
+					stree->sink) > 0) {
+				fprintf(stderr,	"Error: Could not stream "
+						"the partition into the sink! "
+						"Exiting.\n");
+				return (10);
+			}
+			stree->tnode_flushed += stree->tnode_top - window_begin;
+			stree->tnode_top = window_begin;
+		}
+	}
+	if (stree->sink != NULL) {
+		/*
+		 * The top part of the suffix tree is complete now, too.
+		 * It belongs to the beginning of the streamed table tnode.
+		 */
+		if ((st_slai_sink_write(stree->tnode, window_begin, (size_t)(0),
+				stree->sink) > 0) ||
+				(st_slai_sink_finish(stree->sink) > 0)) {
+			fprintf(stderr,	"Error: Could not stream "
+					"the table tnode into the sink! "
+					"Exiting.\n");
+			return (11);
+		}
+		printf("The peak number of the table tnode cells "
+				"kept in the memory: %zu\n\n",
+				resident_records);
+	} else {
+		resident_records = stree->tnode_top;
 	}
 	pwotd_print_memory_usage_stats(stdout, length, &stree->cdata);
 	extra_allocated_memory_size = stree->cdata.maximum_memory_allocated;
@@ -232,10 +287,27 @@ int st_slai_create_pwotd (long int desired_prefix_length,
 	}
 	printf("\nThe suffix tree has been successfully created.\n");
 	st_print_stats(length, (size_t)(0), stree->branching_nodes,
-			stree->tnode_top - 1, (size_t)(0), (size_t)(0),
+			resident_records - 1, (size_t)(0), (size_t)(0),
 			stree->tnode_size, (size_t)(0), (size_t)(0),
 			(size_t)(0), sizeof (unsigned_integral_type),
 			extra_allocated_memory_size,
 			extra_used_memory_size);
+	if (stree->sink != NULL) {
+		/*
+		 * The streamed table tnode replaces the window
+		 * for the subsequent read-only access.
+		 */
+		arena_free(stree->tnode);
+		stree->tnode = NULL;
+		if (st_slai_sink_map(window_begin + stree->tnode_flushed,
+					stree->sink) > 0) {
+			fprintf(stderr,	"Error: Could not map the streamed "
+					"table tnode! Exiting.\n");
+			return (12);
+		}
+		stree->tnode = stree->sink->mapping;
+		stree->tnode_top = window_begin + stree->tnode_flushed;
+		stree->tnode_size = stree->tnode_top;
+	}
 	return (0);
 }
@@ -25,6 +25,7 @@
  * the suffix tree in the memory using the implementation type SLAI.
  */
 #include "stree_slai_common.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <limits.h>
@@ -84,11 +85,19 @@ int st_slai_allocate (size_t length, suffix_tree_slai *stree) {
 		tnode_size = tnode_size >> 1; /* tnode_size / 2 */
 	}
 	tnode_size = tnode_size << 1; /* tnode_size * 2 */
+	/*
+	 * If the completed partitions will be streamed into the sink,
+	 * the table tnode needs to hold only the top part of the tree
+	 * and the largest partition. It will grow on demand.
+	 */
+	if ((stree->sink != NULL) && (tnode_size > sink_flush_threshold)) {
+		tnode_size = sink_flush_threshold;
+	}
 	/*
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tnode);
+	arena_free(stree->tnode);
 	stree->tnode = NULL;
 	printf("Trying to allocate memory for tnode:\n"
 		"%zu cells of %zu bytes (totalling %zu bytes, ",
@@ -97,7 +106,8 @@ int st_slai_allocate (size_t length, suffix_tree_slai *stree) {
 	print_human_readable_size(stdout, tnode_size *
 			sizeof (unsigned_integral_type));
 	printf(").\n");
-	stree->tnode = calloc(tnode_size, sizeof (unsigned_integral_type));
+	stree->tnode = arena_calloc(tnode_size,
+			sizeof (unsigned_integral_type));
 	if (stree->tnode == NULL) {
 		perror("calloc(tnode)");
 		/* resetting the errno */
@@ -129,6 +139,7 @@ int st_slai_allocate (size_t length, suffix_tree_slai *stree) {
 	stree->tnode_top = 0;
 	stree->tnode_size = tnode_size;
 	stree->tnode_size_increase = tnode_size >> 1; /* tnode_size / 2 */
+	stree->tnode_flushed = 0;
 	printf("The memory has been successfully allocated!\n"
 		"===========================================\n\n");
 	return (0);
@@ -187,7 +198,7 @@ int st_slai_reallocate (size_t desired_tnode_size,
 	print_human_readable_size(stdout, new_tnode_size *
 			sizeof (unsigned_integral_type));
 	printf(").\n");
-	tmp_pointer = realloc(stree->tnode,
+	tmp_pointer = arena_realloc(stree->tnode,
 			new_tnode_size * sizeof (unsigned_integral_type));
 	if (tmp_pointer == NULL) {
 		perror("realloc(tnode)");
@@ -288,6 +299,93 @@ int st_slai_compute_childrens_lcp (
 	return (0);
 }
 
+/**
+ * A function which searches for the provided pattern
+ * in the suffix tree in the simple linear array (table tnode).
+ *
+ * @param
+ * pattern	the pattern to search for
+ * @param
+ * pattern_length	the length of the pattern
+ * @param
+ * occurrence	If the pattern has been found, the index to the text
+ * 		of the beginning of one of its occurrences
+ * 		will be stored here.
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * length	the actual length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * stree	the actual suffix tree
+ *
+ * @return	If the pattern occurs in the text, one (1) is returned.
+ * 		Otherwise, zero (0) is returned.
+ */
+int st_slai_find (const character_type *pattern,
+		size_t pattern_length,
+		size_t *occurrence,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai *stree) {
+	unsigned_integral_type current_text_idx = 0;
+	unsigned_integral_type clean_current_text_idx = 0;
+	/* the root's first child is always at the beginning */
+	size_t current_offset = 0;
+	size_t edge_length = 0;
+	size_t matched = 0;
+	size_t i = 0;
+	if (pattern_length == 0) {
+		(*occurrence) = 1;
+		return (1);
+	}
+	while (1) {
+		/* we look for the child starting with the next letter */
+		while (1) {
+			current_text_idx = stree->tnode[current_offset];
+			clean_current_text_idx = (current_text_idx &
+					~rightmost_child & ~leaf_node);
+			if (text[clean_current_text_idx] == pattern[matched]) {
+				break;
+			}
+			if ((current_text_idx & rightmost_child) > 0) {
+				return (0);
+			}
+			if ((current_text_idx & leaf_node) > 0) {
+				++current_offset;
+			} else {
+				current_offset += 2;
+			}
+		}
+		if ((current_text_idx & leaf_node) > 0) {
+			edge_length = length + 2 - clean_current_text_idx;
+		} else {
+			st_slai_compute_childrens_lcp(clean_current_text_idx,
+					(size_t)(stree->tnode[
+						current_offset + 1]),
+					&edge_length, stree);
+		}
+		/* the first letter has already been compared */
+		for (i = 1; (i < edge_length) &&
+				(matched + i < pattern_length); ++i) {
+			if (text[clean_current_text_idx + i] !=
+					pattern[matched + i]) {
+				return (0);
+			}
+		}
+		if (matched + i >= pattern_length) {
+			(*occurrence) = clean_current_text_idx - matched;
+			return (1);
+		}
+		matched += edge_length;
+		/* a leaf ends with the terminating character ($) */
+		if ((current_text_idx & leaf_node) > 0) {
+			return (0);
+		}
+		current_offset = (size_t)(stree->tnode[current_offset + 1]);
+	}
+}
+
 /**
  * A function which prints a single entry of the simple linear array
  * (table tnode) to the provided FILE * type stream.
@@ -350,9 +448,13 @@ int st_slai_print_tnode_entry (FILE *stream,
 /**
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
+ * The traversal is iterative. For each of the branching nodes
+ * on the path from the starting node to the node currently being visited,
+ * the explicit stack keeps the offset of its next child to be visited
+ * and its depth.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_offset	the offset of a node in the simple linear array
@@ -367,38 +469,47 @@ int st_slai_print_tnode_entry (FILE *stream,
  * log10l	A ceiling of base 10 logarithm of the number
  * 		of leaves. It will be used for printing alignment.
  * @param
- * internal_text_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stree	the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_slai_traverse_from (FILE *stream,
+int st_slai_traverse_from (traversal_output *output,
 		size_t starting_offset,
 		unsigned_integral_type parents_depth,
 		size_t log10bn,
 		size_t log10l,
-		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length,
+		traversal_stack *stack,
 		const suffix_tree_slai *stree) {
+	traversal_frame *frame = NULL;
 	unsigned_integral_type current_text_idx = 0;
 	unsigned_integral_type clean_current_text_idx = 0;
 	unsigned_integral_type childs_depth = 0;
 	signed_integral_type child = 0;
 	size_t childs_offset = 0;
 	size_t childrens_lcp_size = 0;
-	size_t current_offset = starting_offset;
-	/* we print all the children of the current parent node */
-	do {
+	size_t current_offset = 0;
+	size_t first_child_offset = 0;
+	stack->top = 0;
+	if (traversal_stack_push(stack, 0, 0, starting_offset,
+				parents_depth) > 0) {
+		return (3);
+	}
+	/* we print all the children of the node on top of the stack */
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		current_offset = frame->offset;
+		parents_depth = frame->depth;
 		current_text_idx = stree->tnode[current_offset];
 		/* we clear the possible rightmost_child flag */
 		clean_current_text_idx =
@@ -413,13 +524,12 @@ int st_slai_traverse_from (FILE *stream,
 			childs_offset = clean_current_text_idx -
 				parents_depth;
 			child = -(signed_integral_type)(childs_offset);
-			if (st_print_edge(stream, 1,
+			if (st_print_edge(output, 1,
 					(signed_integral_type)(0),
 					child, (signed_integral_type)(0),
 					parents_depth, childs_depth,
 					log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text) > 0) {
+					childs_offset, text) > 0) {
 				fprintf(stderr, "Error: Could not "
 						"print an edge!\n");
 				return (1);
@@ -427,45 +537,283 @@ int st_slai_traverse_from (FILE *stream,
 			++current_offset;
 		} else { /* otherwise it is a branching node */
 			++current_offset;
+			/* the first child of the current branching node */
+			first_child_offset =
+				(size_t)(stree->tnode[current_offset]);
 			st_slai_compute_childrens_lcp(clean_current_text_idx,
-				/*
-				 * the first child
-				 * of the current branching node
-				 */
-				(size_t)(stree->tnode[current_offset]),
+				first_child_offset,
 				&childrens_lcp_size, stree);
 			childs_depth = parents_depth +
 				(unsigned_integral_type)(childrens_lcp_size);
 			childs_offset = clean_current_text_idx -
 				parents_depth;
-			child = 0;
-			if (st_print_edge(stream, 0,
+			if (st_print_edge(output, 0,
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					parents_depth, childs_depth,
 					log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text) > 0) {
+					childs_offset, text) > 0) {
 				fprintf(stderr, "Error: Could not "
 						"print an edge!\n");
 				return (2);
 			}
-			if (st_slai_traverse_from(stream,
-			/* the first child of the current branching node */
-				(size_t)(stree->tnode[current_offset]),
-				childs_depth, log10bn, log10l,
-				internal_text_encoding, text, length,
-				stree) > 0) {
-				fprintf(stderr, "Error: The traversal "
-						"from the branching node\n"
-						"was unsuccessful. "
-						"Exiting!\n");
+			++current_offset;
+		}
+		if ((current_text_idx & rightmost_child) > 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+		} else {
+			frame->offset = current_offset;
+		}
+		if ((current_text_idx & leaf_node) == 0) {
+			/* descending to the children of the branching node */
+			if (traversal_stack_push(stack, 0, 0,
+						first_child_offset,
+						childs_depth) > 0) {
 				return (3);
 			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which walks through the whole subtree
+ * below the given node without printing anything
+ * and counts the visited nodes.
+ *
+ * @param
+ * starting_offset	the offset of the first child of the node
+ * 			in the simple linear array (table tnode),
+ * 			from which the walk starts
+ * @param
+ * branching_nodes	the number of the visited branching nodes,
+ * 			not including the starting node, will be added here
+ * @param
+ * leaves	the number of the visited leaves will be added here
+ * @param
+ * stack	the explicit stack to be used by the walk
+ * @param
+ * stree	the actual suffix tree which will be walked through
+ *
+ * @return	If we could successfully walk through the subtree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_walk_from (size_t starting_offset,
+		size_t *branching_nodes,
+		size_t *leaves,
+		traversal_stack *stack,
+		const suffix_tree_slai *stree) {
+	traversal_frame *frame = NULL;
+	unsigned_integral_type current_text_idx = 0;
+	size_t current_offset = 0;
+	size_t first_child_offset = 0;
+	stack->top = 0;
+	if (traversal_stack_push(stack, 0, 0, starting_offset, 0) > 0) {
+		return (1);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		current_offset = frame->offset;
+		current_text_idx = stree->tnode[current_offset];
+		if ((current_text_idx & leaf_node) > 0) {
+			++(*leaves);
 			++current_offset;
+		} else {
+			++(*branching_nodes);
+			first_child_offset =
+				(size_t)(stree->tnode[current_offset + 1]);
+			current_offset += 2;
 		}
-	} while ((current_text_idx & rightmost_child) == 0);
+		if ((current_text_idx & rightmost_child) > 0) {
+			--stack->top;
+		} else {
+			frame->offset = current_offset;
+		}
+		if ((current_text_idx & leaf_node) == 0) {
+			if (traversal_stack_push(stack, 0, 0,
+						first_child_offset, 0) > 0) {
+				return (1);
+			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which analyses the repeats in the whole suffix tree.
+ * It visits all the nodes without printing anything
+ * and summarizes each branching node bottom-up,
+ * after all of its children have been visited.
+ * Unlike the walk, a frame is removed from the stack only after
+ * the subtree of its rightmost child has been visited.
+ *
+ * @param
+ * analysis	the repeat analysis, which collects the results
+ * @param
+ * stack	the explicit stack to be used by the analysis
+ * @param
+ * stree	the actual suffix tree which will be analysed
+ *
+ * @return	If we could successfully analyse the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_analyse_repeats (repeat_analysis *analysis,
+		traversal_stack *stack,
+		const suffix_tree_slai *stree) {
+	traversal_frame *frame = NULL;
+	unsigned_integral_type current_text_idx = 0;
+	unsigned_integral_type clean_current_text_idx = 0;
+	unsigned_integral_type parents_depth = 0;
+	unsigned_integral_type childs_depth = 0;
+	size_t childrens_lcp_size = 0;
+	size_t current_offset = 0;
+	size_t first_child_offset = 0;
+	stack->top = 0;
+	analysis->top = 0;
+	/* the root is not stored in the table tnode */
+	if ((traversal_stack_push(stack, 0, 0, 0, 0) > 0) ||
+			(repeat_analysis_enter(0, 0, analysis) > 0)) {
+		return (1);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		if (frame->child != 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+			repeat_analysis_leave(analysis);
+			continue;
+		}
+		current_offset = frame->offset;
+		parents_depth = frame->depth;
+		current_text_idx = stree->tnode[current_offset];
+		clean_current_text_idx =
+			(current_text_idx & ~rightmost_child);
+		if ((current_text_idx & rightmost_child) > 0) {
+			/* the frame will be removed after this child */
+			frame->child = 1;
+		}
+		if ((current_text_idx & leaf_node) > 0) {
+			clean_current_text_idx ^= leaf_node;
+			frame->offset = current_offset + 1;
+			if (repeat_analysis_leaf((size_t)
+					(clean_current_text_idx -
+					 parents_depth), analysis) > 0) {
+				return (1);
+			}
+			continue;
+		}
+		first_child_offset = (size_t)(stree->tnode[current_offset + 1]);
+		frame->offset = current_offset + 2;
+		st_slai_compute_childrens_lcp(clean_current_text_idx,
+				first_child_offset,
+				&childrens_lcp_size, stree);
+		childs_depth = parents_depth +
+			(unsigned_integral_type)(childrens_lcp_size);
+		if ((traversal_stack_push(stack, 0, 0, first_child_offset,
+						childs_depth) > 0) ||
+				(repeat_analysis_enter(childs_depth,
+					(size_t)(clean_current_text_idx -
+						parents_depth),
+					analysis) > 0)) {
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which exports the suffix array and the LCP array
+ * of the whole suffix tree. It visits the leaves in the lexicographic
+ * order of their suffixes and streams them to the export.
+ * The leaf, whose edge consists of the terminating character ($) only,
+ * is exported before all the other children of its parent.
+ * The terminal leaf is the rightmost child of its parent,
+ * so it is found by scanning the children stored next to each other.
+ *
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ * @param
+ * stack	the explicit stack to be used by the export
+ * @param
+ * stree	the actual suffix tree which will be exported
+ *
+ * @return	If we could successfully export the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_export_arrays (array_export *export,
+		traversal_stack *stack,
+		const suffix_tree_slai *stree) {
+	traversal_frame *frame = NULL;
+	unsigned_integral_type current_text_idx = 0;
+	unsigned_integral_type clean_current_text_idx = 0;
+	unsigned_integral_type depth = 0;
+	size_t childrens_lcp_size = 0;
+	size_t current_offset = 0;
+	/* the offset of the first child of the root */
+	size_t first_child_offset = 0;
+	/* the text index of the terminal leaf */
+	unsigned_integral_type terminal =
+		(unsigned_integral_type)(export->length + 1);
+	/* if this variable evaluates to true, we enter a branching node */
+	int entering = 1;
+	stack->top = 0;
+	while (entering != 0) {
+		/* the terminal leaf can only be the rightmost child */
+		current_offset = first_child_offset;
+		while (((current_text_idx = stree->tnode[current_offset]) &
+					rightmost_child) == 0) {
+			current_offset += (current_text_idx & leaf_node) > 0 ?
+				1 : 2;
+		}
+		if ((current_text_idx & ~rightmost_child) ==
+				(terminal | leaf_node)) {
+			array_export_ancestor(depth, export);
+			array_export_leaf((size_t)(terminal - depth), export);
+		}
+		if (traversal_stack_push(stack, 0, 0, first_child_offset,
+					depth) > 0) {
+			return (1);
+		}
+		entering = 0;
+		while ((entering == 0) && (stack->top > 0)) {
+			frame = stack->frames + stack->top - 1;
+			current_offset = frame->offset;
+			current_text_idx = stree->tnode[current_offset];
+			clean_current_text_idx =
+				(current_text_idx & ~rightmost_child);
+			if ((current_text_idx & rightmost_child) > 0) {
+				/* all the children have been visited */
+				--stack->top;
+			} else {
+				frame->offset = current_offset +
+					((current_text_idx & leaf_node) > 0 ?
+					 1 : 2);
+			}
+			array_export_ancestor(frame->depth, export);
+			if ((current_text_idx & leaf_node) > 0) {
+				clean_current_text_idx ^= leaf_node;
+				if (clean_current_text_idx != terminal) {
+					array_export_leaf((size_t)
+						(clean_current_text_idx -
+						 frame->depth), export);
+				}
+				continue;
+			}
+			first_child_offset =
+				(size_t)(stree->tnode[current_offset + 1]);
+			st_slai_compute_childrens_lcp(clean_current_text_idx,
+					first_child_offset,
+					&childrens_lcp_size, stree);
+			depth = frame->depth +
+				(unsigned_integral_type)(childrens_lcp_size);
+			entering = 1;
+		}
+	}
 	return (0);
 }
 
@@ -494,6 +842,150 @@ int st_slai_dump_tnode (FILE *stream, const suffix_tree_slai *stree) {
 	return (0);
 }
 
+/**
+ * A function which prints a single task of the parallel traversal.
+ * It prints the edge of the task and unless the task is limited
+ * to the edge, also the whole subtree below its child.
+ * The child of the task is identified by its offset
+ * in the simple linear array (table tnode).
+ *
+ * @param
+ * output	the buffered output, to which the task will be printed
+ * @param
+ * task		the task to be printed
+ * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
+ * pool		the parallel traversal pool containing the task
+ *
+ * @return	If we could successfully print the task, 0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_traverse_task (traversal_output *output,
+		const traversal_task *task,
+		traversal_stack *stack,
+		const traversal_pool *pool) {
+	const suffix_tree_slai *stree =
+		(const suffix_tree_slai *)(pool->stree);
+	unsigned_integral_type parents_depth = task->edge.depth;
+	unsigned_integral_type current_text_idx =
+		stree->tnode[task->edge.offset];
+	/* we clear the possible rightmost_child flag */
+	unsigned_integral_type clean_current_text_idx =
+		(current_text_idx & ~rightmost_child);
+	unsigned_integral_type childs_depth = 0;
+	size_t childs_offset = 0;
+	size_t childrens_lcp_size = 0;
+	size_t first_child_offset = 0;
+	/* if the current node is a leaf node */
+	if ((current_text_idx & leaf_node) > 0) {
+		clean_current_text_idx ^= leaf_node;
+		childs_depth = parents_depth +
+			(unsigned_integral_type)(pool->length + 2) -
+			clean_current_text_idx;
+		childs_offset = clean_current_text_idx - parents_depth;
+		if (st_print_edge(output, 1, (signed_integral_type)(0),
+				-(signed_integral_type)(childs_offset),
+				(signed_integral_type)(0),
+				parents_depth, childs_depth,
+				pool->log10bn, pool->log10l,
+				childs_offset, pool->text) > 0) {
+			fprintf(stderr, "Error: Could not print an edge!\n");
+			return (1);
+		}
+		return (0);
+	}
+	first_child_offset = (size_t)(stree->tnode[task->edge.offset + 1]);
+	st_slai_compute_childrens_lcp(clean_current_text_idx,
+			first_child_offset, &childrens_lcp_size, stree);
+	childs_depth = parents_depth +
+		(unsigned_integral_type)(childrens_lcp_size);
+	childs_offset = clean_current_text_idx - parents_depth;
+	if (st_print_edge(output, 0, (signed_integral_type)(0),
+			(signed_integral_type)(0),
+			(signed_integral_type)(0),
+			parents_depth, childs_depth,
+			pool->log10bn, pool->log10l,
+			childs_offset, pool->text) > 0) {
+		fprintf(stderr, "Error: Could not print an edge!\n");
+		return (2);
+	}
+	if (task->edge_only != 0) {
+		return (0);
+	}
+	return (st_slai_traverse_from(output, first_child_offset,
+				childs_depth, pool->log10bn, pool->log10l,
+				pool->text, pool->length, stack, stree));
+}
+
+/**
+ * A function which adds the tasks of the parallel traversal
+ * for all the nodes, which are the children of the same parent.
+ *
+ * @param
+ * first_child_offset	the offset of the first child
+ * 			in the simple linear array (table tnode)
+ * @param
+ * parents_depth	the depth of the parent
+ * @param
+ * pool		the parallel traversal pool
+ *
+ * @return	If the tasks have been successfully added, 0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_add_tasks (size_t first_child_offset,
+		unsigned_integral_type parents_depth,
+		traversal_pool *pool) {
+	const suffix_tree_slai *stree =
+		(const suffix_tree_slai *)(pool->stree);
+	size_t current_offset = first_child_offset;
+	unsigned_integral_type current_text_idx = 0;
+	do {
+		current_text_idx = stree->tnode[current_offset];
+		if (traversal_pool_add((signed_integral_type)(0),
+					(signed_integral_type)(0),
+					current_offset, parents_depth,
+					pool) > 0) {
+			return (1);
+		}
+		/* the branching node occupies two cells */
+		current_offset += (current_text_idx & leaf_node) > 0 ? 1 : 2;
+	} while ((current_text_idx & rightmost_child) == 0);
+	return (0);
+}
+
+/**
+ * A function which adds the tasks of the parallel traversal
+ * for all the children of the child of the provided task.
+ *
+ * @param
+ * task		the task, whose child will be split
+ * @param
+ * pool		the parallel traversal pool
+ *
+ * @return	If the tasks have been successfully added, 0 is returned.
+ * 		If the child of the task is a leaf, (-1) is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_split_task (const traversal_task *task,
+		traversal_pool *pool) {
+	const suffix_tree_slai *stree =
+		(const suffix_tree_slai *)(pool->stree);
+	unsigned_integral_type current_text_idx =
+		stree->tnode[task->edge.offset];
+	size_t first_child_offset = 0;
+	size_t childrens_lcp_size = 0;
+	if ((current_text_idx & leaf_node) > 0) {
+		return (-1);
+	}
+	first_child_offset = (size_t)(stree->tnode[task->edge.offset + 1]);
+	st_slai_compute_childrens_lcp(current_text_idx & ~rightmost_child,
+			first_child_offset, &childrens_lcp_size, stree);
+	return (st_slai_add_tasks(first_child_offset, task->edge.depth +
+				(unsigned_integral_type)(childrens_lcp_size),
+				pool));
+}
+
 /* handling functions */
 
 /**
@@ -1001,9 +1493,14 @@ int st_slai_output_nodes (size_t lcp_size,
 	 * (we suppose there will be at least one node in this partition)
 	 */
 	if (tnode_offset != 0) {
-		/* and if it is necessary, we establish it */
+		/*
+		 * and if it is necessary, we establish it
+		 *
+		 * The cells, which have already been streamed
+		 * into the sink, still count in the offset.
+		 */
 		stree->tnode[tnode_offset] = (unsigned_integral_type)
-			(stree->tnode_top);
+			(stree->tnode_top + stree->tnode_flushed);
 	}
 	/* we iteratively examine all the suffixes in the provided range */
 	for (i = range_begin + 1; i < range_end; ++i) {
@@ -1293,6 +1790,13 @@ int st_slai_empty_partitions_stack (const character_type *text,
  * @param
  * traversal_type	the type of the traversal to perform
  * @param
+ * traversal_format	the format of the traversal output,
+ * 			either tf_text or tf_binary
+ * @param
+ * traversal_workers	the number of the worker threads, which traverse
+ * 			the subtrees in parallel. If it is 1,
+ * 			the traversal is serial.
+ * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
@@ -1306,9 +1810,17 @@ int st_slai_empty_partitions_stack (const character_type *text,
 int st_slai_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
+		size_t traversal_workers,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_slai *stree) {
+	/* the explicit stack of the traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	/* the buffered output of the traversal */
+	traversal_output output;
+	/* the tasks of the parallel traversal */
+	traversal_pool pool = {.tasks = NULL};
 	/* the starting offset of the first child of the root */
 	size_t starting_offset = 0;
 	/* the current number of branching nodes in the suffix tree */
@@ -1361,17 +1873,52 @@ int st_slai_traverse (FILE *stream,
 		printf("The traversal log is being dumped "
 				"to the specified file.\n");
 	}
-	fprintf(stream, "Simple suffix tree traversal BEGIN\n");
-	if (st_slai_traverse_from(stream, starting_offset,
+	if (traversal_output_open(stream, traversal_format,
+				internal_text_encoding, &output) > 0) {
+		fprintf(stderr, "Error: Could not prepare "
+				"the traversal output. Exiting!\n");
+		return (3);
+	}
+	traversal_output_begin(traversal_type, log10bn, log10l,
+			text, length + 2, (size_t)(0), &output);
+	if (traversal_workers > 1) {
+		pool.process = st_slai_traverse_task;
+		pool.split = st_slai_split_task;
+		pool.stree = stree;
+		pool.text = text;
+		pool.length = length;
+		pool.traversal_type = traversal_type;
+		pool.log10bn = log10bn;
+		pool.log10l = log10l;
+		if ((st_slai_add_tasks(starting_offset,
+					(unsigned_integral_type)(0),
+					&pool) > 0) ||
+				(traversal_pool_traverse(traversal_workers,
+					&output, &pool) > 0)) {
+			fprintf(stderr, "Error: The parallel traversal "
+					"was unsuccessful. Exiting!\n");
+			traversal_pool_free(&pool);
+			traversal_output_close(&output);
+			return (5);
+		}
+	} else if (st_slai_traverse_from(&output, starting_offset,
 		(unsigned_integral_type)(0), log10bn, log10l,
-		internal_text_encoding, text, length, stree) > 0) {
+		text, length, &stack, stree) > 0) {
 		fprintf(stderr, "Error: The traversal "
 				"from the branching node\n"
 				"was unsuccessful. "
 				"Exiting!\n");
+		traversal_output_close(&output);
+		traversal_stack_free(&stack);
 		return (2);
 	}
-	fprintf(stream, "Simple suffix tree traversal END\n");
+	traversal_stack_free(&stack);
+	traversal_output_end(traversal_type, &output);
+	if (traversal_output_close(&output) > 0) {
+		fprintf(stderr, "Error: Could not write "
+				"the traversal output. Exiting!\n");
+		return (4);
+	}
 	if (stream != stdout) {
 		printf("Dump complete.\n");
 	}
@@ -1398,15 +1945,23 @@ int st_slai_traverse (FILE *stream,
  */
 int st_slai_delete (suffix_tree_slai *stree) {
 	printf("Deleting the suffix tree\n");
+	/*
+	 * If the table tnode has been mapped back from the sink,
+	 * the mapping will be released when the sink is closed.
+	 */
+	if ((stree->sink != NULL) && (stree->tnode == stree->sink->mapping)) {
+		stree->tnode = NULL;
+	}
 	/*
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tnode);
+	arena_free(stree->tnode);
 	stree->tnode = NULL;
 	stree->branching_nodes = 0;
 	stree->tnode_top = 0;
 	stree->tnode_size = 0;
+	stree->tnode_flushed = 0;
 	/*
 	 * The other entries of the suffix_tree_slai struct
 	 * need not to be reset to zero.
@@ -0,0 +1,902 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * SLAI compact encoding implementation.
+ * This file contains the implementation of the functions,
+ * which convert the table tnode of the suffix tree
+ * in the implementation type SLAI into the compact
+ * variable-length encoding and which access the suffix tree
+ * stored in this encoding.
+ */
+#include "stree_slai_compact.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constants */
+
+/**
+ * The maximum number of small branching nodes, which need to be decoded
+ * when deriving the text index of a small branching node.
+ * If a branching node would exceed this limit,
+ * it is stored as a large node instead.
+ */
+const size_t compact_chain_limit = 4;
+
+/* supporting functions */
+
+/**
+ * A function which stores a single value
+ * using the variable-byte coding.
+ * Seven bits are stored in every byte, starting with the least
+ * significant ones. The most significant bit of a byte is set
+ * if the value continues in the next byte.
+ *
+ * @param
+ * value	the value to be stored
+ * @param
+ * buffer	the buffer, into which the value will be stored.
+ * 		It needs to have space for at least 10 bytes.
+ *
+ * @return	This function returns the number of bytes used.
+ */
+size_t st_slai_compact_put_value (size_t value,
+		unsigned char *buffer) {
+	size_t bytes = 0;
+	while (value > 127) {
+		buffer[bytes] = (unsigned char)((value & 127) | 128);
+		++bytes;
+		value = value >> 7;
+	}
+	buffer[bytes] = (unsigned char)(value);
+	return (bytes + 1);
+}
+
+/**
+ * A function which decodes a single node from the compact linear array.
+ *
+ * @param
+ * offset	the offset in the compact linear array of the node
+ * 		to be decoded. It will be moved just after this node.
+ * @param
+ * node		the decoded node will be stored here
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	This function always returns zero (0).
+ */
+int st_slai_compact_decode_node (size_t *offset,
+		slai_compact_node *node,
+		const suffix_tree_slai_compact *ctree) {
+	const unsigned char *current = ctree->tnode + (*offset);
+	size_t value = 0;
+	size_t distance = 0;
+	size_t shift = 0;
+	/* the first value */
+	do {
+		value |= (size_t)((*current) & 127) << shift;
+		shift += 7;
+	} while (((*(current++)) & 128) != 0);
+	node->leaf = (int)(value & 1);
+	node->rightmost = (int)((value >> 1) & 1);
+	if (node->leaf != 0) {
+		node->large = 0;
+		node->text_idx = value >> 2;
+		(*offset) = (size_t)(current - ctree->tnode);
+		return (0);
+	}
+	node->large = (int)((value >> 2) & 1);
+	node->edge_length = value >> 3;
+	/* the distance to the first child */
+	shift = 0;
+	do {
+		distance |= (size_t)((*current) & 127) << shift;
+		shift += 7;
+	} while (((*(current++)) & 128) != 0);
+	if (node->large != 0) {
+		value = 0;
+		shift = 0;
+		do {
+			value |= (size_t)((*current) & 127) << shift;
+			shift += 7;
+		} while (((*(current++)) & 128) != 0);
+		node->text_idx = value;
+	} else {
+		node->text_idx = 0;
+	}
+	(*offset) = (size_t)(current - ctree->tnode);
+	node->first_child = (*offset) + distance;
+	return (0);
+}
+
+/**
+ * A function which determines the index to the text
+ * of the beginning of the label of an edge, which ends
+ * at the provided node. For the small branching nodes,
+ * it follows their first children until it reaches a leaf
+ * or a large branching node.
+ *
+ * @param
+ * node		the already decoded node
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	This function returns the determined index to the text.
+ */
+size_t st_slai_compact_text_idx (const slai_compact_node *node,
+		const suffix_tree_slai_compact *ctree) {
+	slai_compact_node current = (*node);
+	/* the sum of the edge label lengths on the path */
+	size_t path_length = 0;
+	size_t offset = 0;
+	while ((current.leaf == 0) && (current.large == 0)) {
+		path_length += current.edge_length;
+		offset = current.first_child;
+		st_slai_compact_decode_node(&offset, &current, ctree);
+	}
+	return (current.text_idx - path_length);
+}
+
+/**
+ * A function which finds the child of a branching node,
+ * whose edge label starts with the provided letter.
+ *
+ * @param
+ * first_child	the offset in the compact linear array
+ * 		of the first child of the branching node
+ * @param
+ * letter	the first letter of the desired edge label
+ * @param
+ * child	the found child will be stored here
+ * @param
+ * child_text_idx	an index to the text of the beginning
+ * 			of the edge label of the found child
+ * 			will be stored here
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	If the desired child has been found, one (1) is returned.
+ * 		Otherwise, zero (0) is returned.
+ */
+int st_slai_compact_branch_once (size_t first_child,
+		character_type letter,
+		slai_compact_node *child,
+		size_t *child_text_idx,
+		const character_type *text,
+		const suffix_tree_slai_compact *ctree) {
+	size_t offset = first_child;
+	do {
+		st_slai_compact_decode_node(&offset, child, ctree);
+		(*child_text_idx) = st_slai_compact_text_idx(child, ctree);
+		if (text[(*child_text_idx)] == letter) {
+			return (1);
+		}
+	} while (child->rightmost == 0);
+	return (0);
+}
+
+/* handling functions */
+
+/**
+ * A function which creates the suffix tree in the compact encoding
+ * from the already constructed suffix tree in the implementation type SLAI.
+ *
+ * The table tnode is processed backwards, so that all the children
+ * of a branching node are already encoded when the branching node itself
+ * is being encoded. This way, the distances to the first children
+ * are known and they can be stored using the variable-byte coding.
+ *
+ * @param
+ * length	the final length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * stree	the actual suffix tree in the implementation type SLAI
+ * @param
+ * ctree	the suffix tree in the compact encoding,
+ * 		which will be created
+ *
+ * @return	If the suffix tree in the compact encoding
+ * 		has been successfully created, zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_compact_create (size_t length,
+		const suffix_tree_slai *stree,
+		suffix_tree_slai_compact *ctree) {
+	/* the offsets in the table tnode of all the nodes */
+	size_t *starts = NULL;
+	/*
+	 * the number of bytes from the beginning of each node
+	 * to the end of the compact linear array
+	 */
+	size_t *distances = NULL;
+	/*
+	 * The number of small branching nodes, which need to be decoded
+	 * to derive the text index of each branching node.
+	 * It is zero for the leaves and the large branching nodes.
+	 */
+	unsigned char *chains = NULL;
+	/* the buffer for a single encoded node */
+	unsigned char node_buffer[32] = {0};
+	/* the maximum number of bytes used by the compact linear array */
+	size_t bound = 0;
+	/* the current beginning of the encoded nodes */
+	size_t position = 0;
+	size_t nodes = 0;
+	size_t i = 0;
+	size_t node_offset = 0;
+	size_t first_child = 0;
+	size_t edge_length = 0;
+	size_t chain = 0;
+	size_t bytes = 0;
+	size_t tnode_bytes = stree->tnode_top * sizeof (unsigned_integral_type);
+	unsigned_integral_type value = 0;
+	unsigned_integral_type clean_value = 0;
+	void *tmp_pointer = NULL;
+	printf("Converting the table tnode into the compact encoding\n");
+	/* the leaves and all the branching nodes except for the root */
+	nodes = length + stree->branching_nodes;
+	starts = calloc(nodes, sizeof (size_t));
+	distances = calloc(stree->tnode_top, sizeof (size_t));
+	chains = calloc(stree->tnode_top, sizeof (unsigned char));
+	/*
+	 * Every leaf needs at most 5 bytes
+	 * and every branching node at most 20 bytes.
+	 */
+	bound = (length + 1) * 5 + stree->branching_nodes * 20;
+	ctree->tnode = malloc(bound);
+	if ((starts == NULL) || (distances == NULL) || (chains == NULL) ||
+			(ctree->tnode == NULL)) {
+		perror("st_slai_compact_create: calloc");
+		/* resetting the errno */
+		errno = 0;
+		free(starts);
+		free(distances);
+		free(chains);
+		free(ctree->tnode);
+		ctree->tnode = NULL;
+		return (1);
+	} else {
+		/* resetting the errno */
+		errno = 0;
+	}
+	/* at first, we find where the individual nodes start */
+	nodes = 0;
+	for (node_offset = 0; node_offset < stree->tnode_top; ++nodes) {
+		starts[nodes] = node_offset;
+		if ((stree->tnode[node_offset] & leaf_node) > 0) {
+			++node_offset;
+		} else {
+			node_offset += 2;
+		}
+	}
+	ctree->branching_nodes = stree->branching_nodes;
+	ctree->small_nodes = 0;
+	ctree->large_nodes = 0;
+	position = bound;
+	/* and then we encode them backwards */
+	for (i = nodes; i > 0; --i) {
+		node_offset = starts[i - 1];
+		value = stree->tnode[node_offset];
+		clean_value = value & ~rightmost_child & ~leaf_node;
+		if ((value & leaf_node) > 0) {
+			bytes = st_slai_compact_put_value(
+					((size_t)(clean_value) << 2) |
+					((value & rightmost_child) > 0 ?
+					 (size_t)(2) : (size_t)(0)) |
+					(size_t)(1), node_buffer);
+		} else {
+			first_child = (size_t)(stree->tnode[node_offset + 1]);
+			st_slai_compute_childrens_lcp(clean_value, first_child,
+					&edge_length, stree);
+			/*
+			 * If the first child is a leaf or a large node,
+			 * its chain is zero and this node can derive
+			 * its text index from it directly.
+			 */
+			chain = (size_t)(chains[first_child]) + 1;
+			if (chain > compact_chain_limit) {
+				chain = 0;
+				++ctree->large_nodes;
+			} else {
+				++ctree->small_nodes;
+			}
+			chains[node_offset] = (unsigned char)(chain);
+			bytes = st_slai_compact_put_value((edge_length << 3) |
+					(chain == 0 ? (size_t)(4) :
+					 (size_t)(0)) |
+					((value & rightmost_child) > 0 ?
+					 (size_t)(2) : (size_t)(0)),
+					node_buffer);
+			/*
+			 * the distance from the end of this node
+			 * to the beginning of its first child
+			 */
+			bytes += st_slai_compact_put_value((bound - position) -
+					distances[first_child],
+					node_buffer + bytes);
+			if (chain == 0) {
+				bytes += st_slai_compact_put_value(
+						(size_t)(clean_value),
+						node_buffer + bytes);
+			}
+		}
+		position -= bytes;
+		memcpy(ctree->tnode + position, node_buffer, bytes);
+		distances[node_offset] = bound - position;
+	}
+	free(starts);
+	free(distances);
+	free(chains);
+	ctree->tnode_size = bound - position;
+	memmove(ctree->tnode, ctree->tnode + position, ctree->tnode_size);
+	tmp_pointer = realloc(ctree->tnode, ctree->tnode_size);
+	if (tmp_pointer == NULL) {
+		perror("st_slai_compact_create: realloc");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	} else {
+		/*
+		 * Despite that the call to the realloc seems
+		 * to have been successful, we reset the errno,
+		 * because at least on Mac OS X
+		 * it might have changed.
+		 */
+		errno = 0;
+		ctree->tnode = tmp_pointer;
+	}
+	printf("\nCompact encoding statistics:\n"
+			"----------------------------\n");
+	printf("Number of small branching nodes: %zu\n", ctree->small_nodes);
+	printf("Number of large branching nodes: %zu\n", ctree->large_nodes);
+	printf("Size of the table tnode: %zu bytes (", tnode_bytes);
+	print_human_readable_size(stdout, tnode_bytes);
+	printf(")\nwhich is %.3f bytes per input character.\n",
+			(double)(tnode_bytes) / (double)(length));
+	printf("Size of the compact linear array: %zu bytes (",
+			ctree->tnode_size);
+	print_human_readable_size(stdout, ctree->tnode_size);
+	printf(")\nwhich is %.3f bytes per input character.\n\n",
+			(double)(ctree->tnode_size) / (double)(length));
+	return (0);
+}
+
+/**
+ * A function which searches for the provided pattern
+ * in the suffix tree in the compact encoding.
+ *
+ * @param
+ * pattern	the pattern to search for
+ * @param
+ * pattern_length	the length of the pattern
+ * @param
+ * occurrence	If the pattern has been found, the index to the text
+ * 		of the beginning of one of its occurrences
+ * 		will be stored here.
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * length	the actual length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	If the pattern occurs in the text, one (1) is returned.
+ * 		Otherwise, zero (0) is returned.
+ */
+int st_slai_compact_find (const character_type *pattern,
+		size_t pattern_length,
+		size_t *occurrence,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai_compact *ctree) {
+	slai_compact_node child = {.leaf = 0};
+	/* the root's first child is always at the beginning */
+	size_t first_child = 0;
+	size_t child_text_idx = 0;
+	size_t edge_length = 0;
+	size_t matched = 0;
+	size_t i = 0;
+	if (pattern_length == 0) {
+		(*occurrence) = 1;
+		return (1);
+	}
+	while (1) {
+		if (st_slai_compact_branch_once(first_child,
+					pattern[matched], &child,
+					&child_text_idx, text, ctree) == 0) {
+			return (0);
+		}
+		if (child.leaf != 0) {
+			edge_length = length + 2 - child_text_idx;
+		} else {
+			edge_length = child.edge_length;
+		}
+		/* the first letter has already been compared */
+		for (i = 1; (i < edge_length) &&
+				(matched + i < pattern_length); ++i) {
+			if (text[child_text_idx + i] != pattern[matched + i]) {
+				return (0);
+			}
+		}
+		if (matched + i >= pattern_length) {
+			(*occurrence) = child_text_idx - matched;
+			return (1);
+		}
+		matched += edge_length;
+		/* a leaf ends with the terminating character ($) */
+		if (child.leaf != 0) {
+			return (0);
+		}
+		first_child = child.first_child;
+	}
+}
+
+/**
+ * A function which traverses and prints the suffix tree
+ * in the compact encoding while starting from the given node.
+ * The traversal is iterative. For each of the branching nodes
+ * on the path from the starting node to the node currently being visited,
+ * the explicit stack keeps the offset of its next child to be decoded
+ * and its depth.
+ *
+ * @param
+ * output	the buffered output, to which the traversal progress
+ * 		will be written
+ * @param
+ * starting_offset	the offset of a node in the compact linear array,
+ * 			from which the traversal starts
+ * @param
+ * parents_depth	the depth of a parent, from which
+ * 			this traversal starts
+ * @param
+ * log10bn	A ceiling of base 10 logarithm of the number
+ * 		of branching nodes. It will be used for printing alignment.
+ * @param
+ * log10l	A ceiling of base 10 logarithm of the number
+ * 		of leaves. It will be used for printing alignment.
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * length	the actual length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	If we could successfully traverse and print the suffix tree
+ * 		and if we could start from the given node, 0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_compact_traverse_from (traversal_output *output,
+		size_t starting_offset,
+		unsigned_integral_type parents_depth,
+		size_t log10bn,
+		size_t log10l,
+		const character_type *text,
+		size_t length,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree) {
+	traversal_frame *frame = NULL;
+	slai_compact_node node = {.leaf = 0};
+	unsigned_integral_type childs_depth = 0;
+	size_t childs_offset = 0;
+	size_t current_offset = 0;
+	stack->top = 0;
+	if (traversal_stack_push(stack, 0, 0, starting_offset,
+				parents_depth) > 0) {
+		return (3);
+	}
+	/* we print all the children of the node on top of the stack */
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		current_offset = frame->offset;
+		parents_depth = frame->depth;
+		st_slai_compact_decode_node(&current_offset, &node, ctree);
+		if (node.leaf != 0) {
+			childs_depth = parents_depth +
+				(unsigned_integral_type)(length + 2) -
+				(unsigned_integral_type)(node.text_idx);
+			childs_offset = node.text_idx - parents_depth;
+			if (st_print_edge(output, 1,
+					(signed_integral_type)(0),
+					-(signed_integral_type)(childs_offset),
+					(signed_integral_type)(0),
+					parents_depth, childs_depth,
+					log10bn, log10l,
+					childs_offset, text) > 0) {
+				fprintf(stderr, "Error: Could not "
+						"print an edge!\n");
+				return (1);
+			}
+		} else { /* otherwise it is a branching node */
+			childs_depth = parents_depth +
+				(unsigned_integral_type)(node.edge_length);
+			childs_offset = st_slai_compact_text_idx(&node, ctree) -
+				parents_depth;
+			if (st_print_edge(output, 0,
+					(signed_integral_type)(0),
+					(signed_integral_type)(0),
+					(signed_integral_type)(0),
+					parents_depth, childs_depth,
+					log10bn, log10l,
+					childs_offset, text) > 0) {
+				fprintf(stderr, "Error: Could not "
+						"print an edge!\n");
+				return (2);
+			}
+		}
+		if (node.rightmost != 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+		} else {
+			frame->offset = current_offset;
+		}
+		if (node.leaf == 0) {
+			/* descending to the children of the branching node */
+			if (traversal_stack_push(stack, 0, 0,
+						node.first_child,
+						childs_depth) > 0) {
+				return (3);
+			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which walks through the whole subtree below the given node
+ * of the suffix tree in the compact encoding without printing anything
+ * and counts the visited nodes.
+ *
+ * @param
+ * starting_offset	the offset of the first child of the node
+ * 			in the compact linear array,
+ * 			from which the walk starts
+ * @param
+ * branching_nodes	the number of the visited branching nodes,
+ * 			not including the starting node, will be added here
+ * @param
+ * leaves	the number of the visited leaves will be added here
+ * @param
+ * stack	the explicit stack to be used by the walk
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	If we could successfully walk through the subtree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_compact_walk_from (size_t starting_offset,
+		size_t *branching_nodes,
+		size_t *leaves,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree) {
+	traversal_frame *frame = NULL;
+	slai_compact_node node = {.leaf = 0};
+	size_t current_offset = 0;
+	stack->top = 0;
+	if (traversal_stack_push(stack, 0, 0, starting_offset, 0) > 0) {
+		return (1);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		current_offset = frame->offset;
+		st_slai_compact_decode_node(&current_offset, &node, ctree);
+		if (node.leaf != 0) {
+			++(*leaves);
+		} else {
+			++(*branching_nodes);
+		}
+		if (node.rightmost != 0) {
+			--stack->top;
+		} else {
+			frame->offset = current_offset;
+		}
+		if (node.leaf == 0) {
+			if (traversal_stack_push(stack, 0, 0,
+						node.first_child, 0) > 0) {
+				return (1);
+			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which analyses the repeats in the whole suffix tree.
+ * It visits all the nodes without printing anything
+ * and summarizes each branching node bottom-up,
+ * after all of its children have been visited.
+ * Unlike the walk, a frame is removed from the stack only after
+ * the subtree of its rightmost child has been visited.
+ *
+ * @param
+ * analysis	the repeat analysis, which collects the results
+ * @param
+ * stack	the explicit stack to be used by the analysis
+ * @param
+ * ctree	the actual suffix tree which will be analysed
+ *
+ * @return	If we could successfully analyse the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_compact_analyse_repeats (repeat_analysis *analysis,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree) {
+	traversal_frame *frame = NULL;
+	slai_compact_node node = {.leaf = 0};
+	unsigned_integral_type parents_depth = 0;
+	unsigned_integral_type childs_depth = 0;
+	size_t current_offset = 0;
+	stack->top = 0;
+	analysis->top = 0;
+	/* the root is not stored in the compact encoding */
+	if ((traversal_stack_push(stack, 0, 0, 0, 0) > 0) ||
+			(repeat_analysis_enter(0, 0, analysis) > 0)) {
+		return (1);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		if (frame->child != 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+			repeat_analysis_leave(analysis);
+			continue;
+		}
+		current_offset = frame->offset;
+		parents_depth = frame->depth;
+		st_slai_compact_decode_node(&current_offset, &node, ctree);
+		frame->offset = current_offset;
+		if (node.rightmost != 0) {
+			/* the frame will be removed after this child */
+			frame->child = 1;
+		}
+		if (node.leaf != 0) {
+			if (repeat_analysis_leaf((size_t)(node.text_idx -
+						parents_depth),
+						analysis) > 0) {
+				return (1);
+			}
+			continue;
+		}
+		childs_depth = parents_depth +
+			(unsigned_integral_type)(node.edge_length);
+		if ((traversal_stack_push(stack, 0, 0, node.first_child,
+						childs_depth) > 0) ||
+				(repeat_analysis_enter(childs_depth,
+					(size_t)(st_slai_compact_text_idx(
+						&node, ctree) -
+						parents_depth),
+					analysis) > 0)) {
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which exports the suffix array and the LCP array
+ * of the whole suffix tree. It visits the leaves in the lexicographic
+ * order of their suffixes and streams them to the export.
+ * The leaf, whose edge consists of the terminating character ($) only,
+ * is exported before all the other children of its parent.
+ * The terminal leaf is the rightmost child of its parent,
+ * so it is found by scanning the children stored next to each other.
+ *
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ * @param
+ * stack	the explicit stack to be used by the export
+ * @param
+ * ctree	the actual suffix tree which will be exported
+ *
+ * @return	If we could successfully export the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slai_compact_export_arrays (array_export *export,
+		traversal_stack *stack,
+		const suffix_tree_slai_compact *ctree) {
+	traversal_frame *frame = NULL;
+	slai_compact_node node = {.leaf = 0};
+	unsigned_integral_type depth = 0;
+	size_t current_offset = 0;
+	/* the offset of the first child of the root */
+	size_t first_child_offset = 0;
+	/* the text index of the terminal leaf */
+	size_t terminal = export->length + 1;
+	/* if this variable evaluates to true, we enter a branching node */
+	int entering = 1;
+	stack->top = 0;
+	while (entering != 0) {
+		/* the terminal leaf can only be the rightmost child */
+		current_offset = first_child_offset;
+		do {
+			st_slai_compact_decode_node(&current_offset,
+					&node, ctree);
+		} while (node.rightmost == 0);
+		if ((node.leaf != 0) && (node.text_idx == terminal)) {
+			array_export_ancestor(depth, export);
+			array_export_leaf(terminal - depth, export);
+		}
+		if (traversal_stack_push(stack, 0, 0, first_child_offset,
+					depth) > 0) {
+			return (1);
+		}
+		entering = 0;
+		while ((entering == 0) && (stack->top > 0)) {
+			frame = stack->frames + stack->top - 1;
+			current_offset = frame->offset;
+			st_slai_compact_decode_node(&current_offset,
+					&node, ctree);
+			if (node.rightmost != 0) {
+				/* all the children have been visited */
+				--stack->top;
+			} else {
+				frame->offset = current_offset;
+			}
+			array_export_ancestor(frame->depth, export);
+			if (node.leaf != 0) {
+				if (node.text_idx != terminal) {
+					array_export_leaf(node.text_idx -
+							frame->depth, export);
+				}
+				continue;
+			}
+			first_child_offset = node.first_child;
+			depth = frame->depth +
+				(unsigned_integral_type)(node.edge_length);
+			entering = 1;
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which traverses the suffix tree in the compact encoding
+ * while printing its edges. Only the simple traversal type is supported.
+ *
+ * @param
+ * stream	the FILE * type stream to which the traversal progress
+ * 		will be written
+ * @param
+ * internal_text_encoding	The character encoding used in the internal
+ * 				representation of the text for the suffix tree.
+ * @param
+ * traversal_format	the format of the traversal output,
+ * 			either tf_text or tf_binary
+ * @param
+ * text		the actual underlying text of the suffix tree
+ * @param
+ * length	the actual length of the underlying text in the suffix tree
+ * 		(number of the "real" characters in the text)
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ *
+ * @return	If the traversal was successful, zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_compact_traverse (FILE *stream,
+		const char *internal_text_encoding,
+		int traversal_format,
+		const character_type *text,
+		size_t length,
+		const suffix_tree_slai_compact *ctree) {
+	/* the explicit stack of the traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	/* the buffered output of the traversal */
+	traversal_output output;
+	/* the current number of branching nodes in the suffix tree */
+	size_t branching_nodes = ctree->branching_nodes;
+	/*
+	 * The current number of leaves in the suffix tree.
+	 * We have to include the suffix consisting of
+	 * the terminating character ($) only.
+	 */
+	size_t leaves = length + 1;
+	/*
+	 * a ceiling of base 10 logarithm of the number of branching nodes
+	 * (it will be used for printing alignment)
+	 */
+	size_t log10bn = 1;
+	/*
+	 * a ceiling of base 10 logarithm of the number of leaves
+	 * (it will be used for printing alignment)
+	 */
+	size_t log10l = 1;
+	while (branching_nodes > 9) {
+		++log10bn;
+		branching_nodes = branching_nodes / 10;
+	}
+	while (leaves > 9) {
+		++log10l;
+		leaves = leaves / 10;
+	}
+	printf("Traversing the suffix tree in the compact encoding\n\n");
+	if (stream != stdout) {
+		printf("The traversal log is being dumped "
+				"to the specified file.\n");
+	}
+	if (traversal_output_open(stream, traversal_format,
+				internal_text_encoding, &output) > 0) {
+		fprintf(stderr, "Error: Could not prepare "
+				"the traversal output. Exiting!\n");
+		return (2);
+	}
+	traversal_output_begin(tt_simple, log10bn, log10l,
+			text, length + 2, (size_t)(0), &output);
+	if (st_slai_compact_traverse_from(&output, (size_t)(0),
+		(unsigned_integral_type)(0), log10bn, log10l,
+		text, length, &stack, ctree) > 0) {
+		fprintf(stderr, "Error: The traversal "
+				"from the branching node\n"
+				"was unsuccessful. "
+				"Exiting!\n");
+		traversal_output_close(&output);
+		traversal_stack_free(&stack);
+		return (1);
+	}
+	traversal_stack_free(&stack);
+	traversal_output_end(tt_simple, &output);
+	if (traversal_output_close(&output) > 0) {
+		fprintf(stderr, "Error: Could not write "
+				"the traversal output. Exiting!\n");
+		return (3);
+	}
+	if (stream != stdout) {
+		printf("Dump complete.\n");
+	}
+	printf("\nTraversing completed\n\n");
+	return (0);
+}
+
+/**
+ * A function which deallocates the memory used
+ * by the suffix tree in the compact encoding.
+ *
+ * @param
+ * ctree	the actual suffix tree in the compact encoding
+ * 		to be "deleted"
+ *
+ * @return	This function always returns zero.
+ */
+int st_slai_compact_delete (suffix_tree_slai_compact *ctree) {
+	printf("Deleting the suffix tree in the compact encoding\n");
+	/*
+	 * it is always safe to delete the NULL pointer,
+	 * so we need not to check for it
+	 */
+	free(ctree->tnode);
+	ctree->tnode = NULL;
+	ctree->tnode_size = 0;
+	ctree->branching_nodes = 0;
+	ctree->small_nodes = 0;
+	ctree->large_nodes = 0;
+	printf("Successfully deleted!\n");
+	return (0);
+}
@@ -0,0 +1,439 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * SLAI tnode sink implementation.
+ * This file contains the implementation of the functions,
+ * which stream the completed parts of the table tnode
+ * into a file while the suffix tree is being constructed
+ * using the PWOTD algorithm and the implementation type SLAI.
+ */
+#include "stree_slai_sink.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* constants */
+
+/**
+ * The minimum number of cells, which need to be gathered in the fill buffer
+ * before it is handed over to the writing thread.
+ * Smaller hand-overs would make the writing thread wake up
+ * for almost every single partition.
+ */
+const size_t sink_flush_threshold = 262144; /* 2^18 cells */
+
+/* supporting functions */
+
+/**
+ * A function which writes the provided cells
+ * at the specified position in the output file.
+ *
+ * @param
+ * cells	the cells to be written
+ * @param
+ * count	the number of cells to be written
+ * @param
+ * position	the offset in the table tnode of the first cell
+ * @param
+ * sink		the actual sink
+ *
+ * @return	If all the cells have been successfully written,
+ * 		zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_sink_pwrite (const unsigned_integral_type *cells,
+		size_t count,
+		size_t position,
+		slai_tnode_sink *sink) {
+	const char *buffer = (const char *)(cells);
+	size_t bytes_left = count * sizeof (unsigned_integral_type);
+	off_t offset = (off_t)(position * sizeof (unsigned_integral_type));
+	ssize_t bytes_written = 0;
+	while (bytes_left > 0) {
+		bytes_written = pwrite(sink->fd, buffer, bytes_left, offset);
+		if (bytes_written == (-1)) {
+			if (errno == EINTR) {
+				/* resetting the errno */
+				errno = 0;
+				continue;
+			}
+			perror("st_slai_sink_pwrite: pwrite");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
+		buffer += bytes_written;
+		bytes_left -= (size_t)(bytes_written);
+		offset += (off_t)(bytes_written);
+		sink->bytes_written += (size_t)(bytes_written);
+	}
+	return (0);
+}
+
+#ifdef	ST_USE_PTHREAD
+/**
+ * A function executed by the writing thread.
+ * It waits until the flush buffer is handed over by the main thread
+ * and writes it into the output file.
+ *
+ * @param
+ * arg		the pointer to the sink
+ *
+ * @return	This function always returns NULL.
+ */
+void *sink_writing_thread_function (void *arg) {
+	slai_tnode_sink *sink = arg;
+	int retval = 0;
+	pthread_mutex_lock(&sink->mx);
+	while (1) {
+		while ((sink->flush_pending == 0) && (sink->finished == 0)) {
+			pthread_cond_wait(&sink->cv, &sink->mx);
+		}
+		if (sink->flush_pending == 0) {
+			/* there is nothing more to write */
+			break;
+		}
+		/*
+		 * The main thread will not touch the flush buffer
+		 * until we clear the flush_pending flag,
+		 * so we can write it without holding the mutex.
+		 */
+		pthread_mutex_unlock(&sink->mx);
+		retval = st_slai_sink_pwrite(sink->flush_buffer,
+				sink->flush_top, sink->flush_position, sink);
+		pthread_mutex_lock(&sink->mx);
+		if ((retval > 0) && (sink->error == 0)) {
+			sink->error = retval;
+		}
+		sink->flush_pending = 0;
+		pthread_cond_signal(&sink->cv);
+	}
+	pthread_mutex_unlock(&sink->mx);
+	return (NULL);
+}
+#endif
+
+/**
+ * A function which hands the fill buffer over to the writing thread.
+ * If the threading is not available, the fill buffer is written directly.
+ *
+ * @param
+ * sink		the actual sink
+ *
+ * @return	If the fill buffer has been successfully handed over,
+ * 		zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_sink_hand_over (slai_tnode_sink *sink) {
+#ifdef	ST_USE_PTHREAD
+	unsigned_integral_type *tmp_buffer = NULL;
+	size_t tmp_size = 0;
+	pthread_mutex_lock(&sink->mx);
+	/* we wait until the writing thread has finished the previous buffer */
+	while (sink->flush_pending != 0) {
+		pthread_cond_wait(&sink->cv, &sink->mx);
+	}
+	if (sink->error != 0) {
+		pthread_mutex_unlock(&sink->mx);
+		return (1);
+	}
+	/* swapping the buffers */
+	tmp_buffer = sink->flush_buffer;
+	tmp_size = sink->flush_buffer_size;
+	sink->flush_buffer = sink->fill_buffer;
+	sink->flush_buffer_size = sink->fill_buffer_size;
+	sink->fill_buffer = tmp_buffer;
+	sink->fill_buffer_size = tmp_size;
+	sink->flush_top = sink->fill_top;
+	sink->flush_position = sink->fill_position;
+	sink->fill_top = 0;
+	sink->flush_pending = 1;
+	++sink->flushes;
+	pthread_cond_signal(&sink->cv);
+	pthread_mutex_unlock(&sink->mx);
+#else
+	if (st_slai_sink_pwrite(sink->fill_buffer, sink->fill_top,
+				sink->fill_position, sink) > 0) {
+		return (1);
+	}
+	sink->fill_top = 0;
+	++sink->flushes;
+#endif
+	return (0);
+}
+
+/* handling functions */
+
+/**
+ * A function which opens the sink and starts the writing thread.
+ *
+ * @param
+ * file_name	the name of the file, into which the table tnode
+ * 		will be streamed. If it exists, it will be truncated.
+ * @param
+ * sink		the actual sink to be opened
+ *
+ * @return	If the sink has been successfully opened, zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_sink_open (const char *file_name,
+		slai_tnode_sink *sink) {
+#ifdef	ST_USE_PTHREAD
+	/* the return value from the pthread_create function */
+	int retval = 0;
+#endif
+	sink->fill_buffer = NULL;
+	sink->flush_buffer = NULL;
+	sink->fill_buffer_size = 0;
+	sink->flush_buffer_size = 0;
+	sink->fill_top = 0;
+	sink->flush_top = 0;
+	sink->fill_position = 0;
+	sink->flush_position = 0;
+	sink->bytes_written = 0;
+	sink->flushes = 0;
+	sink->mapped_cells = 0;
+	sink->mapping = NULL;
+	sink->flush_pending = 0;
+	sink->finished = 0;
+	sink->error = 0;
+	sink->file_name = file_name;
+	sink->fd = open(file_name, O_RDWR | O_CREAT | O_TRUNC,
+			S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (sink->fd == (-1)) {
+		perror("<tnode_filename>: open");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	printf("The table tnode will be streamed to the file '%s'\n\n",
+			file_name);
+#ifdef	ST_USE_PTHREAD
+	pthread_mutex_init(&sink->mx, NULL);
+	pthread_cond_init(&sink->cv, NULL);
+	if ((retval = pthread_create(&sink->writer, NULL,
+			sink_writing_thread_function, sink)) != 0) {
+		errno = retval;
+		perror("pthread_create");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+#endif
+	return (0);
+}
+
+/**
+ * A function which appends the provided completed cells of the table tnode
+ * to the sink. The cells are copied, so the caller is free to reuse
+ * the memory they occupy immediately after this function returns.
+ *
+ * @param
+ * cells	the cells to be written
+ * @param
+ * count	the number of cells to be written
+ * @param
+ * position	the offset in the table tnode of the first cell
+ * @param
+ * sink		the actual sink
+ *
+ * @return	If the cells have been successfully stored, zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_sink_write (const unsigned_integral_type *cells,
+		size_t count,
+		size_t position,
+		slai_tnode_sink *sink) {
+	void *tmp_pointer = NULL;
+	size_t new_size = 0;
+	/*
+	 * if the new cells do not continue the cells
+	 * already present in the fill buffer,
+	 * we need to hand it over at first
+	 */
+	if ((sink->fill_top > 0) &&
+			(sink->fill_position + sink->fill_top != position)) {
+		if (st_slai_sink_hand_over(sink) > 0) {
+			fprintf(stderr, "Error: Could not hand over "
+					"the tnode sink buffer!\n");
+			return (1);
+		}
+	}
+	if (sink->fill_top == 0) {
+		sink->fill_position = position;
+	}
+	if (sink->fill_buffer_size < sink->fill_top + count) {
+		new_size = sink->fill_top + count;
+		if (new_size < sink_flush_threshold +
+				(sink_flush_threshold >> 1)) {
+			new_size = sink_flush_threshold +
+				(sink_flush_threshold >> 1);
+		}
+		tmp_pointer = realloc(sink->fill_buffer,
+				new_size * sizeof (unsigned_integral_type));
+		if (tmp_pointer == NULL) {
+			perror("realloc(fill_buffer)");
+			/* resetting the errno */
+			errno = 0;
+			return (2);
+		} else {
+			/*
+			 * Despite that the call to the realloc seems
+			 * to have been successful, we reset the errno,
+			 * because at least on Mac OS X
+			 * it might have changed.
+			 */
+			errno = 0;
+			sink->fill_buffer = tmp_pointer;
+		}
+		sink->fill_buffer_size = new_size;
+	}
+	memcpy(sink->fill_buffer + sink->fill_top, cells,
+			count * sizeof (unsigned_integral_type));
+	sink->fill_top += count;
+	if (sink->fill_top >= sink_flush_threshold) {
+		if (st_slai_sink_hand_over(sink) > 0) {
+			fprintf(stderr, "Error: Could not hand over "
+					"the tnode sink buffer!\n");
+			return (3);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which hands over the remaining cells to the writing thread,
+ * waits until all of them are written and stops the writing thread.
+ *
+ * @param
+ * sink		the actual sink
+ *
+ * @return	If all the cells have been successfully written,
+ * 		zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_sink_finish (slai_tnode_sink *sink) {
+	if (sink->fill_top > 0) {
+		if (st_slai_sink_hand_over(sink) > 0) {
+			fprintf(stderr, "Error: Could not hand over "
+					"the tnode sink buffer!\n");
+			return (1);
+		}
+	}
+#ifdef	ST_USE_PTHREAD
+	pthread_mutex_lock(&sink->mx);
+	sink->finished = 1;
+	pthread_cond_signal(&sink->cv);
+	pthread_mutex_unlock(&sink->mx);
+	pthread_join(sink->writer, NULL);
+#else
+	sink->finished = 1;
+#endif
+	if (sink->error != 0) {
+		return (2);
+	}
+	printf("The table tnode has been streamed to the file '%s':\n"
+			"%zu bytes (", sink->file_name, sink->bytes_written);
+	print_human_readable_size(stdout, sink->bytes_written);
+	printf(") written in %zu buffer flushes.\n", sink->flushes);
+	return (0);
+}
+
+/**
+ * A function which maps the file containing the streamed table tnode
+ * back into the memory for reading.
+ * It can only be called after the sink has been finished.
+ *
+ * @param
+ * cells	the total number of cells in the table tnode
+ * @param
+ * sink		the actual sink
+ *
+ * @return	If the file has been successfully mapped, zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_sink_map (size_t cells,
+		slai_tnode_sink *sink) {
+	void *mapping = mmap(NULL, cells * sizeof (unsigned_integral_type),
+			PROT_READ, MAP_SHARED, sink->fd, 0);
+	if (mapping == MAP_FAILED) {
+		perror("st_slai_sink_map: mmap");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	sink->mapping = mapping;
+	sink->mapped_cells = cells;
+	return (0);
+}
+
+/**
+ * A function which unmaps the file, closes it
+ * and deallocates the memory used by the sink.
+ *
+ * @param
+ * sink		the actual sink to be closed
+ *
+ * @return	If the sink has been successfully closed, zero is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int st_slai_sink_close (slai_tnode_sink *sink) {
+	if (sink->mapping != NULL) {
+		if (munmap(sink->mapping, sink->mapped_cells *
+					sizeof (unsigned_integral_type)) ==
+				(-1)) {
+			perror("st_slai_sink_close: munmap");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
+		sink->mapping = NULL;
+		sink->mapped_cells = 0;
+	}
+	/*
+	 * it is always safe to delete the NULL pointer,
+	 * so we need not to check for it
+	 */
+	free(sink->fill_buffer);
+	sink->fill_buffer = NULL;
+	free(sink->flush_buffer);
+	sink->flush_buffer = NULL;
+	sink->fill_buffer_size = 0;
+	sink->flush_buffer_size = 0;
+#ifdef	ST_USE_PTHREAD
+	pthread_cond_destroy(&sink->cv);
+	pthread_mutex_destroy(&sink->mx);
+#endif
+	if (close(sink->fd) == (-1)) {
+		perror("<tnode_filename>: close");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	return (0);
+}
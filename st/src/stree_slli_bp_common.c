@@ -26,6 +26,7 @@
  * with the backward pointers.
  */
 #include "stree_slli_bp_common.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -64,7 +65,7 @@ int st_slli_bp_allocate (size_t length,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stree->tleaf);
+	arena_free(stree->tleaf);
 	stree->tleaf = NULL;
 	/* we need to fill in the size of the leaf record */
 	stree->lr_size =  sizeof (leaf_record_slli_bp);
@@ -82,7 +83,7 @@ int st_slli_bp_allocate (size_t length,
 	 * and one extra record, representing the shortest non-empty suffix
 	 * and consisting only of the terminating character ($).
 	 */
-	stree->tleaf = calloc((length + 2), stree->lr_size);
+	stree->tleaf = arena_calloc((length + 2), stree->lr_size);
 	if (stree->tleaf == NULL) {
 		perror("calloc(tleaf)");
 		/* resetting the errno */
@@ -94,7 +95,7 @@ int st_slli_bp_allocate (size_t length,
 	}
 	allocated_size = (length + 2) * stree->lr_size;
 	printf("Successfully allocated!\n\n");
-	free(stree->tbranch);
+	arena_free(stree->tbranch);
 	stree->tbranch = NULL;
 	/* we need to fill in the size of the branch record */
 	stree->br_size =  sizeof (branch_record_slli_bp);
@@ -109,7 +110,7 @@ int st_slli_bp_allocate (size_t length,
 	 * The number of actually allocated branch records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	stree->tbranch = calloc(unit_size + 1, stree->br_size);
+	stree->tbranch = arena_calloc(unit_size + 1, stree->br_size);
 	if (stree->tbranch == NULL) {
 		perror("calloc(tbranch)");
 		/* resetting the errno */
@@ -212,7 +213,7 @@ int st_slli_bp_reallocate (size_t desired_size,
 	 * The number of actually allocated branch records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	tmp_pointer = realloc(stree->tbranch,
+	tmp_pointer = arena_realloc(stree->tbranch,
 			(new_tbranch_size + 1) * stree->br_size);
 	if (tmp_pointer == NULL) {
 		perror("realloc(tbranch)");
@@ -1063,9 +1064,13 @@ int st_slli_bp_split_edge (signed_integral_type *parent,
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
  * This function performs a simple traversal.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversing starts
@@ -1076,28 +1081,29 @@ int st_slli_bp_split_edge (signed_integral_type *parent,
  * log10l	A ceiling of base 10 logarithm of the number
  * 		of leaves. It will be used for printing alignment.
  * @param
- * internal_text_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stree	the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_slli_bp_simple_traverse_from (FILE *stream,
+int st_slli_bp_simple_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
-		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length,
+		traversal_stack *stack,
 		const suffix_tree_slli_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1110,69 +1116,88 @@ int st_slli_bp_simple_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	child = stree->tbranch[starting_node].first_child;
-	parents_depth = stree->tbranch[starting_node].depth;
-	while (child != 0) {
-		if (child > 0) {
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node,
+				stree->tbranch[starting_node].first_child,
+				0, stree->tbranch[starting_node].depth) > 0) {
+		return (4);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		parents_depth = frame->depth;
+		if (child == 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+		} else if (child > 0) {
 			childs_depth = stree->tbranch[child].depth;
 			childs_offset = stree->tbranch[child].head_position;
 			childs_parent = stree->tbranch[child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its branching "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (2);
+				if (stack->top == 1) {
+					return (2);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 0,
+			/*
+			 * there would be some overhead if we called
+			 * the next child function, so we do it simply
+			 */
+			frame->child = stree->tbranch[child].branch_brother;
+			st_print_edge(output, 0,
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
-			st_slli_bp_simple_traverse_from(stream, child,
-					log10bn, log10l,
-					internal_text_encoding, text, length,
-					stree);
-			/*
-			 * there would be some overhead if we called
-			 * the next child function, so we do it simply
-			 */
-			child = stree->tbranch[child].branch_brother;
+					childs_offset, text);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child,
+					stree->tbranch[child].first_child,
+					0, childs_depth) > 0) {
+				return (4);
+			}
 		} else { /* child < 0 */
 			childs_depth = (unsigned_integral_type)((length + 2)
 				- (size_t)(-child));
 			childs_offset = (unsigned_integral_type)(-child);
 			childs_parent = stree->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its leaf "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 1,
-					(signed_integral_type)(0),
-					child, (signed_integral_type)(0),
-					parents_depth,
-					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
 			/*
 			 * there would be some overhead if we called
 			 * the next child function, so we do it simply
 			 */
-			child = stree->tleaf[-child].next_brother;
+			frame->child = stree->tleaf[-child].next_brother;
+			st_print_edge(output, 1,
+					(signed_integral_type)(0),
+					child, (signed_integral_type)(0),
+					parents_depth,
+					childs_depth, log10bn, log10l,
+					childs_offset, text);
 		}
 	}
 	return (0);
@@ -1181,9 +1206,13 @@ int st_slli_bp_simple_traverse_from (FILE *stream,
 /**
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversing starts
@@ -1194,28 +1223,29 @@ int st_slli_bp_simple_traverse_from (FILE *stream,
  * log10l	A ceiling of base 10 logarithm of the number
  * 		of leaves. It will be used for printing alignment.
  * @param
- * internal_text_encoding	The character encoding used in the internal
- * 				representation of the text for the suffix tree.
- * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
  * 		(number of the "real" characters in the text)
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stree	the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int st_slli_bp_traverse_from (FILE *stream,
+int st_slli_bp_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
-		const char *internal_text_encoding,
 		const character_type *text,
 		size_t length,
+		traversal_stack *stack,
 		const suffix_tree_slli_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1229,64 +1259,282 @@ int st_slli_bp_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	child = stree->tbranch[starting_node].first_child;
-	parents_depth = stree->tbranch[starting_node].depth;
-	while (child != 0) {
-		if (child > 0) {
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node,
+				stree->tbranch[starting_node].first_child,
+				0, stree->tbranch[starting_node].depth) > 0) {
+		return (4);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		parents_depth = frame->depth;
+		if (child == 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+		} else if (child > 0) {
 			childs_suffix_link = stree->tbranch[child].suffix_link;
 			childs_depth = stree->tbranch[child].depth;
 			childs_offset = stree->tbranch[child].head_position;
 			childs_parent = stree->tbranch[child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its branching "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (2);
+				if (stack->top == 1) {
+					return (2);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 0, starting_node, child,
-					childs_suffix_link, parents_depth,
-					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
-			st_slli_bp_traverse_from(stream, child, log10bn, log10l,
-					internal_text_encoding, text, length,
-					stree);
 			/*
 			 * there would be some overhead if we called
 			 * the next child function, so we do it simply
 			 */
-			child = stree->tbranch[child].branch_brother;
+			frame->child = stree->tbranch[child].branch_brother;
+			st_print_edge(output, 0, parent, child,
+					childs_suffix_link, parents_depth,
+					childs_depth, log10bn, log10l,
+					childs_offset, text);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child,
+					stree->tbranch[child].first_child,
+					0, childs_depth) > 0) {
+				return (4);
+			}
 		} else { /* child < 0 */
 			childs_depth = (unsigned_integral_type)((length + 2)
 				- (size_t)(-child));
 			childs_offset = (unsigned_integral_type)(-child);
 			childs_parent = stree->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its leaf "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
-			st_print_edge(stream, 1, starting_node, child,
-					0, parents_depth,
-					childs_depth, log10bn, log10l,
-					childs_offset, internal_text_encoding,
-					text);
 			/*
 			 * there would be some overhead if we called
 			 * the next child function, so we do it simply
 			 */
-			child = stree->tleaf[-child].next_brother;
+			frame->child = stree->tleaf[-child].next_brother;
+			st_print_edge(output, 1, parent, child,
+					0, parents_depth,
+					childs_depth, log10bn, log10l,
+					childs_offset, text);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which walks through the whole subtree of the given node
+ * without printing anything and counts the visited nodes.
+ *
+ * @param
+ * starting_node	the branching node from which the walk starts
+ * @param
+ * branching_nodes	the number of the visited branching nodes,
+ * 			not including the starting node, will be added here
+ * @param
+ * leaves	the number of the visited leaves will be added here
+ * @param
+ * stack	the explicit stack to be used by the walk
+ * @param
+ * stree	the actual suffix tree which will be walked through
+ *
+ * @return	If we could successfully walk through the subtree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slli_bp_walk_from (signed_integral_type starting_node,
+		size_t *branching_nodes,
+		size_t *leaves,
+		traversal_stack *stack,
+		const suffix_tree_slli_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type child = 0;
+	if (starting_node <= 0) {
+		fprintf(stderr,	"Error: The walk has to start from "
+				"a branching node, but the starting node "
+				"is %d!", starting_node);
+		return (1);
+	}
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node,
+				stree->tbranch[starting_node].first_child,
+				0, 0) > 0) {
+		return (2);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		child = frame->child;
+		if (child == 0) {
+			--stack->top;
+		} else if (child > 0) {
+			frame->child = stree->tbranch[child].branch_brother;
+			++(*branching_nodes);
+			if (traversal_stack_push(stack, child,
+					stree->tbranch[child].first_child,
+					0, 0) > 0) {
+				return (2);
+			}
+		} else {
+			frame->child = stree->tleaf[-child].next_brother;
+			++(*leaves);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which analyses the repeats in the whole suffix tree.
+ * It visits all the nodes without printing anything
+ * and summarizes each branching node bottom-up,
+ * after all of its children have been visited.
+ *
+ * @param
+ * analysis	the repeat analysis, which collects the results
+ * @param
+ * stack	the explicit stack to be used by the analysis
+ * @param
+ * stree	the actual suffix tree which will be analysed
+ *
+ * @return	If we could successfully analyse the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slli_bp_analyse_repeats (repeat_analysis *analysis,
+		traversal_stack *stack,
+		const suffix_tree_slli_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type child = 0;
+	stack->top = 0;
+	analysis->top = 0;
+	if ((traversal_stack_push(stack, 1, stree->tbranch[1].first_child,
+				0, 0) > 0) ||
+			(repeat_analysis_enter(stree->tbranch[1].depth,
+				stree->tbranch[1].head_position,
+				analysis) > 0)) {
+		return (1);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		child = frame->child;
+		if (child == 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+			repeat_analysis_leave(analysis);
+		} else if (child > 0) {
+			frame->child = stree->tbranch[child].branch_brother;
+			if ((traversal_stack_push(stack, child,
+					stree->tbranch[child].first_child,
+					0, 0) > 0) ||
+					(repeat_analysis_enter(
+					stree->tbranch[child].depth,
+					stree->tbranch[child].head_position,
+					analysis) > 0)) {
+				return (1);
+			}
+		} else {
+			frame->child = stree->tleaf[-child].next_brother;
+			if (repeat_analysis_leaf((size_t)(-child),
+						analysis) > 0) {
+				return (1);
+			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which exports the suffix array and the LCP array
+ * of the whole suffix tree. It visits the leaves in the lexicographic
+ * order of their suffixes and streams them to the export.
+ * The leaf, whose edge consists of the terminating character ($) only,
+ * is exported before all the other children of its parent.
+ *
+ * @param
+ * export	the export of the suffix array and of the LCP array
+ * @param
+ * stack	the explicit stack to be used by the export
+ * @param
+ * stree	the actual suffix tree which will be exported
+ *
+ * @return	If we could successfully export the suffix tree,
+ * 		0 is returned.
+ * 		In case of an error, a positive error number is returned.
+ */
+int st_slli_bp_export_arrays (array_export *export,
+		traversal_stack *stack,
+		const suffix_tree_slli_bp *stree) {
+	traversal_frame *frame = NULL;
+	signed_integral_type node = 1;
+	signed_integral_type child = 0;
+	signed_integral_type last_child = 0;
+	/* the leaf, whose edge consists of the terminating character */
+	signed_integral_type terminal = 0;
+	unsigned_integral_type depth = 0;
+	stack->top = 0;
+	while (node > 0) {
+		/* entering the branching node */
+		depth = stree->tbranch[node].depth;
+		terminal = -(signed_integral_type)(export->length + 1 - depth);
+		/* the terminal leaf can only be the last child */
+		last_child = 0;
+		for (child = stree->tbranch[node].first_child; child != 0;
+				child = child > 0 ?
+				stree->tbranch[child].branch_brother :
+				stree->tleaf[-child].next_brother) {
+			last_child = child;
+		}
+		if (last_child == terminal) {
+			array_export_ancestor(depth, export);
+			array_export_leaf((size_t)(-terminal), export);
+		}
+		if (traversal_stack_push(stack, node,
+					stree->tbranch[node].first_child,
+					0, depth) > 0) {
+			return (1);
+		}
+		node = 0;
+		while ((node == 0) && (stack->top > 0)) {
+			frame = stack->frames + stack->top - 1;
+			child = frame->child;
+			if (child == 0) {
+				/* all the children have been visited */
+				--stack->top;
+				continue;
+			}
+			array_export_ancestor(frame->depth, export);
+			if (child > 0) {
+				frame->child =
+					stree->tbranch[child].branch_brother;
+				node = child;
+			} else {
+				frame->child =
+					stree->tleaf[-child].next_brother;
+				if ((size_t)(-child) + frame->depth !=
+						export->length + 1) {
+					array_export_leaf((size_t)(-child),
+							export);
+				}
+			}
 		}
 	}
 	return (0);
@@ -1306,6 +1554,9 @@ int st_slli_bp_traverse_from (FILE *stream,
  * @param
  * traversal_type	the type of the traversal to perform
  * @param
+ * traversal_format	the format of the traversal output,
+ * 			either tf_text or tf_binary
+ * @param
  * text		the actual underlying text of the suffix tree
  * @param
  * length	the actual length of the underlying text in the suffix tree
@@ -1319,9 +1570,14 @@ int st_slli_bp_traverse_from (FILE *stream,
 int st_slli_bp_traverse (FILE *stream,
 		const char *internal_text_encoding,
 		int traversal_type,
+		int traversal_format,
 		const character_type *text,
 		size_t length,
 		const suffix_tree_slli_bp *stree) {
+	/* the explicit stack of the traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	/* the buffered output of the traversal */
+	traversal_output output;
 	signed_integral_type start_node = 1; /* the root */
 	/* the current number of branching nodes in the suffix tree */
 	size_t branching_nodes = stree->branching_nodes;
@@ -1362,37 +1618,54 @@ int st_slli_bp_traverse (FILE *stream,
 		printf("The traversal log is being dumped "
 				"to the specified file.\n");
 	}
+	if (traversal_output_open(stream, traversal_format,
+				internal_text_encoding, &output) > 0) {
+		fprintf(stderr, "Error: Could not prepare "
+				"the traversal output. Exiting!\n");
+		return (4);
+	}
 	if (traversal_type == tt_detailed) {
-		fprintf(stream, "Suffix tree traversal BEGIN\n");
-		if (st_slli_bp_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				text, length + 2, (size_t)(0), &output);
+		if (st_slli_bp_traverse_from(&output, start_node,
 					log10bn, log10l,
-					internal_text_encoding,
-					text, length, stree) > 0) {
+					text, length, &stack, stree) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (1);
 		}
-		fprintf(stream, "Suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else if (traversal_type == tt_simple) {
-		fprintf(stream, "Simple suffix tree traversal BEGIN\n");
-		if (st_slli_bp_simple_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				text, length + 2, (size_t)(0), &output);
+		if (st_slli_bp_simple_traverse_from(&output, start_node,
 					log10bn, log10l,
-					internal_text_encoding,
-					text, length, stree) > 0) {
+					text, length, &stack, stree) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (2);
 		}
-		fprintf(stream, "Simple suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else {
 		fprintf(stderr, "Error: Unknown traversal type (%d) "
 				"Exiting!\n", traversal_type);
+		traversal_output_close(&output);
 		return (3);
 	}
+	traversal_stack_free(&stack);
+	if (traversal_output_close(&output) > 0) {
+		fprintf(stderr, "Error: Could not write "
+				"the traversal output. Exiting!\n");
+		return (5);
+	}
 	if (stream != stdout) {
 		printf("Dump complete.\n");
 	}
@@ -1412,9 +1685,9 @@ int st_slli_bp_traverse (FILE *stream,
  */
 int st_slli_bp_delete (suffix_tree_slli_bp *stree) {
 	printf("Deleting the suffix tree\n");
-	free(stree->tleaf);
+	arena_free(stree->tleaf);
 	stree->tleaf = NULL;
-	free(stree->tbranch);
+	arena_free(stree->tbranch);
 	stree->tbranch = NULL;
 	/*
 	 * maintaining the suffix tree struct
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Binary traversal dump reader header.
+ * This file contains the declarations of the functions,
+ * which read the binary suffix tree traversal dumps
+ * and convert them back to the human readable text format.
+ */
+#ifndef	SUFFIX_TREE_DUMP_READER_HEADER
+#define	SUFFIX_TREE_DUMP_READER_HEADER
+
+#include "suffix_tree_common.h"
+
+/* constants */
+
+/* the largest printing alignment accepted in a traversal chunk */
+
+extern const unsigned long long stdr_max_alignment;
+
+/* the longest encoding name accepted in a traversal chunk */
+
+extern const unsigned long long stdr_max_encoding_length;
+
+/* binary traversal dump reading functions */
+
+int stdr_read_varint (FILE *stream,
+		unsigned long long *value);
+int stdr_read_zigzag (FILE *stream,
+		signed_integral_type *value);
+int stdr_convert_note (FILE *input,
+		FILE *output);
+int stdr_convert_edges (FILE *input,
+		const character_type *text,
+		size_t text_size,
+		size_t window_size,
+		size_t log10bn,
+		size_t log10l,
+		traversal_output *output);
+int stdr_convert_traversal (FILE *input,
+		FILE *output);
+int stdr_convert (FILE *input,
+		FILE *output);
+
+#endif /* SUFFIX_TREE_DUMP_READER_HEADER */
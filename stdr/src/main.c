@@ -0,0 +1,233 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The reader of the binary suffix tree traversal dumps.
+ * This file contains the command line interface of the program,
+ * which converts the binary traversal dumps created by the st
+ * and the stsw back to the human readable text format.
+ */
+
+/*
+ * This file needs to be included in advance of the other include files
+ * as well as before any changes to the feature test macros are made,
+ * because some of the files it includes might rely on the initial values
+ * of the feature test macros.
+ */
+#include "stdr.h"
+
+/* feature test macros */
+
+/* if this macro is either undefined or its value is too small */
+#if (_POSIX_C_SOURCE - 0) < 2
+
+#undef _POSIX_C_SOURCE
+
+/**
+ * This macro is necessary for the function getopt
+ * and variables optarg and optind.
+ */
+#define	_POSIX_C_SOURCE 2
+
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Doxygen main page documentation */
+
+/**
+ * @page stdr Binary traversal dump reader
+ *
+ * @section Description
+ *
+ * Both the st and the stsw can dump the suffix tree traversals
+ * in a compact binary format (using the <tt>-o bin</tt> option),
+ * which is much smaller and faster to write than the text format.
+ * This program converts such a binary dump back
+ * to the human readable text format, which is byte-identical
+ * to the dump created without the <tt>-o bin</tt> option.
+ * Every traversal in the binary dump contains the whole text
+ * its edge labels refer to, so the original input file
+ * is not needed for the conversion.
+ *
+ * @section Usage
+ *
+ * This program can be executed like this:
+ *
+@verbatim
+./stdr [-d output_filename] filename
+@endverbatim
+ *
+ * which converts the binary dump from the file @c 'filename'
+ * and prints the result to the standard output,
+ * or to the file @c 'output_filename'. If the @c 'filename' is '-',
+ * the dump is read from the standard input.
+ *
+ * Both this program and the program which created the dump
+ * need to be compiled with the same @c character_type.
+ */
+
+/**
+ * A function, which prints the short usage text for this program.
+ *
+ * @param
+ * argv0	the argv[0], or the command used to run this program
+ *
+ * @return	This function always returns zero (0).
+ */
+int print_short_usage (const char *argv0) {
+	printf("Usage:\t%s [-d output_filename] filename\n\n", argv0);
+	printf("This will convert the binary suffix tree traversal dump\n"
+		"from the file 'filename' to the human readable "
+		"text format.\n"
+		"If 'filename' is '-', the dump is read "
+		"from the standard input.\n\n");
+	return (0);
+}
+
+/**
+ * A function, which prints the help text for this program.
+ *
+ * @param
+ * argv0	the argv[0], or the command used to run this program
+ *
+ * @return	This function always returns zero (0).
+ */
+int print_help (const char *argv0) {
+	print_short_usage(argv0);
+	printf("Available options are:\n"
+		"-d <filename>\tprint the converted text to the file\n"
+		"\t\t'filename' instead of the standard output\n"
+		"-h\t\tprint this help and exit\n");
+	return (0);
+}
+
+/**
+ * A function, which prints the full usage text for this program.
+ *
+ * @param
+ * argv0	the argv[0], or the command used to run this program
+ *
+ * @return	This function always returns zero (0).
+ */
+int print_usage (const char *argv0) {
+	print_short_usage(argv0);
+	printf("For the list of available options, run: %s -h\n",
+			argv0);
+	return (0);
+}
+
+/**
+ * The main function, which parses the command line options
+ * and converts the provided binary traversal dump.
+ *
+ * @param
+ * argc	the number of the command line arguments
+ * @param
+ * argv	the command line arguments
+ *
+ * @return	If the dump has been successfully converted,
+ * 		EXIT_SUCCESS is returned. Otherwise, EXIT_FAILURE
+ * 		is returned.
+ */
+int main (int argc, char **argv) {
+	FILE *input = NULL;
+	FILE *output = stdout;
+	char *dump_filename = NULL;
+	int getopt_retval = 0;
+	int function_retval = EXIT_SUCCESS;
+	char c = 0;
+	if (argc == 1) {
+		print_usage(argv[0]);
+		return (EXIT_SUCCESS);
+	}
+	/* parsing the command line options */
+	while ((getopt_retval = getopt(argc, argv, "d:h")) != (-1)) {
+		c = (char)(getopt_retval);
+		switch (c) {
+			case 'd':
+				dump_filename = optarg;
+				break;
+			case 'h':
+				print_help(argv[0]);
+				return (EXIT_SUCCESS);
+			case '?':
+				return (EXIT_FAILURE);
+		}
+	}
+	if (optind == argc) {
+		fprintf(stderr, "Missing the 'filename' parameter!\n\n");
+		print_usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+	if (optind + 1 < argc) {
+		fprintf(stderr, "Only one 'filename' parameter "
+				"can be provided!\n\n");
+		print_usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+	/* command line options parsing complete */
+	if (strcmp(argv[optind], "-") == 0) {
+		input = stdin;
+	} else if ((input = fopen(argv[optind], "r")) == NULL) {
+		perror(argv[optind]);
+		/* resetting the errno */
+		errno = 0;
+		return (EXIT_FAILURE);
+	}
+	if (dump_filename != NULL &&
+			(output = fopen(dump_filename, "w")) == NULL) {
+		perror(dump_filename);
+		/* resetting the errno */
+		errno = 0;
+		if (input != stdin) {
+			fclose(input);
+		}
+		return (EXIT_FAILURE);
+	}
+	if (stdr_convert(input, output) != 0) {
+		fprintf(stderr, "The conversion of the dump has failed!\n");
+		function_retval = EXIT_FAILURE;
+	}
+	if (input != stdin && fclose(input) != 0) {
+		perror(argv[optind]);
+		/* resetting the errno */
+		errno = 0;
+		function_retval = EXIT_FAILURE;
+	}
+	if (output != stdout) {
+		if (fclose(output) != 0) {
+			perror(dump_filename);
+			/* resetting the errno */
+			errno = 0;
+			function_retval = EXIT_FAILURE;
+		}
+	} else if (fflush(output) != 0) {
+		perror("fflush(stdout)");
+		/* resetting the errno */
+		errno = 0;
+		function_retval = EXIT_FAILURE;
+	}
+	return (function_retval);
+}
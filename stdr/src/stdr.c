@@ -0,0 +1,433 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Binary traversal dump reader implementation.
+ * This file contains the implementation of the functions,
+ * which read the binary suffix tree traversal dumps
+ * and convert them back to the human readable text format.
+ */
+#include "stdr.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constants */
+
+/**
+ * the largest printing alignment, which can be present
+ * in a valid traversal chunk
+ */
+const unsigned long long stdr_max_alignment = 20;
+
+/**
+ * the longest name of the internal text encoding,
+ * which can be present in a valid traversal chunk
+ */
+const unsigned long long stdr_max_encoding_length = 1024;
+
+/* binary traversal dump reading functions */
+
+/**
+ * A function which reads a single little-endian base 128 varint
+ * from the provided stream.
+ *
+ * @param
+ * stream	the FILE * type stream from which the varint will be read
+ * @param
+ * value	the place where the read value will be stored
+ *
+ * @return	If the varint has been successfully read, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stdr_read_varint (FILE *stream,
+		unsigned long long *value) {
+	unsigned int shift = 0;
+	int c = 0;
+	(*value) = 0;
+	while ((c = getc(stream)) != EOF) {
+		if (shift > 63) {
+			fprintf(stderr, "stdr_read_varint: "
+					"The varint is too long!\n");
+			return (1);
+		}
+		(*value) |= (unsigned long long)(c & 0x7f) << shift;
+		if ((c & 0x80) == 0) {
+			return (0);
+		}
+		shift += 7;
+	}
+	if (ferror(stream) != 0) {
+		perror("stdr_read_varint: getc");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	fprintf(stderr, "stdr_read_varint: "
+			"Unexpected end of the input!\n");
+	return (3);
+}
+
+/**
+ * A function which reads a single zigzag encoded varint
+ * representing a node from the provided stream.
+ *
+ * @param
+ * stream	the FILE * type stream from which the varint will be read
+ * @param
+ * value	the place where the decoded node will be stored
+ *
+ * @return	If the node has been successfully read, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stdr_read_zigzag (FILE *stream,
+		signed_integral_type *value) {
+	unsigned long long raw = 0;
+	if (stdr_read_varint(stream, &raw) != 0) {
+		return (1);
+	}
+	if ((raw >> 1) > (unsigned long long)(INT_MAX)) {
+		fprintf(stderr, "stdr_read_zigzag: "
+				"The node number is out of range!\n");
+		return (2);
+	}
+	(*value) = (signed_integral_type)(raw >> 1);
+	if ((raw & 1) != 0) {
+		(*value) = -(*value) - 1;
+	}
+	return (0);
+}
+
+/**
+ * A function which copies the contents of the note chunk
+ * to the output. The magic of the chunk has already been read.
+ *
+ * @param
+ * input	the FILE * type stream from which the chunk is read
+ * @param
+ * output	the FILE * type stream to which the note is written
+ *
+ * @return	If the note has been successfully copied, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stdr_convert_note (FILE *input,
+		FILE *output) {
+	char buffer[BUFSIZ];
+	unsigned long long length = 0;
+	size_t part = 0;
+	if (stdr_read_varint(input, &length) != 0) {
+		fprintf(stderr, "stdr_convert_note: "
+				"Could not read the length of the note!\n");
+		return (1);
+	}
+	while (length > 0) {
+		part = length < (unsigned long long)(BUFSIZ) ?
+			(size_t)(length) : (size_t)(BUFSIZ);
+		if (fread(buffer, 1, part, input) != part) {
+			fprintf(stderr, "stdr_convert_note: "
+					"The note is truncated!\n");
+			return (2);
+		}
+		if (fwrite(buffer, 1, part, output) != part) {
+			perror("stdr_convert_note: fwrite");
+			/* resetting the errno */
+			errno = 0;
+			return (3);
+		}
+		length -= part;
+	}
+	return (0);
+}
+
+/**
+ * A function which reads the edges of the traversal chunk
+ * and prints them to the traversal output in the text format,
+ * until the tag terminating the chunk is read.
+ * Every edge is checked to refer only to the provided text.
+ *
+ * @param
+ * input	the FILE * type stream from which the edges are read
+ * @param
+ * text		the text, which the edge labels refer to
+ * @param
+ * text_size	the number of the characters of the text
+ * @param
+ * window_size	the size of the circular text window,
+ * 		or zero if the text does not wrap
+ * @param
+ * log10bn	A ceiling of base 10 logarithm of the number
+ * 		of branching nodes. It will be used for printing alignment.
+ * @param
+ * log10l	A ceiling of base 10 logarithm of the number
+ * 		of leaves. It will be used for printing alignment.
+ * @param
+ * output	the traversal output to which the edges are printed
+ *
+ * @return	If all the edges have been successfully converted,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int stdr_convert_edges (FILE *input,
+		const character_type *text,
+		size_t text_size,
+		size_t window_size,
+		size_t log10bn,
+		size_t log10l,
+		traversal_output *output) {
+	signed_integral_type parent = 0;
+	signed_integral_type child = 0;
+	signed_integral_type childs_suffix_link = 0;
+	unsigned long long tag = 0;
+	unsigned long long parents_depth = 0;
+	unsigned long long length = 0;
+	unsigned long long childs_offset = 0;
+	/* the position of the first character of the edge label */
+	unsigned long long offset = 0;
+	while (1) {
+		if (stdr_read_varint(input, &tag) != 0) {
+			return (1);
+		} else if (tag == 2) {
+			return (0);
+		} else if (tag > 2) {
+			fprintf(stderr, "stdr_convert_edges: "
+					"Unrecognized edge tag (%llu)!\n",
+					tag);
+			return (2);
+		}
+		if (stdr_read_zigzag(input, &parent) != 0 ||
+				stdr_read_zigzag(input, &child) != 0 ||
+				stdr_read_zigzag(input,
+					&childs_suffix_link) != 0 ||
+				stdr_read_varint(input,
+					&parents_depth) != 0 ||
+				stdr_read_varint(input, &length) != 0 ||
+				stdr_read_varint(input,
+					&childs_offset) != 0) {
+			fprintf(stderr, "stdr_convert_edges: "
+					"The edge is truncated!\n");
+			return (3);
+		}
+		offset = childs_offset + parents_depth;
+		if (parents_depth > UINT_MAX - length ||
+				childs_offset > text_size ||
+				parents_depth > text_size ||
+				length > text_size ||
+				(tag == 1 && length == 0) ||
+				(window_size == 0 ?
+				 offset + length > text_size :
+				 (offset == 0 || offset > 2 * window_size ||
+				  length > window_size))) {
+			fprintf(stderr, "stdr_convert_edges: "
+					"The edge from %d to %d "
+					"lies outside of the text!\n",
+					parent, child);
+			return (4);
+		}
+		if (traversal_output_edge((int)(tag), parent, child,
+					childs_suffix_link,
+					(unsigned_integral_type)
+					(parents_depth),
+					(unsigned_integral_type)
+					(parents_depth + length),
+					log10bn, log10l,
+					(size_t)(childs_offset), text,
+					window_size, output) != 0) {
+			return (5);
+		}
+	}
+}
+
+/**
+ * A function which converts the traversal chunk
+ * to the human readable text format. The magic of the chunk
+ * has already been read.
+ *
+ * @param
+ * input	the FILE * type stream from which the chunk is read
+ * @param
+ * output	the FILE * type stream to which the traversal is printed
+ *
+ * @return	If the traversal has been successfully converted,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int stdr_convert_traversal (FILE *input,
+		FILE *output) {
+	traversal_output to;
+	unsigned long long traversal_type = 0;
+	unsigned long long size = 0;
+	unsigned long long log10bn = 0;
+	unsigned long long log10l = 0;
+	unsigned long long window_size = 0;
+	unsigned long long text_size = 0;
+	char *encoding = NULL;
+	character_type *text = NULL;
+	int version = getc(input);
+	int retval = 0;
+	if (version != (int)(tf_version)) {
+		fprintf(stderr, "stdr_convert_traversal: "
+				"Unsupported version "
+				"of the traversal chunk (%d)!\n", version);
+		return (1);
+	}
+	if (stdr_read_varint(input, &traversal_type) != 0 ||
+			stdr_read_varint(input, &size) != 0) {
+		return (2);
+	}
+	if (traversal_type != (unsigned long long)(tt_detailed) &&
+			traversal_type != (unsigned long long)(tt_simple)) {
+		fprintf(stderr, "stdr_convert_traversal: "
+				"Unrecognized traversal type (%llu)!\n",
+				traversal_type);
+		return (3);
+	}
+	if (size != (unsigned long long)(character_type_size)) {
+		fprintf(stderr, "stdr_convert_traversal: "
+				"The dump uses the characters of %llu bytes,\n"
+				"but this program uses the characters "
+				"of %zu bytes!\n", size, character_type_size);
+		return (4);
+	}
+	if (stdr_read_varint(input, &size) != 0) {
+		return (5);
+	}
+	if (size > stdr_max_encoding_length) {
+		fprintf(stderr, "stdr_convert_traversal: "
+				"The encoding name is too long!\n");
+		return (6);
+	}
+	if ((encoding = (char *)(malloc((size_t)(size) + 1))) == NULL) {
+		perror("stdr_convert_traversal: malloc(encoding)");
+		/* resetting the errno */
+		errno = 0;
+		return (7);
+	}
+	if (fread(encoding, 1, (size_t)(size), input) != (size_t)(size)) {
+		fprintf(stderr, "stdr_convert_traversal: "
+				"The encoding name is truncated!\n");
+		free(encoding);
+		return (8);
+	}
+	encoding[size] = '\0';
+	if (stdr_read_varint(input, &log10bn) != 0 ||
+			stdr_read_varint(input, &log10l) != 0 ||
+			stdr_read_varint(input, &window_size) != 0 ||
+			stdr_read_varint(input, &text_size) != 0) {
+		free(encoding);
+		return (9);
+	}
+	if (log10bn > stdr_max_alignment || log10l > stdr_max_alignment ||
+			text_size == 0 ||
+			text_size > SIZE_MAX / character_type_size ||
+			(window_size > 0 && text_size != window_size + 1)) {
+		fprintf(stderr, "stdr_convert_traversal: "
+				"The header of the traversal chunk "
+				"is corrupted!\n");
+		free(encoding);
+		return (10);
+	}
+	if ((text = (character_type *)(malloc((size_t)(text_size) *
+						character_type_size))) ==
+			NULL) {
+		perror("stdr_convert_traversal: malloc(text)");
+		/* resetting the errno */
+		errno = 0;
+		free(encoding);
+		return (11);
+	}
+	if (fread(text, character_type_size, (size_t)(text_size), input) !=
+			(size_t)(text_size)) {
+		fprintf(stderr, "stdr_convert_traversal: "
+				"The text is truncated!\n");
+		free(text);
+		free(encoding);
+		return (12);
+	}
+	if (traversal_output_open(output, tf_text, encoding, &to) != 0) {
+		free(text);
+		free(encoding);
+		return (13);
+	}
+	traversal_output_begin((int)(traversal_type), (size_t)(log10bn),
+			(size_t)(log10l), text, (size_t)(text_size),
+			(size_t)(window_size), &to);
+	if (stdr_convert_edges(input, text, (size_t)(text_size),
+				(size_t)(window_size), (size_t)(log10bn),
+				(size_t)(log10l), &to) != 0) {
+		retval = 14;
+	} else {
+		traversal_output_end((int)(traversal_type), &to);
+	}
+	if (traversal_output_close(&to) != 0 && retval == 0) {
+		retval = 15;
+	}
+	free(text);
+	free(encoding);
+	return (retval);
+}
+
+/**
+ * A function which converts the whole binary traversal dump
+ * to the human readable text format, chunk by chunk.
+ *
+ * @param
+ * input	the FILE * type stream from which the dump is read
+ * @param
+ * output	the FILE * type stream to which the text is written
+ *
+ * @return	If the dump has been successfully converted, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stdr_convert (FILE *input,
+		FILE *output) {
+	char magic[4];
+	size_t read_bytes = 0;
+	while ((read_bytes = fread(magic, 1, 4, input)) == 4) {
+		if (memcmp(magic, tf_note_magic, 4) == 0) {
+			if (stdr_convert_note(input, output) != 0) {
+				return (1);
+			}
+		} else if (memcmp(magic, tf_traversal_magic, 4) == 0) {
+			if (stdr_convert_traversal(input, output) != 0) {
+				return (2);
+			}
+		} else {
+			fprintf(stderr, "stdr_convert: "
+					"Unrecognized chunk magic!\n");
+			return (3);
+		}
+	}
+	if (ferror(input) != 0) {
+		perror("stdr_convert: fread");
+		/* resetting the errno */
+		errno = 0;
+		return (4);
+	}
+	if (read_bytes != 0) {
+		fprintf(stderr, "stdr_convert: "
+				"Unexpected end of the input!\n");
+		return (5);
+	}
+	return (0);
+}
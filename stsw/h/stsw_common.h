@@ -29,6 +29,8 @@
 
 #include "suffix_tree_common.h"
 
+#include <sys/types.h> /* for off_t and ssize_t */
+
 /* if we are on the Apple platform (Mac OS X, for example) */
 #ifdef	__APPLE__
 
@@ -67,6 +69,8 @@
 /* we can use the POSIX threads */
 #define	STSW_USE_PTHREAD
 #include <pthread.h>
+/* for the fibers of the multi-stream mode */
+#include <ucontext.h>
 
 #endif
 
@@ -80,8 +84,173 @@ extern const int BLOCK_STATUS_UNKNOWN;
 extern const int BLOCK_STATUS_READ_AND_UNPROCESSED;
 extern const int BLOCK_STATUS_STILL_IN_USE;
 
+/* reading status flags */
+
+extern const int READING_STATUS_IN_PROGRESS;
+extern const int READING_STATUS_COMPLETE;
+extern const int READING_STATUS_STOPPED;
+
+/* block metrics formats */
+
+extern const int METRICS_FORMAT_CSV;
+extern const int METRICS_FORMAT_JSON;
+
 /* struct typedefs */
 
+/**
+ * A struct containing the counters, which describe how long
+ * a single thread has been waiting for another thread.
+ */
+typedef struct wait_counters_struct {
+	/**
+	 * the number of times the thread has found the data
+	 * it was interested in not ready and had to wait for it
+	 */
+	size_t waits;
+	/**
+	 * the number of times the thread has given up spinning
+	 * and has gone to sleep until the next event
+	 */
+	size_t sleeps;
+	/** the total time spent waiting, in nanoseconds */
+	unsigned long long wait_time;
+} wait_counters;
+
+/**
+ * A struct containing an event counter, on which the threads
+ * can sleep until another thread announces a change.
+ * On Linux, the counter itself is used as a futex.
+ */
+typedef struct event_counter_struct {
+	/** the number of the events announced so far */
+	int event;
+	/** the number of threads currently sleeping on the counter */
+	int sleepers;
+} event_counter;
+
+#ifdef	STSW_USE_PTHREAD
+/**
+ * A struct describing a fiber, which is a cooperatively scheduled
+ * function with its own stack. In the multi-stream mode,
+ * the streams and their input pipelines run in the fibers,
+ * so that many of them can be kept alive by a few threads.
+ * A fiber never migrates. It is always resumed by the same
+ * scheduling thread, which has started it.
+ */
+typedef struct stream_fiber_struct {
+	/** the saved context of the fiber */
+	ucontext_t context;
+	/** the stack of the fiber */
+	void *stack;
+	/** the size of the stack in bytes, including the guard page */
+	size_t stack_size;
+	/** the function executed by the fiber */
+	void *(*function)(void *);
+	/** the argument of the function */
+	void *arg;
+	/** the return value of the function */
+	void *retval;
+	/** the scheduling thread, which runs the fiber */
+	struct stream_scheduler_struct *scheduler;
+	/** the state of the fiber, one of the FIBER_STATE_* constants */
+	int state;
+	/** the event counter, on which the fiber waits */
+	event_counter *wait_ec;
+	/** the value of the event counter observed before the wait */
+	int wait_observed;
+	/** the file descriptor, on which the fiber waits for the input */
+	int wait_fd;
+	/** nonzero if the last poll has found the file descriptor ready */
+	int wait_fd_ready;
+	/**
+	 * nonzero if the fiber has finished and it has been removed
+	 * from its scheduling thread, accessed by the atomic operations
+	 */
+	int finished;
+	/** the next fiber in the list of the scheduling thread */
+	struct stream_fiber_struct *next;
+} stream_fiber;
+
+/**
+ * A struct describing an auxiliary thread of the suffix tree
+ * construction, such as the reading thread.
+ * Outside of the multi-stream mode, it is a POSIX thread.
+ * Within a stream of the multi-stream mode, it is a fiber
+ * run by one of the I/O threads.
+ */
+typedef struct stream_thread_struct {
+	/** the POSIX thread, if the fiber is NULL */
+	pthread_t thread;
+	/** the fiber, or NULL */
+	stream_fiber *fiber;
+} stream_thread;
+#endif
+
+/**
+ * A struct containing a ring of buffers, which connects two stages
+ * of the input pipeline. One thread keeps filling the free buffers,
+ * while the other thread keeps consuming the filled ones.
+ * The read-ahead ring holds the raw bytes of the input file,
+ * the decode ring holds the characters converted from them.
+ * This way, the raw I/O and the character conversion
+ * are decoupled from the sliding window blocks.
+ * The counters of the filled and consumed buffers, as well as
+ * the status, are accessed exclusively by the atomic operations.
+ */
+typedef struct buffer_ring_struct {
+	/** the number of buffers, also known as the depth of the ring */
+	size_t depth;
+	/** the size of a single buffer in bytes */
+	size_t buffer_size;
+	/** the buffers themselves */
+	char **buffers;
+	/** the number of valid bytes in each of the buffers */
+	size_t *lengths;
+	/**
+	 * the number of input bytes used to fill each of the buffers,
+	 * or NULL if it is not tracked
+	 */
+	size_t *source_lengths;
+	/** the total number of buffers filled so far */
+	size_t filled;
+	/** the total number of buffers consumed so far */
+	size_t consumed;
+	/** the number of bytes consumed from the oldest filled buffer */
+	size_t offset;
+	/**
+	 * the offset in the input file of the next byte to be read,
+	 * used by the read-ahead ring only
+	 */
+	off_t file_offset;
+	/**
+	 * The status of the filling of the ring.
+	 * It is equal to one of the READING_STATUS_* constants.
+	 */
+	int status;
+	/**
+	 * if nonzero, the filling thread is requested to stop
+	 * or it is not running at all
+	 */
+	int stop;
+	/** the errno value describing the error of the filling thread */
+	int error_number;
+	/**
+	 * if nonzero, the input file does not support pread,
+	 * used by the read-ahead ring only
+	 */
+	int sequential_only;
+	/** the event counter bumped on every buffer handoff */
+	event_counter ec;
+	/** the wait counters of the consuming thread */
+	wait_counters consumer_counters;
+	/** the wait counters of the filling thread */
+	wait_counters producer_counters;
+#ifdef	STSW_USE_PTHREAD
+	/** the filling thread */
+	stream_thread thread;
+#endif
+} buffer_ring;
+
 /**
  * A struct containing the sliding window over the text coming
  * from the input file and all the necessary information
@@ -207,7 +376,7 @@ typedef struct text_file_sliding_window_struct {
 	int *sw_block_flags;
 	/** the characters in the current sliding window */
 	character_type *text_window;
-	/** the name of the input file */
+	/** the name of the input file, "-" for the standard input */
 	const char *file_name;
 	/** the character encoding of the input file */
 	const char *fromcode;
@@ -220,6 +389,7 @@ typedef struct text_file_sliding_window_struct {
 	/**
 	 * The buffer, which will be used for character conversion
 	 * while reading from the input file.
+	 * If the decode stage is running, it is used by the decode thread.
 	 */
 	char *conversion_buffer;
 	/** the current size of the conversion buffer */
@@ -234,6 +404,28 @@ typedef struct text_file_sliding_window_struct {
 	size_t outbytesleft;
 	/** the desired method of the edge label maintenance to use */
 	int elm_method;
+	/**
+	 * The number of the threads, which perform the batch update
+	 * of the edge labels. If it is 1, the update is serial.
+	 */
+	size_t bu_workers;
+	/**
+	 * The maximum number of the branching records, which are moved
+	 * or released by a single step of the compaction of the table
+	 * tbranch. If it is zero, the compaction is disabled.
+	 */
+	size_t compaction_step;
+	/**
+	 * The read-ahead ring of the raw input buffers.
+	 * If it is NULL, the input file is read directly.
+	 */
+	buffer_ring *ra;
+	/**
+	 * The decode ring of the converted characters.
+	 * If it is NULL, the characters are converted
+	 * while filling the sliding window.
+	 */
+	buffer_ring *dr;
 	/** the read-only file descriptor associated with the input file */
 	int fd;
 	/** the conversion descriptor used by the iconv */
@@ -247,20 +439,23 @@ typedef struct text_file_sliding_window_struct {
  * and the auxiliary thread, which reads the input file
  * and replaces the already expired characters
  * in the oldest blocks of the sliding window with the new ones.
+ * The block flags in the sliding window together with this struct
+ * form a single-producer/single-consumer ring of block states.
+ * All the flags, as well as the reading_finished variable,
+ * are accessed exclusively by the atomic loads with the acquire
+ * and the atomic stores with the release semantics.
+ * That is why no mutex is necessary.
  */
 typedef struct shared_data_struct {
-	/** the mutex */
-	pthread_mutex_t mx;
-	/** the condition variable */
-	pthread_cond_t cv;
 	/** the pointer to the sliding window */
 	text_file_sliding_window *tfsw;
 	/**
-	 * if this variable evaluates to true, it means that
-	 * the reading thread has already finished the reading
-	 * of the input file
+	 * The status of the reading of the input file.
+	 * It is equal to one of the READING_STATUS_* constants.
 	 */
 	int reading_finished;
+	/** the event counter bumped on every block status change */
+	event_counter ec;
 	/**
 	 * The number of characters, which have been read and replaced
 	 * in the most recently read block of the sliding window.
@@ -278,13 +473,282 @@ typedef struct shared_data_struct {
 	 * to the main thread.
 	 */
 	size_t final_block_number;
+	/** the wait counters of the reading thread */
+	wait_counters reader_counters;
+	/** the wait counters of the main thread */
+	wait_counters main_counters;
 } shared_data;
 
+/**
+ * A struct describing the part of the batch update of the edge labels,
+ * which is performed by a single worker thread.
+ * Each worker walks a contiguous range of the leaves and propagates
+ * their sliding window offsets towards the root.
+ * The head positions are updated by the atomic compare and swap,
+ * so several workers can safely share the branching nodes.
+ */
+typedef struct batch_update_task_struct {
+	/** the sliding window containing the text */
+	const text_file_sliding_window *tfsw;
+	/** the suffix tree of either of the implementation types */
+	void *stsw;
+	/** the number of the first leaf to be processed by the worker */
+	size_t first_leaf;
+	/** the number of the leaves to be processed by the worker */
+	size_t leaves;
+	/** the sliding window offset of the first leaf */
+	unsigned_integral_type first_sw_offset;
+	/**
+	 * the begin of the currently valid part of the sliding window,
+	 * which is common for all the workers
+	 */
+	size_t vp_window_begin;
+	/**
+	 * The array of the flags, one for each branching node,
+	 * which are set when the branching node is visited for the first time
+	 * during the current batch update. It is shared by all the workers.
+	 */
+	unsigned char *visited;
+	/** the return value of the worker */
+	int retval;
+} batch_update_task;
+#endif
+
+/**
+ * A struct containing the state and the statistics
+ * of the greedy LZ77 factorization of the input text,
+ * which is performed while the suffix tree slides over it.
+ */
+typedef struct lz77_factorization_struct {
+	/**
+	 * the stream to which the factors are written,
+	 * or NULL if the factors should only be counted
+	 */
+	FILE *stream;
+	/**
+	 * the number of characters covered by the most recent factor,
+	 * which have not been added to the suffix tree yet
+	 */
+	size_t pending;
+	/** the number of factors emitted so far */
+	size_t factors;
+	/** the number of factors, which consist of the literal only */
+	size_t literals;
+	/** the total number of characters covered by the matches */
+	size_t matched_characters;
+	/** the length of the longest match found so far */
+	size_t longest_match;
+	/** the value of the monotonic clock at the start, in nanoseconds */
+	unsigned long long start_time;
+} lz77_factorization;
+
+/**
+ * A struct containing the state of the collection of the metrics,
+ * which are written for each processed block of the sliding window.
+ */
+typedef struct block_metrics_struct {
+	/**
+	 * the stream to which the metrics are written,
+	 * or NULL if no metrics are collected
+	 */
+	FILE *stream;
+	/** the format of the metrics, one of the METRICS_FORMAT_* */
+	int format;
+	/** the number of blocks recorded so far */
+	size_t blocks;
+	/** the number of characters in all the recorded blocks */
+	size_t characters;
+	/** the value of the monotonic clock at the start, in nanoseconds */
+	unsigned long long start_time;
+	/** the value of the monotonic clock at the most recent record */
+	unsigned long long last_time;
+} block_metrics;
+
+/**
+ * A struct describing a single input stream processed
+ * in the multi-stream mode. Each stream has its own sliding window
+ * and its own suffix tree, which are created and deleted
+ * by the fiber, which processes the stream.
+ */
+typedef struct stream_task_struct {
+	/** the stream pool, to which this stream belongs */
+	const struct stream_pool_struct *pool;
+	/** the index of this stream, starting from 1 */
+	size_t index;
+	/** the name of the input file, "-" for the standard input */
+	const char *file_name;
+	/** the benchmark settings shared by all the streams */
+	const void *settings;
+	/** the number of blocks processed in this stream */
+	size_t blocks;
+	/** the number of characters processed in this stream */
+	size_t characters;
+	/** the wall time spent by processing this stream, in nanoseconds */
+	unsigned long long wall_time;
+	/** the return value of the processing of this stream */
+	int retval;
+} stream_task;
+
+/**
+ * A struct containing the input streams of the multi-stream mode
+ * together with the function, which processes a single stream.
+ * All the streams are opened and processed at once,
+ * each of them by its own fiber. The fibers are distributed
+ * among a fixed pool of the worker threads, which interleave
+ * the streams block by block, while the reading of all the streams
+ * is multiplexed over a small set of the I/O threads.
+ */
+typedef struct stream_pool_struct {
+	/** the function, which processes a single stream */
+	int (*process)(stream_task *task);
+	/** the array of the streams */
+	stream_task *tasks;
+	/** the number of the streams */
+	size_t streams;
+	/** the wall time spent by processing all the streams */
+	unsigned long long wall_time;
+} stream_pool;
+
+#ifdef	STSW_USE_PTHREAD
+/**
+ * A struct describing a single scheduling thread of the multi-stream
+ * mode. It resumes its fibers one after another in a round-robin
+ * fashion. A fiber runs until it has to wait, or until it has
+ * finished a block of the sliding window. The fibers waiting
+ * for an event counter are resumed after the counter has changed,
+ * the fibers waiting for the input are resumed after the poll
+ * has found their file descriptors readable. If none of its fibers
+ * can run, the thread sleeps in the poll until the input arrives
+ * or until another thread writes to its wake-up pipe.
+ */
+typedef struct stream_scheduler_struct {
+	/** the scheduling thread itself */
+	pthread_t thread;
+	/** the fiber pool, to which this thread belongs */
+	struct stream_fiber_pool_struct *pool;
+	/** the context of the scheduling loop */
+	ucontext_t context;
+	/** the currently running fiber, or NULL */
+	stream_fiber *current;
+	/** the first of the fibers run by this thread */
+	stream_fiber *first;
+	/** the last of the fibers run by this thread */
+	stream_fiber *last;
+	/**
+	 * the new fibers, which have not been taken over
+	 * by this thread yet, protected by the mutex
+	 */
+	stream_fiber *incoming;
+	/** the mutex protecting the new fibers */
+	pthread_mutex_t mutex;
+	/**
+	 * the number of the unfinished fibers assigned to this thread,
+	 * accessed by the atomic operations
+	 */
+	size_t load;
+	/**
+	 * nonzero if the thread is about to sleep in the poll,
+	 * accessed by the atomic operations
+	 */
+	int sleeping;
+	/** the pipe, which wakes up the thread from the poll */
+	int wake_pipe[2];
+	/** the file descriptors passed to the poll */
+	struct pollfd *pollfds;
+	/** the fibers waiting for the polled file descriptors */
+	stream_fiber **polled_fibers;
+	/** the capacity of the pollfds and polled_fibers arrays */
+	size_t pollfds_size;
+} stream_scheduler;
+
+/**
+ * A struct containing all the scheduling threads of the multi-stream
+ * mode. The worker threads run the fibers processing the streams,
+ * while the I/O threads run the fibers reading their input files.
+ */
+typedef struct stream_fiber_pool_struct {
+	/** the worker threads followed by the I/O threads */
+	stream_scheduler *schedulers;
+	/** the number of the worker threads */
+	size_t workers;
+	/** the number of the I/O threads */
+	size_t io_threads;
+	/**
+	 * nonzero if the scheduling threads should finish
+	 * after all their fibers, accessed by the atomic operations
+	 */
+	int shutdown;
+	/** the event counter bumped whenever a fiber finishes */
+	event_counter finished_ec;
+} stream_fiber_pool;
+#endif
+
 /* auxiliary functions */
 
+unsigned long long monotonic_clock_ns (void);
+
+#ifdef	STSW_USE_PTHREAD
 /* thread related auxiliary function */
 
+void event_counter_sleep (int observed, event_counter *ec);
+
+void event_counter_notify (event_counter *ec);
+
+void event_counter_pause (size_t *spins, int observed,
+		wait_counters *counters, event_counter *ec);
+
+int buffer_ring_wait_for_free (buffer_ring *ring);
+
+void buffer_ring_publish (size_t length, size_t source_length,
+		buffer_ring *ring);
+
+void buffer_ring_finish (int status, int error_number, buffer_ring *ring);
+
+ssize_t buffer_ring_fetch (char *destination, size_t size,
+		size_t *source_bytes, buffer_ring *ring);
+
+int buffer_ring_start (void *(*thread_function)(void *),
+		buffer_ring *ring,
+		text_file_sliding_window *tfsw);
+
+void sd_init (text_file_sliding_window *tfsw, shared_data *sd);
+
+int sd_reading_finished (shared_data *sd);
+
+void sd_set_reading_finished (int status, shared_data *sd);
+
+void sd_set_block_status (size_t block, int status, shared_data *sd);
+
+int sd_check_block (size_t block, int reading, shared_data *sd);
+
+int sd_wait_for_block (size_t block, int reading, shared_data *sd);
+
+unsigned long long sd_wait_time (int reading, shared_data *sd);
+
+void sd_print_wait_counters (const shared_data *sd);
+
 void *reading_thread_function (void *arg);
+
+void *read_ahead_thread_function (void *arg);
+
+void *decode_thread_function (void *arg);
+
+/* parallel batch update supporting functions */
+
+size_t stsw_vp_window_begin (const text_file_sliding_window *tfsw);
+
+int stsw_is_newer_head_position (size_t head_position,
+		size_t new_head_position,
+		size_t vp_window_begin,
+		const text_file_sliding_window *tfsw);
+
+int batch_update_run (void *(*worker_function)(void *),
+		size_t first_leaf,
+		size_t leaves,
+		size_t tleaf_size,
+		size_t tbranch_size,
+		void *stsw,
+		const text_file_sliding_window *tfsw);
 #endif
 
 size_t stsw_get_leafs_depth_order (size_t sw_offset,
@@ -292,6 +756,59 @@ size_t stsw_get_leafs_depth_order (size_t sw_offset,
 int stsw_validate_sw_offset (size_t sw_offset,
 		const text_file_sliding_window *tfsw);
 
+/* LZ77 factorization functions */
+
+void lz77_init (FILE *stream, lz77_factorization *lz);
+int lz77_emit_factor (size_t offset,
+		size_t length,
+		character_type literal,
+		lz77_factorization *lz);
+int lz77_print_stats (const text_file_sliding_window *tfsw,
+		const lz77_factorization *lz);
+
+/* block metrics functions */
+
+int block_metrics_init (FILE *stream, int format, block_metrics *bm);
+int block_metrics_record (size_t characters,
+		size_t edges,
+		size_t branching_nodes,
+		size_t tedge_size,
+		size_t tbranch_size,
+		size_t tbdeleted_records,
+		unsigned long long reader_wait_time,
+		unsigned long long main_wait_time,
+		block_metrics *bm);
+
+/* multi-stream functions */
+
+#ifdef	STSW_USE_PTHREAD
+stream_fiber *stream_fiber_current (void);
+void stream_fiber_yield (void);
+void stream_fiber_wait_event (int observed, event_counter *ec);
+void stream_fiber_wait_input (int fd);
+void stream_fiber_pool_wake (stream_fiber_pool *pool);
+int stream_thread_create (stream_thread *thread,
+		void *(*function)(void *),
+		void *arg);
+int stream_thread_join (stream_thread *thread, void **retval);
+#endif
+ssize_t stream_fiber_read (int fd, void *buffer, size_t size);
+int stream_pool_run (size_t workers, size_t io_threads, stream_pool *sp);
+int stream_pool_print_stats (FILE *stream, const stream_pool *sp);
+
+/* compaction functions */
+
+int compare_indices_descending (const void *a, const void *b);
+int compaction_plan (size_t max_steps,
+		unsigned_integral_type *tbranch_deleted,
+		size_t *tbdeleted_records,
+		size_t *branching_nodes,
+		signed_integral_type **remap);
+signed_integral_type compaction_remap (signed_integral_type node,
+		size_t old_hwm,
+		size_t new_hwm,
+		const signed_integral_type *remap);
+
 /* reading related functions */
 
 int text_file_open (const int verbosity_level,
@@ -302,9 +819,37 @@ int text_file_open (const int verbosity_level,
 		size_t desired_ap_scale_factor,
 		size_t desired_sw_scale_factor,
 		int desired_elm_method,
+		size_t desired_bu_workers,
+		size_t desired_compaction_step,
+		size_t desired_read_ahead_depth,
+		size_t desired_decode_depth,
 		text_file_sliding_window *tfsw);
 int text_file_close (const int verbosity_level,
 		text_file_sliding_window *tfsw);
+int text_file_convert (char **outbuf,
+		size_t *outbytesleft,
+		size_t *characters_read,
+		size_t *bytes_read,
+		text_file_sliding_window *tfsw);
+ssize_t text_file_read_raw (char *buffer, size_t size,
+		buffer_ring *ra, int fd);
+int text_file_probe_input (buffer_ring *ra, int fd);
+int buffer_ring_create (size_t depth,
+		size_t buffer_size,
+		int with_sources,
+		buffer_ring **ring,
+		text_file_sliding_window *tfsw);
+int buffer_ring_destroy (const int verbosity_level,
+		const char *name,
+		buffer_ring **ring,
+		text_file_sliding_window *tfsw);
+int text_file_pipeline_start (size_t read_ahead_depth,
+		size_t decode_depth,
+		text_file_sliding_window *tfsw);
+int text_file_pipeline_stop (const int verbosity_level,
+		text_file_sliding_window *tfsw);
+ssize_t text_file_fetch_bytes (char *destination, size_t size,
+		text_file_sliding_window *tfsw);
 int text_file_read_blocks (size_t blocks_to_read,
 		size_t *blocks_read,
 		size_t *characters_read,
@@ -313,7 +858,7 @@ int text_file_read_blocks (size_t blocks_to_read,
 
 /* printing functions */
 
-int stsw_print_edge (FILE *stream,
+int stsw_print_edge (traversal_output *output,
 		int print_terminating_character,
 		signed_integral_type parent,
 		signed_integral_type child,
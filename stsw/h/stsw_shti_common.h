@@ -40,6 +40,9 @@ int stsw_shti_reallocate (const int verbosity_level,
 		size_t desired_tedge_size,
 		const text_file_sliding_window *tfsw,
 		suffix_tree_sliding_window_shti *stsw);
+int stsw_shti_shrink (const int verbosity_level,
+		size_t desired_tbranch_size,
+		suffix_tree_sliding_window_shti *stsw);
 
 /* supporting functions */
 
@@ -107,17 +110,24 @@ int stsw_shti_split_edge (signed_integral_type *parent,
 		const text_file_sliding_window *tfsw,
 		suffix_tree_sliding_window_shti *stsw);
 
-int stsw_shti_simple_traverse_from (FILE *stream,
+int stsw_shti_simple_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
 		const text_file_sliding_window *tfsw,
+		traversal_stack *stack,
 		const suffix_tree_sliding_window_shti *stsw);
-int stsw_shti_traverse_from (FILE *stream,
+int stsw_shti_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
 		const text_file_sliding_window *tfsw,
+		traversal_stack *stack,
+		const suffix_tree_sliding_window_shti *stsw);
+int stsw_shti_lz77_factor (size_t position,
+		size_t ending_position,
+		lz77_factorization *lz,
+		const text_file_sliding_window *tfsw,
 		const suffix_tree_sliding_window_shti *stsw);
 
 /* handling functions */
@@ -125,6 +135,7 @@ int stsw_shti_traverse_from (FILE *stream,
 int stsw_shti_traverse (const int verbosity_level,
 		FILE *stream,
 		int traversal_type,
+		int traversal_format,
 		const text_file_sliding_window *tfsw,
 		const suffix_tree_sliding_window_shti *stsw);
 int stsw_shti_delete (const int verbosity_level,
@@ -36,7 +36,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 		const int benchmark,
 		const int variation,
 		const int traversal_type,
+		const int traversal_format,
 		const int collect_stats,
+		block_metrics *bm,
 		text_file_sliding_window *tfsw,
 		suffix_tree_sliding_window_slli *stsw);
 
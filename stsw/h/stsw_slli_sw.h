@@ -52,4 +52,11 @@ int stsw_slli_delete_longest_suffix (size_t *starting_position,
 		text_file_sliding_window *tfsw,
 		suffix_tree_sliding_window_slli *stsw);
 
+/* compaction function */
+
+int stsw_slli_compact_tbranch (const int verbosity_level,
+		signed_integral_type *active_node,
+		const text_file_sliding_window *tfsw,
+		suffix_tree_sliding_window_slli *stsw);
+
 #endif /* SUFFIX_TREE_SLIDING_WINDOW_SHTI_SLIDING_WINDOW_HEADER */
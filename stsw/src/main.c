@@ -32,6 +32,8 @@
  * of the feature test macros.
  */
 #include "stsw.h"
+#include "phase_profile.h"
+#include "arena.h"
 
 /* feature test macros */
 
@@ -110,7 +112,7 @@
  * This program can be executed like this:
  *
 @verbatim
-./stsw -t <type> -a <algorithm>[variation] -b <benchmark> [options] filename
+./stsw -t <type> -a <algorithm>[variation] -b <benchmark> [options] filename...
 @endverbatim
  *
  * which effectively results in
@@ -119,6 +121,23 @@
  * using the implementation type <tt>&lt;type&gt;</tt>
  * and construction algorithm <tt>&lt;algorithm&gt;</tt>
  * with variation <tt>[variation]</tt>.
+ * If @c 'filename' is @c -, the text is read from the standard input.
+ * Pipes and other non-seekable files are supported as well,
+ * so the program can be used directly in a streaming pipeline.
+ *
+ * If more than one @c 'filename' is provided, the program runs
+ * in the multi-stream mode. Each input file forms an independent stream
+ * with its own sliding window and its own suffix tree. All the streams
+ * are opened and kept alive at once. Their blocks are processed
+ * in turns by a fixed pool of the worker threads (see the @c -P
+ * option), while their input files are read by a small set
+ * of the I/O threads (see the @c -Q option). This way, every stream
+ * is read as soon as its input arrives, even if there are
+ * more streams than the threads. The output files specified
+ * by the @c -d and the @c -M options get the index of the stream
+ * appended, for example @c 'dump.txt.2'.
+ * When all the streams have been processed, the per-stream
+ * and the aggregated statistics are printed.
  *
  * The available implementation types are:
  *
@@ -136,6 +155,8 @@
  * The available benchmarks are:
  * \li	@c C	create and delete the suffix tree
  * \li	@c T	create, traverse and delete the suffix tree
+ * \li	@c Z	create and delete the suffix tree, while using it
+ * 		to perform the greedy LZ77 factorization of the text
  *
  * Additional available options are:
  *
@@ -154,6 +175,30 @@
  * 		<ul><li>@c B	batch update by M. Senft</li>
  * 		<li>@c F	Fiala's and Greene's method</li></ul>
  * 		The default method is batch update by M. Senft.
+ * \li	<tt>-W &lt;workers&gt;</tt>
+ * 		Specifies the number of the threads, which perform
+ * 		the batch update of the edge labels in parallel.
+ * 		The result is identical to the serial update.
+ * 		It requires the POSIX threads to be enabled.
+ * 		The default value is @c 1.
+ * \li	<tt>-C &lt;records&gt;</tt>
+ * 		Enables the online compaction of the table of the branching
+ * 		nodes. After each processed block, at most @c records
+ * 		of the highest branching records are moved to the vacant
+ * 		ones below them, provided that more than one eighth
+ * 		of the records is vacant. The table is shrunk when less
+ * 		than a quarter of it is in use.
+ * 		The default value of @c 0 disables the compaction.
+ * \li	<tt>-P &lt;workers&gt;</tt>
+ * 		Specifies the number of the threads, which process
+ * 		the blocks of the input streams in the multi-stream mode.
+ * 		It requires the POSIX threads to be enabled.
+ * 		The default value is @c 1.
+ * \li	<tt>-Q &lt;io_threads&gt;</tt>
+ * 		Specifies the number of the threads, which read
+ * 		the input files in the multi-stream mode.
+ * 		It requires the POSIX threads to be enabled.
+ * 		The default value is @c 1.
  * \li	@c -s	Enables simple traversal logs, which have the same format
  * 		for all the algorithms and implementation techniques.
  * \li	<tt>-d &lt;dump_filename&gt;</tt>
@@ -161,6 +206,16 @@
  * 		the log from the traversal of the suffix tree
  * 		will be printed to the file @c 'dump_filename'
  * 		instead of the standard output.
+ * 		If the LZ77 factorization benchmark is selected,
+ * 		the factors will be printed to the file @c 'dump_filename',
+ * 		one per line, as the offset, the length and the code
+ * 		of the literal. Otherwise, they are only counted.
+ * \li	<tt>-o &lt;format&gt;</tt>
+ * 		Specifies the format of the traversal log.
+ * 		The default value is @c text. The value @c bin selects
+ * 		the compact binary format, which requires the @c -d
+ * 		option and which can be converted back
+ * 		to the text format by the @c stdr.
  * \li	<tt>-e &lt;file_encoding&gt;</tt>
  * 		Specifies the character encoding of the input file
  * 		@c 'filename'. The default value is @c UTF-8.
@@ -185,6 +240,60 @@
  * 		also known as the sliding window scale factor.
  * 		The minimum allowed value is <tt>ap_scale_factor + 1</tt>.
  * 		The default value is <tt>ap_scale_factor + 2</tt>.
+ * \li	<tt>-R &lt;depth&gt;</tt>
+ * 		Specifies the number of the raw input buffers kept in flight
+ * 		by the read-ahead thread. Each of them holds at most 1 MiB.
+ * 		The value of @c 0 disables the read-ahead.
+ * 		The default value is @c 4.
+ * \li	<tt>-D &lt;depth&gt;</tt>
+ * 		Specifies the number of the buffers of converted characters
+ * 		kept in flight by the decode thread.
+ * 		The value of @c 0 moves the character conversion
+ * 		back to the reading thread.
+ * 		The default value is @c 2.
+ * \li	<tt>-M &lt;metrics_filename&gt;</tt>
+ * 		Writes one line of metrics for each processed block
+ * 		to the file @c 'metrics_filename'. Each line contains
+ * 		the wall time, the characters per second, the number
+ * 		of edges and branching nodes, the sizes of the tables
+ * 		tedge and tbranch, the number of the vacant branching
+ * 		records and the wait times of both threads.
+ * 		By default, no metrics are written.
+ * \li	<tt>-F &lt;format&gt;</tt>
+ * 		Specifies the format of the block metrics.
+ * 		Available values are:
+ * 		<ul><li>@c C	comma-separated values</li>
+ * 		<li>@c J	one JSON object per line</li></ul>
+ * 		The default format is @c C.
+ * \li	@c -H	Records the hardware performance counters (the cycles,
+ * 		the instructions, the L1 data cache, last level cache
+ * 		and data TLB read misses and the branch misses)
+ * 		separately for the opening of the input file,
+ * 		the construction (including the interleaved reading
+ * 		and traversal), the deletion of the suffix tree
+ * 		and the closing of the input file and prints them
+ * 		in a table. It requires the perf_event_open system call
+ * 		of Linux and a single input file. The counters,
+ * 		which are not available, are reported as @c n/a.
+ * \li	<tt>-I &lt;interval&gt;</tt>
+ * 		Samples the resident set size every @c interval
+ * 		milliseconds by a separate thread. The wall-clock time
+ * 		and the peak resident set size of each phase
+ * 		are always reported for a single input file,
+ * 		but by default, the resident set size is only read
+ * 		between the phases.
+ * \li	<tt>-J &lt;profile_filename&gt;</tt>
+ * 		Writes the wall-clock time, the memory usage
+ * 		and the hardware performance counters (if requested)
+ * 		of each phase and the samples of the resident set size
+ * 		to the file @c 'profile_filename' as a JSON object.
+ * \li	<tt>-x &lt;allocator&gt;</tt>
+ * 		Selects the allocator of the tables of the suffix trees.
+ * 		The @c malloc (default) allocates them by the standard
+ * 		library. The @c arena allocates them from a large range
+ * 		of the reserved virtual memory and grows them
+ * 		by remapping their pages. The statistics
+ * 		of the allocations are reported at the end.
  * \li	@c -v	The requested verbosity level. Available values are:
  * 		<ul><li>@c 0	low verbosity</li>
  * 		<li>@c 1	medium verbosity</li>
@@ -192,6 +301,66 @@
  * 		The default verbosity level is low.
  */
 
+/* struct typedef */
+
+/**
+ * A struct containing the benchmark settings parsed from the command line,
+ * which are shared by all the input streams.
+ */
+typedef struct benchmark_settings_struct {
+	/** the desired implementation type */
+	int type;
+	/** the desired construction algorithm */
+	int algorithm;
+	/** the desired algorithm variation */
+	int variation;
+	/** the requested benchmark */
+	int benchmark;
+	/** the type of the suffix tree traversal */
+	int traversal_type;
+	/** the format of the suffix tree traversal log */
+	int traversal_format;
+	/** the requested verbosity level */
+	int verbosity_level;
+	/** the desired collision resolution technique */
+	int crt_type;
+	/** the desired number of the Cuckoo hash functions */
+	size_t chf_number;
+	/** the desired edge label maintenance method */
+	int elm_method;
+	/** the desired number of the batch update threads */
+	size_t bu_workers;
+	/** the desired number of the records moved by a compaction step */
+	size_t compaction_step;
+	/** the desired size of a single block in the sliding window */
+	size_t sw_block_size;
+	/** the desired active part scale factor */
+	size_t ap_scale_factor;
+	/** the desired sliding window scale factor */
+	size_t sw_scale_factor;
+	/** the desired number of the raw input buffers kept in flight */
+	size_t read_ahead_depth;
+	/** the desired number of the converted buffers kept in flight */
+	size_t decode_depth;
+	/** the character encoding of the input files */
+	const char *input_file_encoding;
+	/** the desired internal text encoding, or NULL for the default */
+	const char *internal_text_encoding;
+	/** the name of the dump file, or NULL */
+	const char *dump_filename;
+	/** the name of the block metrics file, or NULL */
+	const char *metrics_filename;
+	/** the desired format of the block metrics */
+	int metrics_format;
+	/** the number of the input streams */
+	size_t streams;
+	/**
+	 * the time, the memory usage and the hardware performance
+	 * counters recorded per phase, or NULL in the multi-stream mode
+	 */
+	phase_profile *profile;
+} benchmark_settings;
+
 /* helping function */
 
 /**
@@ -205,12 +374,16 @@
 int print_short_usage (const char *argv0) {
 	printf("Usage:\t%s\t-t <type> ", argv0);
 	printf("-a <algorithm>[variation] -b <benchmark> [options]\n"
-		"\t\tfilename\n\n"
+		"\t\tfilename...\n\n"
 		"This will perform the benchmark <benchmark> "
 		"on the suffix tree\nfor the text from the file "
 		"'filename' using the implementation type <type>\n"
 		"and the construction algorithm <algorithm> "
-		"with variation [variation]\n\n");
+		"with variation [variation]\n"
+		"If 'filename' is '-', the text is read "
+		"from the standard input.\n"
+		"If more files are provided, each of them is processed\n"
+		"as an independent stream, all of them at once.\n\n");
 	return (0);
 }
 
@@ -240,7 +413,9 @@ int print_help (const char *argv0) {
 	 */
 	printf("Available benchmarks are:\n"
 		"C\tcreate and delete the suffix tree\n"
-		"T\tcreate, traverse and delete the suffix tree\n\n"
+		"T\tcreate, traverse and delete the suffix tree\n"
+		"Z\tcreate and delete the suffix tree, while using it\n"
+		"\tto perform the greedy LZ77 factorization of the text\n\n"
 		"Additional options:\n"
 		"-r <CRT>\t\tForces the simple hash table implementation\n"
 		"\t\t\ttype to use the specified collision resolution\n"
@@ -254,7 +429,20 @@ int print_help (const char *argv0) {
 		"\t\t\tto use. Available values are:\n"
 		"\t\t\tB\tbatch update by M. Senft\n"
 		"\t\t\tF\tFiala's and Greene's method\n"
-		"\t\t\tThe default method is batch update by M. Senft.\n");
+		"\t\t\tThe default method is batch update by M. Senft.\n"
+		"-W <workers>\t\tSpecifies the number of the threads,\n"
+		"\t\t\twhich perform the batch update of the edge labels\n"
+		"\t\t\tin parallel. The default value is 1.\n"
+		"-C <records>\t\tEnables the online compaction of the table\n"
+		"\t\t\tof the branching nodes, which moves at most\n"
+		"\t\t\t<records> records after each processed block.\n"
+		"\t\t\tThe default value of 0 disables the compaction.\n"
+		"-P <workers>\t\tSpecifies the number of the threads,\n"
+		"\t\t\twhich process the blocks of the input streams\n"
+		"\t\t\tin the multi-stream mode. The default value is 1.\n"
+		"-Q <io_threads>\t\tSpecifies the number of the threads,\n"
+		"\t\t\twhich read the input files\n"
+		"\t\t\tin the multi-stream mode. The default value is 1.\n");
 	printf("-s\t\t\tEnables simple traversal logs,\n"
 		"\t\t\twhich have the same format for all the algorithms\n"
 		"\t\t\tand implementation techniques.\n"
@@ -262,6 +450,16 @@ int print_help (const char *argv0) {
 		"\t\t\tthe log from the traversal of the suffix tree\n"
 		"\t\t\twill be printed to the file 'dump_filename'\n"
 		"\t\t\tinstead of to the standard output.\n"
+		"\t\t\tIf the LZ77 factorization benchmark is selected,\n"
+		"\t\t\tthe factors will be printed to the file\n"
+		"\t\t\t'dump_filename'. Otherwise, they are only counted.\n"
+		"\t\t\tIn the multi-stream mode, the index of the stream\n"
+		"\t\t\tis appended to the 'dump_filename'.\n"
+		"-o <format>\t\tSpecifies the format of the traversal log.\n"
+		"\t\t\tThe default value is text. The value bin selects\n"
+		"\t\t\tthe compact binary format, which requires\n"
+		"\t\t\tthe -d parameter and which can be converted\n"
+		"\t\t\tback to the text format by the stdr.\n"
 		"-e <file_encoding>\tSpecifies the character encoding\n"
 		"\t\t\tof the input file 'filename'. The default value\n"
 		"\t\t\tis UTF-8. The valid encodings are all those\n"
@@ -285,6 +483,34 @@ int print_help (const char *argv0) {
 		"\t\t\tthe sliding window scale <factor>.\n"
 		"\t\t\tIts value needs to be strictly higher than\n"
 		"\t\t\tthe active part scale factor.\n"
+		"-R <depth>\t\tSpecifies the number of the raw input buffers\n"
+		"\t\t\tkept in flight by the read-ahead thread.\n"
+		"\t\t\tThe value of 0 disables the read-ahead.\n"
+		"\t\t\tThe default value is 4.\n"
+		"-D <depth>\t\tSpecifies the number of the buffers "
+		"of characters\n"
+		"\t\t\tkept in flight by the decode thread.\n"
+		"\t\t\tThe value of 0 moves the character conversion\n"
+		"\t\t\tback to the reading thread.\n"
+		"\t\t\tThe default value is 2.\n");
+	printf("-M <metrics_filename>\tWrites one line of metrics\n"
+		"\t\t\tfor each processed block to the file\n"
+		"\t\t\t'metrics_filename'.\n"
+		"-F <format>\t\tSpecifies the format of the block metrics.\n"
+		"\t\t\tAvailable values are:\n"
+		"\t\t\tC\tcomma-separated values\n"
+		"\t\t\tJ\tone JSON object per line\n"
+		"\t\t\tThe default format is C.\n"
+		"-H\t\t\tRecords the hardware performance counters\n"
+		"\t\t\tfor each phase of the benchmark.\n"
+		"-I <interval>\t\tSamples the resident set size every\n"
+		"\t\t\t<interval> milliseconds.\n"
+		"-J <profile_filename>\tWrites the time and the memory usage\n"
+		"\t\t\tof each phase to the file 'profile_filename'\n"
+		"\t\t\tas a JSON object.\n"
+		"-x <allocator>\t\tAllocates the tables by the 'malloc'\n"
+		"\t\t\t(default) or from an 'arena' of the reserved\n"
+		"\t\t\tvirtual memory.\n"
 		"-v\t\t\tThe requested verbosity level. "
 		"Available values are:\n"
 		"\t\t\t0\tlow verbosity\n"
@@ -319,7 +545,7 @@ int print_usage (const char *argv0) {
  *
  * @param
  * stream	the FILE * type stream to which the traversal progress
- * 		will be written (if requested)
+ * 		or the LZ77 factors will be written (if requested)
  * @param
  * algorithm	the desired construction algorithm to use
  * @param
@@ -330,16 +556,25 @@ int print_usage (const char *argv0) {
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
  * requested_verbosity_level	The requested level of verbosity
  * 				of the information collected
  * 				and displayed to the user during
  * 				the suffix tree construction
  * 				and maintenance.
  * @param
+ * bm		the metrics of the processed blocks,
+ * 		which will be written (if requested)
+ * @param
+ * profile	the time, the memory usage and the hardware performance
+ * 		counters recorded per phase
+ * 		(or NULL)
+ * @param
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  *
- * @return	If the benchmark could be successfully started,
+ * @return	If the benchmark has been successfully performed,
  * 		zero (0) is returned.
  * 		Otherwise, a positive error number is returned.
  */
@@ -348,17 +583,26 @@ int benchmark_slli (FILE *stream,
 		const int variation,
 		const int benchmark,
 		const int traversal_type,
+		const int traversal_format,
 		const int requested_verbosity_level,
+		block_metrics *bm,
+		phase_profile *profile,
 		text_file_sliding_window *tfsw) {
 	suffix_tree_sliding_window_slli stsw = {.branching_nodes =
 		(size_t)(0)};
+	int retval = 0;
+	phase_profile_begin("construction", profile);
 	switch (algorithm) {
 		case 1:
 			if ((variation == 0) || (variation == 1)) {
-				stsw_slli_create_ukkonen(stream, benchmark,
-						variation, traversal_type,
+				if (stsw_slli_create_ukkonen(stream,
+						benchmark, variation,
+						traversal_type,
+						traversal_format,
 						requested_verbosity_level,
-						tfsw, &stsw);
+						bm, tfsw, &stsw) > 0) {
+					retval = 3;
+				}
 			} else {
 				fprintf(stderr, "Unknown value for "
 						"the selected algorithm "
@@ -372,8 +616,9 @@ int benchmark_slli (FILE *stream,
 					"algorithm (%d)\n", algorithm);
 			return (2);
 	}
+	phase_profile_begin("deletion", profile);
 	stsw_slli_delete(requested_verbosity_level, &stsw);
-	return (0);
+	return (retval);
 }
 
 /**
@@ -383,7 +628,7 @@ int benchmark_slli (FILE *stream,
  *
  * @param
  * stream	the FILE * type stream to which the traversal progress
- * 		will be written (if requested)
+ * 		or the LZ77 factors will be written (if requested)
  * @param
  * algorithm	the desired construction algorithm to use
  * @param
@@ -394,6 +639,8 @@ int benchmark_slli (FILE *stream,
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
  * requested_verbosity_level	The requested level of verbosity
  * 				of the information collected
  * 				and displayed to the user during
@@ -404,10 +651,17 @@ int benchmark_slli (FILE *stream,
  * @param
  * chf_number	the desired number of the Cuckoo hash functions
  * @param
+ * bm		the metrics of the processed blocks,
+ * 		which will be written (if requested)
+ * @param
+ * profile	the time, the memory usage and the hardware performance
+ * 		counters recorded per phase
+ * 		(or NULL)
+ * @param
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  *
- * @return	If the benchmark could be successfully started,
+ * @return	If the benchmark has been successfully performed,
  * 		zero (0) is returned.
  * 		Otherwise, a positive error number is returned.
  */
@@ -416,19 +670,28 @@ int benchmark_shti (FILE *stream,
 		const int variation,
 		const int benchmark,
 		const int traversal_type,
+		const int traversal_format,
 		const int requested_verbosity_level,
 		const int crt_type,
 		const size_t chf_number,
+		block_metrics *bm,
+		phase_profile *profile,
 		text_file_sliding_window *tfsw) {
 	suffix_tree_sliding_window_shti stsw = {.crt_type = crt_type,
 		.chf_number = chf_number};
+	int retval = 0;
+	phase_profile_begin("construction", profile);
 	switch (algorithm) {
 		case 1:
 			if ((variation == 0) || (variation == 1)) {
-				stsw_shti_create_ukkonen(stream, benchmark,
-						variation, traversal_type,
+				if (stsw_shti_create_ukkonen(stream,
+						benchmark, variation,
+						traversal_type,
+						traversal_format,
 						requested_verbosity_level,
-						tfsw, &stsw);
+						bm, tfsw, &stsw) > 0) {
+					retval = 3;
+				}
 			} else {
 				fprintf(stderr, "Unknown value for "
 						"the selected algorithm "
@@ -442,8 +705,199 @@ int benchmark_shti (FILE *stream,
 					"algorithm (%d)\n", algorithm);
 			return (2);
 	}
+	phase_profile_begin("deletion", profile);
 	stsw_shti_delete(requested_verbosity_level, &stsw);
-	return (0);
+	return (retval);
+}
+
+/**
+ * A function, which opens an output file of a single input stream.
+ * In the multi-stream mode, the index of the stream is appended
+ * to the provided file name.
+ *
+ * @param
+ * filename	the name of the output file
+ * @param
+ * task		the input stream
+ *
+ * @return	If the file could be opened, its FILE * stream is returned.
+ * 		Otherwise, NULL is returned.
+ */
+FILE *benchmark_open_output (const char *filename, const stream_task *task) {
+	const benchmark_settings *bs =
+		(const benchmark_settings *)(task->settings);
+	char *indexed_filename = NULL;
+	FILE *output = NULL;
+	size_t length = 0;
+	if (bs->streams == 1) {
+		output = fopen(filename, "w");
+		if (output == NULL) {
+			perror("fopen(output)");
+			/* resetting the errno */
+			errno = 0;
+		}
+		return (output);
+	}
+	/* the dot, at most 20 digits and the terminating NULL character */
+	length = strlen(filename) + 22;
+	indexed_filename = malloc(length);
+	if (indexed_filename == NULL) {
+		perror("malloc(indexed_filename)");
+		/* resetting the errno */
+		errno = 0;
+		return (NULL);
+	}
+	snprintf(indexed_filename, length, "%s.%zu", filename, task->index);
+	output = fopen(indexed_filename, "w");
+	if (output == NULL) {
+		fprintf(stderr, "Stream %zu: ", task->index);
+		perror("fopen(output)");
+		/* resetting the errno */
+		errno = 0;
+	}
+	free(indexed_filename);
+	return (output);
+}
+
+/**
+ * A function, which performs the benchmark on a single input stream.
+ * It opens the sliding window and the output files of the stream,
+ * runs the benchmark on its own suffix tree and closes them again.
+ *
+ * @param
+ * task		the input stream, whose statistics will be filled in
+ *
+ * @return	If the benchmark has been successfully performed,
+ * 		zero (0) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int benchmark_stream (stream_task *task) {
+	const benchmark_settings *bs =
+		(const benchmark_settings *)(task->settings);
+	text_file_sliding_window tfsw = {.blocks_read = 0};
+	block_metrics bm = {.stream = NULL};
+	unsigned long long start_time = monotonic_clock_ns();
+	/*
+	 * The identification string of the internal text encoding.
+	 * It is written by the text_file_open, so each stream
+	 * needs its own copy.
+	 */
+	char *internal_text_encoding = NULL;
+	FILE *stream = stdout;
+	FILE *metrics_stream = NULL;
+	int retval = 0;
+	internal_text_encoding = calloc((size_t)(64), (size_t)(1));
+	if (internal_text_encoding == NULL) {
+		perror("calloc(internal_text_encoding)");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	} else {
+		/* resetting the errno */
+		errno = 0;
+	}
+	if (bs->internal_text_encoding != NULL) {
+		/* its length has already been checked */
+		strcpy(internal_text_encoding, bs->internal_text_encoding);
+	}
+	if (bs->dump_filename != NULL) {
+		/* if we got here, benchmark must be set to 2 or 3 */
+		stream = benchmark_open_output(bs->dump_filename, task);
+		if (stream == NULL) {
+			free(internal_text_encoding);
+			return (2);
+		}
+	} else if (bs->benchmark == 3) {
+		/*
+		 * we do not want the factors to be mixed
+		 * with the other output, so we only count them
+		 */
+		stream = NULL;
+	}
+	phase_profile_begin("opening", bs->profile);
+	if (text_file_open(bs->verbosity_level,
+				task->file_name, bs->input_file_encoding,
+				&internal_text_encoding,
+				bs->sw_block_size, bs->ap_scale_factor,
+				bs->sw_scale_factor, bs->elm_method,
+				bs->bu_workers, bs->compaction_step,
+				bs->read_ahead_depth, bs->decode_depth,
+				&tfsw) > 0) {
+		fprintf(stderr, "text_file_open: The function call "
+				"has failed!\n");
+		retval = 3;
+		goto stream_closing;
+	}
+	if (bs->metrics_filename != NULL) {
+		metrics_stream = benchmark_open_output(bs->metrics_filename,
+				task);
+		if (metrics_stream == NULL) {
+			retval = 4;
+			goto window_closing;
+		}
+	}
+	if (block_metrics_init(metrics_stream, bs->metrics_format,
+				&bm) > 0) {
+		fprintf(stderr, "block_metrics_init: The function call "
+				"has failed!\n");
+		retval = 5;
+		goto window_closing;
+	}
+	if (bs->type == 1) {
+		if (benchmark_slli(stream, bs->algorithm, bs->variation,
+					bs->benchmark, bs->traversal_type,
+					bs->traversal_format,
+					bs->verbosity_level, &bm,
+					bs->profile, &tfsw) > 0) {
+			retval = 6;
+		}
+	} else if (bs->type == 2) {
+		if (benchmark_shti(stream, bs->algorithm, bs->variation,
+					bs->benchmark, bs->traversal_type,
+					bs->traversal_format,
+					bs->verbosity_level, bs->crt_type,
+					bs->chf_number, &bm,
+					bs->profile, &tfsw) > 0) {
+			retval = 6;
+		}
+	} else {
+		fprintf(stderr, "Error: Unknown implementation type (%d)\n",
+				bs->type);
+		retval = 7;
+	}
+	task->blocks = bm.blocks;
+	task->characters = bm.characters;
+window_closing:
+	phase_profile_begin("closing", bs->profile);
+	if (text_file_close(bs->verbosity_level, &tfsw) > 0) {
+		fprintf(stderr, "text_file_close: The function call "
+				"has failed!\n");
+		if (retval == 0) {
+			retval = 8;
+		}
+	}
+stream_closing:
+	if ((bs->dump_filename != NULL) && (fclose(stream) == EOF)) {
+		perror("fclose(stream)");
+		/* resetting the errno */
+		errno = 0;
+		if (retval == 0) {
+			retval = 9;
+		}
+	}
+	if ((metrics_stream != NULL) && (fclose(metrics_stream) == EOF)) {
+		perror("fclose(metrics_stream)");
+		/* resetting the errno */
+		errno = 0;
+		if (retval == 0) {
+			retval = 10;
+		}
+	}
+	phase_profile_end(bs->profile);
+	free(internal_text_encoding);
+	internal_text_encoding = NULL;
+	task->wall_time = monotonic_clock_ns() - start_time;
+	return (retval);
 }
 
 /* the main function */
@@ -478,7 +932,28 @@ int main (int argc, char **argv) {
 	 * an alternative which does not produce gcc warnings.
 	 */
 	struct rusage resource_usage_struct = {.ru_maxrss = 0};
-	text_file_sliding_window tfsw = {.blocks_read = 0};
+	benchmark_settings bs = {.type = 0};
+	stream_pool sp = {.tasks = NULL};
+	/* the wall-clock time and the memory usage of each phase */
+	phase_profile profile = {.phases = 0};
+	/*
+	 * if this variable evaluates to true, the hardware performance
+	 * counters will be recorded for each phase of the benchmark
+	 */
+	int counters = 0;
+	/*
+	 * the interval in milliseconds, in which the resident set size
+	 * is sampled, where the default value of zero means that it is
+	 * only read between the phases
+	 */
+	size_t sampling_interval = 0;
+	/* the name of the file, to which the phase profile is written */
+	char *profile_filename = NULL;
+	/*
+	 * if this variable evaluates to true, the tables
+	 * will be allocated from the arena
+	 */
+	int use_arena = 0;
 	/* the maximum resident set size */
 	size_t maximum_rss_size = 0;
 	char c = '\0';
@@ -524,6 +999,17 @@ int main (int argc, char **argv) {
 	 * 			3 - Larsson's method
 	 */
 	int elm_method = 0;
+	/* the desired number of the batch update threads */
+	size_t bu_workers = 1;
+	/* the desired number of the records moved by a compaction step */
+	size_t compaction_step = 0;
+	/* the desired number of the threads processing the input streams */
+	size_t stream_workers = 1;
+	/* the desired number of the threads reading the input streams */
+	size_t io_threads = 1;
+	/* the number of the input streams read from the standard input */
+	size_t stdin_streams = 0;
+	size_t i = 0;
 	/* the desired number of Cuckoo hash functions */
 	size_t chf_number = 0;
 	/* the desired size of a single block in the sliding window */
@@ -532,13 +1018,14 @@ int main (int argc, char **argv) {
 	size_t ap_scale_factor = 0;
 	/* the desired sliding window scale factor */
 	size_t sw_scale_factor = 0;
+	/* the desired number of the raw input buffers kept in flight */
+	size_t read_ahead_depth = 4;
+	/* the desired number of the converted buffers kept in flight */
+	size_t decode_depth = 2;
 	/* by default, we would like the traversal to be detailed */
 	int traversal_type = tt_detailed;
-	/*
-	 * The pointer to the identification string
-	 * of the internal text encoding.
-	 */
-	char *internal_text_encoding = NULL;
+	/* by default, the traversal log is human readable */
+	int traversal_format = tf_text;
 	/*
 	 * The pointer to the program argument representing the
 	 * identification string of the desired internal text encoding.
@@ -546,9 +1033,11 @@ int main (int argc, char **argv) {
 	char *internal_text_encoding_arg = NULL;
 	/* By default, we suppose that the input file encoding is UTF-8 */
 	char *input_file_encoding = "UTF-8";
-	char *input_filename = NULL;
 	char *dump_filename = NULL;
-	FILE *stream = stdout;
+	char *metrics_filename = NULL;
+	/* the desired format of the block metrics */
+	int metrics_format = METRICS_FORMAT_CSV;
+	int function_retval = EXIT_SUCCESS;
 	printf("Benchmark of the suffix tree construction algorithms,\n"
 			"which use the sliding window.\n\n");
 	printf("Compile-time options:\n"
@@ -569,7 +1058,8 @@ int main (int argc, char **argv) {
 	}
 	/* parsing the command line options */
 	while ((getopt_retval = getopt(argc, argv,
-					"t:a:b:r:c:m:sd:e:i:k:A:S:v:h")) !=
+					"t:a:b:r:c:m:W:C:P:Q:sd:o:e:i:k:"
+					"A:S:R:D:M:F:v:HI:J:x:h")) !=
 			(-1)) {
 		c = (char)(getopt_retval);
 		switch (c) {
@@ -616,6 +1106,8 @@ int main (int argc, char **argv) {
 					benchmark = 1;
 				} else if (optarg[0] == 'T') {
 					benchmark = 2;
+				} else if (optarg[0] == 'Z') {
+					benchmark = 3;
 				} else {
 					fprintf(stderr, "Unrecognized "
 						"argument for the -b "
@@ -663,12 +1155,76 @@ int main (int argc, char **argv) {
 					return (EXIT_FAILURE);
 				}
 				break;
+			case 'W':
+				bu_workers = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -W "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(bu_workers)");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'C':
+				compaction_step = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -C "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(compaction_step)");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'P':
+				stream_workers = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -P "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(stream_workers)");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'Q':
+				io_threads = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -Q "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(io_threads)");
+					return (EXIT_FAILURE);
+				}
+				break;
 			case 's':
 				traversal_type = tt_simple;
 				break;
 			case 'd':
 				dump_filename = optarg;
 				break;
+			case 'o':
+				if (strcmp(optarg, "text") == 0) {
+					traversal_format = tf_text;
+				} else if (strcmp(optarg, "bin") == 0) {
+					traversal_format = tf_binary;
+				} else {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -o "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				break;
 			case 'e':
 				input_file_encoding = optarg;
 				break;
@@ -714,6 +1270,47 @@ int main (int argc, char **argv) {
 					return (EXIT_FAILURE);
 				}
 				break;
+			case 'R':
+				read_ahead_depth = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -R "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(read_ahead_depth)");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'D':
+				decode_depth = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -D "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(decode_depth)");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'M':
+				metrics_filename = optarg;
+				break;
+			case 'F':
+				if (optarg[0] == 'C') {
+					metrics_format = METRICS_FORMAT_CSV;
+				} else if (optarg[0] == 'J') {
+					metrics_format = METRICS_FORMAT_JSON;
+				} else {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -F "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				break;
 			case 'v':
 				verbosity_level = strtol(optarg, &endptr, 0);
 				if ((*endptr) != '\0') {
@@ -727,6 +1324,37 @@ int main (int argc, char **argv) {
 					return (EXIT_FAILURE);
 				}
 				break;
+			case 'H':
+				counters = 1;
+				break;
+			case 'I':
+				sampling_interval = strtoul(optarg, &endptr, 0);
+				if ((*endptr) != '\0') {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -I "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				if (errno != 0) {
+					perror("strtoul(sampling_interval)");
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'J':
+				profile_filename = optarg;
+				break;
+			case 'x':
+				if (strcmp(optarg, "arena") == 0) {
+					use_arena = 1;
+				} else if (strcmp(optarg, "malloc") == 0) {
+					use_arena = 0;
+				} else {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -x "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				break;
 			case 'h':
 				print_help(argv[0]);
 				return (EXIT_SUCCESS);
@@ -739,11 +1367,12 @@ int main (int argc, char **argv) {
 		print_usage(argv[0]);
 		return (EXIT_FAILURE);
 	}
-	input_filename = argv[optind];
-	if (optind + 1 < argc) {
-		fprintf(stderr, "Too many parameters!\n\n");
-		print_usage(argv[0]);
-		return (EXIT_FAILURE);
+	/* all the remaining parameters are the names of the input files */
+	bs.streams = (size_t)(argc - optind);
+	for (i = 0; i < bs.streams; ++i) {
+		if (strcmp(argv[optind + (int)(i)], "-") == 0) {
+			++stdin_streams;
+		}
 	}
 	/* command line options parsing complete */
 	if (type == 0) {
@@ -764,18 +1393,57 @@ int main (int argc, char **argv) {
 		print_usage(argv[0]);
 		return (EXIT_FAILURE);
 	}
-	if ((dump_filename != NULL) && (benchmark != 2)) {
+	if ((dump_filename != NULL) && (benchmark != 2) && (benchmark != 3)) {
 		fprintf(stderr, "The -d parameter "
 				"can only be used with the traverse (T) "
+				"or the LZ77 factorization (Z) "
 				"type of benchmark!\n");
 		return (EXIT_FAILURE);
 	}
+	if ((bs.streams > 1) && (benchmark == 2) && (dump_filename == NULL)) {
+		fprintf(stderr, "The -d parameter is mandatory "
+				"for the traverse (T) type of benchmark\n"
+				"when more than one input file is provided!\n");
+		return (EXIT_FAILURE);
+	}
+	if ((bs.streams > 1) && (stdin_streams > 0)) {
+		fprintf(stderr, "The standard input ('-') can not be used "
+				"when more than one input file "
+				"is provided!\n");
+		return (EXIT_FAILURE);
+	}
+	if (((counters != 0) || (sampling_interval != 0) ||
+				(profile_filename != NULL)) &&
+			(bs.streams > 1)) {
+		fprintf(stderr, "The -H, -I and -J parameters "
+				"can only be used with a single "
+				"input file!\n");
+		return (EXIT_FAILURE);
+	}
+	if (stream_workers == 0) {
+		fprintf(stderr, "The argument for the -P parameter "
+				"needs to be at least 1!\n");
+		return (EXIT_FAILURE);
+	}
+	if (io_threads == 0) {
+		fprintf(stderr, "The argument for the -Q parameter "
+				"needs to be at least 1!\n");
+		return (EXIT_FAILURE);
+	}
 	if ((traversal_type != tt_detailed) && (benchmark != 2)) {
 		fprintf(stderr, "The -s parameter "
 				"can only be used with the traverse (T) "
 				"type of benchmark!\n");
 		return (EXIT_FAILURE);
 	}
+	if ((traversal_format != tf_text) &&
+			((benchmark != 2) || (dump_filename == NULL))) {
+		fprintf(stderr, "The -o bin parameter "
+				"can only be used with the traverse (T) "
+				"type of benchmark\nand together "
+				"with the -d parameter!\n");
+		return (EXIT_FAILURE);
+	}
 	if ((type != 2) && (crt_type != 0)) {
 		fprintf(stderr, "The -r parameter "
 				"can only be used with the SH "
@@ -817,76 +1485,106 @@ int main (int argc, char **argv) {
 	}
 #endif
 	/*
-	 * we need not to free the internal_text_encoding,
-	 * because it is a local variable, which has been initialized to NULL
+	 * We test if the argument representing the internal text
+	 * encoding fits into the buffer of each stream. Its length
+	 * might not be more than 63 bytes, because the last byte
+	 * is reserved for the terminating NULL character.
 	 */
-	internal_text_encoding = calloc((size_t)(64), (size_t)(1));
-	if (internal_text_encoding == NULL) {
-		perror("calloc(internal_text_encoding)");
-		/* resetting the errno */
-		errno = 0;
+	if ((internal_text_encoding_arg != NULL) &&
+			(strlen(internal_text_encoding_arg) > (size_t)(63))) {
+		fprintf(stderr, "The argument for the -i parameter "
+				"is too long.\nIts maximum length "
+				"is 63 bytes (characters).\n");
+		/*
+		 * strlen returns the text length NOT including
+		 * the terminating NULL character
+		 */
 		return (EXIT_FAILURE);
-	} else {
+	}
+	bs.type = type;
+	bs.algorithm = algorithm;
+	bs.variation = variation;
+	bs.benchmark = benchmark;
+	bs.traversal_type = traversal_type;
+	bs.traversal_format = traversal_format;
+	bs.verbosity_level = (int)(verbosity_level);
+	bs.crt_type = crt_type;
+	bs.chf_number = chf_number;
+	bs.elm_method = elm_method;
+	bs.bu_workers = bu_workers;
+	bs.compaction_step = compaction_step;
+	bs.sw_block_size = sw_block_size;
+	bs.ap_scale_factor = ap_scale_factor;
+	bs.sw_scale_factor = sw_scale_factor;
+	bs.read_ahead_depth = read_ahead_depth;
+	bs.decode_depth = decode_depth;
+	bs.input_file_encoding = input_file_encoding;
+	bs.internal_text_encoding = internal_text_encoding_arg;
+	bs.dump_filename = dump_filename;
+	bs.metrics_filename = metrics_filename;
+	bs.metrics_format = metrics_format;
+	sp.tasks = calloc(bs.streams, sizeof (stream_task));
+	if (sp.tasks == NULL) {
+		perror("calloc(tasks)");
 		/* resetting the errno */
 		errno = 0;
+		return (EXIT_FAILURE);
 	}
-	if (internal_text_encoding_arg != NULL) {
-		/*
-		 * We test if the argument representing the internal text
-		 * encoding fits into the provided buffer. Its length
-		 * might not be more than 63 bytes, because the last byte
-		 * is reserved for the terminating NULL character.
-		 */
-		if (strlen(internal_text_encoding_arg) > (size_t)(63)) {
-			fprintf(stderr, "The argument for the -i parameter "
-					"is too long.\nIts maximum length "
-					"is 63 bytes (characters).\n");
-			/*
-			 * strlen returns the text length NOT including
-			 * the terminating NULL character
-			 */
-			return (EXIT_FAILURE);
-		}
-		strcpy(internal_text_encoding, internal_text_encoding_arg);
+	for (i = 0; i < bs.streams; ++i) {
+		sp.tasks[i].index = i + 1;
+		sp.tasks[i].file_name = argv[optind + (int)(i)];
+		sp.tasks[i].settings = &bs;
 	}
-	if (dump_filename != NULL) {
-		/* if we got here, benchmark must be set to 2 */
-		stream = fopen(dump_filename, "w");
-		if (stream == NULL) {
-			perror("fopen(stream)");
+	sp.streams = bs.streams;
+	sp.process = benchmark_stream;
+	/*
+	 * The phases of the parallel streams would overlap,
+	 * so they are only recorded for a single stream.
+	 */
+	if (bs.streams == 1) {
+		/* before any other thread is started */
+		if (phase_profile_open(counters, sampling_interval,
+					&profile) > 0) {
+			free(sp.tasks);
 			return (EXIT_FAILURE);
 		}
+		bs.profile = &profile;
 	}
-	if (text_file_open((const int)(verbosity_level),
-				input_filename, input_file_encoding,
-				&internal_text_encoding,
-				sw_block_size, ap_scale_factor,
-				sw_scale_factor, elm_method, &tfsw) > 0) {
-		fprintf(stderr, "text_file_open: The function call "
-				"has failed!\n");
+	if ((use_arena != 0) && (arena_open((size_t)(0)) > 0)) {
+		if (bs.profile != NULL) {
+			phase_profile_close(bs.profile);
+		}
+		free(sp.tasks);
 		return (EXIT_FAILURE);
 	}
 	/* random number generator initialization */
 	srandom((unsigned int)(time(NULL)));
-	if (type == 1) {
-		benchmark_slli(stream, algorithm, variation,
-				benchmark, traversal_type,
-				(const int)(verbosity_level), &tfsw);
-	} else if (type == 2) {
-		benchmark_shti(stream, algorithm, variation,
-				benchmark, traversal_type,
-				(const int)(verbosity_level),
-				crt_type, chf_number, &tfsw);
-	} else {
-		fprintf(stderr, "Error: Unknown implementation type (%d)\n",
-				type);
-		return (EXIT_FAILURE);
-	}
-	if (text_file_close((const int)(verbosity_level), &tfsw) > 0) {
-		fprintf(stderr, "text_file_close: The function call "
+	if (stream_pool_run(stream_workers, io_threads, &sp) > 0) {
+		fprintf(stderr, "stream_pool_run: The function call "
 				"has failed!\n");
-		return (EXIT_FAILURE);
+		function_retval = EXIT_FAILURE;
+	}
+	if (bs.streams > 1) {
+		if (stream_pool_print_stats(stdout, &sp) > 0) {
+			function_retval = EXIT_FAILURE;
+		}
+	} else if (sp.tasks[0].retval > 0) {
+		function_retval = EXIT_FAILURE;
 	}
+	if (bs.profile != NULL) {
+		phase_profile_finish(bs.profile);
+		printf("\n");
+		phase_profile_print(stdout, bs.profile);
+		if ((profile_filename != NULL) &&
+				(phase_profile_write_json(profile_filename,
+							  bs.profile) > 0)) {
+			function_retval = EXIT_FAILURE;
+		}
+		phase_profile_close(bs.profile);
+	}
+	printf("\n");
+	arena_print_stats(stdout);
+	arena_close();
 	getrusage(RUSAGE_SELF, &resource_usage_struct);
 	printf("\nFinal CPU and memory statistics:\n"
 			"--------------------------------\n");
@@ -918,13 +1616,7 @@ int main (int argc, char **argv) {
 			maximum_rss_size);
 	print_human_readable_size(stdout, maximum_rss_size);
 	printf(")\n");
-	if (dump_filename != NULL) {
-		if (fclose(stream) == EOF) {
-			perror("fclose(stream)");
-			return (EXIT_FAILURE);
-		}
-	}
-	free(internal_text_encoding);
-	internal_text_encoding = NULL;
-	return (EXIT_SUCCESS);
+	free(sp.tasks);
+	sp.tasks = NULL;
+	return (function_retval);
 }
@@ -24,17 +24,50 @@
  * which are used for the construction and maintenance
  * of the suffix tree over a sliding window.
  */
+
+/* if we are on the Linux platform */
+#ifdef	__linux__
+
+#ifndef	_GNU_SOURCE
+
+/**
+ * This macro is necessary for the F_SETPIPE_SZ command
+ * of the function fcntl
+ */
+#define	_GNU_SOURCE
+
+#endif
+
+#endif
+
 #include "stsw_common.h"
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 
+#ifdef	STSW_USE_PTHREAD
+
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#ifdef	__linux__
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#endif
+
+#endif
+
 /* constants */
 
 /* sliding window block status flags */
@@ -64,25 +97,105 @@ const int BLOCK_STATUS_READ_AND_UNPROCESSED = 1;
  */
 const int BLOCK_STATUS_STILL_IN_USE = 2;
 
+/* reading status flags */
+
+/** A flag indicating that the reading of the input file is in progress. */
+const int READING_STATUS_IN_PROGRESS = 0;
+
+/**
+ * A flag indicating that the whole input file has been read
+ * and that the information about the final block is available.
+ */
+const int READING_STATUS_COMPLETE = 1;
+
+/**
+ * A flag indicating that the reading has been stopped prematurely,
+ * either because of a reading error or on a request of the main thread.
+ */
+const int READING_STATUS_STOPPED = 2;
+
+/* block metrics formats */
+
+/** The block metrics are written as comma-separated values. */
+const int METRICS_FORMAT_CSV = 1;
+
+/** The block metrics are written as one JSON object per line. */
+const int METRICS_FORMAT_JSON = 2;
+
+#ifdef	STSW_USE_PTHREAD
+
+/**
+ * The number of times a waiting thread rechecks the block status
+ * before it goes to sleep until the next block status change.
+ */
+const size_t wait_spin_limit = 1024;
+
+/* fiber states */
+
+/** A flag indicating that the fiber can be resumed right away. */
+const int FIBER_STATE_READY = 0;
+
+/** A flag indicating that the fiber waits for its event counter to change. */
+const int FIBER_STATE_WAITING_EVENT = 1;
+
+/** A flag indicating that the fiber waits for its input to be readable. */
+const int FIBER_STATE_WAITING_INPUT = 2;
+
+/** A flag indicating that the function of the fiber has returned. */
+const int FIBER_STATE_FINISHED = 3;
+
+/**
+ * The size of the stack of a single fiber in bytes.
+ * The stack is only reserved, its pages are allocated on the first use.
+ */
+const size_t fiber_stack_size = 8388608; /* 8 MiB */
+
+/** the fiber pool of the running multi-stream mode, or NULL */
+static stream_fiber_pool *running_fiber_pool = NULL;
+
+/** the scheduling thread of the calling thread, or NULL */
+static __thread stream_scheduler *running_scheduler = NULL;
+
+#endif
+
+/**
+ * The maximum size of a single buffer in the read-ahead ring in bytes.
+ * If the block in the sliding window is smaller,
+ * the size of the block is used instead.
+ */
+const size_t read_ahead_buffer_size_limit = 1048576; /* 1 MiB */
+
+/**
+ * The minimum size of the conversion buffer in bytes.
+ * It needs to be able to hold the longest multi-byte sequence
+ * of any supported input file encoding.
+ */
+const size_t conversion_buffer_min_size = 64;
+
 /* auxiliary functions */
 
 /**
- * A function which reads the next part of the previously specified input file
- * into the previously specified part of the provided sliding window.
- * This function does not perform the checking nor adjusting
- * of the sliding window block flags or the index of the most recently read
- * block. It is user's responsibility to check
- * and appropriately change these flags and the index if necessary.
- * Also, this function does not update the total number of blocks,
- * characters or bytes read in the text_file_sliding_window struct.
- * Again, it is user's responsibility to adjust these values accordingly,
- * based on this function's output parameters.
+ * A function which converts the next part of the previously specified
+ * input file into the provided output buffer.
+ * The conversion is restartable. When the output buffer
+ * gets full, the bytes which have already been read but not yet
+ * converted stay in the conversion buffer for the next call.
+ * Likewise, an incomplete multi-byte sequence at the end
+ * of the conversion buffer is moved to its beginning
+ * and completed by the bytes read next.
+ * The conversion buffer is never reallocated.
  *
  * @param
+ * outbuf	the pointer to the output buffer, which will be advanced
+ * 		past the converted characters
+ * @param
+ * outbytesleft	the number of bytes left in the output buffer,
+ * 		which will be decreased accordingly
+ * @param
  * characters_read	When this function successfully finishes,
  * 			this variable will be replaced with the total
- * 			number of characters read from the input file
- * 			and converted during this function call.
+ * 			number of characters converted
+ * 			during this function call.
  * @param
  * bytes_read	When this function successfully finishes,
  * 		this variable will be replaced with the total number of bytes
@@ -90,25 +203,17 @@ const int BLOCK_STATUS_STILL_IN_USE = 2;
  * 		Note that this variable contains the number of bytes read,
  * 		which does not necessarily have to be the same
  * 		as the number of bytes read and converted.
- * 		For example, when there are no bytes left in the output buffer,
- * 		but there are still some bytes left in the input (conversion)
- * 		buffer, it means that not all of the bytes
- * 		which have already been read have also already been used
- * 		for the conversion to the characters. These read but
- * 		yet unused bytes will be utilized later,
- * 		in the next call of this function.
  * @param
- * tfsw		the sliding window which will be updated
- * 		with the new characters coming
- * 		from the previously specified input file
+ * tfsw		the sliding window with an already opened input file
  *
- * @return	If the reading was successful, this function returns 0.
- * 		If the reading was partially successful (it had to stop,
- * 		because the input file does not have enough
- * 		unread bytes left), (-1) is returned.
+ * @return	If the output buffer has been filled, this function returns 0.
+ * 		If it had to stop, because the input file does not have
+ * 		enough unread bytes left, (-1) is returned.
  * 		Otherwise, a positive error number is returned.
  */
-int text_file_read_part (size_t *characters_read,
+int text_file_convert (char **outbuf,
+		size_t *outbytesleft,
+		size_t *characters_read,
 		size_t *bytes_read,
 		text_file_sliding_window *tfsw) {
 	/*
@@ -119,451 +224,2587 @@ int text_file_read_part (size_t *characters_read,
 	size_t outbytesleft_at_start = 0;
 	/* the return value of the iconv */
 	size_t retval = 0;
-	/* the number of bytes read by one function call to read() */
+	/* the number of bytes read by one call to text_file_fetch_bytes */
 	ssize_t current_bytes_read = 0;
 	/*
-	 * number of unused bytes in the input buffer
-	 * used in the last call to the iconv function
+	 * a flag indicating that the conversion buffer ends
+	 * with an incomplete multi-byte sequence
 	 */
-	size_t unused_input_bytes = 0;
+	int incomplete = 0;
 	/* at first, we clear the provided output parameters */
 	(*bytes_read) = 0;
 	(*characters_read) = 0;
-	/*
-	 * while we have not freshened all the characters
-	 * in the first part of the desired blocks
-	 */
-	while (tfsw->outbytesleft > 0) {
+	while ((*outbytesleft) > 0) {
+		/* if we need more input bytes */
+		if ((tfsw->inbytesleft == 0) || (incomplete != 0)) {
+			if (tfsw->inbytesleft == tfsw->conversion_buffer_size) {
+				fprintf(stderr, "text_file_convert: "
+						"The conversion buffer "
+						"is too small!\n");
+				return (4);
+			}
+			/*
+			 * We move the yet unconverted bytes
+			 * to the beginning of the conversion buffer.
+			 */
+			if (tfsw->inbytesleft > 0) {
+				memmove(tfsw->conversion_buffer,
+						tfsw->inbuf,
+						tfsw->inbytesleft);
+			}
+			tfsw->inbuf = tfsw->conversion_buffer;
+			current_bytes_read = text_file_fetch_bytes(
+					tfsw->conversion_buffer +
+					tfsw->inbytesleft,
+					tfsw->conversion_buffer_size -
+					tfsw->inbytesleft, tfsw);
+			/* we check whether the read has encountered an error */
+			if (current_bytes_read == (-1)) {
+				perror("text_file_convert: "
+						"text_file_fetch_bytes");
+				/* resetting the errno */
+				errno = 0;
+				return (3);
+			/* if we have reached the end of the input file */
+			} else if (current_bytes_read == 0) {
+				if (tfsw->inbytesleft > 0) {
+					fprintf(stderr, "text_file_convert: "
+							"Ignoring %zu bytes "
+							"of an incomplete "
+							"multi-byte sequence\n"
+							"at the end "
+							"of the input file.\n",
+							tfsw->inbytesleft);
+					tfsw->inbytesleft = 0;
+				}
+				return (-1); /* partial success */
+			}
+			tfsw->inbytesleft += (size_t)(current_bytes_read);
+			/* we increment the total number of bytes read so far */
+			(*bytes_read) += (size_t)(current_bytes_read);
+			incomplete = 0;
+		}
 		/*
 		 * we remember the current number of bytes,
-		 * which remain to be read
-		 */
-		outbytesleft_at_start = tfsw->outbytesleft;
-		/*
-		 * we try to use iconv to convert the characters
-		 * in the input buffer to the characters in the output buffer
-		 *
-		 * note that we do not have to use
-		 * the parentheses like this: &(tfsw->inbuf),
-		 * because the member selection via pointer (->)
-		 * has greater priority than the address operator (&)
-		 *
-		 * The first call to this function has tfsw->inbuf == NULL
-		 * and tfsw->inbytesleft == 0 while tfsw->outbuf != NULL
-		 * and tfsw->outbytesleft != 0. This is not an error,
-		 * because in this case iconv sets the conversion descriptor
-		 * to the initial state and stores a corresponding state
-		 * shift sequence at tfsw->outbuf.
-		 * Since all the internal character encodings
-		 * (ASCII, UCS-2LE, UCS-4LE) are state-independent,
-		 * no state shift sequence is output to tfsw->outbuf.
+		 * which remain to be converted
 		 */
+		outbytesleft_at_start = (*outbytesleft);
 		retval = iconv(tfsw->cd, &tfsw->inbuf, &tfsw->inbytesleft,
-				&tfsw->outbuf, &tfsw->outbytesleft);
+				outbuf, outbytesleft);
 		/*
-		 * FIXME:
-		 * We don't know why, but there are segmentation faults
-		 * when converting from inbuf to outbuf such that exactly
-		 * one of them is exhausted and the other is not.
-		 * The segmentation faults occur in the function iconv here.
-		 * Unlikely, but it is also possible
-		 * that it is a bug in iconv.
-		 * FIXME: Resolve this!
+		 * Now we add the number of characters,
+		 * which have just been converted
+		 * to the total number of characters read so far.
 		 */
-		/* resetting the number of unused bytes */
-		unused_input_bytes = 0;
+		(*characters_read) += (outbytesleft_at_start -
+				(*outbytesleft)) / character_type_size;
 		/* if the iconv has encountered an error */
 		if (retval == (size_t)(-1)) {
-			/*
-			 * The most common case when iconv can return (-1)
-			 * and set errno and it is not considered an error
-			 * is when the output buffer is fully exhausted
-			 * (E2BIG). This means that all the characters
-			 * expected to be read in this part have already
-			 * been read. Similarly, if iconv has encountered
-			 * an incomplete multi-byte sequence at the end
-			 * of the input buffer (EINVAL), it is not really
-			 * an error as well.
-			 * In both of these cases we simply move the unused
-			 * part of the input buffer to its beginning
-			 * for later processing.
-			 */
-			if ((errno == E2BIG) || (errno == EINVAL)) {
+			if (errno == E2BIG) {
+				/*
+				 * The output buffer is full. The remaining
+				 * input bytes will be converted
+				 * in the next call of this function.
+				 */
+				/* resetting the errno */
+				errno = 0;
+				break;
+			} else if (errno == EINVAL) {
 				/*
 				 * An incomplete multi-byte sequence
 				 * has been encountered at the end
-				 * of the input buffer. We move it
-				 * to the beginning of the input buffer
-				 * for later processing.
+				 * of the input buffer. We need to read
+				 * more bytes to complete it.
 				 */
-				memmove(tfsw->conversion_buffer,
-						tfsw->inbuf,
-						tfsw->inbytesleft);
-				/* correcting the number of unused bytes */
-				unused_input_bytes = tfsw->inbytesleft;
+				incomplete = 1;
 				/* resetting the errno */
 				errno = 0;
 			} else {
-				perror("text_file_read_part: iconv");
+				perror("text_file_convert: iconv");
 				/* resetting the errno */
 				errno = 0;
 				return (1);
 			}
 		} else if (retval > 0) {
-			fprintf(stderr,	"text_file_read_part: iconv "
+			fprintf(stderr,	"text_file_convert: iconv "
 					"converted %zu characters\n"
 					"in a nonreversible way!\n",
 					retval);
 			return (2);
 		}
-		/*
-		 * Now we add the number of characters,
-		 * which have just been converted from the conversion buffer
-		 * to the total number of characters read so far.
-		 */
-		(*characters_read) += (outbytesleft_at_start -
-				tfsw->outbytesleft) / character_type_size;
-		current_bytes_read = read(tfsw->fd, tfsw->conversion_buffer +
-				unused_input_bytes,
-				tfsw->conversion_buffer_size -
-				unused_input_bytes);
-		/* we check whether the read has encountered an error */
-		if (current_bytes_read == (-1)) {
-			perror("text_file_read_part: read");
-			/* resetting the errno */
-			errno = 0;
-			return (3);
-		/* if we have reached the end of the input file */
-		} else if ((current_bytes_read == 0) &&
-			/*
-			 * and there are no unused bytes left
-			 * in the input buffer
-			 */
-				(unused_input_bytes == (size_t)(0))) {
-			/*
-			 * we don't need to increment the total number
-			 * of bytes read so far
-			 */
-			return (-1); /* partial success */
-		}
-		/*
-		 * we set the iconv input buffer to the beginning
-		 * of the buffer which has recently been read
-		 */
-		tfsw->inbuf = tfsw->conversion_buffer;
-		/* the maximum number of input bytes to process */
-		tfsw->inbytesleft = unused_input_bytes +
-			(size_t)(current_bytes_read);
-		/* we increment the total number of bytes read so far */
-		(*bytes_read) += (size_t)(current_bytes_read);
 	}
 	return (0);
 }
 
+/**
+ * A function which reads the next part of the previously specified input file
+ * into the previously specified part of the provided sliding window.
+ * If the decode stage is running, the already converted characters
+ * are just copied from the decode ring. Otherwise, the bytes
+ * are converted right here.
+ * This function does not perform the checking nor adjusting
+ * of the sliding window block flags or the index of the most recently read
+ * block. It is user's responsibility to check
+ * and appropriately change these flags and the index if necessary.
+ * Also, this function does not update the total number of blocks,
+ * characters or bytes read in the text_file_sliding_window struct.
+ * Again, it is user's responsibility to adjust these values accordingly,
+ * based on this function's output parameters.
+ *
+ * @param
+ * characters_read	When this function successfully finishes,
+ * 			this variable will be replaced with the total
+ * 			number of characters read from the input file
+ * 			and converted during this function call.
+ * @param
+ * bytes_read	When this function successfully finishes,
+ * 		this variable will be replaced with the total number of bytes
+ * 		read from the input file in this function call.
+ * 		If the decode stage is running, the bytes are accounted for
+ * 		once all the characters converted from them
+ * 		have been copied.
+ * @param
+ * tfsw		the sliding window which will be updated
+ * 		with the new characters coming
+ * 		from the previously specified input file
+ *
+ * @return	If the reading was successful, this function returns 0.
+ * 		If the reading was partially successful (it had to stop,
+ * 		because the input file does not have enough
+ * 		unread bytes left), (-1) is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int text_file_read_part (size_t *characters_read,
+		size_t *bytes_read,
+		text_file_sliding_window *tfsw) {
+#ifdef	STSW_USE_PTHREAD
+	/* the number of bytes copied by one call to buffer_ring_fetch */
+	ssize_t current_bytes_copied = 0;
+	if (tfsw->dr != NULL) {
+		(*bytes_read) = 0;
+		(*characters_read) = 0;
+		while (tfsw->outbytesleft > 0) {
+			current_bytes_copied = buffer_ring_fetch(tfsw->outbuf,
+					tfsw->outbytesleft, bytes_read,
+					tfsw->dr);
+			if (current_bytes_copied == (-1)) {
+				perror("text_file_read_part: "
+						"buffer_ring_fetch");
+				/* resetting the errno */
+				errno = 0;
+				return (3);
+			} else if (current_bytes_copied == 0) {
+				return (-1); /* partial success */
+			}
+			tfsw->outbuf += current_bytes_copied;
+			tfsw->outbytesleft -= (size_t)(current_bytes_copied);
+			(*characters_read) += (size_t)(current_bytes_copied) /
+				character_type_size;
+		}
+		return (0);
+	}
+#endif
+	return (text_file_convert(&tfsw->outbuf, &tfsw->outbytesleft,
+				characters_read, bytes_read, tfsw));
+}
+
+/**
+ * A function, which returns the current value of the monotonic clock.
+ *
+ * @return	the current value of the monotonic clock in nanoseconds
+ */
+unsigned long long monotonic_clock_ns (void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((unsigned long long)(ts.tv_sec) * 1000000000ULL +
+			(unsigned long long)(ts.tv_nsec));
+}
+
 #ifdef	STSW_USE_PTHREAD
-/* thread related auxiliary function */
+/* thread related auxiliary functions */
 
 /**
- * A function, which is executed by the auxiliary thread
- * and which reads the input file and replaces the characters
- * in the oldest blocks of the sliding window.
- * This funtion reads one block at a time.
+ * A function, which puts the calling thread to sleep
+ * until the event counter differs from the provided value.
+ * On Linux, a futex is used. Elsewhere, the thread just yields
+ * the processor, so the caller will recheck its condition soon.
+ * A fiber does not sleep, it yields to the other fibers
+ * of its scheduling thread instead.
  *
  * @param
- * arg		The void * type of the pointer to the shared_data struct,
- * 		which holds all the data necessary for this thread's operation
- * 		and for the synchronization with the main thread.
+ * observed	the value of the event counter,
+ * 		which has been observed before the condition check
+ * @param
+ * ec		the event counter
+ */
+void event_counter_sleep (int observed, event_counter *ec) {
+	if (stream_fiber_current() != NULL) {
+		stream_fiber_wait_event(observed, ec);
+		return;
+	}
+	__atomic_add_fetch(&ec->sleepers, 1, __ATOMIC_SEQ_CST);
+#ifdef	__linux__
+	/*
+	 * The kernel compares the counter with the observed value
+	 * atomically, so a change, which has happened after
+	 * the observation, can not be missed.
+	 */
+	syscall(SYS_futex, &ec->event, FUTEX_WAIT_PRIVATE, observed, NULL,
+			NULL, 0);
+	/* EAGAIN and EINTR are both fine, the caller will recheck */
+	errno = 0;
+#else
+	if (__atomic_load_n(&ec->event, __ATOMIC_SEQ_CST) == observed) {
+		sched_yield();
+	}
+#endif
+	__atomic_sub_fetch(&ec->sleepers, 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * A function, which announces an event
+ * and wakes up the threads sleeping on the event counter.
+ * In the multi-stream mode, the sleeping scheduling threads
+ * are woken up as well, because their fibers might be waiting
+ * on the event counter.
  *
- * @return	If the whole input file has been successfully read
- * 		and all the parts of the sliding window have been
- * 		successfully overwritten, this function returns NULL.
- * 		Otherwise, if an error occurs,
- * 		a positive error number type-cast to (void*) is returned.
+ * @param
+ * ec		the event counter
  */
-void *reading_thread_function (void *arg) {
-	/* an index of the currently read block */
-	size_t block_to_read = 0;
-	size_t blocks_read = 0;
-	size_t characters_read = 0;
-	size_t bytes_read = 0;
-	/* the return value from the function text_file_read_blocks */
+void event_counter_notify (event_counter *ec) {
+	stream_fiber_pool *pool = NULL;
+	__atomic_add_fetch(&ec->event, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ec->sleepers, __ATOMIC_SEQ_CST) > 0) {
+#ifdef	__linux__
+		syscall(SYS_futex, &ec->event, FUTEX_WAKE_PRIVATE, INT_MAX,
+				NULL, NULL, 0);
+#endif
+	}
+	pool = __atomic_load_n(&running_fiber_pool, __ATOMIC_ACQUIRE);
+	if (pool != NULL) {
+		stream_fiber_pool_wake(pool);
+	}
+}
+
+/**
+ * A function, which is called by a waiting thread
+ * after its condition has not been met.
+ * At first, it just counts the spins. When the spin limit is reached,
+ * it puts the thread to sleep until the next event.
+ * A fiber does not spin at all, because the event it waits for
+ * might have to be announced by another fiber of the same thread.
+ *
+ * @param
+ * spins	the number of spins performed so far by the caller
+ * @param
+ * observed	the value of the event counter,
+ * 		which has been observed before the condition check
+ * @param
+ * counters	the wait counters of the calling thread
+ * @param
+ * ec		the event counter
+ */
+void event_counter_pause (size_t *spins, int observed,
+		wait_counters *counters, event_counter *ec) {
+	if (((*spins) < wait_spin_limit) && (stream_fiber_current() == NULL)) {
+		++(*spins);
+	} else {
+		++counters->sleeps;
+		event_counter_sleep(observed, ec);
+	}
+}
+
+/**
+ * A function, which waits until there is a free buffer in the ring.
+ * It is called by the thread filling the ring.
+ * A fiber yields to the other fibers of its scheduling thread first.
+ *
+ * @param
+ * ring		the buffer ring
+ *
+ * @return	If there is a free buffer, this function returns zero.
+ * 		If the filling thread has been requested to stop,
+ * 		a positive value is returned.
+ */
+int buffer_ring_wait_for_free (buffer_ring *ring) {
+	unsigned long long wait_start = 0;
+	size_t spins = 0;
+	int event = 0;
 	int retval = 0;
-	shared_data *sd = arg;
+	if (stream_fiber_current() != NULL) {
+		/* the other fibers get their turn after every buffer */
+		stream_fiber_yield();
+	}
 	while (1) {
-		block_to_read = sd->tfsw->sw_mrr_block + 1;
-		if (block_to_read == sd->tfsw->sw_blocks) {
-			block_to_read = 0;
+		event = __atomic_load_n(&ring->ec.event, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&ring->stop, __ATOMIC_ACQUIRE) != 0) {
+			retval = 1;
+			break;
 		}
-		/* start of the first critical section */
-		pthread_mutex_lock(&sd->mx);
-		/*
-		 * the block, which we are going to refresh,
-		 * must not be already read but not yet completely processed
-		 */
-		while ((sd->tfsw->sw_block_flags[block_to_read] !=
-				BLOCK_STATUS_UNKNOWN) &&
-				(sd->reading_finished == 0)) {
-			/* if this condition is not met, we have to wait */
-			pthread_cond_wait(&sd->cv, &sd->mx);
+		if (ring->filled - __atomic_load_n(&ring->consumed,
+					__ATOMIC_ACQUIRE) < ring->depth) {
+			break;
 		}
-		/*
-		 * if some other thread has set this variable to nonzero,
-		 * we have to finish this thread immediately,
-		 * because some special situation might just have occurred
-		 */
-		if (sd->reading_finished != 0) {
-			/*
-			 * Signaling might not be necessary,
-			 * because the shared data has changed
-			 * in the main thread,
-			 * not in the reading thread.
-			 * FIXME: Remove the signaling?
-			 */
-			pthread_cond_signal(&sd->cv);
-			pthread_mutex_unlock(&sd->mx);
-			fprintf(stderr, "The main thread has requested\n"
-					"that the reading thread "
-					"stops immediately!\n");
-			return ((void *)(1));
+		if (wait_start == 0) {
+			wait_start = monotonic_clock_ns();
+			++ring->producer_counters.waits;
+		}
+		event_counter_pause(&spins, event,
+				&ring->producer_counters, &ring->ec);
+	}
+	if (wait_start != 0) {
+		ring->producer_counters.wait_time +=
+			monotonic_clock_ns() - wait_start;
+	}
+	return (retval);
+}
+
+/**
+ * A function, which hands the most recently filled buffer
+ * over to the consuming thread.
+ *
+ * @param
+ * length	the number of valid bytes in the buffer
+ * @param
+ * source_length	the number of input bytes used to fill the buffer
+ * @param
+ * ring		the buffer ring
+ */
+void buffer_ring_publish (size_t length, size_t source_length,
+		buffer_ring *ring) {
+	size_t slot = ring->filled % ring->depth;
+	ring->lengths[slot] = length;
+	if (ring->source_lengths != NULL) {
+		ring->source_lengths[slot] = source_length;
+	}
+	/*
+	 * The release store publishes the content
+	 * of the buffer to the consuming thread.
+	 */
+	__atomic_store_n(&ring->filled, ring->filled + 1, __ATOMIC_RELEASE);
+	event_counter_notify(&ring->ec);
+}
+
+/**
+ * A function, which announces that no more buffers will be filled.
+ *
+ * @param
+ * status	READING_STATUS_COMPLETE if the input has been exhausted,
+ * 		READING_STATUS_STOPPED if an error has occurred
+ * @param
+ * error_number	the errno value describing the error, if any
+ * @param
+ * ring		the buffer ring
+ */
+void buffer_ring_finish (int status, int error_number, buffer_ring *ring) {
+	ring->error_number = error_number;
+	__atomic_store_n(&ring->status, status, __ATOMIC_RELEASE);
+	event_counter_notify(&ring->ec);
+}
+
+/**
+ * A function, which copies the bytes from the filled buffers
+ * of the ring. It waits only if there are no filled buffers at all.
+ * It is called by the thread consuming the ring.
+ *
+ * @param
+ * destination	the buffer to store the bytes to
+ * @param
+ * size		the maximum number of bytes to copy
+ * @param
+ * source_bytes	If not NULL, the number of input bytes used to fill
+ * 		each of the buffers, which have been completely consumed,
+ * 		will be added to (*source_bytes).
+ * @param
+ * ring		the buffer ring
+ *
+ * @return	The number of bytes copied. Zero means that no more bytes
+ * 		will be available. If the thread filling the ring
+ * 		has encountered an error, (-1) is returned and errno is set.
+ */
+ssize_t buffer_ring_fetch (char *destination, size_t size,
+		size_t *source_bytes, buffer_ring *ring) {
+	unsigned long long wait_start = 0;
+	size_t spins = 0;
+	size_t filled = 0;
+	size_t slot = 0;
+	size_t chunk = 0;
+	size_t copied = 0;
+	int status = 0;
+	int event = 0;
+	/* we wait until at least one buffer has been filled */
+	while (1) {
+		event = __atomic_load_n(&ring->ec.event, __ATOMIC_SEQ_CST);
+		filled = __atomic_load_n(&ring->filled, __ATOMIC_ACQUIRE);
+		if (filled != ring->consumed) {
+			break;
+		}
+		status = __atomic_load_n(&ring->status, __ATOMIC_ACQUIRE);
+		if (status != READING_STATUS_IN_PROGRESS) {
+			/*
+			 * The status is raised only after the final buffer
+			 * has been published. So, we have to check
+			 * once more whether it has been consumed.
+			 */
+			if (__atomic_load_n(&ring->filled,
+						__ATOMIC_ACQUIRE) !=
+					ring->consumed) {
+				continue;
+			}
+			if (wait_start != 0) {
+				ring->consumer_counters.wait_time +=
+					monotonic_clock_ns() - wait_start;
+			}
+			if (status == READING_STATUS_COMPLETE) {
+				return (0);
+			}
+			errno = ring->error_number;
+			return (-1);
+		}
+		if (wait_start == 0) {
+			wait_start = monotonic_clock_ns();
+			++ring->consumer_counters.waits;
+		}
+		event_counter_pause(&spins, event,
+				&ring->consumer_counters, &ring->ec);
+	}
+	if (wait_start != 0) {
+		ring->consumer_counters.wait_time +=
+			monotonic_clock_ns() - wait_start;
+	}
+	/* we copy the bytes from as many filled buffers as possible */
+	while ((copied < size) && (ring->consumed != filled)) {
+		slot = ring->consumed % ring->depth;
+		chunk = ring->lengths[slot] - ring->offset;
+		if (chunk > size - copied) {
+			chunk = size - copied;
+		}
+		memcpy(destination + copied,
+				ring->buffers[slot] + ring->offset, chunk);
+		copied += chunk;
+		ring->offset += chunk;
+		/* if the whole buffer has been consumed */
+		if (ring->offset == ring->lengths[slot]) {
+			ring->offset = 0;
+			if ((source_bytes != NULL) &&
+					(ring->source_lengths != NULL)) {
+				(*source_bytes) += ring->source_lengths[slot];
+			}
+			/* we hand the buffer back to the filling thread */
+			__atomic_store_n(&ring->consumed, ring->consumed + 1,
+					__ATOMIC_RELEASE);
+			event_counter_notify(&ring->ec);
+		}
+	}
+	return ((ssize_t)(copied));
+}
+
+/**
+ * A function, which initializes the shared data.
+ *
+ * @param
+ * tfsw		the sliding window
+ * @param
+ * sd		the shared data to be initialized
+ */
+void sd_init (text_file_sliding_window *tfsw, shared_data *sd) {
+	sd->tfsw = tfsw;
+	sd->reading_finished = READING_STATUS_IN_PROGRESS;
+	sd->ec.event = 0;
+	sd->ec.sleepers = 0;
+	sd->final_block_characters = 0;
+	sd->final_block_number = 0;
+	sd->reader_counters.waits = 0;
+	sd->reader_counters.sleeps = 0;
+	sd->reader_counters.wait_time = 0;
+	sd->main_counters = sd->reader_counters;
+}
+
+/**
+ * A function, which returns the current reading status.
+ * If it is READING_STATUS_COMPLETE, the information
+ * about the final block is guaranteed to be visible
+ * to the calling thread.
+ *
+ * @param
+ * sd		the shared data
+ *
+ * @return	one of the READING_STATUS_* constants
+ */
+int sd_reading_finished (shared_data *sd) {
+	return (__atomic_load_n(&sd->reading_finished, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * A function, which sets the reading status
+ * and wakes up the other thread, if it is sleeping.
+ * If the status is READING_STATUS_COMPLETE, the information
+ * about the final block has to be set in advance.
+ *
+ * @param
+ * status	the new reading status
+ * @param
+ * sd		the shared data
+ */
+void sd_set_reading_finished (int status, shared_data *sd) {
+	__atomic_store_n(&sd->reading_finished, status, __ATOMIC_RELEASE);
+	event_counter_notify(&sd->ec);
+}
+
+/**
+ * A function, which sets the status of a single block
+ * in the sliding window and wakes up the other thread,
+ * if it is sleeping.
+ * All the modifications of the block contents made before this call
+ * become visible to the thread, which observes the new status.
+ *
+ * @param
+ * block	the number of the block
+ * @param
+ * status	the new status of the block
+ * @param
+ * sd		the shared data
+ */
+void sd_set_block_status (size_t block, int status, shared_data *sd) {
+	__atomic_store_n(&sd->tfsw->sw_block_flags[block], status,
+			__ATOMIC_RELEASE);
+	event_counter_notify(&sd->ec);
+}
+
+/**
+ * A function, which checks whether the provided block
+ * is ready for the requested operation.
+ *
+ * @param
+ * block	the number of the block
+ * @param
+ * reading	If nonzero, the block is checked from the point of view
+ * 		of the reading thread. Otherwise, it is checked
+ * 		from the point of view of the main thread.
+ * @param
+ * sd		the shared data
+ *
+ * @return	If the block is ready, this function returns zero.
+ * 		If it is not ready yet, one is returned.
+ * 		If it will never become ready, two is returned.
+ */
+int sd_check_block (size_t block, int reading, shared_data *sd) {
+	int status = 0;
+	int reading_status = 0;
+	if (reading != 0) {
+		/*
+		 * The request of the main thread to stop
+		 * takes precedence over the block status.
+		 */
+		if (sd_reading_finished(sd) != READING_STATUS_IN_PROGRESS) {
+			return (2);
+		}
+		status = __atomic_load_n(&sd->tfsw->sw_block_flags[block],
+				__ATOMIC_ACQUIRE);
+		if (status == BLOCK_STATUS_UNKNOWN) {
+			return (0);
+		}
+		return (1);
+	}
+	status = __atomic_load_n(&sd->tfsw->sw_block_flags[block],
+			__ATOMIC_ACQUIRE);
+	if (status == BLOCK_STATUS_READ_AND_UNPROCESSED) {
+		return (0);
+	}
+	reading_status = sd_reading_finished(sd);
+	if (reading_status == READING_STATUS_IN_PROGRESS) {
+		return (1);
+	}
+	/*
+	 * The reading thread raises the reading status
+	 * just before it sets the flag of the final block.
+	 * So, if the final block is the one we are waiting for,
+	 * it will become ready very soon.
+	 */
+	if (reading_status == READING_STATUS_COMPLETE &&
+			block == sd->final_block_number) {
+		return (1);
+	}
+	return (2);
+}
+
+/**
+ * A function, which waits until the provided block is ready
+ * for the requested operation. At first, it spins for a while,
+ * and just then it goes to sleep until the next block status change.
+ * The time spent waiting is added to the wait counters
+ * of the calling thread. A fiber yields to the other fibers
+ * of its scheduling thread first, even if the block is ready.
+ *
+ * @param
+ * block	the number of the block
+ * @param
+ * reading	If nonzero, we wait as the reading thread
+ * 		for the block to become available for reading.
+ * 		Otherwise, we wait as the main thread
+ * 		for the block to become ready to be processed.
+ * @param
+ * sd		the shared data
+ *
+ * @return	If the block is ready, this function returns zero.
+ * 		Otherwise, if it is clear that the block
+ * 		will never become ready, a positive value is returned.
+ */
+int sd_wait_for_block (size_t block, int reading, shared_data *sd) {
+	wait_counters *counters = NULL;
+	unsigned long long wait_start = 0;
+	size_t spins = 0;
+	int event = 0;
+	int retval = 0;
+	if (reading != 0) {
+		counters = &sd->reader_counters;
+	} else {
+		counters = &sd->main_counters;
+	}
+	if (stream_fiber_current() != NULL) {
+		/*
+		 * The other fibers get their turn after every block,
+		 * so the streams sharing a thread are interleaved.
+		 */
+		stream_fiber_yield();
+	}
+	while (1) {
+		/*
+		 * The counter has to be observed before the check,
+		 * so that any later block status change
+		 * prevents us from sleeping.
+		 */
+		event = __atomic_load_n(&sd->ec.event, __ATOMIC_SEQ_CST);
+		if ((retval = sd_check_block(block, reading, sd)) != 1) {
+			break;
+		}
+		if (wait_start == 0) {
+			wait_start = monotonic_clock_ns();
+			++counters->waits;
+		}
+		event_counter_pause(&spins, event, counters, &sd->ec);
+	}
+	if (wait_start != 0) {
+		/*
+		 * The wait time can be sampled by the other thread
+		 * while collecting the block metrics.
+		 */
+		__atomic_fetch_add(&counters->wait_time,
+				monotonic_clock_ns() - wait_start,
+				__ATOMIC_RELAXED);
+	}
+	return (retval);
+}
+
+/**
+ * A function, which returns the total time spent waiting
+ * for the block handoff by one of the threads so far.
+ * It can be safely called while the other thread is running.
+ *
+ * @param
+ * reading	nonzero for the reading thread, zero for the main thread
+ * @param
+ * sd		the data shared by the main thread and the reading thread
+ *
+ * @return	the total wait time of the selected thread in nanoseconds
+ */
+unsigned long long sd_wait_time (int reading, shared_data *sd) {
+	if (reading != 0) {
+		return (__atomic_load_n(&sd->reader_counters.wait_time,
+					__ATOMIC_RELAXED));
+	} else {
+		return (__atomic_load_n(&sd->main_counters.wait_time,
+					__ATOMIC_RELAXED));
+	}
+}
+
+/**
+ * A function, which prints the wait counters of both the threads.
+ * It should be called only after the reading thread has been joined.
+ *
+ * @param
+ * sd		the shared data
+ */
+void sd_print_wait_counters (const shared_data *sd) {
+	printf("Block handoff wait statistics:\n"
+			"reading thread: %zu waits, %zu sleeps, "
+			"%.3f ms waiting\n"
+			"main thread: %zu waits, %zu sleeps, "
+			"%.3f ms waiting\n",
+			sd->reader_counters.waits,
+			sd->reader_counters.sleeps,
+			(double)(sd->reader_counters.wait_time) / 1e6,
+			sd->main_counters.waits,
+			sd->main_counters.sleeps,
+			(double)(sd->main_counters.wait_time) / 1e6);
+}
+
+/**
+ * A function, which is executed by the auxiliary thread
+ * and which reads the input file and replaces the characters
+ * in the oldest blocks of the sliding window.
+ * This funtion reads one block at a time.
+ *
+ * @param
+ * arg		The void * type of the pointer to the shared_data struct,
+ * 		which holds all the data necessary for this thread's operation
+ * 		and for the synchronization with the main thread.
+ *
+ * @return	If the whole input file has been successfully read
+ * 		and all the parts of the sliding window have been
+ * 		successfully overwritten, this function returns NULL.
+ * 		Otherwise, if an error occurs,
+ * 		a positive error number type-cast to (void*) is returned.
+ */
+void *reading_thread_function (void *arg) {
+	/* an index of the currently read block */
+	size_t block_to_read = 0;
+	size_t blocks_read = 0;
+	size_t characters_read = 0;
+	size_t bytes_read = 0;
+	/* the return value from the function text_file_read_blocks */
+	int retval = 0;
+	shared_data *sd = arg;
+	while (1) {
+		block_to_read = sd->tfsw->sw_mrr_block + 1;
+		if (block_to_read == sd->tfsw->sw_blocks) {
+			block_to_read = 0;
+		}
+		/*
+		 * the block, which we are going to refresh,
+		 * must not be already read but not yet completely processed
+		 *
+		 * If the main thread has raised the reading_finished flag,
+		 * we have to finish this thread immediately,
+		 * because some special situation might just have occurred.
+		 */
+		if (sd_wait_for_block(block_to_read, 1, sd) != 0) {
+			fprintf(stderr, "The main thread has requested\n"
+					"that the reading thread "
+					"stops immediately!\n");
+			return ((void *)(1));
+		}
+		/*
+		 * From now on, the block has the correct flags set.
+		 * We know that no other thread can invalidate this condition.
+		 * This assumption is true,
+		 * because there is only one reading thread.
+		 */
+		if ((retval = text_file_read_blocks((size_t)(1),
+						&blocks_read,
+						&characters_read,
+						&bytes_read, sd->tfsw)) > 1) {
+			/*
+			 * we have to raise a flag indicating
+			 * that the reading has (unsuccessfully) finished
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED, sd);
+			fprintf(stderr, "reading_thread_function: "
+					"file reading error\n");
+			return ((void *)(2));
+		}
+		/* if there are no more unread bytes left in the input file */
+		if (retval == 1) {
+			sd->final_block_characters = characters_read;
+			sd->final_block_number = block_to_read;
+			/*
+			 * The information about the final block
+			 * is published by the release store
+			 * of the reading status. The main thread
+			 * keeps waiting for the final block
+			 * until its flag is set below.
+			 */
+			sd_set_reading_finished(READING_STATUS_COMPLETE, sd);
+			sd_set_block_status(block_to_read,
+					BLOCK_STATUS_READ_AND_UNPROCESSED, sd);
+			printf("The whole input file has been read.\n");
+			break;
+		} else { /* retval == 0 */
+			/*
+			 * The release store of the flag publishes
+			 * the newly read characters to the main thread.
+			 */
+			sd_set_block_status(block_to_read,
+					BLOCK_STATUS_READ_AND_UNPROCESSED, sd);
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * A function, which is executed by the auxiliary read-ahead thread
+ * and which keeps filling the free buffers in the read-ahead ring
+ * with the raw bytes from the input file.
+ * This is the first stage of the input pipeline.
+ *
+ * @param
+ * arg		The void * type of the pointer
+ * 		to the text_file_sliding_window struct,
+ * 		whose read-ahead ring should be filled.
+ *
+ * @return	If the whole input file has been successfully read,
+ * 		or if the thread has been requested to stop,
+ * 		this function returns NULL.
+ * 		Otherwise, if an error occurs,
+ * 		a positive error number type-cast to (void*) is returned.
+ */
+void *read_ahead_thread_function (void *arg) {
+	text_file_sliding_window *tfsw = arg;
+	buffer_ring *ra = tfsw->ra;
+	ssize_t bytes_read = 0;
+	while (buffer_ring_wait_for_free(ra) == 0) {
+		bytes_read = text_file_read_raw(
+				ra->buffers[ra->filled % ra->depth],
+				ra->buffer_size, ra, tfsw->fd);
+		if (bytes_read == (-1)) {
+			/*
+			 * the error will be reported
+			 * by the consuming thread
+			 */
+			buffer_ring_finish(READING_STATUS_STOPPED, errno, ra);
+			/* resetting the errno */
+			errno = 0;
+			return ((void *)(1));
+		} else if (bytes_read == 0) {
+			/* we have reached the end of the input file */
+			buffer_ring_finish(READING_STATUS_COMPLETE, 0, ra);
+			return (NULL);
+		}
+		buffer_ring_publish((size_t)(bytes_read),
+				(size_t)(bytes_read), ra);
+	}
+	return (NULL);
+}
+
+/**
+ * A function, which is executed by the auxiliary decode thread
+ * and which keeps filling the free buffers in the decode ring
+ * with the characters converted from the raw bytes of the input file.
+ * This is the second stage of the input pipeline. The third stage,
+ * which fills the sliding window, just copies the characters.
+ *
+ * @param
+ * arg		The void * type of the pointer
+ * 		to the text_file_sliding_window struct,
+ * 		whose decode ring should be filled.
+ *
+ * @return	If the whole input file has been successfully converted,
+ * 		or if the thread has been requested to stop,
+ * 		this function returns NULL.
+ * 		Otherwise, if an error occurs,
+ * 		a positive error number type-cast to (void*) is returned.
+ */
+void *decode_thread_function (void *arg) {
+	text_file_sliding_window *tfsw = arg;
+	buffer_ring *dr = tfsw->dr;
+	char *outbuf = NULL;
+	size_t outbytesleft = 0;
+	size_t characters_converted = 0;
+	size_t bytes_read = 0;
+	int retval = 0;
+	while (buffer_ring_wait_for_free(dr) == 0) {
+		outbuf = dr->buffers[dr->filled % dr->depth];
+		outbytesleft = dr->buffer_size;
+		if ((retval = text_file_convert(&outbuf, &outbytesleft,
+						&characters_converted,
+						&bytes_read, tfsw)) > 0) {
+			/*
+			 * the error has already been described
+			 * by the text_file_convert
+			 */
+			buffer_ring_finish(READING_STATUS_STOPPED, EIO, dr);
+			return ((void *)(1));
+		}
+		if (outbytesleft < dr->buffer_size) {
+			buffer_ring_publish(dr->buffer_size - outbytesleft,
+					bytes_read, dr);
+		}
+		/* if we have reached the end of the input file */
+		if (retval == (-1)) {
+			buffer_ring_finish(READING_STATUS_COMPLETE, 0, dr);
+			return (NULL);
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * A function which determines the begin of the currently valid part
+ * of the sliding window. The valid sliding window offsets are not only
+ * the ones inside the currently active part of the sliding window.
+ * The offsets which are at most max_ap_window_size before
+ * the ap_window_begin are valid as well.
+ *
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ *
+ * @return	this function returns the sliding window offset
+ * 		of the begin of the currently valid part
+ * 		of the sliding window
+ */
+size_t stsw_vp_window_begin (const text_file_sliding_window *tfsw) {
+	if (tfsw->ap_window_begin > tfsw->max_ap_window_size) {
+		return (tfsw->ap_window_begin - tfsw->max_ap_window_size);
+	} else {
+		return (tfsw->total_window_size + tfsw->ap_window_begin -
+				tfsw->max_ap_window_size);
+	}
+}
+
+/**
+ * A function which decides whether the provided new head position
+ * should replace the current head position of a branching node
+ * during the batch update of the edge labels.
+ * The decision is exactly the same as the one made
+ * by the serial path update. For the valid offsets, it orders them
+ * by their distance from the begin of the currently valid part
+ * of the sliding window, so the replacing behaves as an atomic maximum
+ * relative to the window origin.
+ *
+ * @param
+ * head_position	the current head position of the branching node
+ * @param
+ * new_head_position	the candidate for the new head position
+ * @param
+ * vp_window_begin	the begin of the currently valid part
+ * 			of the sliding window
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ *
+ * @return	If the new head position should replace the current one,
+ * 		this function returns 1. Otherwise, it returns 0.
+ */
+int stsw_is_newer_head_position (size_t head_position,
+		size_t new_head_position,
+		size_t vp_window_begin,
+		const text_file_sliding_window *tfsw) {
+	/*
+	 * Here, it is possible that vp_window_begin ==
+	 * tfsw->ap_window_end.
+	 */
+	if (vp_window_begin < tfsw->ap_window_end) {
+		return (head_position < new_head_position);
+	/* vp_window_begin >= tfsw->ap_window_end */
+	} else if (vp_window_begin <= head_position) {
+		return ((head_position < new_head_position) ||
+				(new_head_position < tfsw->ap_window_end));
+	/* vp_window_begin > head_position */
+	} else if (new_head_position < tfsw->ap_window_end) {
+		return (head_position < new_head_position);
+	} else {
+		return (0);
+	}
+}
+
+/**
+ * A function which performs the batch update of the edge labels
+ * using several worker threads. The circular range of the leaves
+ * is split into the contiguous parts of almost the same size
+ * and each of them is processed by a single worker thread.
+ *
+ * @param
+ * worker_function	the function to be executed by each worker.
+ * 			Its argument is a pointer to the batch_update_task.
+ * @param
+ * first_leaf	the number of the first leaf to be processed
+ * @param
+ * leaves	the total number of the leaves to be processed
+ * @param
+ * tleaf_size	the size of the table of the leaves
+ * @param
+ * tbranch_size	the size of the table of the branching nodes
+ * @param
+ * stsw		the actual suffix tree
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ *
+ * @return	If all the workers have finished successfully,
+ * 		this function returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int batch_update_run (void *(*worker_function)(void *),
+		size_t first_leaf,
+		size_t leaves,
+		size_t tleaf_size,
+		size_t tbranch_size,
+		void *stsw,
+		const text_file_sliding_window *tfsw) {
+	size_t workers = tfsw->bu_workers;
+	size_t started = 0;
+	size_t leaves_assigned = 0;
+	size_t i = 0;
+	size_t vp_window_begin = stsw_vp_window_begin(tfsw);
+	unsigned char *visited = NULL;
+	pthread_t *threads = NULL;
+	batch_update_task *tasks = NULL;
+	int retval = 0;
+	int error = 0;
+	if (leaves < workers) {
+		workers = leaves;
+	}
+	if (workers == 0) {
+		return (0);
+	}
+	visited = calloc(tbranch_size, sizeof (unsigned char));
+	threads = calloc(workers, sizeof (pthread_t));
+	tasks = calloc(workers, sizeof (batch_update_task));
+	if ((visited == NULL) || (threads == NULL) || (tasks == NULL)) {
+		perror("batch_update_run: calloc");
+		/* resetting the errno */
+		errno = 0;
+		free(visited);
+		free(threads);
+		free(tasks);
+		return (1);
+	}
+	for (i = 0; i < workers; ++i) {
+		tasks[i].tfsw = tfsw;
+		tasks[i].stsw = stsw;
+		tasks[i].first_leaf = (first_leaf - 1 + leaves_assigned) %
+			tleaf_size + 1;
+		tasks[i].leaves = leaves / workers +
+			(i < leaves % workers ? 1 : 0);
+		tasks[i].first_sw_offset = (unsigned_integral_type)
+			((tfsw->ap_window_begin - 1 + leaves_assigned) %
+			 tfsw->total_window_size + 1);
+		tasks[i].vp_window_begin = vp_window_begin;
+		tasks[i].visited = visited;
+		tasks[i].retval = 0;
+		leaves_assigned += tasks[i].leaves;
+		if ((retval = pthread_create(&threads[i], NULL,
+					worker_function, &tasks[i])) != 0) {
+			fprintf(stderr, "batch_update_run:\n");
+			errno = retval; /* retval != 0 */
+			perror("pthread_create");
+			/* resetting the errno */
+			errno = 0;
+			error = 2;
+			break;
+		}
+		++started;
+	}
+	for (i = 0; i < started; ++i) {
+		if ((retval = pthread_join(threads[i], NULL)) != 0) {
+			fprintf(stderr, "batch_update_run:\n");
+			errno = retval; /* retval != 0 */
+			perror("pthread_join");
+			/* resetting the errno */
+			errno = 0;
+			error = 3;
+		} else if ((tasks[i].retval > 0) && (error == 0)) {
+			fprintf(stderr, "batch_update_run: The worker %zu "
+					"has failed!\n", i);
+			error = 4;
+		}
+	}
+	free(visited);
+	free(threads);
+	free(tasks);
+	return (error);
+}
+#endif
+
+/**
+ * A function which determines the sliding window offset of the first character
+ * of the suffix corresponding to the the leaf with the provided number.
+ * Important:
+ * It is not advisable to call this function, unless the suffix tree itself
+ * is not available. There are suffix-tree-implementation-aware versions
+ * of this function, which are slightly faster.
+ *
+ * @param
+ * child	the number of child which corresponds to the suffix,
+ * 		for which we would like to determine the offset
+ * 		of its first character in the sliding window
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ *
+ * @return	this function returns the determined sliding window offset
+ * 		of the first character of the suffix corresponding
+ * 		to the provided child
+ */
+size_t stsw_get_leafs_sw_offset (signed_integral_type child,
+		const text_file_sliding_window *tfsw) {
+	size_t ap_window_begin_sw_block = (tfsw->ap_window_begin - 1) /
+		tfsw->sw_block_size;
+	size_t ap_window_begin_sw_block_offset = (tfsw->ap_window_begin - 1) %
+		tfsw->sw_block_size;
+	size_t ap_window_end_sw_block = (tfsw->ap_window_end - 1) /
+		tfsw->sw_block_size;
+	size_t ap_window_end_sw_block_offset = (tfsw->ap_window_end - 1) %
+		tfsw->sw_block_size;
+	size_t ap_window_begin_ap_block = 0;
+	size_t childs_number = (size_t)(-child);
+	size_t childs_ap_block = (childs_number - 1) / tfsw->sw_block_size;
+	size_t childs_ap_block_offset = (childs_number - 1) %
+		tfsw->sw_block_size;
+	size_t childs_sw_block = 0;
+	size_t childs_sw_offset = 0;
+	size_t sw_read_loops = (tfsw->blocks_read - 1) / tfsw->sw_blocks;
+	if (ap_window_end_sw_block_offset == 0) {
+		if (ap_window_end_sw_block == 0) {
+			ap_window_end_sw_block = tfsw->sw_blocks - 1;
+		} else {
+			--ap_window_end_sw_block;
+		}
+	}
+	if (tfsw->sw_mrr_block < ap_window_end_sw_block) {
+		--sw_read_loops;
+	} else if (ap_window_end_sw_block < ap_window_begin_sw_block) {
+		--sw_read_loops;
+	}
+	ap_window_begin_ap_block = (sw_read_loops * tfsw->sw_blocks +
+			ap_window_begin_sw_block) % tfsw->ap_scale_factor;
+	if (childs_ap_block < ap_window_begin_ap_block) {
+		childs_ap_block += tfsw->ap_scale_factor;
+	} else if (childs_ap_block == ap_window_begin_ap_block) {
+		if (childs_ap_block_offset < ap_window_begin_sw_block_offset) {
+			childs_ap_block += tfsw->ap_scale_factor;
+		}
+	}
+	childs_sw_block = (ap_window_begin_sw_block + childs_ap_block -
+		ap_window_begin_ap_block) % tfsw->sw_blocks;
+	childs_sw_offset = childs_sw_block * tfsw->sw_block_size +
+		childs_ap_block_offset + 1;
+	return (childs_sw_offset);
+}
+
+/**
+ * a function which determines the depth order of a leaf, which corresponds
+ * to the suffix beginning at the provided position in the sliding window.
+ * the depth order of a leaf is its depth relative to
+ * the maximum possible depth in the current suffix tree, starting from zero.
+ * the leaf with the depth order of zero has the maximum possible depth
+ * of a suffix in the current suffix tree.
+ *
+ * @param
+ * sw_offset	the position in the sliding window of the first character
+ * 		of the suffix, which corresponds to the leaf,
+ * 		which depth order we would like to determine.
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ *
+ * @return	this function returns the determined depth order of a leaf,
+ * 		which corresponds to the suffix beginning at the provided
+ * 		position in the sliding window
+ */
+size_t stsw_get_leafs_depth_order (size_t sw_offset,
+		const text_file_sliding_window *tfsw) {
+	size_t depth_order = 0;
+	if (tfsw->ap_window_begin <= sw_offset) {
+		depth_order = sw_offset - tfsw->ap_window_begin;
+	} else { /* tfsw->ap_window_begin > sw_offset */
+		depth_order = tfsw->total_window_size + sw_offset -
+			tfsw->ap_window_begin;
+	}
+	return (depth_order);
+}
+
+/**
+ * A function which checks whether the provided offset in the sliding window
+ * is or has recently been within the currently active part
+ * of the sliding window and therefore is valid.
+ *
+ * @param
+ * sw_offset	the position in the sliding window, which should be validated
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ *
+ * @return	If the provided sliding window offset is valid,
+ * 		this function returns zero.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stsw_validate_sw_offset (size_t sw_offset,
+		const text_file_sliding_window *tfsw) {
+	/* the begin of the currently valid part of the sliding window */
+	size_t vp_window_begin = tfsw->ap_window_begin;
+	/*
+	 * Here, we need to identify the edge label maintenance method,
+	 * which is currently in use. This method determines
+	 * the range of the valid sliding window offsets.
+	 */
+	if (tfsw->elm_method == 1) { /* batch update by M. Senft */
+		/*
+		 * When using this edge label maintenance method,
+		 * the valid sliding window offsets are not only
+		 * the ones inside the currently active part
+		 * of the sliding window. The offsets
+		 * which are at most max_ap_window_size before
+		 * the ap_window_begin are valid as well.
+		 */
+		if (vp_window_begin > tfsw->max_ap_window_size) {
+			vp_window_begin -= tfsw->max_ap_window_size;
+		} else {
+			vp_window_begin = tfsw->total_window_size +
+				tfsw->ap_window_begin -
+				tfsw->max_ap_window_size;
+		}
+		/*
+		 * Here, it is possible that vp_window_begin ==
+		 * tfsw->ap_window_end. In this case, all the offsets
+		 * in the sliding window are valid
+		 */
+		if (vp_window_begin == tfsw->ap_window_end) {
+			return (0);
+		}
+	}
+	/*
+	 * we now know that vp_window_begin !=
+	 * tfsw->ap_window_end
+	 */
+	if (vp_window_begin < tfsw->ap_window_end) {
+		if ((sw_offset < vp_window_begin) ||
+				(tfsw->ap_window_end <= sw_offset)) {
+			fprintf(stderr, "stsw_validate_sw_offset:\n"
+					"The offset %zu is not within "
+					"the currently valid "
+					"part\nof the sliding "
+					"window [%zu, %zu).\n",
+					sw_offset,
+					vp_window_begin,
+					tfsw->ap_window_end);
+			return (1);
+		}
+	} else { /* vp_window_begin > tfsw->ap_window_end */
+		if ((sw_offset < vp_window_begin) &&
+				(tfsw->ap_window_end <= sw_offset)) {
+			fprintf(stderr, "stsw_validate_sw_offset:\n"
+					"The offset %zu is not within "
+					"the currently valid "
+					"part\nof the sliding "
+					"window [%zu, %zu).\n",
+					sw_offset,
+					vp_window_begin,
+					tfsw->ap_window_end);
+			return (2);
+		}
+	}
+	return (0);
+}
+
+/* LZ77 factorization functions */
+
+/**
+ * A function which initializes the state of the greedy LZ77 factorization.
+ *
+ * @param
+ * stream	the stream to which the factors will be written,
+ * 		or NULL if the factors should only be counted
+ * @param
+ * lz		the factorization state, which will be initialized
+ */
+void lz77_init (FILE *stream, lz77_factorization *lz) {
+	lz->stream = stream;
+	lz->pending = 0;
+	lz->factors = 0;
+	lz->literals = 0;
+	lz->matched_characters = 0;
+	lz->longest_match = 0;
+	lz->start_time = monotonic_clock_ns();
+}
+
+/**
+ * A function which records a single LZ77 factor and writes it
+ * to the factorization stream, if there is any.
+ * Each factor is written on a separate line as three decimal numbers:
+ * the distance to the source of the match, the length of the match
+ * and the code of the literal character, which follows the match.
+ * The distance is zero if and only if the length is zero.
+ *
+ * @param
+ * offset	the distance in characters from the source of the match
+ * 		to the first character of the factor
+ * @param
+ * length	the length of the match
+ * @param
+ * literal	the character, which follows the match
+ * @param
+ * lz		the factorization state
+ *
+ * @return	If the factor has been successfully recorded, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int lz77_emit_factor (size_t offset,
+		size_t length,
+		character_type literal,
+		lz77_factorization *lz) {
+	++lz->factors;
+	if (length == 0) {
+		++lz->literals;
+	} else {
+		lz->matched_characters += length;
+		if (length > lz->longest_match) {
+			lz->longest_match = length;
+		}
+	}
+	if (lz->stream == NULL) {
+		return (0);
+	}
+#ifdef	SUFFIX_TREE_TEXT_WIDE_CHAR
+	if (fprintf(lz->stream, "%zu %zu %lu\n", offset, length,
+				(unsigned long)(literal)) < 0) {
+#else
+	if (fprintf(lz->stream, "%zu %zu %lu\n", offset, length,
+				(unsigned long)((unsigned char)
+					(literal))) < 0) {
+#endif
+		perror("lz77_emit_factor: fprintf");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	return (0);
+}
+
+/**
+ * A function which prints the statistics
+ * of the finished greedy LZ77 factorization.
+ * The elapsed time includes the maintenance of the suffix tree,
+ * because the suffix tree is the match finder of the factorization.
+ *
+ * @param
+ * tfsw		the sliding window, which has been factorized
+ * @param
+ * lz		the factorization state
+ *
+ * @return	this function always returns zero (0)
+ */
+int lz77_print_stats (const text_file_sliding_window *tfsw,
+		const lz77_factorization *lz) {
+	unsigned long long elapsed = monotonic_clock_ns() - lz->start_time;
+	double seconds = (double)(elapsed) / 1e9;
+	printf("\nLZ77 factorization statistics:\n"
+			"------------------------------\n");
+	printf("Characters factorized: %zu\n", tfsw->characters_read);
+	printf("Factors emitted: %zu (%zu of them without a match)\n",
+			lz->factors, lz->literals);
+	if (lz->factors > 0) {
+		printf("Average factor length: %.3f characters\n",
+				(double)(tfsw->characters_read) /
+				(double)(lz->factors));
+	}
+	printf("Characters covered by the matches: %zu\n",
+			lz->matched_characters);
+	printf("The longest match: %zu characters\n", lz->longest_match);
+	printf("Factorization time: ");
+	/* nanoseconds to milliseconds */
+	print_human_readable_time(stdout, (size_t)(elapsed / 1000000));
+	printf("\n");
+	if (seconds > 0) {
+		printf("Factors per second: %.0f\n",
+				(double)(lz->factors) / seconds);
+		printf("Input throughput: %.3f MB/s\n",
+				(double)(tfsw->bytes_read) / 1e6 / seconds);
+	}
+	return (0);
+}
+
+/* block metrics functions */
+
+/**
+ * A function which initializes the collection of the block metrics
+ * and writes the header of the metrics table, if the format requires it.
+ * The wall time of all the subsequently recorded blocks
+ * is measured from the moment of this call.
+ *
+ * @param
+ * stream	the stream to which the metrics will be written,
+ * 		or NULL if no metrics should be collected
+ * @param
+ * format	the format of the metrics,
+ * 		one of the METRICS_FORMAT_* constants
+ * @param
+ * bm		the block metrics state, which will be initialized
+ *
+ * @return	If the initialization is successful, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int block_metrics_init (FILE *stream, int format, block_metrics *bm) {
+	bm->stream = stream;
+	bm->format = format;
+	bm->blocks = 0;
+	bm->characters = 0;
+	bm->start_time = monotonic_clock_ns();
+	bm->last_time = bm->start_time;
+	if ((stream != NULL) && (format == METRICS_FORMAT_CSV)) {
+		if (fprintf(stream, "block,wall_time,characters,"
+					"characters_per_second,edges,"
+					"branching_nodes,tedge_size,"
+					"tbranch_size,tbdeleted_records,"
+					"reader_wait_time,"
+					"main_wait_time\n") < 0) {
+			perror("block_metrics_init: fprintf");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which writes the metrics of the block,
+ * which has just been processed, as a single line.
+ * If no metrics stream has been set, the block is only counted.
+ * All the times are written in seconds.
+ *
+ * @param
+ * characters	the number of characters in the processed block
+ * @param
+ * edges	the current number of edges (zero if not available)
+ * @param
+ * branching_nodes	the current number of branching nodes
+ * @param
+ * tedge_size	the current size of the table tedge
+ * 		(zero if not available)
+ * @param
+ * tbranch_size	the current size of the table tbranch
+ * @param
+ * tbdeleted_records	the current number of the vacant records
+ * 			in the table tbranch
+ * @param
+ * reader_wait_time	the total wait time of the reading thread
+ * 			so far, in nanoseconds
+ * @param
+ * main_wait_time	the total wait time of the main thread
+ * 			so far, in nanoseconds
+ * @param
+ * bm		the block metrics state
+ *
+ * @return	If the metrics have been successfully written,
+ * 		or if they are not collected at all, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int block_metrics_record (size_t characters,
+		size_t edges,
+		size_t branching_nodes,
+		size_t tedge_size,
+		size_t tbranch_size,
+		size_t tbdeleted_records,
+		unsigned long long reader_wait_time,
+		unsigned long long main_wait_time,
+		block_metrics *bm) {
+	unsigned long long now = 0;
+	/* the characters per second in the recorded block */
+	double rate = 0;
+	const char *format = NULL;
+	if (bm->stream == NULL) {
+		bm->characters += characters;
+		++bm->blocks;
+		return (0);
+	}
+	now = monotonic_clock_ns();
+	if (now > bm->last_time) {
+		rate = (double)(characters) * 1e9 /
+			(double)(now - bm->last_time);
+	}
+	bm->last_time = now;
+	bm->characters += characters;
+	if (bm->format == METRICS_FORMAT_JSON) {
+		format = "{\"block\":%zu,\"wall_time\":%.6f,"
+			"\"characters\":%zu,\"characters_per_second\":%.0f,"
+			"\"edges\":%zu,\"branching_nodes\":%zu,"
+			"\"tedge_size\":%zu,\"tbranch_size\":%zu,"
+			"\"tbdeleted_records\":%zu,"
+			"\"reader_wait_time\":%.6f,"
+			"\"main_wait_time\":%.6f}\n";
+	} else {
+		format = "%zu,%.6f,%zu,%.0f,%zu,%zu,%zu,%zu,%zu,%.6f,%.6f\n";
+	}
+	if (fprintf(bm->stream, format, bm->blocks,
+				(double)(now - bm->start_time) / 1e9,
+				bm->characters, rate, edges, branching_nodes,
+				tedge_size, tbranch_size, tbdeleted_records,
+				(double)(reader_wait_time) / 1e9,
+				(double)(main_wait_time) / 1e9) < 0) {
+		perror("block_metrics_record: fprintf");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	++bm->blocks;
+	return (0);
+}
+
+/* multi-stream functions */
+
+#ifdef	STSW_USE_PTHREAD
+/**
+ * A function, which returns the fiber running in the calling thread.
+ *
+ * @return	If the calling thread is a scheduling thread
+ * 		of the multi-stream mode and it is currently running a fiber,
+ * 		this function returns the fiber.
+ * 		Otherwise, NULL is returned.
+ */
+stream_fiber *stream_fiber_current (void) {
+	if (running_scheduler == NULL) {
+		return (NULL);
+	}
+	return (running_scheduler->current);
+}
+
+/**
+ * A function, which wakes up the provided scheduling thread,
+ * if it is sleeping in the poll or if it is about to.
+ *
+ * @param
+ * scheduler	the scheduling thread
+ */
+void stream_scheduler_wake (stream_scheduler *scheduler) {
+	char byte = 0;
+	if (__atomic_exchange_n(&scheduler->sleeping, 0,
+				__ATOMIC_SEQ_CST) != 0) {
+		/*
+		 * If the pipe is full, the thread
+		 * will be woken up anyway.
+		 */
+		if (write(scheduler->wake_pipe[1], &byte, 1) == -1) {
+			/* resetting the errno */
+			errno = 0;
+		}
+	}
+}
+
+/**
+ * A function, which wakes up all the sleeping scheduling threads
+ * of the provided fiber pool.
+ *
+ * @param
+ * pool		the fiber pool
+ */
+void stream_fiber_pool_wake (stream_fiber_pool *pool) {
+	size_t i = 0;
+	for (i = 0; i < pool->workers + pool->io_threads; ++i) {
+		stream_scheduler_wake(&pool->schedulers[i]);
+	}
+}
+
+/**
+ * A function, which suspends the provided fiber
+ * and switches back to the scheduling loop of its thread.
+ * The fiber is resumed in its current state.
+ *
+ * @param
+ * fiber	the currently running fiber
+ */
+void stream_fiber_suspend (stream_fiber *fiber) {
+	if (swapcontext(&fiber->context, &fiber->scheduler->context) == -1) {
+		perror("stream_fiber_suspend: swapcontext");
+		/* resetting the errno */
+		errno = 0;
+	}
+}
+
+/**
+ * A function, which lets the other fibers of the scheduling thread run,
+ * before the currently running fiber continues.
+ */
+void stream_fiber_yield (void) {
+	stream_fiber *fiber = stream_fiber_current();
+	fiber->state = FIBER_STATE_READY;
+	stream_fiber_suspend(fiber);
+}
+
+/**
+ * A function, which suspends the currently running fiber
+ * until the event counter differs from the provided value.
+ *
+ * @param
+ * observed	the value of the event counter,
+ * 		which has been observed before the condition check
+ * @param
+ * ec		the event counter
+ */
+void stream_fiber_wait_event (int observed, event_counter *ec) {
+	stream_fiber *fiber = stream_fiber_current();
+	fiber->wait_ec = ec;
+	fiber->wait_observed = observed;
+	fiber->state = FIBER_STATE_WAITING_EVENT;
+	stream_fiber_suspend(fiber);
+}
+
+/**
+ * A function, which suspends the currently running fiber
+ * until the provided file descriptor is readable,
+ * or until the end of the input has been reached.
+ *
+ * @param
+ * fd		the file descriptor
+ */
+void stream_fiber_wait_input (int fd) {
+	stream_fiber *fiber = stream_fiber_current();
+	fiber->wait_fd = fd;
+	fiber->wait_fd_ready = 0;
+	fiber->state = FIBER_STATE_WAITING_INPUT;
+	stream_fiber_suspend(fiber);
+}
+
+/**
+ * A function, which is the entry point of every fiber.
+ * It runs the function of the fiber and then it switches back
+ * to the scheduling loop for the last time.
+ */
+void stream_fiber_entry (void) {
+	stream_fiber *fiber = stream_fiber_current();
+	fiber->retval = fiber->function(fiber->arg);
+	fiber->state = FIBER_STATE_FINISHED;
+	stream_fiber_suspend(fiber);
+}
+
+/**
+ * A function, which prepares the context of the provided fiber,
+ * so that it starts in the entry point on its own stack.
+ *
+ * @param
+ * guard_size	the size of the guard page at the bottom of the stack
+ * @param
+ * fiber	the fiber with an already allocated stack
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stream_fiber_make_context (size_t guard_size, stream_fiber *fiber) {
+	if (getcontext(&fiber->context) == -1) {
+		return (1);
+	}
+	fiber->context.uc_stack.ss_sp = (char *)(fiber->stack) + guard_size;
+	fiber->context.uc_stack.ss_size = fiber_stack_size;
+	fiber->context.uc_link = NULL;
+	makecontext(&fiber->context, stream_fiber_entry, 0);
+	return (0);
+}
+
+/**
+ * A function, which creates a new fiber and hands it over
+ * to the provided scheduling thread.
+ *
+ * @param
+ * function	the function to be executed by the fiber
+ * @param
+ * arg		the argument of the function
+ * @param
+ * scheduler	the scheduling thread, which will run the fiber
+ *
+ * @return	If this function call is successful, it returns
+ * 		the new fiber. Otherwise, NULL is returned.
+ */
+stream_fiber *stream_fiber_create (void *(*function)(void *),
+		void *arg,
+		stream_scheduler *scheduler) {
+	stream_fiber *fiber = calloc(1, sizeof (stream_fiber));
+	size_t guard_size = (size_t)(sysconf(_SC_PAGESIZE));
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	if (fiber == NULL) {
+		perror("stream_fiber_create: calloc");
+		/* resetting the errno */
+		errno = 0;
+		return (NULL);
+	}
+#ifdef	MAP_NORESERVE
+	flags |= MAP_NORESERVE;
+#endif
+	fiber->stack_size = fiber_stack_size + guard_size;
+	fiber->stack = mmap(NULL, fiber->stack_size, PROT_READ | PROT_WRITE,
+			flags, -1, 0);
+	if (fiber->stack == MAP_FAILED) {
+		perror("stream_fiber_create: mmap");
+		/* resetting the errno */
+		errno = 0;
+		free(fiber);
+		return (NULL);
+	}
+	/* the stack grows down, so the guard page is at its lowest end */
+	if ((mprotect(fiber->stack, guard_size, PROT_NONE) == -1) ||
+			(stream_fiber_make_context(guard_size, fiber) > 0)) {
+		perror("stream_fiber_create: mprotect or getcontext");
+		/* resetting the errno */
+		errno = 0;
+		munmap(fiber->stack, fiber->stack_size);
+		free(fiber);
+		return (NULL);
+	}
+	fiber->function = function;
+	fiber->arg = arg;
+	fiber->scheduler = scheduler;
+	fiber->state = FIBER_STATE_READY;
+	__atomic_add_fetch(&scheduler->load, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_lock(&scheduler->mutex);
+	fiber->next = scheduler->incoming;
+	scheduler->incoming = fiber;
+	pthread_mutex_unlock(&scheduler->mutex);
+	stream_scheduler_wake(scheduler);
+	return (fiber);
+}
+
+/**
+ * A function, which waits until the provided fiber has finished
+ * and then it deallocates it. It can be called both from a fiber
+ * and from an ordinary thread.
+ *
+ * @param
+ * fiber	the fiber to be joined
+ *
+ * @return	This function returns the return value
+ * 		of the function of the fiber.
+ */
+void *stream_fiber_join (stream_fiber *fiber) {
+	event_counter *ec = &fiber->scheduler->pool->finished_ec;
+	void *retval = NULL;
+	int event = 0;
+	while (1) {
+		event = __atomic_load_n(&ec->event, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&fiber->finished, __ATOMIC_ACQUIRE) != 0) {
+			break;
+		}
+		event_counter_sleep(event, ec);
+	}
+	retval = fiber->retval;
+	free(fiber);
+	return (retval);
+}
+
+/**
+ * A function, which determines whether the provided fiber
+ * can be resumed right away.
+ *
+ * @param
+ * fiber	the fiber
+ *
+ * @return	If the fiber can be resumed, this function returns 1.
+ * 		Otherwise, 0 is returned.
+ */
+int stream_fiber_runnable (const stream_fiber *fiber) {
+	if (fiber->state == FIBER_STATE_READY) {
+		return (1);
+	} else if (fiber->state == FIBER_STATE_WAITING_EVENT) {
+		return (__atomic_load_n(&fiber->wait_ec->event,
+					__ATOMIC_SEQ_CST) !=
+				fiber->wait_observed);
+	} else if (fiber->state == FIBER_STATE_WAITING_INPUT) {
+		return (fiber->wait_fd_ready);
+	}
+	return (0);
+}
+
+/**
+ * A function, which determines whether the provided scheduling thread
+ * has anything to do, apart from waiting for the input.
+ *
+ * @param
+ * scheduler	the scheduling thread
+ *
+ * @return	If there is a new or a runnable fiber, or if the thread
+ * 		should finish, this function returns 1.
+ * 		Otherwise, 0 is returned.
+ */
+int stream_scheduler_has_work (stream_scheduler *scheduler) {
+	const stream_fiber *fiber = NULL;
+	int retval = 0;
+	if (__atomic_load_n(&scheduler->pool->shutdown,
+				__ATOMIC_SEQ_CST) != 0) {
+		return (1);
+	}
+	pthread_mutex_lock(&scheduler->mutex);
+	retval = (scheduler->incoming != NULL);
+	pthread_mutex_unlock(&scheduler->mutex);
+	for (fiber = scheduler->first; (fiber != NULL) && (retval == 0);
+			fiber = fiber->next) {
+		retval = stream_fiber_runnable(fiber);
+	}
+	return (retval);
+}
+
+/**
+ * A function, which polls the file descriptors of the fibers
+ * waiting for the input and marks the readable ones.
+ * The wake-up pipe of the scheduling thread is polled as well
+ * and it is drained, if anything has been written to it.
+ *
+ * @param
+ * timeout	the timeout of the poll in milliseconds,
+ * 		(-1) to wait until anything happens
+ * @param
+ * scheduler	the scheduling thread
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stream_scheduler_poll (int timeout, stream_scheduler *scheduler) {
+	stream_fiber *fiber = NULL;
+	struct pollfd *new_pollfds = NULL;
+	stream_fiber **new_polled_fibers = NULL;
+	char bytes[64];
+	size_t polled = 1;
+	size_t i = 0;
+	for (fiber = scheduler->first; fiber != NULL; fiber = fiber->next) {
+		if ((fiber->state == FIBER_STATE_WAITING_INPUT) &&
+				(fiber->wait_fd_ready == 0)) {
+			++polled;
+		}
+	}
+	if (polled > scheduler->pollfds_size) {
+		new_pollfds = realloc(scheduler->pollfds,
+				polled * sizeof (struct pollfd));
+		if (new_pollfds == NULL) {
+			perror("stream_scheduler_poll: realloc(pollfds)");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
+		scheduler->pollfds = new_pollfds;
+		new_polled_fibers = realloc(scheduler->polled_fibers,
+				polled * sizeof (stream_fiber *));
+		if (new_polled_fibers == NULL) {
+			perror("stream_scheduler_poll: "
+					"realloc(polled_fibers)");
+			/* resetting the errno */
+			errno = 0;
+			return (2);
+		}
+		scheduler->polled_fibers = new_polled_fibers;
+		scheduler->pollfds_size = polled;
+	}
+	scheduler->pollfds[0].fd = scheduler->wake_pipe[0];
+	scheduler->pollfds[0].events = POLLIN;
+	polled = 1;
+	for (fiber = scheduler->first; fiber != NULL; fiber = fiber->next) {
+		if ((fiber->state == FIBER_STATE_WAITING_INPUT) &&
+				(fiber->wait_fd_ready == 0)) {
+			scheduler->pollfds[polled].fd = fiber->wait_fd;
+			scheduler->pollfds[polled].events = POLLIN;
+			scheduler->polled_fibers[polled] = fiber;
+			++polled;
+		}
+	}
+	if (poll(scheduler->pollfds, (nfds_t)(polled), timeout) == -1) {
+		/* EINTR is fine, the scheduling loop will poll again */
+		if (errno != EINTR) {
+			perror("stream_scheduler_poll: poll");
+		}
+		/* resetting the errno */
+		errno = 0;
+		return (0);
+	}
+	/* POLLHUP and POLLERR are reported by the subsequent read */
+	for (i = 1; i < polled; ++i) {
+		if (scheduler->pollfds[i].revents != 0) {
+			scheduler->polled_fibers[i]->wait_fd_ready = 1;
+		}
+	}
+	if (scheduler->pollfds[0].revents != 0) {
+		while (read(scheduler->wake_pipe[0], bytes,
+					sizeof (bytes)) > 0) {
+		}
+		/* resetting the errno */
+		errno = 0;
+	}
+	return (0);
+}
+
+/**
+ * A function, which releases the stack of the provided finished fiber
+ * and announces that it can be joined.
+ * The fiber must not be accessed by the scheduling thread afterwards.
+ *
+ * @param
+ * fiber	the finished fiber
+ */
+void stream_fiber_release (stream_fiber *fiber) {
+	stream_fiber_pool *pool = fiber->scheduler->pool;
+	if (munmap(fiber->stack, fiber->stack_size) == -1) {
+		perror("stream_fiber_release: munmap");
+		/* resetting the errno */
+		errno = 0;
+	}
+	fiber->stack = NULL;
+	__atomic_sub_fetch(&fiber->scheduler->load, 1, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&fiber->finished, 1, __ATOMIC_RELEASE);
+	event_counter_notify(&pool->finished_ec);
+}
+
+/**
+ * A function which is executed by each scheduling thread
+ * of the multi-stream mode. It resumes its runnable fibers
+ * one after another, until the fiber pool is shut down
+ * and all of its fibers have finished.
+ *
+ * @param
+ * arg	the pointer to the scheduling thread
+ *
+ * @return	This function always returns NULL.
+ */
+void *stream_scheduler_run (void *arg) {
+	stream_scheduler *scheduler = (stream_scheduler *)(arg);
+	stream_fiber *fiber = NULL;
+	stream_fiber *previous = NULL;
+	stream_fiber *next = NULL;
+	size_t resumed = 0;
+	size_t waiting_for_input = 0;
+	running_scheduler = scheduler;
+	while (1) {
+		/* we take over the new fibers in the order of their creation */
+		pthread_mutex_lock(&scheduler->mutex);
+		previous = NULL;
+		for (fiber = scheduler->incoming; fiber != NULL;
+				fiber = next) {
+			next = fiber->next;
+			fiber->next = previous;
+			previous = fiber;
+		}
+		scheduler->incoming = NULL;
+		pthread_mutex_unlock(&scheduler->mutex);
+		if (previous != NULL) {
+			if (scheduler->last != NULL) {
+				scheduler->last->next = previous;
+			} else {
+				scheduler->first = previous;
+			}
+			while (previous->next != NULL) {
+				previous = previous->next;
+			}
+			scheduler->last = previous;
+		}
+		resumed = 0;
+		waiting_for_input = 0;
+		previous = NULL;
+		fiber = scheduler->first;
+		while (fiber != NULL) {
+			next = fiber->next;
+			if (stream_fiber_runnable(fiber) == 0) {
+				if (fiber->state ==
+						FIBER_STATE_WAITING_INPUT) {
+					++waiting_for_input;
+				}
+				previous = fiber;
+				fiber = next;
+				continue;
+			}
+			fiber->state = FIBER_STATE_READY;
+			scheduler->current = fiber;
+			if (swapcontext(&scheduler->context,
+						&fiber->context) == -1) {
+				perror("stream_scheduler_run: swapcontext");
+				/* resetting the errno */
+				errno = 0;
+			}
+			scheduler->current = NULL;
+			++resumed;
+			if (fiber->state == FIBER_STATE_FINISHED) {
+				if (previous != NULL) {
+					previous->next = next;
+				} else {
+					scheduler->first = next;
+				}
+				if (scheduler->last == fiber) {
+					scheduler->last = previous;
+				}
+				stream_fiber_release(fiber);
+			} else {
+				if (fiber->state ==
+						FIBER_STATE_WAITING_INPUT) {
+					++waiting_for_input;
+				}
+				previous = fiber;
+			}
+			fiber = next;
+		}
+		if ((scheduler->first == NULL) &&
+				(__atomic_load_n(&scheduler->pool->shutdown,
+						 __ATOMIC_SEQ_CST) != 0)) {
+			break;
+		}
+		if (resumed > 0) {
+			/* we only check the input, which might be ready */
+			if (waiting_for_input > 0) {
+				stream_scheduler_poll(0, scheduler);
+			}
+			continue;
+		}
+		/*
+		 * The sleeping flag has to be set before the final check,
+		 * so that any later event wakes us up.
+		 */
+		__atomic_store_n(&scheduler->sleeping, 1, __ATOMIC_SEQ_CST);
+		if (stream_scheduler_has_work(scheduler) == 0) {
+			stream_scheduler_poll(-1, scheduler);
+		}
+		__atomic_store_n(&scheduler->sleeping, 0, __ATOMIC_SEQ_CST);
+	}
+	running_scheduler = NULL;
+	return (NULL);
+}
+
+/**
+ * A function, which selects the least loaded scheduling thread
+ * from the provided range of the scheduling threads.
+ *
+ * @param
+ * schedulers	the first scheduling thread of the range
+ * @param
+ * count	the number of the scheduling threads in the range
+ *
+ * @return	This function returns the selected scheduling thread.
+ */
+stream_scheduler *stream_scheduler_select (stream_scheduler *schedulers,
+		size_t count) {
+	stream_scheduler *selected = &schedulers[0];
+	size_t i = 0;
+	for (i = 1; i < count; ++i) {
+		if (__atomic_load_n(&schedulers[i].load, __ATOMIC_SEQ_CST) <
+				__atomic_load_n(&selected->load,
+					__ATOMIC_SEQ_CST)) {
+			selected = &schedulers[i];
+		}
+	}
+	return (selected);
+}
+
+/**
+ * A function, which starts an auxiliary thread of the suffix tree
+ * construction. Within a fiber of the multi-stream mode,
+ * a new fiber is run by the least loaded I/O thread instead.
+ *
+ * @param
+ * thread	the thread to be started
+ * @param
+ * function	the function to be executed by the thread
+ * @param
+ * arg		the argument of the function
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, an error number is returned,
+ * 		as if by the pthread_create.
+ */
+int stream_thread_create (stream_thread *thread,
+		void *(*function)(void *),
+		void *arg) {
+	stream_fiber *fiber = stream_fiber_current();
+	stream_fiber_pool *pool = NULL;
+	thread->fiber = NULL;
+	if (fiber == NULL) {
+		return (pthread_create(&thread->thread, NULL, function, arg));
+	}
+	pool = fiber->scheduler->pool;
+	thread->fiber = stream_fiber_create(function, arg,
+			stream_scheduler_select(&pool->schedulers[pool->
+				workers], pool->io_threads));
+	if (thread->fiber == NULL) {
+		return (EAGAIN);
+	}
+	return (0);
+}
+
+/**
+ * A function, which waits for an auxiliary thread
+ * of the suffix tree construction to finish.
+ *
+ * @param
+ * thread	the thread to be joined
+ * @param
+ * retval	the place to store the return value of the thread to
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, an error number is returned,
+ * 		as if by the pthread_join.
+ */
+int stream_thread_join (stream_thread *thread, void **retval) {
+	if (thread->fiber == NULL) {
+		return (pthread_join(thread->thread, retval));
+	}
+	(*retval) = stream_fiber_join(thread->fiber);
+	thread->fiber = NULL;
+	return (0);
+}
+
+/**
+ * A function which is executed by the fiber processing a single stream.
+ *
+ * @param
+ * ptr	the pointer to the stream
+ *
+ * @return	This function always returns NULL.
+ */
+void *stream_pool_fiber (void *ptr) {
+	stream_task *task = (stream_task *)(ptr);
+	task->retval = task->pool->process(task);
+	return (NULL);
+}
+
+/**
+ * A function which initializes the scheduling threads
+ * of the provided fiber pool, but it does not start them.
+ *
+ * @param
+ * pool		the fiber pool with the numbers of the threads set
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stream_fiber_pool_init (stream_fiber_pool *pool) {
+	stream_scheduler *scheduler = NULL;
+	size_t i = 0;
+	pool->schedulers = calloc(pool->workers + pool->io_threads,
+			sizeof (stream_scheduler));
+	if (pool->schedulers == NULL) {
+		perror("stream_fiber_pool_init: calloc");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	for (i = 0; i < pool->workers + pool->io_threads; ++i) {
+		scheduler = &pool->schedulers[i];
+		scheduler->pool = pool;
+		if (pipe(scheduler->wake_pipe) == -1) {
+			perror("stream_fiber_pool_init: pipe");
+			/* resetting the errno */
+			errno = 0;
+			break;
+		}
+		if ((fcntl(scheduler->wake_pipe[0], F_SETFL,
+						O_NONBLOCK) == -1) ||
+				(fcntl(scheduler->wake_pipe[1], F_SETFL,
+				       O_NONBLOCK) == -1) ||
+				(pthread_mutex_init(&scheduler->mutex,
+						    NULL) != 0)) {
+			perror("stream_fiber_pool_init: fcntl "
+					"or pthread_mutex_init");
+			/* resetting the errno */
+			errno = 0;
+			close(scheduler->wake_pipe[0]);
+			close(scheduler->wake_pipe[1]);
+			break;
+		}
+	}
+	if (i < pool->workers + pool->io_threads) {
+		while (i > 0) {
+			--i;
+			pthread_mutex_destroy(&pool->schedulers[i].mutex);
+			close(pool->schedulers[i].wake_pipe[0]);
+			close(pool->schedulers[i].wake_pipe[1]);
+		}
+		free(pool->schedulers);
+		pool->schedulers = NULL;
+		return (2);
+	}
+	return (0);
+}
+
+/**
+ * A function which deallocates the scheduling threads
+ * of the provided fiber pool. They have to be joined already.
+ *
+ * @param
+ * pool		the fiber pool
+ */
+void stream_fiber_pool_destroy (stream_fiber_pool *pool) {
+	stream_scheduler *scheduler = NULL;
+	size_t i = 0;
+	for (i = 0; i < pool->workers + pool->io_threads; ++i) {
+		scheduler = &pool->schedulers[i];
+		pthread_mutex_destroy(&scheduler->mutex);
+		close(scheduler->wake_pipe[0]);
+		close(scheduler->wake_pipe[1]);
+		free(scheduler->pollfds);
+		free(scheduler->polled_fibers);
+	}
+	free(pool->schedulers);
+	pool->schedulers = NULL;
+}
+
+/**
+ * A function which processes all the input streams at once.
+ * Each stream is processed by its own fiber. The fibers
+ * are distributed among the worker threads, which interleave
+ * the streams block by block. The reading of the input files
+ * is performed by the fibers of the I/O threads.
+ * This way, every stream is kept open and it is read
+ * as soon as its input arrives, regardless of the number
+ * of the worker threads.
+ *
+ * @param
+ * workers	the number of the worker threads
+ * @param
+ * io_threads	the number of the I/O threads
+ * @param
+ * sp		the stream pool
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		The results of the individual streams are stored
+ * 		in their tasks. Otherwise, a positive error number
+ * 		is returned.
+ */
+int stream_pool_run_fibers (size_t workers,
+		size_t io_threads,
+		stream_pool *sp) {
+	stream_fiber_pool pool = {.schedulers = NULL};
+	stream_fiber **fibers = NULL;
+	size_t started = 0;
+	size_t i = 0;
+	int retval = 0;
+	int error = 0;
+	pool.workers = workers;
+	pool.io_threads = io_threads;
+	fibers = calloc(sp->streams, sizeof (stream_fiber *));
+	if (fibers == NULL) {
+		perror("stream_pool_run_fibers: calloc(fibers)");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	if (stream_fiber_pool_init(&pool) > 0) {
+		free(fibers);
+		return (2);
+	}
+	__atomic_store_n(&running_fiber_pool, &pool, __ATOMIC_RELEASE);
+	for (i = 0; i < workers + io_threads; ++i) {
+		if ((retval = pthread_create(&pool.schedulers[i].thread, NULL,
+					stream_scheduler_run,
+					&pool.schedulers[i])) != 0) {
+			fprintf(stderr, "stream_pool_run_fibers:\n");
+			errno = retval; /* retval != 0 */
+			perror("pthread_create");
+			/* resetting the errno */
+			errno = 0;
+			error = 3;
+			break;
 		}
-		/*
-		 * From now on, the block has the correct flags set.
-		 * We can safely unlock the mutex immediately, because we know
-		 * that no other thread can invalidate this condition.
-		 * This assumption is true,
-		 * because there is only one reading thread.
-		 */
-		/* FIXME: The signaling is not necessary here, right? */
-		pthread_mutex_unlock(&sd->mx);
-		/* the end of the first critical section */
-		if ((retval = text_file_read_blocks((size_t)(1),
-						&blocks_read,
-						&characters_read,
-						&bytes_read, sd->tfsw)) > 1) {
-			/* start of the second critical section */
-			pthread_mutex_lock(&sd->mx);
-			/*
-			 * we have to raise a flag indicating
-			 * that the reading has (unsuccessfully) finished
-			 */
-			sd->reading_finished = 1;
-			/*
-			 * Signaling is necessary here,
-			 * because we have changed the shared data.
-			 */
-			pthread_cond_signal(&sd->cv);
-			pthread_mutex_unlock(&sd->mx);
-			fprintf(stderr, "reading_thread_function: "
-					"file reading error\n");
-			return ((void *)(2));
+		++started;
+	}
+	for (i = 0; (i < sp->streams) && (error == 0); ++i) {
+		fibers[i] = stream_fiber_create(stream_pool_fiber,
+				&sp->tasks[i],
+				stream_scheduler_select(pool.schedulers,
+					workers));
+		if (fibers[i] == NULL) {
+			error = 4;
 		}
-		/* start of the third critical section */
-		pthread_mutex_lock(&sd->mx);
-		/*
-		 * under the protection of the mutex, we set
-		 * the appropriate flag for the most recently read block
-		 */
-		sd->tfsw->sw_block_flags[block_to_read] =
-			BLOCK_STATUS_READ_AND_UNPROCESSED;
-		/* if there are no more unread bytes left in the input file */
-		if (retval == 1) {
-			sd->reading_finished = 1;
-			sd->final_block_characters = characters_read;
-			/* FIXME: Explain why this is correct! */
-			sd->final_block_number = block_to_read;
-			pthread_cond_signal(&sd->cv);
-			pthread_mutex_unlock(&sd->mx);
-			printf("The whole input file has been read.\n");
-			break;
-		} else { /* retval == 0 */
-			pthread_cond_signal(&sd->cv);
-			pthread_mutex_unlock(&sd->mx);
+	}
+	for (i = 0; i < sp->streams; ++i) {
+		if (fibers[i] != NULL) {
+			stream_fiber_join(fibers[i]);
+		} else {
+			/* the stream has not been processed at all */
+			sp->tasks[i].retval = 1;
 		}
-		/* the end of the second critical section */
 	}
-	return (NULL);
+	__atomic_store_n(&pool.shutdown, 1, __ATOMIC_SEQ_CST);
+	stream_fiber_pool_wake(&pool);
+	for (i = 0; i < started; ++i) {
+		if ((retval = pthread_join(pool.schedulers[i].thread,
+						NULL)) != 0) {
+			fprintf(stderr, "stream_pool_run_fibers:\n");
+			errno = retval; /* retval != 0 */
+			perror("pthread_join");
+			/* resetting the errno */
+			errno = 0;
+			error = 5;
+		}
+	}
+	__atomic_store_n(&running_fiber_pool, NULL, __ATOMIC_RELEASE);
+	stream_fiber_pool_destroy(&pool);
+	free(fibers);
+	return (error);
 }
 #endif
 
 /**
- * A function which determines the sliding window offset of the first character
- * of the suffix corresponding to the the leaf with the provided number.
- * Important:
- * It is not advisable to call this function, unless the suffix tree itself
- * is not available. There are suffix-tree-implementation-aware versions
- * of this function, which are slightly faster.
+ * A function, which reads from the provided file descriptor.
+ * Outside of a fiber, it just calls the read.
+ * Within a fiber, the file descriptor is expected to be nonblocking.
+ * If there is no input available yet, the fiber waits for it,
+ * so that the scheduling thread can run the other fibers meanwhile.
+ * A FIFO, whose writer has not opened it yet, reports the end
+ * of the input, but it is not readable. That is why the end
+ * of the input is only accepted after the poll has confirmed it.
  *
  * @param
- * child	the number of child which corresponds to the suffix,
- * 		for which we would like to determine the offset
- * 		of its first character in the sliding window
+ * fd		the file descriptor
  * @param
- * tfsw		the actual sliding window containing the text
- * 		currently used by the suffix tree
+ * buffer	the buffer to store the bytes to
+ * @param
+ * size		the maximum number of bytes to read
  *
- * @return	this function returns the determined sliding window offset
- * 		of the first character of the suffix corresponding
- * 		to the provided child
+ * @return	The number of bytes read. Zero means the end of the file.
+ * 		If an error occurs, (-1) is returned and errno is set.
  */
-size_t stsw_get_leafs_sw_offset (signed_integral_type child,
-		const text_file_sliding_window *tfsw) {
-	size_t ap_window_begin_sw_block = (tfsw->ap_window_begin - 1) /
-		tfsw->sw_block_size;
-	size_t ap_window_begin_sw_block_offset = (tfsw->ap_window_begin - 1) %
-		tfsw->sw_block_size;
-	size_t ap_window_end_sw_block = (tfsw->ap_window_end - 1) /
-		tfsw->sw_block_size;
-	size_t ap_window_end_sw_block_offset = (tfsw->ap_window_end - 1) %
-		tfsw->sw_block_size;
-	size_t ap_window_begin_ap_block = 0;
-	size_t childs_number = (size_t)(-child);
-	size_t childs_ap_block = (childs_number - 1) / tfsw->sw_block_size;
-	size_t childs_ap_block_offset = (childs_number - 1) %
-		tfsw->sw_block_size;
-	size_t childs_sw_block = 0;
-	size_t childs_sw_offset = 0;
-	size_t sw_read_loops = (tfsw->blocks_read - 1) / tfsw->sw_blocks;
-	if (ap_window_end_sw_block_offset == 0) {
-		if (ap_window_end_sw_block == 0) {
-			ap_window_end_sw_block = tfsw->sw_blocks - 1;
-		} else {
-			--ap_window_end_sw_block;
+ssize_t stream_fiber_read (int fd, void *buffer, size_t size) {
+	ssize_t bytes_read = 0;
+#ifdef	STSW_USE_PTHREAD
+	int polled = 0;
+	if (stream_fiber_current() == NULL) {
+		return (read(fd, buffer, size));
+	}
+	while (1) {
+		bytes_read = read(fd, buffer, size);
+		if ((bytes_read == (-1)) &&
+				((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+			/* resetting the errno */
+			errno = 0;
+		} else if ((bytes_read != 0) || (polled != 0)) {
+			return (bytes_read);
 		}
+		stream_fiber_wait_input(fd);
+		polled = 1;
 	}
-	if (tfsw->sw_mrr_block < ap_window_end_sw_block) {
-		--sw_read_loops;
-	} else if (ap_window_end_sw_block < ap_window_begin_sw_block) {
-		--sw_read_loops;
+#else
+	bytes_read = read(fd, buffer, size);
+	return (bytes_read);
+#endif
+}
+
+/**
+ * A function which processes all the input streams.
+ * If there is more than one stream, all of them are processed
+ * at once by a fixed pool of the worker threads
+ * and a fixed set of the I/O threads.
+ * If there is only a single stream, or if the POSIX threads
+ * are disabled, the streams are processed one after another
+ * by the calling thread.
+ *
+ * @param
+ * workers	the desired number of the worker threads
+ * @param
+ * io_threads	the desired number of the I/O threads
+ * @param
+ * sp		the stream pool
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		The results of the individual streams are stored
+ * 		in their tasks. Otherwise, a positive error number
+ * 		is returned.
+ */
+int stream_pool_run (size_t workers, size_t io_threads, stream_pool *sp) {
+	unsigned long long start_time = monotonic_clock_ns();
+	size_t i = 0;
+	int retval = 0;
+	for (i = 0; i < sp->streams; ++i) {
+		sp->tasks[i].pool = sp;
 	}
-	ap_window_begin_ap_block = (sw_read_loops * tfsw->sw_blocks +
-			ap_window_begin_sw_block) % tfsw->ap_scale_factor;
-	if (childs_ap_block < ap_window_begin_ap_block) {
-		childs_ap_block += tfsw->ap_scale_factor;
-	} else if (childs_ap_block == ap_window_begin_ap_block) {
-		if (childs_ap_block_offset < ap_window_begin_sw_block_offset) {
-			childs_ap_block += tfsw->ap_scale_factor;
+#ifdef	STSW_USE_PTHREAD
+	if (sp->streams > 1) {
+		if (workers > sp->streams) {
+			workers = sp->streams;
 		}
+		retval = stream_pool_run_fibers(workers, io_threads, sp);
+		sp->wall_time = monotonic_clock_ns() - start_time;
+		return (retval);
 	}
-	childs_sw_block = (ap_window_begin_sw_block + childs_ap_block -
-		ap_window_begin_ap_block) % tfsw->sw_blocks;
-	childs_sw_offset = childs_sw_block * tfsw->sw_block_size +
-		childs_ap_block_offset + 1;
-	return (childs_sw_offset);
+#else
+	(void)(workers);
+	(void)(io_threads);
+#endif
+	for (i = 0; i < sp->streams; ++i) {
+		sp->tasks[i].retval = sp->process(&sp->tasks[i]);
+	}
+	sp->wall_time = monotonic_clock_ns() - start_time;
+	return (retval);
 }
 
 /**
- * a function which determines the depth order of a leaf, which corresponds
- * to the suffix beginning at the provided position in the sliding window.
- * the depth order of a leaf is its depth relative to
- * the maximum possible depth in the current suffix tree, starting from zero.
- * the leaf with the depth order of zero has the maximum possible depth
- * of a suffix in the current suffix tree.
+ * A function which prints the statistics of each of the processed
+ * input streams, followed by the aggregated statistics of all of them.
  *
  * @param
- * sw_offset	the position in the sliding window of the first character
- * 		of the suffix, which corresponds to the leaf,
- * 		which depth order we would like to determine.
+ * stream	the FILE * type stream to which the statistics are printed
  * @param
- * tfsw		the actual sliding window containing the text
- * 		currently used by the suffix tree
+ * sp		the stream pool, whose streams have been processed
  *
- * @return	this function returns the determined depth order of a leaf,
- * 		which corresponds to the suffix beginning at the provided
- * 		position in the sliding window
+ * @return	This function returns the number of the streams,
+ * 		whose processing has failed.
  */
-size_t stsw_get_leafs_depth_order (size_t sw_offset,
-		const text_file_sliding_window *tfsw) {
-	size_t depth_order = 0;
-	if (tfsw->ap_window_begin <= sw_offset) {
-		depth_order = sw_offset - tfsw->ap_window_begin;
-	} else { /* tfsw->ap_window_begin > sw_offset */
-		depth_order = tfsw->total_window_size + sw_offset -
-			tfsw->ap_window_begin;
+int stream_pool_print_stats (FILE *stream, const stream_pool *sp) {
+	const stream_task *task = NULL;
+	size_t blocks = 0;
+	size_t characters = 0;
+	size_t i = 0;
+	int failed = 0;
+	/* the sum of the wall times of all the streams */
+	unsigned long long busy_time = 0;
+	fprintf(stream, "\nPer-stream statistics:\n"
+			"----------------------\n");
+	for (i = 0; i < sp->streams; ++i) {
+		task = &sp->tasks[i];
+		fprintf(stream, "Stream %zu (%s): %s, %zu blocks, "
+				"%zu characters in ", task->index,
+				task->file_name,
+				task->retval == 0 ? "OK" : "FAILED",
+				task->blocks, task->characters);
+		print_human_readable_time(stream, (size_t)
+				(task->wall_time / 1000000));
+		fprintf(stream, " (%.0f characters per second)\n",
+				task->wall_time > 0 ?
+				(double)(task->characters) * 1e9 /
+				(double)(task->wall_time) : 0.0);
+		blocks += task->blocks;
+		characters += task->characters;
+		busy_time += task->wall_time;
+		if (task->retval != 0) {
+			++failed;
+		}
 	}
-	return (depth_order);
+	fprintf(stream, "\nAggregated statistics:\n"
+			"----------------------\n"
+			"Streams: %zu (%d failed)\n"
+			"Blocks: %zu\nCharacters: %zu\nTotal wall time: ",
+			sp->streams, failed, blocks, characters);
+	print_human_readable_time(stream, (size_t)(sp->wall_time / 1000000));
+	fprintf(stream, "\nAggregated throughput: %.0f characters per second\n"
+			"Average concurrency: %.2f streams\n",
+			sp->wall_time > 0 ? (double)(characters) * 1e9 /
+			(double)(sp->wall_time) : 0.0,
+			sp->wall_time > 0 ? (double)(busy_time) /
+			(double)(sp->wall_time) : 0.0);
+	return (failed);
 }
 
+/* compaction functions */
+
 /**
- * A function which checks whether the provided offset in the sliding window
- * is or has recently been within the currently active part
- * of the sliding window and therefore is valid.
+ * A function which compares two indices of the branching records
+ * so that they can be sorted in the descending order by the qsort.
  *
  * @param
- * sw_offset	the position in the sliding window, which should be validated
+ * a	the pointer to the first index
  * @param
- * tfsw		the actual sliding window containing the text
- * 		currently used by the suffix tree
+ * b	the pointer to the second index
  *
- * @return	If the provided sliding window offset is valid,
- * 		this function returns zero.
+ * @return	If the first index is larger, a negative number is returned.
+ * 		If it is smaller, a positive number is returned.
+ * 		Otherwise, zero is returned.
+ */
+int compare_indices_descending (const void *a, const void *b) {
+	unsigned_integral_type first = *((const unsigned_integral_type *)(a));
+	unsigned_integral_type second =
+		*((const unsigned_integral_type *)(b));
+	if (first > second) {
+		return (-1);
+	} else if (first < second) {
+		return (1);
+	} else {
+		return (0);
+	}
+}
+
+/**
+ * A function which plans a single step of the compaction
+ * of the table tbranch. The vacant records are sorted
+ * so that the smallest of them is reused first.
+ * Then, while starting from the branching record at the highest index
+ * currently in use, each record is either released, if it is vacant,
+ * or it is planned to be moved to the smallest vacant record.
+ * Each released or moved record lowers the number of the branching
+ * records in use by one. The records are not moved by this function.
+ * It is up to the caller to copy them and to patch all the references
+ * to them according to the returned remapping table.
+ *
+ * @param
+ * max_steps	the maximum number of the records released or moved
+ * @param
+ * tbranch_deleted	the array of indices of the vacant branching records
+ * @param
+ * tbdeleted_records	the number of the vacant branching records,
+ * 			which will be updated
+ * @param
+ * branching_nodes	the highest index of the branching record in use,
+ * 			which will be updated
+ * @param
+ * remap	When this function finishes successfully, it will point
+ * 		to the newly allocated remapping table. Its entry
+ * 		at the index (old branching_nodes - node) contains
+ * 		the new index of the node, or zero if the node
+ * 		has been vacant. The caller is responsible for freeing it.
+ *
+ * @return	If this function call is successful, it returns 0.
  * 		Otherwise, a positive error number is returned.
  */
-int stsw_validate_sw_offset (size_t sw_offset,
-		const text_file_sliding_window *tfsw) {
-	/* the begin of the currently valid part of the sliding window */
-	size_t vp_window_begin = tfsw->ap_window_begin;
+int compaction_plan (size_t max_steps,
+		unsigned_integral_type *tbranch_deleted,
+		size_t *tbdeleted_records,
+		size_t *branching_nodes,
+		signed_integral_type **remap) {
+	size_t old_hwm = (*branching_nodes);
+	/* the index of the largest vacant record not yet released */
+	size_t lo = 0;
+	/* the index just after the smallest vacant record not yet reused */
+	size_t hi = (*tbdeleted_records);
+	size_t steps = 0;
+	if (max_steps > (*tbdeleted_records)) {
+		max_steps = (*tbdeleted_records);
+	}
+	(*remap) = calloc(max_steps + 1, sizeof (signed_integral_type));
+	if ((*remap) == NULL) {
+		perror("compaction_plan: calloc(remap)");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	qsort(tbranch_deleted, (*tbdeleted_records),
+			sizeof (unsigned_integral_type),
+			compare_indices_descending);
 	/*
-	 * Here, we need to identify the edge label maintenance method,
-	 * which is currently in use. This method determines
-	 * the range of the valid sliding window offsets.
+	 * All the vacant records are below or at the highest index in use,
+	 * so if the highest record in use is vacant, it is the largest
+	 * of them. Otherwise, the smallest vacant record is below it.
 	 */
-	if (tfsw->elm_method == 1) { /* batch update by M. Senft */
-		/*
-		 * When using this edge label maintenance method,
-		 * the valid sliding window offsets are not only
-		 * the ones inside the currently active part
-		 * of the sliding window. The offsets
-		 * which are at most max_ap_window_size before
-		 * the ap_window_begin are valid as well.
-		 */
-		if (vp_window_begin > tfsw->max_ap_window_size) {
-			vp_window_begin -= tfsw->max_ap_window_size;
+	for (; (steps < max_steps) && (lo < hi); ++steps) {
+		if (tbranch_deleted[lo] == (*branching_nodes)) {
+			/* the highest record is vacant, we just release it */
+			++lo;
 		} else {
-			vp_window_begin = tfsw->total_window_size +
-				tfsw->ap_window_begin -
-				tfsw->max_ap_window_size;
-		}
-		/*
-		 * Here, it is possible that vp_window_begin ==
-		 * tfsw->ap_window_end. In this case, all the offsets
-		 * in the sliding window are valid
-		 */
-		if (vp_window_begin == tfsw->ap_window_end) {
-			return (0);
+			/* we move the highest record to the smallest hole */
+			--hi;
+			(*remap)[old_hwm - (*branching_nodes)] =
+				(signed_integral_type)(tbranch_deleted[hi]);
 		}
+		--(*branching_nodes);
 	}
+	/* the remaining vacant records are moved to the beginning */
+	memmove(tbranch_deleted, tbranch_deleted + lo,
+			(hi - lo) * sizeof (unsigned_integral_type));
+	memset(tbranch_deleted + (hi - lo), 0,
+			((*tbdeleted_records) - (hi - lo)) *
+			sizeof (unsigned_integral_type));
+	(*tbdeleted_records) = hi - lo;
+	return (0);
+}
+
+/**
+ * A function which translates the number of a node
+ * according to the remapping table created by the compaction_plan.
+ *
+ * @param
+ * node		the number of a node (the leaves are left intact)
+ * @param
+ * old_hwm	the highest index of the branching record in use
+ * 		before the compaction step
+ * @param
+ * new_hwm	the highest index of the branching record in use
+ * 		after the compaction step
+ * @param
+ * remap	the remapping table
+ *
+ * @return	This function returns the new number of the node.
+ */
+signed_integral_type compaction_remap (signed_integral_type node,
+		size_t old_hwm,
+		size_t new_hwm,
+		const signed_integral_type *remap) {
 	/*
-	 * we now know that vp_window_begin !=
-	 * tfsw->ap_window_end
+	 * the stale references from the vacant records
+	 * might lie above the old highest index, we leave them intact
 	 */
-	if (vp_window_begin < tfsw->ap_window_end) {
-		if ((sw_offset < vp_window_begin) ||
-				(tfsw->ap_window_end <= sw_offset)) {
-			fprintf(stderr, "stsw_validate_sw_offset:\n"
-					"The offset %zu is not within "
-					"the currently valid "
-					"part\nof the sliding "
-					"window [%zu, %zu).\n",
-					sw_offset,
-					vp_window_begin,
-					tfsw->ap_window_end);
-			return (1);
-		}
-	} else { /* vp_window_begin > tfsw->ap_window_end */
-		if ((sw_offset < vp_window_begin) &&
-				(tfsw->ap_window_end <= sw_offset)) {
-			fprintf(stderr, "stsw_validate_sw_offset:\n"
-					"The offset %zu is not within "
-					"the currently valid "
-					"part\nof the sliding "
-					"window [%zu, %zu).\n",
-					sw_offset,
-					vp_window_begin,
-					tfsw->ap_window_end);
-			return (2);
-		}
+	if ((node > 0) && ((size_t)(node) > new_hwm) &&
+			((size_t)(node) <= old_hwm)) {
+		return (remap[old_hwm - (size_t)(node)]);
 	}
-	return (0);
+	return (node);
 }
 
 /* functions to hande the reading */
@@ -619,6 +2860,28 @@ int stsw_validate_sw_offset (size_t sw_offset,
  * 			The default value is 1 for the batch update
  * 			by M. Senft.
  * @param
+ * desired_bu_workers	The desired number of the threads performing
+ * 			the batch update of the edge labels.
+ * 			It is only used by the batch update by M. Senft
+ * 			and only when the POSIX threads are enabled.
+ * 			The default value is 1 for the serial update.
+ * @param
+ * desired_compaction_step	The desired maximum number of the branching
+ * 				records moved or released by a single step
+ * 				of the compaction of the table tbranch.
+ * 				If it is zero, the compaction is disabled.
+ * @param
+ * desired_read_ahead_depth	The desired number of the raw input buffers
+ * 				kept in flight by the read-ahead thread.
+ * 				If it is zero, the input file
+ * 				is read directly.
+ * @param
+ * desired_decode_depth	The desired number of the buffers
+ * 			of the converted characters kept in flight
+ * 			by the decode thread. If it is zero,
+ * 			the characters are converted
+ * 			while filling the sliding window.
+ * @param
  * tfsw		When this function finishes successfully, this variable
  * 		will be initialized as a new sliding window for the text
  * 		coming from the desired input file.
@@ -638,6 +2901,10 @@ int text_file_open (const int verbosity_level,
 		size_t desired_ap_scale_factor,
 		size_t desired_sw_scale_factor,
 		int desired_elm_method,
+		size_t desired_bu_workers,
+		size_t desired_compaction_step,
+		size_t desired_read_ahead_depth,
+		size_t desired_decode_depth,
 		text_file_sliding_window *tfsw) {
 	/* the default size of a single block in the sliding window */
 	size_t sw_block_size = 8388608; /* 8 MiC (8 mebi characters) */
@@ -647,6 +2914,8 @@ int text_file_open (const int verbosity_level,
 	size_t sw_scale_factor = ap_scale_factor + 2;
 	/* the default value of the edge label maintenance method */
 	int elm_method = 1; /* batch update by M. Senft */
+	/* the default number of the batch update threads */
+	size_t bu_workers = 1;
 	tfsw->file_name = file_name;
 	/* By default, we suppose that the input file encoding is UTF-8. */
 	tfsw->fromcode = "UTF-8";
@@ -656,13 +2925,39 @@ int text_file_open (const int verbosity_level,
 	 * or the size of the character_type.
 	 */
 	tfsw->tocode = NULL;
-	/* we try to open the input file for reading */
-	tfsw->fd = open(file_name, O_RDONLY);
-	if (tfsw->fd == -1) {
-		perror("text_file_open: open");
-		/* resetting the errno */
-		errno = 0;
-		return (1);
+	/* the file name "-" stands for the standard input */
+	if (strcmp(file_name, "-") == 0) {
+		/*
+		 * We duplicate the descriptor, so that it can be closed
+		 * in the same way as the descriptor of any other file.
+		 */
+		tfsw->fd = dup(STDIN_FILENO);
+		if (tfsw->fd == -1) {
+			perror("text_file_open: dup");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
+	} else {
+		/*
+		 * We try to open the input file for reading.
+		 * Within a fiber, it has to be nonblocking,
+		 * so that waiting for it does not block
+		 * the other fibers of the same thread.
+		 */
+#ifdef	STSW_USE_PTHREAD
+		tfsw->fd = open(file_name, O_RDONLY |
+				(stream_fiber_current() != NULL ?
+				 O_NONBLOCK : 0));
+#else
+		tfsw->fd = open(file_name, O_RDONLY);
+#endif
+		if (tfsw->fd == -1) {
+			perror("text_file_open: open");
+			/* resetting the errno */
+			errno = 0;
+			return (1);
+		}
 	}
 	if (input_file_encoding != NULL) {
 		/*
@@ -757,6 +3052,28 @@ int text_file_open (const int verbosity_level,
 				desired_elm_method);
 		return (3);
 	}
+	/*
+	 * if the caller did not provide any preference
+	 * on the number of the batch update threads
+	 */
+	if (desired_bu_workers <= 1) {
+		/*
+		 * we can use the default number
+		 * and therefore we do nothing here
+		 */
+	} else if (elm_method != 1) {
+		fprintf(stderr, "Warning: The number of the batch update "
+				"threads (%zu)\nis ignored, because "
+				"the batch update is not in use.\n\n",
+				desired_bu_workers);
+	} else { /* otherwise, we respect the caller's choice */
+#ifdef	STSW_USE_PTHREAD
+		bu_workers = desired_bu_workers;
+#else
+		fprintf(stderr, "Warning: The POSIX threads are disabled.\n"
+				"The batch update will be serial.\n\n");
+#endif
+	}
 	/*
 	 * if the caller did not provide any preference
 	 * on the size of a single block in the sliding window
@@ -914,6 +3231,13 @@ int text_file_open (const int verbosity_level,
 	 * of bytes that a single block in the sliding window occupies
 	 */
 	tfsw->conversion_buffer_size = sw_block_size * character_type_size;
+	/*
+	 * but it always has to be able to hold
+	 * the longest multi-byte sequence
+	 */
+	if (tfsw->conversion_buffer_size < conversion_buffer_min_size) {
+		tfsw->conversion_buffer_size = conversion_buffer_min_size;
+	}
 	/*
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
@@ -987,6 +3311,8 @@ int text_file_open (const int verbosity_level,
 	tfsw->inbytesleft = 0;
 	tfsw->outbytesleft = 0;
 	tfsw->elm_method = elm_method;
+	tfsw->bu_workers = bu_workers;
+	tfsw->compaction_step = desired_compaction_step;
 	/*
 	 * we do not intend to use tfsw->text_window[0],
 	 * that's why we fill it with "blank" (space) character
@@ -996,6 +3322,12 @@ int text_file_open (const int verbosity_level,
 #else
 	tfsw->text_window[0] = ' ';
 #endif
+	if (text_file_pipeline_start(desired_read_ahead_depth,
+				desired_decode_depth, tfsw) > 0) {
+		fprintf(stderr, "text_file_open: Could not start "
+				"the input pipeline!\n");
+		return (11);
+	}
 	printf("The file '%s' has been opened successfully!\n",
 			tfsw->file_name);
 	printf("Selected input file encoding: '%s'\n", tfsw->fromcode);
@@ -1028,6 +3360,30 @@ int text_file_open (const int verbosity_level,
 	if (verbosity_level > 0) {
 		printf("Active part scale factor: %zu\n", ap_scale_factor);
 		printf("Sliding window scale factor: %zu\n", sw_scale_factor);
+		if (tfsw->elm_method == 1) {
+			printf("Batch update threads: %zu\n",
+					tfsw->bu_workers);
+		}
+		if (tfsw->compaction_step > 0) {
+			printf("Compaction step: %zu branching records\n",
+					tfsw->compaction_step);
+		} else {
+			printf("Compaction is disabled\n");
+		}
+		if (tfsw->ra != NULL) {
+			printf("Read-ahead depth: %zu buffers "
+					"of %zu bytes\n", tfsw->ra->depth,
+					tfsw->ra->buffer_size);
+		} else {
+			printf("Read-ahead is disabled\n");
+		}
+		if (tfsw->dr != NULL) {
+			printf("Decode depth: %zu buffers "
+					"of %zu bytes\n", tfsw->dr->depth,
+					tfsw->dr->buffer_size);
+		} else {
+			printf("Decode stage is disabled\n");
+		}
 	}
 	if (verbosity_level > 1) {
 		printf("Additional amount of memory allocated\n"
@@ -1066,8 +3422,14 @@ int text_file_close (const int verbosity_level,
 				"and clean the sliding window "
 				"associated with it.\n", tfsw->file_name);
 	}
+	/* at first, we stop the input pipeline */
+	if (text_file_pipeline_stop(verbosity_level, tfsw) > 0) {
+		fprintf(stderr, "text_file_close: Could not stop "
+				"the input pipeline!\n");
+		return (5);
+	}
 	/*
-	 * At first, we free the memory for the conversion buffer.
+	 * Then, we free the memory for the conversion buffer.
 	 *
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
@@ -1116,102 +3478,579 @@ int text_file_close (const int verbosity_level,
 		perror("text_file_close: close");
 		/* resetting the errno */
 		errno = 0;
-		return (4);
-	}
-	tfsw->fd = 0;
-	if (verbosity_level > 0) {
-		printf("Successfully closed!\n\n");
-	}
-	printf("The sliding window statistics:\n"
-		"------------------------------\n");
-	printf("Block size: %zu characters of %zu bytes\n"
-			"            (totalling %zu bytes, ",
-			tfsw->sw_block_size, character_type_size,
-			tfsw->sw_block_size * character_type_size);
-	print_human_readable_size(stdout,
-			tfsw->sw_block_size * character_type_size);
-	printf(")\nActive part scale factor: %zu\n", tfsw->ap_scale_factor);
-	printf("Sliding window scale factor: %zu\n", tfsw->sw_scale_factor);
-	if (verbosity_level > 1) {
-		printf("Maximum size of the active part:\n"
-				"%zu characters of %zu bytes "
-				"(totalling %zu bytes, ",
-				tfsw->max_ap_window_size, character_type_size,
-				tfsw->max_ap_window_size * character_type_size);
-		print_human_readable_size(stdout,
-				tfsw->max_ap_window_size * character_type_size);
-		printf(")\nTotal size of the sliding window:\n"
-				"%zu characters of %zu bytes "
-				"(totalling %zu bytes, ",
-				tfsw->total_window_size, character_type_size,
-				tfsw->total_window_size * character_type_size);
-		print_human_readable_size(stdout,
-				tfsw->total_window_size * character_type_size);
-		printf(")\n");
-	}
-	if (verbosity_level > 0) {
-		printf("\nThe total amount of memory allocated\n"
-				"for the sliding window: %zu bytes (",
-				bytes_allocated);
-		print_human_readable_size(stdout,
-				bytes_allocated);
-		printf(")\n");
+		return (4);
+	}
+	tfsw->fd = 0;
+	if (verbosity_level > 0) {
+		printf("Successfully closed!\n\n");
+	}
+	printf("The sliding window statistics:\n"
+		"------------------------------\n");
+	printf("Block size: %zu characters of %zu bytes\n"
+			"            (totalling %zu bytes, ",
+			tfsw->sw_block_size, character_type_size,
+			tfsw->sw_block_size * character_type_size);
+	print_human_readable_size(stdout,
+			tfsw->sw_block_size * character_type_size);
+	printf(")\nActive part scale factor: %zu\n", tfsw->ap_scale_factor);
+	printf("Sliding window scale factor: %zu\n", tfsw->sw_scale_factor);
+	if (verbosity_level > 1) {
+		printf("Maximum size of the active part:\n"
+				"%zu characters of %zu bytes "
+				"(totalling %zu bytes, ",
+				tfsw->max_ap_window_size, character_type_size,
+				tfsw->max_ap_window_size * character_type_size);
+		print_human_readable_size(stdout,
+				tfsw->max_ap_window_size * character_type_size);
+		printf(")\nTotal size of the sliding window:\n"
+				"%zu characters of %zu bytes "
+				"(totalling %zu bytes, ",
+				tfsw->total_window_size, character_type_size,
+				tfsw->total_window_size * character_type_size);
+		print_human_readable_size(stdout,
+				tfsw->total_window_size * character_type_size);
+		printf(")\n");
+	}
+	if (verbosity_level > 0) {
+		printf("\nThe total amount of memory allocated\n"
+				"for the sliding window: %zu bytes (",
+				bytes_allocated);
+		print_human_readable_size(stdout,
+				bytes_allocated);
+		printf(")\n");
+	}
+	if (verbosity_level > 1) {
+		printf("\nTotal number of blocks read: %zu\n",
+				tfsw->blocks_read);
+		printf("Total disk space read for the text: %zu bytes (",
+				tfsw->bytes_read);
+		print_human_readable_size(stdout, tfsw->bytes_read);
+		printf(")\n");
+	}
+	if (verbosity_level > 0) {
+		printf("Total number of characters obtained "
+				"from the input file: %zu\n",
+				tfsw->characters_read);
+		printf("Average character size: %2.3f bytes\n",
+				(double)(tfsw->bytes_read) /
+				(double)(tfsw->characters_read));
+	}
+	if (verbosity_level > 1) {
+		printf("\nThe active part can hold "
+				"%2.2f%% of the text\n", 100 *
+				(double)(tfsw->max_ap_window_size) /
+				(double)(tfsw->characters_read));
+		printf("The whole sliding window can hold "
+				"%2.2f%% of the text\n", 100 *
+				(double)(tfsw->total_window_size) /
+				(double)(tfsw->characters_read));
+	}
+	/*
+	 * we should, of course, also reset the other variables
+	 * to their initial values
+	 */
+	tfsw->blocks_read = 0;
+	tfsw->bytes_read = 0;
+	tfsw->characters_read = 0;
+	tfsw->total_window_size = 0;
+	tfsw->max_ap_window_size = 0;
+	tfsw->ap_window_size = 0;
+	tfsw->ap_window_begin = 0;
+	tfsw->ap_window_end = 0;
+	tfsw->ap_scale_factor = 0;
+	tfsw->sw_scale_factor = 0;
+	tfsw->sw_blocks = 0;
+	tfsw->sw_mrp_block = 0;
+	tfsw->sw_mrr_block = 0;
+	tfsw->sw_block_size = 0;
+	tfsw->file_name = NULL;
+	tfsw->fromcode = NULL;
+	tfsw->tocode = NULL;
+	tfsw->conversion_buffer_size = 0;
+	tfsw->inbuf = NULL;
+	tfsw->outbuf = NULL;
+	tfsw->inbytesleft = 0;
+	tfsw->outbytesleft = 0;
+	return (0);
+}
+
+/**
+ * A function, which reads the raw bytes from the input file
+ * into the provided buffer. If it is possible, the pread is used
+ * and the kernel is advised to start reading the bytes,
+ * which will be requested by the subsequent calls.
+ * Otherwise, if the input file does not support positioned reading,
+ * like a pipe or the standard input, the plain read is used
+ * until the buffer is full.
+ *
+ * @param
+ * buffer	the buffer to store the bytes to
+ * @param
+ * size		the maximum number of bytes to read
+ * @param
+ * ra		the read-ahead ring holding the current file offset
+ * @param
+ * fd		the file descriptor of the input file
+ *
+ * @return	The number of bytes read. Zero means the end of the file.
+ * 		If an error occurs, (-1) is returned and errno is set.
+ */
+ssize_t text_file_read_raw (char *buffer, size_t size,
+		buffer_ring *ra, int fd) {
+	ssize_t bytes_read = 0;
+	/* the number of bytes read by one call to read() */
+	ssize_t current_bytes_read = 0;
+	if (ra->sequential_only == 0) {
+		/*
+		 * The advice is only a hint, so we do not care
+		 * about its return value.
+		 */
+		posix_fadvise(fd, ra->file_offset + (off_t)(size),
+				(off_t)(ra->depth * ra->buffer_size),
+				POSIX_FADV_WILLNEED);
+		bytes_read = pread(fd, buffer, size, ra->file_offset);
+		if ((bytes_read == (-1)) && (errno == ESPIPE)) {
+			/* the input file is not seekable */
+			ra->sequential_only = 1;
+			bytes_read = 0;
+			/* resetting the errno */
+			errno = 0;
+		}
+	}
+	if (ra->sequential_only != 0) {
+		/*
+		 * A pipe returns at most the bytes it currently holds,
+		 * so we keep reading until the buffer is full
+		 * or until the end of the input is reached.
+		 * This way, the consuming thread is not woken up
+		 * for every small piece of the stream.
+		 */
+		while ((size_t)(bytes_read) < size) {
+			current_bytes_read = stream_fiber_read(fd,
+					buffer + bytes_read,
+					size - (size_t)(bytes_read));
+			if (current_bytes_read == (-1)) {
+				if (errno == EINTR) {
+					/* resetting the errno */
+					errno = 0;
+					continue;
+				}
+				/* the bytes read so far would be lost */
+				if (bytes_read == 0) {
+					return (-1);
+				}
+				/*
+				 * the error will be encountered again
+				 * by the next call
+				 */
+				/* resetting the errno */
+				errno = 0;
+				break;
+			} else if (current_bytes_read == 0) {
+				break;
+			}
+			bytes_read += current_bytes_read;
+		}
+	}
+	if (bytes_read > 0) {
+		ra->file_offset += (off_t)(bytes_read);
+	}
+	return (bytes_read);
+}
+
+/**
+ * A function, which determines how the input file can be read.
+ * If it is a regular file, the kernel is told that it will be
+ * read sequentially and the pread will be used.
+ * Otherwise, for example for a pipe or the standard input,
+ * the plain read will be used. If the input is a pipe
+ * and the platform allows it, the capacity of the pipe is increased
+ * to the size of a single buffer, so that the writer is not blocked
+ * while the read-ahead thread is waiting for a free buffer.
+ *
+ * @param
+ * ra		the read-ahead ring
+ * @param
+ * fd		the file descriptor of the input file
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int text_file_probe_input (buffer_ring *ra, int fd) {
+	struct stat input_stat;
+	if (fstat(fd, &input_stat) == -1) {
+		perror("text_file_probe_input: fstat");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	if (S_ISREG(input_stat.st_mode)) {
+		/*
+		 * The advice is only a hint, so we do not care
+		 * about its return value.
+		 */
+		posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+		return (0);
+	}
+	ra->sequential_only = 1;
+#ifdef	F_SETPIPE_SZ
+	if (S_ISFIFO(input_stat.st_mode)) {
+		/*
+		 * The capacity might be limited by the system,
+		 * so the failure is not an error.
+		 */
+		if (fcntl(fd, F_SETPIPE_SZ, (int)(ra->buffer_size)) == -1) {
+			/* resetting the errno */
+			errno = 0;
+		}
+	}
+#endif
+	return (0);
+}
+
+/**
+ * A function, which allocates a new buffer ring.
+ * Without the POSIX threads, the buffers themselves
+ * are not allocated, because there is no thread to fill them.
+ *
+ * @param
+ * depth	the number of buffers in the ring
+ * @param
+ * buffer_size	the size of a single buffer in bytes
+ * @param
+ * with_sources	If nonzero, the number of input bytes used to fill
+ * 		each of the buffers will be tracked as well.
+ * @param
+ * ring		When this function finishes successfully,
+ * 		(*ring) will point to the new buffer ring.
+ * @param
+ * tfsw		the sliding window, whose memory accounting
+ * 		will be updated
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int buffer_ring_create (size_t depth,
+		size_t buffer_size,
+		int with_sources,
+		buffer_ring **ring,
+		text_file_sliding_window *tfsw) {
+	buffer_ring *new_ring = NULL;
+#ifdef	STSW_USE_PTHREAD
+	size_t i = 0;
+#endif
+	new_ring = calloc((size_t)(1), sizeof (buffer_ring));
+	if (new_ring == NULL) {
+		perror("buffer_ring_create: calloc(ring)");
+		/* resetting the errno */
+		errno = 0;
+		return (1);
+	}
+	(*ring) = new_ring;
+	tfsw->additional_bytes_allocated += sizeof (buffer_ring);
+	tfsw->bytes_allocated += sizeof (buffer_ring);
+	new_ring->depth = depth;
+	new_ring->buffer_size = buffer_size;
+	new_ring->status = READING_STATUS_IN_PROGRESS;
+	/* no thread is filling the ring yet */
+	new_ring->stop = 2;
+#ifdef	STSW_USE_PTHREAD
+	new_ring->buffers = calloc(depth, sizeof (char *));
+	new_ring->lengths = calloc(depth, sizeof (size_t));
+	if ((new_ring->buffers == NULL) || (new_ring->lengths == NULL)) {
+		perror("buffer_ring_create: calloc(buffers)");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	tfsw->additional_bytes_allocated += depth *
+		(sizeof (char *) + sizeof (size_t));
+	tfsw->bytes_allocated += depth * (sizeof (char *) + sizeof (size_t));
+	if (with_sources != 0) {
+		new_ring->source_lengths = calloc(depth, sizeof (size_t));
+		if (new_ring->source_lengths == NULL) {
+			perror("buffer_ring_create: calloc(source_lengths)");
+			/* resetting the errno */
+			errno = 0;
+			return (3);
+		}
+		tfsw->additional_bytes_allocated += depth * sizeof (size_t);
+		tfsw->bytes_allocated += depth * sizeof (size_t);
+	}
+	for (i = 0; i < depth; ++i) {
+		new_ring->buffers[i] = malloc(buffer_size);
+		if (new_ring->buffers[i] == NULL) {
+			perror("buffer_ring_create: malloc(buffer)");
+			/* resetting the errno */
+			errno = 0;
+			return (4);
+		}
+		tfsw->additional_bytes_allocated += buffer_size;
+		tfsw->bytes_allocated += buffer_size;
+	}
+#else
+	/* the buffers are not used without the POSIX threads */
+	(void)(with_sources);
+#endif
+	return (0);
+}
+
+/**
+ * A function, which stops the thread filling the buffer ring,
+ * if it is running, and deallocates the ring.
+ *
+ * @param
+ * verbosity_level	the desired level of messaging verbosity
+ * @param
+ * name		the name of the pipeline stage filling the ring,
+ * 		used in the wait statistics
+ * @param
+ * ring		the pointer to the buffer ring, which will be set to NULL
+ * @param
+ * tfsw		the sliding window, whose memory accounting
+ * 		will be updated
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int buffer_ring_destroy (const int verbosity_level,
+		const char *name,
+		buffer_ring **ring,
+		text_file_sliding_window *tfsw) {
+	buffer_ring *old_ring = (*ring);
+#ifdef	STSW_USE_PTHREAD
+	void *thread_retval = NULL;
+	size_t i = 0;
+#endif
+	if (old_ring == NULL) {
+		return (0);
+	}
+#ifdef	STSW_USE_PTHREAD
+	/* if the thread filling the ring is running */
+	if (old_ring->stop == 0) {
+		__atomic_store_n(&old_ring->stop, 1, __ATOMIC_RELEASE);
+		event_counter_notify(&old_ring->ec);
+		/*
+		 * The errors have already been reported
+		 * by the consuming thread, so we ignore
+		 * the return value of the filling thread.
+		 */
+		stream_thread_join(&old_ring->thread, &thread_retval);
+		if (verbosity_level > 0) {
+			printf("%s wait statistics:\n"
+					"filling thread: %zu waits, "
+					"%zu sleeps, %.3f ms waiting\n"
+					"consuming thread: %zu waits, "
+					"%zu sleeps, %.3f ms waiting\n",
+					name,
+					old_ring->producer_counters.waits,
+					old_ring->producer_counters.sleeps,
+					(double)(old_ring->producer_counters.
+						wait_time) / 1e6,
+					old_ring->consumer_counters.waits,
+					old_ring->consumer_counters.sleeps,
+					(double)(old_ring->consumer_counters.
+						wait_time) / 1e6);
+		}
+	}
+	if (old_ring->buffers != NULL) {
+		for (i = 0; i < old_ring->depth; ++i) {
+			if (old_ring->buffers[i] != NULL) {
+				free(old_ring->buffers[i]);
+				tfsw->additional_bytes_allocated -=
+					old_ring->buffer_size;
+				tfsw->bytes_allocated -= old_ring->buffer_size;
+			}
+		}
+	}
+	if ((old_ring->buffers != NULL) && (old_ring->lengths != NULL)) {
+		tfsw->additional_bytes_allocated -= old_ring->depth *
+			(sizeof (char *) + sizeof (size_t));
+		tfsw->bytes_allocated -= old_ring->depth *
+			(sizeof (char *) + sizeof (size_t));
+	}
+	if (old_ring->source_lengths != NULL) {
+		tfsw->additional_bytes_allocated -= old_ring->depth *
+			sizeof (size_t);
+		tfsw->bytes_allocated -= old_ring->depth * sizeof (size_t);
+	}
+	free(old_ring->buffers);
+	free(old_ring->lengths);
+	free(old_ring->source_lengths);
+#else
+	(void)(verbosity_level);
+	(void)(name);
+#endif
+	free(old_ring);
+	(*ring) = NULL;
+	tfsw->additional_bytes_allocated -= sizeof (buffer_ring);
+	tfsw->bytes_allocated -= sizeof (buffer_ring);
+	return (0);
+}
+
+#ifdef	STSW_USE_PTHREAD
+/**
+ * A function, which starts the thread filling the provided buffer ring.
+ *
+ * @param
+ * thread_function	the function to be executed by the thread
+ * @param
+ * ring		the buffer ring to be filled
+ * @param
+ * tfsw		the sliding window passed to the thread
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int buffer_ring_start (void *(*thread_function)(void *),
+		buffer_ring *ring,
+		text_file_sliding_window *tfsw) {
+	int retval = 0;
+	ring->stop = 0;
+	if ((retval = stream_thread_create(&ring->thread,
+				thread_function, tfsw)) != 0) {
+		fprintf(stderr, "buffer_ring_start:\n");
+		errno = retval; /* retval != 0 */
+		perror("stream_thread_create");
+		/* resetting the errno */
+		errno = 0;
+		/* there is no thread to join with */
+		ring->stop = 2;
+		return (1);
 	}
-	if (verbosity_level > 1) {
-		printf("\nTotal number of blocks read: %zu\n",
-				tfsw->blocks_read);
-		printf("Total disk space read for the text: %zu bytes (",
-				tfsw->bytes_read);
-		print_human_readable_size(stdout, tfsw->bytes_read);
-		printf(")\n");
+	return (0);
+}
+#endif
+
+/**
+ * A function, which sets up the input pipeline for the input file.
+ * The first stage reads the raw bytes into the read-ahead ring,
+ * the second stage converts them into the characters
+ * in the decode ring and the third stage, which is run
+ * by the caller of the text_file_read_blocks,
+ * copies the characters into the sliding window.
+ * Without the POSIX threads, there are no auxiliary stages
+ * and only the kernel read-ahead of the requested depth is used.
+ *
+ * @param
+ * read_ahead_depth	The desired number of the raw input buffers
+ * 			kept in flight. If it is zero, the input file
+ * 			will be read directly.
+ * @param
+ * decode_depth	The desired number of the buffers of converted
+ * 		characters kept in flight. If it is zero, the characters
+ * 		will be converted while filling the sliding window.
+ * @param
+ * tfsw		the sliding window with an already opened input file
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int text_file_pipeline_start (size_t read_ahead_depth,
+		size_t decode_depth,
+		text_file_sliding_window *tfsw) {
+	size_t buffer_size = tfsw->conversion_buffer_size;
+	tfsw->ra = NULL;
+	tfsw->dr = NULL;
+	if (buffer_size > read_ahead_buffer_size_limit) {
+		buffer_size = read_ahead_buffer_size_limit;
 	}
-	if (verbosity_level > 0) {
-		printf("Total number of characters obtained "
-				"from the input file: %zu\n",
-				tfsw->characters_read);
-		printf("Average character size: %2.3f bytes\n",
-				(double)(tfsw->bytes_read) /
-				(double)(tfsw->characters_read));
+	if (read_ahead_depth > 0) {
+		if (buffer_ring_create(read_ahead_depth, buffer_size, 0,
+					&tfsw->ra, tfsw) > 0) {
+			return (1);
+		}
+		if (text_file_probe_input(tfsw->ra, tfsw->fd) > 0) {
+			return (5);
+		}
+#ifdef	STSW_USE_PTHREAD
+		if (buffer_ring_start(&read_ahead_thread_function,
+					tfsw->ra, tfsw) > 0) {
+			return (2);
+		}
+#endif
 	}
-	if (verbosity_level > 1) {
-		printf("\nThe active part can hold "
-				"%2.2f%% of the text\n", 100 *
-				(double)(tfsw->max_ap_window_size) /
-				(double)(tfsw->characters_read));
-		printf("The whole sliding window can hold "
-				"%2.2f%% of the text\n", 100 *
-				(double)(tfsw->total_window_size) /
-				(double)(tfsw->characters_read));
+#ifdef	STSW_USE_PTHREAD
+	if (decode_depth > 0) {
+		/*
+		 * The size of the buffer has to be a multiple
+		 * of the character size, so that no character
+		 * is split between two buffers.
+		 */
+		buffer_size -= buffer_size % character_type_size;
+		if (buffer_ring_create(decode_depth, buffer_size, 1,
+					&tfsw->dr, tfsw) > 0) {
+			return (3);
+		}
+		if (buffer_ring_start(&decode_thread_function,
+					tfsw->dr, tfsw) > 0) {
+			return (4);
+		}
 	}
+#else
+	/* there is no decode stage without the POSIX threads */
+	(void)(decode_depth);
+#endif
+	return (0);
+}
+
+/**
+ * A function, which stops the auxiliary stages of the input pipeline
+ * and deallocates their buffer rings.
+ *
+ * @param
+ * verbosity_level	the desired level of messaging verbosity
+ * @param
+ * tfsw		the sliding window with the input pipeline
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int text_file_pipeline_stop (const int verbosity_level,
+		text_file_sliding_window *tfsw) {
 	/*
-	 * we should, of course, also reset the other variables
-	 * to their initial values
+	 * The decode stage consumes the read-ahead ring,
+	 * so it has to be stopped first.
 	 */
-	tfsw->blocks_read = 0;
-	tfsw->bytes_read = 0;
-	tfsw->characters_read = 0;
-	tfsw->total_window_size = 0;
-	tfsw->max_ap_window_size = 0;
-	tfsw->ap_window_size = 0;
-	tfsw->ap_window_begin = 0;
-	tfsw->ap_window_end = 0;
-	tfsw->ap_scale_factor = 0;
-	tfsw->sw_scale_factor = 0;
-	tfsw->sw_blocks = 0;
-	tfsw->sw_mrp_block = 0;
-	tfsw->sw_mrr_block = 0;
-	tfsw->sw_block_size = 0;
-	tfsw->file_name = NULL;
-	tfsw->fromcode = NULL;
-	tfsw->tocode = NULL;
-	tfsw->conversion_buffer_size = 0;
-	tfsw->inbuf = NULL;
-	tfsw->outbuf = NULL;
-	tfsw->inbytesleft = 0;
-	tfsw->outbytesleft = 0;
+	if (buffer_ring_destroy(verbosity_level, "Decode",
+				&tfsw->dr, tfsw) > 0) {
+		return (1);
+	}
+	if (buffer_ring_destroy(verbosity_level, "Read-ahead",
+				&tfsw->ra, tfsw) > 0) {
+		return (2);
+	}
 	return (0);
 }
 
+/**
+ * A function, which fetches the next raw bytes of the input file.
+ * If the read-ahead ring is set up, the bytes are taken
+ * from its already filled buffers. Otherwise, the input file
+ * is read directly.
+ *
+ * @param
+ * destination	the buffer to store the bytes to
+ * @param
+ * size		the maximum number of bytes to fetch
+ * @param
+ * tfsw		the sliding window with an already opened input file
+ *
+ * @return	The number of bytes fetched. Zero means the end of the file.
+ * 		If an error occurs, (-1) is returned and errno is set.
+ */
+ssize_t text_file_fetch_bytes (char *destination, size_t size,
+		text_file_sliding_window *tfsw) {
+	if (tfsw->ra == NULL) {
+		return (stream_fiber_read(tfsw->fd, destination, size));
+	}
+#ifdef	STSW_USE_PTHREAD
+	return (buffer_ring_fetch(destination, size, NULL, tfsw->ra));
+#else
+	return (text_file_read_raw(destination, size, tfsw->ra, tfsw->fd));
+#endif
+}
+
 /**
  * A function which tries to read the desired number of blocks
  * from the previously specified input file
@@ -1328,8 +4167,7 @@ int text_file_read_blocks (size_t blocks_to_read,
 	 * because the tfsw->text_window might be of the type wchar_t*
 	 */
 	tfsw->outbuf = (char *)(tfsw->text_window + 1 +
-			starting_block * tfsw->sw_block_size *
-			character_type_size);
+			starting_block * tfsw->sw_block_size);
 	/* filling in the maximum number of bytes to write in the first part */
 	if (starting_block < ending_block) {
 		tfsw->outbytesleft = (ending_block - starting_block) *
@@ -1531,11 +4369,10 @@ int text_file_read_blocks (size_t blocks_to_read,
 
 /**
  * A function which prints the edge from parent to the child
- * within a suffix tree over a sliding window in a human readable format.
+ * within a suffix tree over a sliding window to the traversal output.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
- * 		will be written
+ * output	the buffered output, to which the edge will be written
  * @param
  * print_terminating_character	If this variable evaluates to true,
  * 				this function will print the dollar sign ($)
@@ -1569,7 +4406,7 @@ int text_file_read_blocks (size_t blocks_to_read,
  * @return	If we could successfully print the edge, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int stsw_print_edge (FILE *stream,
+int stsw_print_edge (traversal_output *output,
 		int print_terminating_character,
 		signed_integral_type parent,
 		signed_integral_type child,
@@ -1580,252 +4417,12 @@ int stsw_print_edge (FILE *stream,
 		size_t log10l,
 		size_t childs_offset,
 		const text_file_sliding_window *tfsw) {
-	/*
-	 * The format string buffer. Its length should never exceed 128.
-	 * All its characters (not only the first one) are initialized
-	 * to zero automatically.
-	 */
-	static char fs_buffer[128] = {0};
-	/*
-	 * The text string buffer. Its length should never exceed 512.
-	 * It has space for at least 128 4-byte UTF-8 characters,
-	 * which should be sufficient for our purposes, as the maximum
-	 * number of bytes used by any single UTF-8 character is 4.
-	 * All its characters (not only the first one) are initialized
-	 * to zero automatically.
-	 */
-	static char text_buffer[512] = {0};
-	/*
-	 * By default, we suppose that the current locale supports
-	 * the character encoding UTF-8 and that's why we print
-	 * the underlying text of the suffix tree using this encoding.
-	 */
-	static char *tocode = "UTF-8";
-	/* the length of the text which forms the parent->child edge label */
-	size_t text_length = childs_depth - parents_depth;
-	/* the conversion descriptor used by the iconv */
-	iconv_t cd = NULL; /* iconv_t is just a typedef for void* */
-	/* the variables used by the iconv */
-	char *inbuf = NULL;
-	char *outbuf = NULL;
-	size_t inbuf_offset = 0;
-	size_t incharsleft = 0;
-	size_t inbytesleft = 0;
-	size_t outbytesleft = 0;
-	/* the return value of the iconv */
-	size_t retval = 0;
-	if (childs_depth < parents_depth) {
-		fprintf(stderr,	"Error: Something went wrong.\n"
-				"The child (%d) has the depth of %u,\n"
-				"but its parent (%d) has the depth "
-				"of %u,\nwhich should never happen!\n",
-				child, childs_depth, parent, parents_depth);
-		fprintf(stderr,	"The traversal of this branch "
-				"is terminated here.\n");
-		return (1);
-	}
-	/* at first, we can safely print the parent */
-	if (parent == 0) {
-		fprintf(stream, "P(?)[%u]", parents_depth);
-	} else {
-		fprintf(stream, "P(%0*d)[%u]", (int)(log10bn), parent,
-				parents_depth);
-	}
-	/* we create the desired conversion descriptor */
-	if ((cd = iconv_open(tocode, tfsw->tocode)) ==
-			(iconv_t)(-1)) {
-		perror("stsw_print_edge: iconv_open");
-		/* resetting the errno */
-		errno = 0;
-		return (2);
-	}
-	/* we print the edge label */
-	if (text_length < 33) {
-		inbuf_offset = childs_offset + parents_depth;
-		if (inbuf_offset > tfsw->total_window_size) {
-			inbuf_offset -= tfsw->total_window_size;
-		}
-		if (print_terminating_character == 0) {
-			sprintf(fs_buffer, "--\"%%s\"(%zu)-->", text_length);
-			incharsleft = text_length;
-		} else {
-			/*
-			 * we do not want the terminating character
-			 * to be printed from the memory as is, so
-			 * we print the dollar sign ($) instead
-			 */
-			sprintf(fs_buffer, "--\"%%s$\"(%zu)-->", text_length);
-			incharsleft = text_length - 1;
-		}
-		if (inbuf_offset + incharsleft - 1 >
-				tfsw->total_window_size) {
-			inbytesleft = (tfsw->total_window_size -
-				inbuf_offset + 1) * character_type_size;
-		} else {
-			inbytesleft = incharsleft * character_type_size;
-		}
-		inbuf = (char *)(tfsw->text_window + inbuf_offset);
-		outbuf = text_buffer;
-		outbytesleft = 511;
-		retval = iconv(cd, &inbuf, &inbytesleft,
-				&outbuf, &outbytesleft);
-		/* if the iconv has encountered an error */
-		if (inbytesleft > 0 || retval != 0) {
-			perror("stsw_print_edge: iconv 1");
-			/* resetting the errno */
-			errno = 0;
-			return (3);
-		}
-		if (inbuf_offset + incharsleft - 1 >
-				tfsw->total_window_size) {
-			inbytesleft = (inbuf_offset + incharsleft -
-					tfsw->total_window_size - 1) *
-				character_type_size;
-			inbuf = (char *)(tfsw->text_window + 1);
-			retval = iconv(cd, &inbuf, &inbytesleft,
-					&outbuf, &outbytesleft);
-			/* if the iconv has encountered an error */
-			if (inbytesleft > 0 || retval != 0) {
-				perror("stsw_print_edge: iconv 2");
-				/* resetting the errno */
-				errno = 0;
-				return (4);
-			}
-		}
-		/* we make sure that the string is safely printable */
-		(*outbuf) = 0;
-		fprintf(stream, fs_buffer, text_buffer);
-	} else { /* text_length >= 33 */
-		inbuf_offset = childs_offset + parents_depth;
-		if (inbuf_offset > tfsw->total_window_size) {
-			inbuf_offset -= tfsw->total_window_size;
-		}
-		incharsleft = 15;
-		if (inbuf_offset + incharsleft - 1 >
-				tfsw->total_window_size) {
-			inbytesleft = (tfsw->total_window_size -
-				inbuf_offset + 1) * character_type_size;
-		} else {
-			inbytesleft = incharsleft * character_type_size;
-		}
-		inbuf = (char *)(tfsw->text_window + inbuf_offset);
-		outbuf = text_buffer;
-		outbytesleft = 255;
-		retval = iconv(cd, &inbuf, &inbytesleft,
-				&outbuf, &outbytesleft);
-		/* if the iconv has encountered an error */
-		if (inbytesleft > 0 || retval != 0) {
-			perror("stsw_print_edge: iconv 3");
-			/* resetting the errno */
-			errno = 0;
-			return (5);
-		}
-		if (inbuf_offset + incharsleft - 1 >
-				tfsw->total_window_size) {
-			inbytesleft = (inbuf_offset + incharsleft -
-					tfsw->total_window_size - 1) *
-				character_type_size;
-			inbuf = (char *)(tfsw->text_window + 1);
-			retval = iconv(cd, &inbuf, &inbytesleft,
-					&outbuf, &outbytesleft);
-			/* if the iconv has encountered an error */
-			if (inbytesleft > 0 || retval != 0) {
-				perror("stsw_print_edge: iconv 4");
-				/* resetting the errno */
-				errno = 0;
-				return (6);
-			}
-		}
-		/* we make sure that the string is safely printable */
-		(*outbuf) = 0;
-		inbuf_offset = childs_offset + childs_depth - 15;
-		if (inbuf_offset > tfsw->total_window_size) {
-			inbuf_offset -= tfsw->total_window_size;
-		}
-		if (print_terminating_character == 0) {
-			sprintf(fs_buffer, "--\"%%s...%%s\"(%zu)-->",
-					text_length);
-			incharsleft = 15;
-		} else {
-			/*
-			 * we do not want the terminating character
-			 * to be printed from the memory as is, so
-			 * we print the dollar sign ($) instead
-			 */
-			sprintf(fs_buffer, "--\"%%s...%%s$\"(%zu)-->",
-					text_length);
-			incharsleft = 14;
-		}
-		if (inbuf_offset + incharsleft - 1 >
-				tfsw->total_window_size) {
-			inbytesleft = (tfsw->total_window_size -
-				inbuf_offset + 1) * character_type_size;
-		} else {
-			inbytesleft = incharsleft * character_type_size;
-		}
-		inbuf = (char *)(tfsw->text_window + inbuf_offset);
-		outbuf = text_buffer + 256;
-		outbytesleft = 255;
-		retval = iconv(cd, &inbuf, &inbytesleft,
-				&outbuf, &outbytesleft);
-		/* if the iconv has encountered an error */
-		if (inbytesleft > 0 || retval != 0) {
-			perror("stsw_print_edge: iconv 5");
-			/* resetting the errno */
-			errno = 0;
-			return (7);
-		}
-		if (inbuf_offset + incharsleft - 1 >
-				tfsw->total_window_size) {
-			inbytesleft = (inbuf_offset + incharsleft -
-					tfsw->total_window_size - 1) *
-				character_type_size;
-			inbuf = (char *)(tfsw->text_window + 1);
-			retval = iconv(cd, &inbuf, &inbytesleft,
-					&outbuf, &outbytesleft);
-			/* if the iconv has encountered an error */
-			if (inbytesleft > 0 || retval != 0) {
-				perror("stsw_print_edge: iconv 6");
-				/* resetting the errno */
-				errno = 0;
-				return (8);
-			}
-		}
-		/* we make sure that the string is safely printable */
-		(*outbuf) = 0;
-		fprintf(stream, fs_buffer, text_buffer, text_buffer + 256);
-	}
-	/* now we can safely print the child */
-	if (child == 0) {
-		fprintf(stream, "C(?)[%u]", childs_depth);
-	} else if (child > 0) {
-		fprintf(stream, "C(%0*d)[%u]", (int)(log10bn), child,
-				childs_depth);
-	} else { /* child < 0 => child is a leaf */
-		fprintf(stream, "C(%0*d)[%u]", (int)(log10l), child,
-				childs_depth);
-	}
-	/* and finally, we can optionally print the suffix link */
-	if (childs_suffix_link == 0) {
-		fprintf(stream, "\n");
-	} else {
-		fprintf(stream, "{%0*d}\n", (int)(log10bn),
-				childs_suffix_link);
-	}
-	/* we delete the conversion descriptor used by the iconv */
-	if (iconv_close(cd) == (-1)) {
-		perror("stsw_print_edge: iconv_close");
-		/* resetting the errno */
-		errno = 0;
-		return (9);
-	}
-	if (errno != 0) {
-		perror("stsw_print_edge: printf");
-		/* resetting the errno */
-		errno = 0;
-		return (10);
-	}
-	return (0);
+	/* the edge labels might wrap around the end of the sliding window */
+	return (traversal_output_edge(print_terminating_character,
+				parent, child, childs_suffix_link,
+				parents_depth, childs_depth, log10bn, log10l,
+				childs_offset, tfsw->text_window,
+				tfsw->total_window_size, output));
 }
 
 /**
@@ -1849,9 +4446,10 @@ int stsw_print_sliding_window (FILE *stream,
 	 * which should be sufficient for our purposes, as the maximum
 	 * number of bytes used by any single UTF-8 character is 4.
 	 * All its characters (not only the first one) are initialized
-	 * to zero automatically.
+	 * to zero on each call, so that the concurrently processed
+	 * streams do not share it.
 	 */
-	static char text_buffer[512] = {0};
+	char text_buffer[512] = {0};
 	/*
 	 * By default, we suppose that the current locale supports
 	 * the character encoding UTF-8 and that's why we print
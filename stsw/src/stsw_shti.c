@@ -845,7 +845,7 @@ int stsw_shti_ukkonen_prolong_suffixes (const int variation,
  *
  * @param
  * stream	the FILE * type stream to which the traversal progress
- * 		will be written (if requested)
+ * 		or the LZ77 factors will be written (if requested)
  * @param
  * benchmark	the requested benchmark to perform
  * @param
@@ -854,10 +854,15 @@ int stsw_shti_ukkonen_prolong_suffixes (const int variation,
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
  * verbosity_level	The requested level of verbosity of the information
  * 			collected and displayed to the user
  * 			during the suffix tree construction and maintenance.
  * @param
+ * bm		the metrics of the processed blocks,
+ * 		which will be written (if requested)
+ * @param
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
@@ -872,7 +877,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 		const int benchmark,
 		const int variation,
 		const int traversal_type,
+		const int traversal_format,
 		const int verbosity_level,
+		block_metrics *bm,
 		text_file_sliding_window *tfsw,
 		suffix_tree_sliding_window_shti *stsw) {
 	/*
@@ -949,7 +956,7 @@ int stsw_shti_create_ukkonen (FILE *stream,
 	/* the number of the last block which has been read */
 	size_t final_block_number = 0;
 	/*
-	 * The return value from the pthread_create function
+	 * The return value from the stream_thread_create function
 	 * and from the block reading function.
 	 */
 	int retval = 0;
@@ -999,6 +1006,8 @@ int stsw_shti_create_ukkonen (FILE *stream,
 	 * of branching nodes observed
 	 */
 	size_t max_brn_ap_bti = 0;
+	/* the state of the LZ77 factorization (if requested) */
+	lz77_factorization lz;
 /* POSIX threads-related variables */
 #ifdef STSW_USE_PTHREAD
 	/* The index of a block, which will be made available for reading. */
@@ -1015,26 +1024,8 @@ int stsw_shti_create_ukkonen (FILE *stream,
 	 * so it will never be used uninitialized.
 	 */
 	shared_data sd;
-	/*
-	 * The mutex attributes.
-	 *
-	 * We do not initialize it right here,
-	 * but we do it immediately afterwards,
-	 * so it will never be used uninitialized.
-	 */
-	pthread_mutexattr_t mutex_attributes;
-	/* initialization of the mutex attributes */
-	pthread_mutexattr_init(&mutex_attributes);
-	pthread_mutexattr_settype(&mutex_attributes, PTHREAD_MUTEX_NORMAL);
-	/* initialization of the mutex itself */
-	pthread_mutex_init(&sd.mx, &mutex_attributes);
-	/* initialization of the condition variable */
-	pthread_cond_init(&sd.cv, NULL);
 	/* initialization of the shared_data struct */
-	sd.tfsw = tfsw;
-	sd.reading_finished = 0;
-	sd.final_block_characters = 0;
-	sd.final_block_number = 0;
+	sd_init(tfsw, &sd);
 #else /* non POSIX threads-related variables */
 	size_t blocks_read = 0;
 	size_t characters_read = 0;
@@ -1108,21 +1099,26 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				"Reallocation error. Exiting.\n");
 		return (3);
 	}
+	/* if the LZ77 factorization benchmark has been requested */
+	if (benchmark == 3) {
+		/* the factorization starts together with the reading */
+		lz77_init(stream, &lz);
+	}
 #ifdef STSW_USE_PTHREAD /* the pthread part */
-	pthread_t reader; /* the reading thread */
+	stream_thread reader; /* the reading thread */
 	// FIXME: What if not even all the blocks in the active part
 	// of the sliding window will be read? What about stats then?
 	// That should be handled by the number of observations.
 	// At least one observation should always be performed -
 	// before the final part.
-	if ((retval = pthread_create(&reader, NULL,
+	if ((retval = stream_thread_create(&reader,
 				&reading_thread_function, &sd)) != 0) {
 		fprintf(stderr, "stsw_shti_create_ukkonen:\n");
 		if (errno != 0) {
-			perror("pthread_create inside");
+			perror("stream_thread_create inside");
 		}
 		errno = retval; /* retval != 0 */
-		perror("pthread_create");
+		perror("stream_thread_create");
 		/* resetting the errno */
 		errno = 0;
 		return (4);
@@ -1164,44 +1160,18 @@ int stsw_shti_create_ukkonen (FILE *stream,
 		 * than the maximum number of blocks forming
 		 * the active part of the sliding window.
 		 */
-		/* the start of the critical section */
-		pthread_mutex_lock(&sd.mx);
-		/* while the current block is not ready to be processed */
-		while (tfsw->sw_block_flags[block_to_process] !=
-				BLOCK_STATUS_READ_AND_UNPROCESSED) {
-			/* if the reading thread has not finished yet */
-			if (sd.reading_finished == 0) {
-				/*
-				 * we wait for it to signal
-				 * a block status change
-				 */
-				pthread_cond_wait(&sd.cv, &sd.mx);
-			} else {
-				/*
-				 * Otherwise we know that no more blocks
-				 * will be read, so we can safely unlock
-				 * the mutex and jump
-				 * to the thread joining part.
-				 */
-				pthread_mutex_unlock(&sd.mx);
-				goto thread_joining;
-			}
-		}
 		/*
-		 * we are still inside the critical section
-		 *
-		 * The current block is now ready to be processed!
+		 * we wait until the current block is ready to be processed
+		 * or until it is clear that no more blocks will be read
 		 */
+		if (sd_wait_for_block(block_to_process, 0, &sd) != 0) {
+			goto thread_joining;
+		}
+		/* The current block is now ready to be processed! */
 		/* if no more blocks will be read */
-		if (sd.reading_finished == 1) {
-			/*
-			 * We know that the reading thread has either
-			 * already finished or it will finish soon.
-			 * So, we can afford to keep the mutex locked
-			 * for a little longer without much worrying.
-			 *
-			 * if the current block is the last block
-			 */
+		if (sd_reading_finished(&sd) ==
+					READING_STATUS_COMPLETE) {
+			/* if the current block is the last block */
 			if (block_to_process == sd.final_block_number) {
 				/* we just process it */
 				ending_position = block_to_process *
@@ -1236,15 +1206,11 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				 */
 				tfsw->sw_block_size + 1;
 		}
-		pthread_mutex_unlock(&sd.mx);
 		/*
-		 * the end of the critical section
-		 *
 		 * Now we have the current block ready to be processed
 		 * and we know that its status can not change,
 		 * because this is the only processing thread.
-		 * So, we can end the critical section here
-		 * and continue to process the block normally.
+		 * So, we can continue to process the block normally.
 		 */
 		for (; i <= ending_position; ++i) {
 			/*
@@ -1257,6 +1223,31 @@ int stsw_shti_create_ukkonen (FILE *stream,
 			 * of the sliding window as well
 			 */
 			++tfsw->ap_window_size;
+			if ((benchmark == 3) && (stsw_shti_lz77_factor(i,
+						ending_position, &lz,
+						tfsw, stsw) > 0)) {
+				fprintf(stderr,	"Could not factorize "
+						"the text just before "
+						"the position %zu. "
+						"Exiting.\n", i);
+				/*
+				 * There was an error, so we need to terminate
+				 * the reading thread, if it is still running.
+				 * But at first, we have to wake it up,
+				 * because it might be sleeping.
+				 * We also have to raise the reading_finished
+				 * flag to force the reading thread
+				 * to terminate immediately.
+				 */
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
+				/*
+				 * we need to join with the reading thread
+				 * at first and just then return failure
+				 */
+				function_retval = 28;
+				goto thread_joining;
+			}
 			if (stsw_shti_ukkonen_prolong_suffixes(variation,
 						&starting_position, i,
 						&active_index, &active_node,
@@ -1265,8 +1256,6 @@ int stsw_shti_create_ukkonen (FILE *stream,
 						"the suffixes to end "
 						"at the position %zu. "
 						"Exiting.\n", i);
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1276,12 +1265,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1289,23 +1275,52 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				goto thread_joining;
 			}
 		}
+		if (block_metrics_record(ending_position - 1 -
+					block_to_process *
+					tfsw->sw_block_size,
+					stsw->edges, stsw->branching_nodes,
+					stsw->tedge_size, stsw->tbranch_size,
+					stsw->tbdeleted_records,
+					sd_wait_time(1, &sd),
+					sd_wait_time(0, &sd),
+					bm) > 0) {
+			fprintf(stderr, "Error: Could not record "
+					"the metrics of the initial block. "
+					"Exiting!\n");
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 34;
+			goto thread_joining;
+		}
 	}
 	/* if the traversal type of benchmark has been requested */
 	if (benchmark == 2) {
-		fprintf(stream, "Initial suffix tree traversal:\n");
-		fprintf(stream, "The suffix tree is built over the initial "
-			"%zu characters\nof the input text.\n\n",
-			stsw->tleaf_last - stsw->tleaf_first + 1);
+		traversal_output_note(stream, traversal_format,
+				"Initial suffix tree traversal:\n"
+				"The suffix tree is built over the initial "
+				"%zu characters\nof the input text.\n\n",
+				stsw->tleaf_last - stsw->tleaf_first + 1);
 		/*
 		 * we traverse the suffix tree here,
 		 * because it has just grown to its maximum size
 		 */
 		if (stsw_shti_traverse(verbosity_level, stream, traversal_type,
-					tfsw, stsw) != 0) {
+					traversal_format, tfsw, stsw) != 0) {
 			fprintf(stderr, "Error: The initial suffix tree "
 					"traversal has failed. Exiting!\n");
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
 			/*
 			 * There was an error, so we need to terminate
 			 * the reading thread, if it is still running.
@@ -1315,12 +1330,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 			 * flag to force the reading thread
 			 * to terminate immediately.
 			 */
-			sd.reading_finished = 1;
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
 			/*
-			 * the end of the critical sectiom
-			 *
 			 * we need to join with the reading thread
 			 * at first and just then return failure
 			 */
@@ -1379,45 +1391,28 @@ int stsw_shti_create_ukkonen (FILE *stream,
 		if (block_to_process == tfsw->sw_blocks) {
 			block_to_process = 0;
 		}
-		/* the start of the critical section */
-		pthread_mutex_lock(&sd.mx);
-		/* while the current block is not ready to be processed */
-		while (tfsw->sw_block_flags[block_to_process] !=
-				BLOCK_STATUS_READ_AND_UNPROCESSED) {
-			/* if the reading thread has not finished yet */
-			if (sd.reading_finished == 0) {
-				/*
-				 * we wait for it to signal
-				 * a block status change
-				 */
-				pthread_cond_wait(&sd.cv, &sd.mx);
-			} else {
-				/*
-				 * Otherwise we know that no more blocks
-				 * will be read, so we can safely unlock
-				 * the mutex and jump
-				 * to the thread joining part.
-				 */
-				pthread_mutex_unlock(&sd.mx);
-				goto thread_joining;
-			}
-		}
 		/*
-		 * we are still inside the critical section
-		 *
-		 * The current block is now ready to be processed!
+		 * we wait until the current block is ready to be processed
+		 * or until it is clear that no more blocks will be read
 		 */
+		if (sd_wait_for_block(block_to_process, 0, &sd) != 0) {
+			goto thread_joining;
+		}
+		/* The current block is now ready to be processed! */
 		/* if no more blocks will be read */
-		if (sd.reading_finished == 1) {
-			/*
-			 * We know that the reading thread has either
-			 * already finished or it will finish soon.
-			 * So, we can afford to keep the mutex locked
-			 * for a little longer without much worrying.
-			 *
-			 * if the current block is the last block
-			 */
+		if (sd_reading_finished(&sd) ==
+					READING_STATUS_COMPLETE) {
+			/* if the current block is the last block */
 			if (block_to_process == sd.final_block_number) {
+				/*
+				 * If the input text ends exactly
+				 * at the block boundary, the final block
+				 * is empty and there is nothing left
+				 * to be processed.
+				 */
+				if (sd.final_block_characters == 0) {
+					goto thread_joining;
+				}
 				/* we just process it */
 				ending_position = block_to_process *
 					tfsw->sw_block_size +
@@ -1451,15 +1446,11 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				 */
 				tfsw->sw_block_size + 1;
 		}
-		pthread_mutex_unlock(&sd.mx);
 		/*
-		 * the end of the critical section
-		 *
 		 * Now we have the current block ready to be processed
 		 * and we know that its status can not change,
 		 * because this is the only processing thread.
-		 * So, we can end the critical section here
-		 * and continue to process the block normally.
+		 * So, we can continue to process the block normally.
 		 */
 		for (; i < ending_position; ++i) {
 			/* at first, we have to delete the longest suffix */
@@ -1473,8 +1464,6 @@ int stsw_shti_create_ukkonen (FILE *stream,
 						"%zu. Exiting.\n",
 						tfsw->ap_window_begin,
 						tfsw->ap_window_end);
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1484,12 +1473,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1505,6 +1491,31 @@ int stsw_shti_create_ukkonen (FILE *stream,
 			 * So, it does not change here and we don't
 			 * have to worry about adjusting it at all.
 			 */
+			if ((benchmark == 3) && (stsw_shti_lz77_factor(i,
+						ending_position, &lz,
+						tfsw, stsw) > 0)) {
+				fprintf(stderr,	"Could not factorize "
+						"the text just before "
+						"the position %zu. "
+						"Exiting.\n", i);
+				/*
+				 * There was an error, so we need to terminate
+				 * the reading thread, if it is still running.
+				 * But at first, we have to wake it up,
+				 * because it might be sleeping.
+				 * We also have to raise the reading_finished
+				 * flag to force the reading thread
+				 * to terminate immediately.
+				 */
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
+				/*
+				 * we need to join with the reading thread
+				 * at first and just then return failure
+				 */
+				function_retval = 29;
+				goto thread_joining;
+			}
 			if (stsw_shti_ukkonen_prolong_suffixes(variation,
 						&starting_position, i,
 						&active_index, &active_node,
@@ -1513,8 +1524,6 @@ int stsw_shti_create_ukkonen (FILE *stream,
 						"the suffixes to end "
 						"at the position %zu. "
 						"Exiting.\n", i);
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1524,12 +1533,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1601,8 +1607,6 @@ int stsw_shti_create_ukkonen (FILE *stream,
 					"%zu. Exiting.\n",
 					tfsw->ap_window_begin,
 					tfsw->ap_window_end);
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
 			/*
 			 * There was an error, so we need to terminate
 			 * the reading thread, if it is still running.
@@ -1612,12 +1616,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 			 * flag to force the reading thread
 			 * to terminate immediately.
 			 */
-			sd.reading_finished = 1;
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
 			/*
-			 * the end of the critical section
-			 *
 			 * we need to join with the reading thread
 			 * at first and just then return failure
 			 */
@@ -1641,6 +1642,31 @@ int stsw_shti_create_ukkonen (FILE *stream,
 		 * So, it does not change here and we don't
 		 * have to worry about adjusting it at all.
 		 */
+		if ((benchmark == 3) && (stsw_shti_lz77_factor(i,
+					ending_position, &lz,
+					tfsw, stsw) > 0)) {
+			fprintf(stderr,	"Could not factorize "
+					"the text just before "
+					"the position %zu. "
+					"Exiting.\n", i);
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 30;
+			goto thread_joining;
+		}
 		if (stsw_shti_ukkonen_prolong_suffixes(variation,
 					&starting_position, i,
 					&active_index, &active_node,
@@ -1649,8 +1675,6 @@ int stsw_shti_create_ukkonen (FILE *stream,
 					"the suffixes to end "
 					"at the position %zu. "
 					"Exiting.\n", i);
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
 			/*
 			 * There was an error, so we need to terminate
 			 * the reading thread, if it is still running.
@@ -1660,12 +1684,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 			 * flag to force the reading thread
 			 * to terminate immediately.
 			 */
-			sd.reading_finished = 1;
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
 			/*
-			 * the end of the critical section
-			 *
 			 * we need to join with the reading thread
 			 * at first and just then return failure
 			 */
@@ -1749,28 +1770,19 @@ int stsw_shti_create_ukkonen (FILE *stream,
 		if (tfsw->elm_method == 1) {
 			/*
 			 * We set the appropriate block flag.
-			 * Note that we can safely do it outside of
-			 * the critical section, because despite that
-			 * we are modifying the shared data,
-			 * the modifications we are making
-			 * do not influence the behaviour
-			 * of the reading thread.
+			 * The reading thread keeps waiting for this block,
+			 * because its status is still not unknown.
 			 */
-			tfsw->sw_block_flags[tfsw->sw_mrp_block] =
-				BLOCK_STATUS_STILL_IN_USE;
+			sd_set_block_status(tfsw->sw_mrp_block,
+				BLOCK_STATUS_STILL_IN_USE, &sd);
 		} else {
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
-			/* we set the appropriate block flag */
-			tfsw->sw_block_flags[tfsw->sw_mrp_block] =
-				BLOCK_STATUS_UNKNOWN;
 			/*
-			 * We signal that the status of the most recently
-			 * processed block has changed.
+			 * We set the appropriate block flag
+			 * and we wake up the reading thread,
+			 * if it is waiting for this block.
 			 */
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
-			/* the end of the critical section */
+			sd_set_block_status(tfsw->sw_mrp_block,
+				BLOCK_STATUS_UNKNOWN, &sd);
 		}
 		++blocks_processed;
 		if (verbosity_level > 0) {
@@ -1779,11 +1791,66 @@ int stsw_shti_create_ukkonen (FILE *stream,
 					tfsw->sw_mrp_block,
 					blocks_processed);
 		}
+		/* the bounded step of the compaction of the table tbranch */
+		if (stsw_shti_compact_tbranch(verbosity_level, &active_node,
+					tfsw, stsw) > 0) {
+			fprintf(stderr, "Error: The compaction "
+					"of the table tbranch "
+					"has failed. Exiting!\n");
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 38;
+			goto thread_joining;
+		}
+		if (block_metrics_record(ending_position - 1 -
+					block_to_process *
+					tfsw->sw_block_size,
+					stsw->edges, stsw->branching_nodes,
+					stsw->tedge_size, stsw->tbranch_size,
+					stsw->tbdeleted_records,
+					sd_wait_time(1, &sd),
+					sd_wait_time(0, &sd),
+					bm) > 0) {
+			fprintf(stderr, "Error: Could not record "
+					"the metrics of the processed block. "
+					"Exiting!\n");
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 35;
+			goto thread_joining;
+		}
 		/* if the traversal type of benchmark has been requested */
 		if (benchmark == 2) {
-			fprintf(stream, "\nIntermediate suffix tree "
-					"traversal:\n");
-			fprintf(stream, "The suffix tree is built over "
+			traversal_output_note(stream, traversal_format,
+					"\nIntermediate suffix tree "
+					"traversal:\n"
+					"The suffix tree is built over "
 					"the %zu characters,\n"
 					"starting at the %zu.th "
 					"character of the input "
@@ -1796,12 +1863,11 @@ int stsw_shti_create_ukkonen (FILE *stream,
 			 */
 			if (stsw_shti_traverse(verbosity_level, stream,
 						traversal_type,
+						traversal_format,
 						tfsw, stsw) != 0) {
 				fprintf(stderr, "Error: The intermediate "
 						"suffix tree traversal "
 						"has failed. Exiting!\n");
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1811,12 +1877,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1844,8 +1907,6 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				fprintf(stderr, "Error: The batch update "
 						"of the edge labels "
 						"has failed. Exiting!\n");
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1855,12 +1916,9 @@ int stsw_shti_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1890,39 +1948,32 @@ int stsw_shti_create_ukkonen (FILE *stream,
 					block_to_release -
 					tfsw->ap_scale_factor;
 			}
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
-			/* we set the appropriate block flags */
+			/*
+			 * We set the appropriate block flags.
+			 * Each of them wakes up the reading thread,
+			 * if it is waiting for the respective block.
+			 */
 			if (block_to_release <= tfsw->sw_mrp_block) {
 				for (; block_to_release <= tfsw->sw_mrp_block;
 						++block_to_release) {
-					tfsw->sw_block_flags[
-						block_to_release] =
-						BLOCK_STATUS_UNKNOWN;
+					sd_set_block_status(block_to_release,
+						BLOCK_STATUS_UNKNOWN, &sd);
 				}
 			} else { /* block_to_release > tfsw->sw_mrp_block */
 				for (; block_to_release < tfsw->sw_blocks;
 						++block_to_release) {
-					tfsw->sw_block_flags[
-						block_to_release] =
-						BLOCK_STATUS_UNKNOWN;
+					sd_set_block_status(block_to_release,
+						BLOCK_STATUS_UNKNOWN, &sd);
 				}
 				/* here, block_to_release == tfsw->sw_blocks */
 				for (block_to_release = 0;
 						block_to_release <=
 						tfsw->sw_mrp_block;
 						++block_to_release) {
-					tfsw->sw_block_flags[
-						block_to_release] =
-						BLOCK_STATUS_UNKNOWN;
+					sd_set_block_status(block_to_release,
+						BLOCK_STATUS_UNKNOWN, &sd);
 				}
 			}
-			/*
-			 * We signal that the statuses of the blocks,
-			 * which have previously been still in use has changed.
-			 */
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
 		}
 	}
 thread_joining:
@@ -1930,13 +1981,10 @@ thread_joining:
 		printf("Thread joining begins\n");
 	}
 	/* we try to join with the reading thread */
-	pthread_join(reader, &thread_retval);
-	/* deallocation of the mutex attributes */
-	pthread_mutexattr_destroy(&mutex_attributes);
-	/* deallocation of the mutex itself */
-	pthread_mutex_destroy(&sd.mx);
-	/* deallocation of the condition variable */
-	pthread_cond_destroy(&sd.cv);
+	stream_thread_join(&reader, &thread_retval);
+	if (verbosity_level > 0) {
+		sd_print_wait_counters(&sd);
+	}
 	/* now we need to check for possible errors and return if necessary */
 	if (thread_retval != 0) {
 		fprintf(stderr, "Error: The reading thread "
@@ -2067,6 +2115,15 @@ thread_joining:
 		 * of the sliding window as well
 		 */
 		++tfsw->ap_window_size;
+		if ((benchmark == 3) && (stsw_shti_lz77_factor(i,
+					ending_position, &lz,
+					tfsw, stsw) > 0)) {
+			fprintf(stderr,	"Could not factorize "
+					"the text just before "
+					"the position %zu. "
+					"Exiting.\n", i);
+			return (31);
+		}
 		if (stsw_shti_ukkonen_prolong_suffixes(variation,
 					&starting_position, i,
 					&active_index, &active_node,
@@ -2098,6 +2155,18 @@ thread_joining:
 		max_branching_nodes = stsw->branching_nodes;
 		max_brn_ap_bti = ap_window_begin_text_idx;
 	}
+	if (block_metrics_record(ending_position - 1,
+				stsw->edges, stsw->branching_nodes,
+				stsw->tedge_size, stsw->tbranch_size,
+				stsw->tbdeleted_records,
+				/* there is no reading thread */
+				0ULL, 0ULL,
+				bm) > 0) {
+		fprintf(stderr, "Error: Could not record "
+				"the metrics of the initial blocks. "
+				"Exiting!\n");
+		return (36);
+	}
 	/*
 	 * checking the return value from the latest call
 	 * to the text_file_read_blocks function
@@ -2111,16 +2180,17 @@ thread_joining:
 	}
 	/* if the traversal type of benchmark has been requested */
 	if (benchmark == 2) {
-		fprintf(stream, "Initial suffix tree traversal:\n");
-		fprintf(stream, "The suffix tree is built over the initial "
-			"%zu characters\nof the input text.\n\n",
-			stsw->tleaf_last - stsw->tleaf_first + 1);
+		traversal_output_note(stream, traversal_format,
+				"Initial suffix tree traversal:\n"
+				"The suffix tree is built over the initial "
+				"%zu characters\nof the input text.\n\n",
+				stsw->tleaf_last - stsw->tleaf_first + 1);
 		/*
 		 * we traverse the suffix tree here,
 		 * because it has just grown to its maximum size
 		 */
 		if (stsw_shti_traverse(verbosity_level, stream, traversal_type,
-					tfsw, stsw) != 0) {
+					traversal_format, tfsw, stsw) != 0) {
 			fprintf(stderr, "Error: The initial suffix tree "
 					"traversal has failed. Exiting!\n");
 			return (18);
@@ -2254,6 +2324,15 @@ thread_joining:
 			 * So, it does not change here and we don't
 			 * have to worry about adjusting it at all.
 			 */
+			if ((benchmark == 3) && (stsw_shti_lz77_factor(i,
+						ending_position, &lz,
+						tfsw, stsw) > 0)) {
+				fprintf(stderr,	"Could not factorize "
+						"the text just before "
+						"the position %zu. "
+						"Exiting.\n", i);
+				return (32);
+			}
 			if (stsw_shti_ukkonen_prolong_suffixes(variation,
 						&starting_position, i,
 						&active_index, &active_node,
@@ -2348,6 +2427,15 @@ thread_joining:
 		 * So, it does not change here and we don't
 		 * have to worry about adjusting it at all.
 		 */
+		if ((benchmark == 3) && (stsw_shti_lz77_factor(i,
+					ending_position, &lz,
+					tfsw, stsw) > 0)) {
+			fprintf(stderr,	"Could not factorize "
+					"the text just before "
+					"the position %zu. "
+					"Exiting.\n", i);
+			return (33);
+		}
 		if (stsw_shti_ukkonen_prolong_suffixes(variation,
 					&starting_position, i,
 					&active_index, &active_node,
@@ -2433,11 +2521,34 @@ thread_joining:
 					tfsw->sw_mrp_block,
 					blocks_processed);
 		}
+		/* the bounded step of the compaction of the table tbranch */
+		if (stsw_shti_compact_tbranch(verbosity_level, &active_node,
+					tfsw, stsw) > 0) {
+			fprintf(stderr, "Error: The compaction "
+					"of the table tbranch "
+					"has failed. Exiting!\n");
+			return (39);
+		}
+		if (block_metrics_record(ending_position - 1 -
+					block_to_process *
+					tfsw->sw_block_size,
+					stsw->edges, stsw->branching_nodes,
+					stsw->tedge_size, stsw->tbranch_size,
+					stsw->tbdeleted_records,
+					/* there is no reading thread */
+					0ULL, 0ULL,
+					bm) > 0) {
+			fprintf(stderr, "Error: Could not record "
+					"the metrics of the processed block. "
+					"Exiting!\n");
+			return (37);
+		}
 		/* if the traversal type of benchmark has been requested */
 		if (benchmark == 2) {
-			fprintf(stream, "\nIntermediate suffix tree "
-					"traversal:\n");
-			fprintf(stream, "The suffix tree is built over "
+			traversal_output_note(stream, traversal_format,
+					"\nIntermediate suffix tree "
+					"traversal:\n"
+					"The suffix tree is built over "
 					"the %zu characters,\n"
 					"starting at the %zu.th "
 					"character of the input "
@@ -2450,6 +2561,7 @@ thread_joining:
 			 */
 			if (stsw_shti_traverse(verbosity_level, stream,
 						traversal_type,
+						traversal_format,
 						tfsw, stsw) != 0) {
 				fprintf(stderr, "Error: The intermediate "
 						"suffix tree traversal "
@@ -2673,5 +2785,8 @@ final_part:
 			stsw->hs->allocated_size +
 			(stsw->max_tbdeleted_index + 1) *
 			sizeof (unsigned_integral_type));
+	if (benchmark == 3) {
+		lz77_print_stats(tfsw, &lz);
+	}
 	return (0);
 }
@@ -26,6 +26,7 @@
  * using the implementation type SHTI with backward pointers.
  */
 #include "stsw_shti_common.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <limits.h>
@@ -102,7 +103,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * We allocate and clear the memory for the hash settings.
 	 * To achieve it, we simply use calloc instead of malloc.
 	 */
-	stsw->hs = calloc(stsw->hs_size, (size_t)(1));
+	stsw->hs = arena_calloc(stsw->hs_size, (size_t)(1));
 	if (stsw->hs == NULL) {
 		perror("calloc(stsw->hs)");
 		/* resetting the errno */
@@ -160,7 +161,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stsw->tleaf);
+	arena_free(stsw->tleaf);
 	stsw->tleaf = NULL;
 	if (verbosity_level > 1) {
 		printf("Trying to allocate memory for tleaf:\n"
@@ -177,7 +178,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * The number of actually allocated leaf records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	stsw->tleaf = calloc(tfsw->max_ap_window_size + 1, stsw->lr_size);
+	stsw->tleaf = arena_calloc(tfsw->max_ap_window_size + 1, stsw->lr_size);
 	if (stsw->tleaf == NULL) {
 		perror("calloc(tleaf)");
 		/* resetting the errno */
@@ -209,7 +210,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stsw->tbranch);
+	arena_free(stsw->tbranch);
 	stsw->tbranch = NULL;
 	if (verbosity_level > 1) {
 		printf("Trying to allocate memory for tbranch:\n"
@@ -224,7 +225,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * The number of actually allocated branch records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	stsw->tbranch = calloc(unit_size + 1, stsw->br_size);
+	stsw->tbranch = arena_calloc(unit_size + 1, stsw->br_size);
 	if (stsw->tbranch == NULL) {
 		perror("calloc(tbranch)");
 		/* resetting the errno */
@@ -272,7 +273,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stsw->tbranch_deleted);
+	arena_free(stsw->tbranch_deleted);
 	stsw->tbranch_deleted = NULL;
 	if (verbosity_level > 1) {
 		printf("Trying to allocate memory for the array of indices\n"
@@ -291,7 +292,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * will be deleted. That's why the size of this array needs to be
 	 * at least as large as the maximum number of branching nodes.
 	 */
-	stsw->tbranch_deleted = calloc(unit_size,
+	stsw->tbranch_deleted = arena_calloc(unit_size,
 			sizeof (unsigned_integral_type));
 	if (stsw->tbranch_deleted == NULL) {
 		perror("calloc(tbranch_deleted)");
@@ -322,7 +323,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stsw->tedge);
+	arena_free(stsw->tedge);
 	stsw->tedge = NULL;
 	if (verbosity_level > 1) {
 		printf("Trying to allocate memory for tedge:\n"
@@ -337,7 +338,7 @@ int stsw_shti_allocate (const int verbosity_level,
 	 * The number of edge records has already been determined,
 	 * so we just use it.
 	 */
-	stsw->tedge = calloc(stsw->tedge_size, stsw->er_size);
+	stsw->tedge = arena_calloc(stsw->tedge_size, stsw->er_size);
 	if (stsw->tedge == NULL) {
 		perror("calloc(tedge)");
 		/* resetting the errno */
@@ -481,7 +482,7 @@ int stsw_shti_reallocate (const int verbosity_level,
 		 * is increased by one, because of the 0.th record,
 		 * which is never used.
 		 */
-		tmp_pointer = realloc(stsw->tbranch,
+		tmp_pointer = arena_realloc(stsw->tbranch,
 				(new_tbranch_size + 1) * stsw->br_size);
 		if (tmp_pointer == NULL) {
 			perror("realloc(tbranch)");
@@ -534,7 +535,7 @@ int stsw_shti_reallocate (const int verbosity_level,
 					sizeof (unsigned_integral_type));
 			printf(").\n");
 		}
-		tmp_pointer = realloc(stsw->tbranch_deleted,
+		tmp_pointer = arena_realloc(stsw->tbranch_deleted,
 			new_tbranch_size * sizeof (unsigned_integral_type));
 		if (tmp_pointer == NULL) {
 			perror("realloc(tbranch_deleted)");
@@ -632,6 +633,81 @@ int stsw_shti_reallocate (const int verbosity_level,
 	return (0);
 }
 
+/**
+ * A function which reallocates the memory for the suffix tree
+ * to make the table tbranch smaller. This is only possible
+ * after the compaction of the table tbranch, because none
+ * of the branching records in use, nor any of the vacant ones,
+ * may lie above the new size.
+ *
+ * @param
+ * verbosity_level	the desired level of messaging verbosity
+ * @param
+ * desired_tbranch_size	The requested size of the table tbranch
+ * 			(in the number of nodes, not including
+ * 			the leading 0.th node).
+ * @param
+ * stsw		the actual suffix tree
+ *
+ * @return	On successful reallocation, this function returns 0.
+ * 		If an error occurs, a positive error number is returned.
+ */
+int stsw_shti_shrink (const int verbosity_level,
+		size_t desired_tbranch_size,
+		suffix_tree_sliding_window_shti *stsw) {
+	void *tmp_pointer = NULL;
+	/*
+	 * The vacant records always lie below or at the highest index
+	 * in use, so it is enough to check the latter.
+	 */
+	if ((desired_tbranch_size < stsw->branching_nodes) ||
+			(desired_tbranch_size >= stsw->tbranch_size)) {
+		fprintf(stderr, "stsw_shti_shrink:\n"
+				"Error: The table tbranch of the size %zu "
+				"with %zu records in use\n"
+				"can not be shrunk to the size %zu!\n",
+				stsw->tbranch_size, stsw->branching_nodes,
+				desired_tbranch_size);
+		return (1);
+	}
+	if (verbosity_level > 1) {
+		fprintf(stderr, "\nShrinking the table tbranch "
+				"from %zu to %zu records.",
+				stsw->tbranch_size, desired_tbranch_size);
+	}
+	/*
+	 * The number of actually allocated branch records is increased by one,
+	 * because of the 0.th record, which is never used.
+	 */
+	tmp_pointer = arena_realloc(stsw->tbranch,
+			(desired_tbranch_size + 1) * stsw->br_size);
+	if (tmp_pointer == NULL) {
+		perror("realloc(tbranch)");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	} else {
+		/* at least on Mac OS X, the errno might have changed */
+		errno = 0;
+		stsw->tbranch = tmp_pointer;
+	}
+	stsw->tbranch_size = desired_tbranch_size;
+	tmp_pointer = arena_realloc(stsw->tbranch_deleted,
+		desired_tbranch_size * sizeof (unsigned_integral_type));
+	if (tmp_pointer == NULL) {
+		perror("realloc(tbranch_deleted)");
+		/* resetting the errno */
+		errno = 0;
+		return (3);
+	} else {
+		/* at least on Mac OS X, the errno might have changed */
+		errno = 0;
+		stsw->tbranch_deleted = tmp_pointer;
+	}
+	stsw->tbdeleted_size = desired_tbranch_size;
+	return (0);
+}
+
 /* supporting functions */
 
 /**
@@ -1563,6 +1639,21 @@ int stsw_shti_split_edge (signed_integral_type *parent,
 		childs_head_position = (unsigned_integral_type)
 			(stsw_shti_get_leafs_sw_offset((*child), tfsw, stsw));
 	}
+	/*
+	 * If there are no vacant positions in the table tbranch
+	 * and it has been shrunk by the compaction, it has to grow again.
+	 */
+	if ((stsw->tbdeleted_records == 0) &&
+			(stsw->branching_nodes == stsw->tbranch_size)) {
+		if (stsw_shti_reallocate(0, stsw->tbranch_size +
+					(stsw->tbranch_size >> 1),
+					(size_t)(0), tfsw, stsw) > 0) {
+			fprintf(stderr,	"stsw_shti_split_edge:\n"
+					"Error: Could not enlarge "
+					"the table tbranch!\n");
+			return (3);
+		}
+	}
 	/* if there are no vacant positions in the table tbranch */
 	if (stsw->tbdeleted_records == 0) {
 		/* we insert the new node at the end of the table tbranch */
@@ -1589,7 +1680,7 @@ int stsw_shti_split_edge (signed_integral_type *parent,
 		 * In both cases, we can not split an edge nor create
 		 * a new branching node. So, in fact, it is a failure.
 		 */
-		return (3);
+		return (4);
 	}
 	/*
 	 * This is where the implementation with backward pointers differs
@@ -1632,7 +1723,7 @@ int stsw_shti_split_edge (signed_integral_type *parent,
 				new_branching_node, 1, tfsw, stsw) != 0) {
 		fprintf(stderr,	"Error: Could not correct the old edge "
 				"to end at the new_branching_node!\n");
-		return (4);
+		return (5);
 	}
 	letter_offset = childs_head_position +
 			stsw->tbranch[new_branching_node].depth;
@@ -1650,7 +1741,7 @@ int stsw_shti_split_edge (signed_integral_type *parent,
 				"Error: Could not insert the new edge "
 				"starting at the new_branching_node\n"
 				"into the hash table!\n");
-		return (5);
+		return (6);
 	}
 	/* we set the number of children of the new branching node */
 	stsw->tbranch[new_branching_node].children = 1;
@@ -1672,7 +1763,7 @@ int stsw_shti_split_edge (signed_integral_type *parent,
 					"Error: The parent of the provided "
 					"child node (%d) is zero!\n",
 					(*child));
-			return (6);
+			return (7);
 		/* we must preserve the child's credit */
 		} else if (stsw->tbranch[(*child)].parent > 0) {
 			stsw->tbranch[(*child)].parent = new_branching_node;
@@ -1698,9 +1789,14 @@ int stsw_shti_split_edge (signed_integral_type *parent,
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
  * This function performs a simple traversal.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack
+ * together with the last visited child of each of its nodes.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversal starts
@@ -1714,18 +1810,23 @@ int stsw_shti_split_edge (signed_integral_type *parent,
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stsw		the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int stsw_shti_simple_traverse_from (FILE *stream,
+int stsw_shti_simple_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
 		const text_file_sliding_window *tfsw,
+		traversal_stack *stack,
 		const suffix_tree_sliding_window_shti *stsw) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1738,45 +1839,80 @@ int stsw_shti_simple_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	/* getting the first child of the starting_node */
-	if (stsw_shti_quick_next_child(starting_node, &child,
-			tfsw, stsw) != 0) {
-		fprintf(stderr,	"Error: The traversal of the current branch "
-				"is not possible,\nbecause we were not able "
-				"to advance to the next child of the parent "
-				"(%d)!\n", starting_node);
-		return (2);
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0,
+				stsw->tbranch[starting_node].depth) > 0) {
+		return (7);
 	}
-	parents_depth = stsw->tbranch[starting_node].depth;
-	do {
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		/*
+		 * there is quite a large overhead to move to the next child
+		 * of the current node, but it is unevitable, because of
+		 * the nature of the hash table representation.
+		 */
+		if (stsw_shti_quick_next_child(parent, &child,
+					tfsw, stsw) != 0) {
+			if (frame->child == 0) {
+				/* getting the first child has failed */
+				fprintf(stderr,	"Error: The traversal of "
+						"the current branch "
+						"is not possible,\nbecause "
+						"we were not able "
+						"to advance to the next child "
+						"of the parent (%d)!\n",
+						parent);
+				if (stack->top == 1) {
+					return (2);
+				}
+			}
+			/* all the children of this node have been visited */
+			--stack->top;
+			continue;
+		}
+		frame->child = child;
+		parents_depth = frame->depth;
 		if (child > 0) {
 			childs_depth = stsw->tbranch[child].depth;
 			childs_offset = stsw->tbranch[child].head_position;
 			if (stsw_validate_sw_offset(childs_offset,
 						tfsw) != 0) {
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_parent = abs(stsw->tbranch[child].parent);
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its branching "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (4);
+				if (stack->top == 1) {
+					return (4);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0,
+			stsw_print_edge(output, 0,
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
 					childs_offset, tfsw);
-			stsw_shti_simple_traverse_from(stream, child,
-					log10bn, log10l, tfsw, stsw);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child, 0, 0,
+						childs_depth) > 0) {
+				return (7);
+			}
 		} else { /* child < 0 */
 			if (stsw_shti_get_leafs_depth(child, (size_t *)
 						(&childs_depth), stsw) > 0) {
@@ -1787,45 +1923,52 @@ int stsw_shti_simple_traverse_from (FILE *stream,
 						"(%d).\n", child);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (5);
+				if (stack->top == 1) {
+					return (5);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_offset = stsw_shti_get_leafs_sw_offset(child,
 					tfsw, stsw);
 			childs_parent = stsw->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its leaf "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (6);
+				if (stack->top == 1) {
+					return (6);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0,
+			stsw_print_edge(output, 0,
 					(signed_integral_type)(0),
 					child, (signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
 					childs_offset, tfsw);
 		}
-		/*
-		 * there is quite a large overhead to move to the next child
-		 * of the starting_node, but it is unevitable, because of
-		 * the nature of the hash table representation.
-		 */
-	} while (stsw_shti_quick_next_child(starting_node, &child,
-			tfsw, stsw) == 0);
+	}
 	return (0);
 }
 
 /**
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack
+ * together with the last visited child of each of its nodes.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversal starts
@@ -1839,18 +1982,23 @@ int stsw_shti_simple_traverse_from (FILE *stream,
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stsw		the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int stsw_shti_traverse_from (FILE *stream,
+int stsw_shti_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
 		const text_file_sliding_window *tfsw,
+		traversal_stack *stack,
 		const suffix_tree_sliding_window_shti *stsw) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1864,43 +2012,78 @@ int stsw_shti_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	/* getting the first child of the starting_node */
-	if (stsw_shti_quick_next_child(starting_node, &child,
-			tfsw, stsw) != 0) {
-		fprintf(stderr,	"Error: The traversal of the current branch "
-				"is not possible,\nbecause we were not able "
-				"to advance to the next child of the parent "
-				"(%d)!\n", starting_node);
-		return (2);
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node, 0, 0,
+				stsw->tbranch[starting_node].depth) > 0) {
+		return (7);
 	}
-	parents_depth = stsw->tbranch[starting_node].depth;
-	do {
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		/*
+		 * there is quite a large overhead to move to the next child
+		 * of the current node, but it is unevitable, because of
+		 * the nature of the hash table representation.
+		 */
+		if (stsw_shti_quick_next_child(parent, &child,
+					tfsw, stsw) != 0) {
+			if (frame->child == 0) {
+				/* getting the first child has failed */
+				fprintf(stderr,	"Error: The traversal of "
+						"the current branch "
+						"is not possible,\nbecause "
+						"we were not able "
+						"to advance to the next child "
+						"of the parent (%d)!\n",
+						parent);
+				if (stack->top == 1) {
+					return (2);
+				}
+			}
+			/* all the children of this node have been visited */
+			--stack->top;
+			continue;
+		}
+		frame->child = child;
+		parents_depth = frame->depth;
 		if (child > 0) {
 			childs_suffix_link = stsw->tbranch[child].suffix_link;
 			childs_depth = stsw->tbranch[child].depth;
 			childs_offset = stsw->tbranch[child].head_position;
 			if (stsw_validate_sw_offset(childs_offset,
 						tfsw) != 0) {
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_parent = abs(stsw->tbranch[child].parent);
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its branching "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (4);
+				if (stack->top == 1) {
+					return (4);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0, starting_node, child,
+			stsw_print_edge(output, 0, parent, child,
 					childs_suffix_link, parents_depth,
 					childs_depth, log10bn, log10l,
 					childs_offset, tfsw);
-			stsw_shti_traverse_from(stream, child, log10bn, log10l,
-					tfsw, stsw);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child, 0, 0,
+						childs_depth) > 0) {
+				return (7);
+			}
 		} else { /* child < 0 */
 			if (stsw_shti_get_leafs_depth(child, (size_t *)
 						(&childs_depth), stsw) > 0) {
@@ -1911,34 +2094,164 @@ int stsw_shti_traverse_from (FILE *stream,
 						"(%d).\n", child);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (5);
+				if (stack->top == 1) {
+					return (5);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_offset = stsw_shti_get_leafs_sw_offset(child,
 					tfsw, stsw);
 			childs_parent = stsw->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild (%d) has a different "
 						"parent (%d)\nfrom what is "
 						"stored inside its leaf "
 						"record (%d).\n", child,
-						starting_node, childs_parent);
+						parent, childs_parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (6);
+				if (stack->top == 1) {
+					return (6);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0, starting_node, child,
+			stsw_print_edge(output, 0, parent, child,
 					0, parents_depth,
 					childs_depth, log10bn, log10l,
 					childs_offset, tfsw);
 		}
-		/*
-		 * there is quite a large overhead to move to the next child
-		 * of the starting_node, but it is unevitable, because of
-		 * the nature of the hash table representation.
-		 */
-	} while (stsw_shti_quick_next_child(starting_node, &child,
-			tfsw, stsw) == 0);
+	}
+	return (0);
+}
+
+/**
+ * A function which emits the greedy LZ77 factor starting at the character,
+ * which is just being added to the suffix tree, unless this character
+ * is still covered by the previously emitted factor.
+ * The match is the longest prefix of the text starting at this character,
+ * which can be spelled out from the root of the suffix tree.
+ * Its source is the head position of the node (or the offset of the leaf)
+ * at the end of the matching path. The edge label maintenance keeps
+ * these positions valid, so the source always precedes the factor.
+ * The match is followed by a single literal character.
+ *
+ * @param
+ * position	the position in the sliding window just after the character,
+ * 		which is just being added to the suffix tree
+ * @param
+ * ending_position	the position in the sliding window just after
+ * 			the last character, which can be used
+ * 			as the lookahead of the factorization
+ * @param
+ * lz		the factorization state
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ * @param
+ * stsw		the actual suffix tree
+ *
+ * @return	If the factor could be successfully emitted, or if it was not
+ * 		necessary to emit any, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stsw_shti_lz77_factor (size_t position,
+		size_t ending_position,
+		lz77_factorization *lz,
+		const text_file_sliding_window *tfsw,
+		const suffix_tree_sliding_window_shti *stsw) {
+	signed_integral_type parent = 1; /* we start at the root */
+	signed_integral_type child = 0;
+	/* the position of the first character of the factor */
+	size_t factor_position = 0;
+	/* the position of the next character of the factor to be matched */
+	size_t text_position = 0;
+	/* the position of the next character of the edge label to compare */
+	size_t edge_letter_index = 0;
+	/* the position of the source of the match */
+	size_t source_position = 0;
+	size_t childs_depth = 0;
+	size_t max_length = 0;
+	size_t length = 0;
+	size_t offset = 0;
+	/* if the current character is covered by the previous factor */
+	if (lz->pending > 0) {
+		--lz->pending;
+		return (0);
+	}
+	if (position == 1) {
+		factor_position = tfsw->total_window_size;
+	} else {
+		factor_position = position - 1;
+	}
+	/*
+	 * the literal following the match
+	 * has to be available in the sliding window as well
+	 */
+	max_length = ending_position - factor_position - 1;
+	text_position = factor_position;
+	/* length == stsw->tbranch[parent].depth at each iteration */
+	while ((length < max_length) &&
+			(stsw->tbranch[parent].children != 0)) {
+		if (stsw_shti_branch_once(parent, &child, text_position,
+					tfsw, stsw) != 0) {
+			break; /* no edge starts with the desired letter */
+		}
+		if (child > 0) {
+			source_position = stsw->tbranch[child].head_position;
+			childs_depth = stsw->tbranch[child].depth;
+		} else { /* child < 0 */
+			source_position = stsw_shti_get_leafs_sw_offset(child,
+					tfsw, stsw);
+			/* the leaf edges end with the active part */
+			childs_depth = tfsw->ap_window_end - source_position;
+			if (tfsw->ap_window_end <= source_position) {
+				childs_depth += tfsw->total_window_size;
+			}
+		}
+		edge_letter_index = source_position + length;
+		if (edge_letter_index > tfsw->total_window_size) {
+			edge_letter_index -= tfsw->total_window_size;
+		}
+		while ((length < childs_depth) && (length < max_length) &&
+				(tfsw->text_window[edge_letter_index] ==
+				tfsw->text_window[text_position])) {
+			++length;
+			if (edge_letter_index == tfsw->total_window_size) {
+				edge_letter_index = 1;
+			} else {
+				++edge_letter_index;
+			}
+			if (text_position == tfsw->total_window_size) {
+				text_position = 1;
+			} else {
+				++text_position;
+			}
+		}
+		/* if the match ends on this edge or in a leaf */
+		if ((length < childs_depth) || (child < 0)) {
+			break;
+		}
+		parent = child;
+	}
+	if (length > 0) {
+		offset = factor_position - source_position;
+		if (factor_position < source_position) {
+			offset += tfsw->total_window_size;
+		}
+	}
+	if (lz77_emit_factor(offset, length,
+				tfsw->text_window[text_position], lz) > 0) {
+		fprintf(stderr, "stsw_shti_lz77_factor:\n"
+				"Error: Could not emit the factor "
+				"starting at the position %zu.\n",
+				factor_position);
+		return (1);
+	}
+	/* the characters of the match have yet to be added */
+	lz->pending = length;
 	return (0);
 }
 
@@ -1955,6 +2268,9 @@ int stsw_shti_traverse_from (FILE *stream,
  * @param
  * traversal_type	the type of the traversal to perform
  * @param
+ * traversal_format	the format of the traversal output,
+ * 			either tf_text or tf_binary
+ * @param
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
@@ -1966,8 +2282,13 @@ int stsw_shti_traverse_from (FILE *stream,
 int stsw_shti_traverse (const int verbosity_level,
 		FILE *stream,
 		int traversal_type,
+		int traversal_format,
 		const text_file_sliding_window *tfsw,
 		const suffix_tree_sliding_window_shti *stsw) {
+	/* the explicit stack of the traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	/* the buffered output of the traversal */
+	traversal_output output;
 	signed_integral_type start_node = 1; /* the root */
 	/* the current number of branching nodes in the suffix tree */
 	size_t branching_nodes = stsw->branching_nodes;
@@ -2006,35 +2327,58 @@ int stsw_shti_traverse (const int verbosity_level,
 					"to the specified file.\n");
 		}
 	}
+	if (traversal_output_open(stream, traversal_format,
+				tfsw->tocode, &output) > 0) {
+		fprintf(stderr, "Error: Could not prepare "
+				"the traversal output. Exiting!\n");
+		return (4);
+	}
 	if (traversal_type == tt_detailed) {
-		fprintf(stream, "Suffix tree traversal BEGIN\n");
-		if (stsw_shti_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				tfsw->text_window,
+				tfsw->total_window_size + 1,
+				tfsw->total_window_size, &output);
+		if (stsw_shti_traverse_from(&output, start_node,
 					log10bn, log10l,
-					tfsw, stsw) > 0) {
+					tfsw, &stack, stsw) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (1);
 		}
-		fprintf(stream, "Suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else if (traversal_type == tt_simple) {
-		fprintf(stream, "Simple suffix tree traversal BEGIN\n");
-		if (stsw_shti_simple_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				tfsw->text_window,
+				tfsw->total_window_size + 1,
+				tfsw->total_window_size, &output);
+		if (stsw_shti_simple_traverse_from(&output, start_node,
 					log10bn, log10l,
-					tfsw, stsw) > 0) {
+					tfsw, &stack, stsw) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (2);
 		}
-		fprintf(stream, "Simple suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else {
 		fprintf(stderr, "Error: Unknown traversal type (%d) "
 				"Exiting!\n", traversal_type);
+		traversal_output_close(&output);
 		return (3);
 	}
+	traversal_stack_free(&stack);
+	if (traversal_output_close(&output) > 0) {
+		fprintf(stderr, "Error: Could not write "
+				"the traversal output. Exiting!\n");
+		return (5);
+	}
 	if (verbosity_level > 2) {
 		if (stream != stdout) {
 			printf("Dump complete.\n");
@@ -2076,13 +2420,13 @@ int stsw_shti_delete (const int verbosity_level,
 				"properly deallocated!\n");
 		return (2);
 	}
-	free(stsw->tedge);
+	arena_free(stsw->tedge);
 	stsw->tedge = NULL;
-	free(stsw->tbranch_deleted);
+	arena_free(stsw->tbranch_deleted);
 	stsw->tbranch_deleted = NULL;
-	free(stsw->tbranch);
+	arena_free(stsw->tbranch);
 	stsw->tbranch = NULL;
-	free(stsw->tleaf);
+	arena_free(stsw->tleaf);
 	stsw->tleaf = NULL;
 	/*
 	 * maintaining the suffix tree struct
@@ -26,6 +26,7 @@
  * using the implementation type SHTI with backward pointers.
  */
 #include "stsw_shti_ht.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <limits.h>
@@ -414,7 +415,7 @@ int stsw_shti_ht_rehash (size_t *new_size,
 		 * it is always safe to delete the NULL pointer,
 		 * so we need not to check for it
 		 */
-		free(stsw->tedge);
+		arena_free(stsw->tedge);
 		stsw->tedge = NULL;
 		/*
 		 * And now we allocate the new, cleared memory
@@ -427,7 +428,7 @@ int stsw_shti_ht_rehash (size_t *new_size,
 		 * set to NULL is equivalent to malloc,
 		 * which does not clear the memory.
 		 */
-		stsw->tedge = calloc((*new_size), sizeof (edge_record));
+		stsw->tedge = arena_calloc((*new_size), sizeof (edge_record));
 		if (stsw->tedge == NULL) {
 			perror("calloc(stsw->tedge)");
 			/* resetting the errno */
@@ -502,7 +503,7 @@ int stsw_shti_ht_rehash (size_t *new_size,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(original_tedge);
+	arena_free(original_tedge);
 	original_tedge = NULL;
 	fprintf(stderr, "Current hash table size:\n%zu cells of %zu "
 			"bytes (totalling %zu bytes, ",
@@ -870,7 +870,7 @@ int stsw_slli_ukkonen_prolong_suffixes (const int variation,
  *
  * @param
  * stream	the FILE * type stream to which the traversal progress
- * 		will be written (if requested)
+ * 		or the LZ77 factors will be written (if requested)
  * @param
  * benchmark	the requested benchmark to perform
  * @param
@@ -879,10 +879,15 @@ int stsw_slli_ukkonen_prolong_suffixes (const int variation,
  * traversal_type	the type of the suffix tree traversal,
  * 			which will be performed (if requested)
  * @param
+ * traversal_format	the format of the suffix tree traversal log
+ * @param
  * verbosity_level	The requested level of verbosity of the information
  * 			collected and displayed to the user
  * 			during the suffix tree construction and maintenance.
  * @param
+ * bm		the metrics of the processed blocks,
+ * 		which will be written (if requested)
+ * @param
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
@@ -897,7 +902,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 		const int benchmark,
 		const int variation,
 		const int traversal_type,
+		const int traversal_format,
 		const int verbosity_level,
+		block_metrics *bm,
 		text_file_sliding_window *tfsw,
 		suffix_tree_sliding_window_slli *stsw) {
 	/*
@@ -974,7 +981,7 @@ int stsw_slli_create_ukkonen (FILE *stream,
 	/* the number of the last block which has been read */
 	size_t final_block_number = 0;
 	/*
-	 * The return value from the pthread_create function
+	 * The return value from the stream_thread_create function
 	 * and from the block reading function.
 	 */
 	int retval = 0;
@@ -1004,6 +1011,8 @@ int stsw_slli_create_ukkonen (FILE *stream,
 	 * of branching nodes observed
 	 */
 	size_t max_brn_ap_bti = 0;
+	/* the state of the LZ77 factorization (if requested) */
+	lz77_factorization lz;
 /* POSIX threads-related variables */
 #ifdef STSW_USE_PTHREAD
 	/* The index of a block, which will be made available for reading. */
@@ -1020,26 +1029,8 @@ int stsw_slli_create_ukkonen (FILE *stream,
 	 * so it will never be used uninitialized.
 	 */
 	shared_data sd;
-	/*
-	 * The mutex attributes.
-	 *
-	 * We do not initialize it right here,
-	 * but we do it immediately afterwards,
-	 * so it will never be used uninitialized.
-	 */
-	pthread_mutexattr_t mutex_attributes;
-	/* initialization of the mutex attributes */
-	pthread_mutexattr_init(&mutex_attributes);
-	pthread_mutexattr_settype(&mutex_attributes, PTHREAD_MUTEX_NORMAL);
-	/* initialization of the mutex itself */
-	pthread_mutex_init(&sd.mx, &mutex_attributes);
-	/* initialization of the condition variable */
-	pthread_cond_init(&sd.cv, NULL);
 	/* initialization of the shared_data struct */
-	sd.tfsw = tfsw;
-	sd.reading_finished = 0;
-	sd.final_block_characters = 0;
-	sd.final_block_number = 0;
+	sd_init(tfsw, &sd);
 #else /* non POSIX threads-related variables */
 	size_t blocks_read = 0;
 	size_t characters_read = 0;
@@ -1082,21 +1073,26 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				"Reallocation error. Exiting.\n");
 		return (3);
 	}
+	/* if the LZ77 factorization benchmark has been requested */
+	if (benchmark == 3) {
+		/* the factorization starts together with the reading */
+		lz77_init(stream, &lz);
+	}
 #ifdef STSW_USE_PTHREAD /* the pthread part */
-	pthread_t reader; /* the reading thread */
+	stream_thread reader; /* the reading thread */
 	// FIXME: What if not even all the blocks in the active part
 	// of the sliding window will be read? What about stats then?
 	// That should be handled by the number of observations.
 	// At least one observation should always be performed -
 	// before the final part.
-	if ((retval = pthread_create(&reader, NULL,
+	if ((retval = stream_thread_create(&reader,
 				&reading_thread_function, &sd)) != 0) {
 		fprintf(stderr, "stsw_slli_create_ukkonen:\n");
 		if (errno != 0) {
-			perror("pthread_create inside");
+			perror("stream_thread_create inside");
 		}
 		errno = retval; /* retval != 0 */
-		perror("pthread_create");
+		perror("stream_thread_create");
 		/* resetting the errno */
 		errno = 0;
 		return (4);
@@ -1138,44 +1134,18 @@ int stsw_slli_create_ukkonen (FILE *stream,
 		 * than the maximum number of blocks forming
 		 * the active part of the sliding window.
 		 */
-		/* the start of the critical section */
-		pthread_mutex_lock(&sd.mx);
-		/* while the current block is not ready to be processed */
-		while (tfsw->sw_block_flags[block_to_process] !=
-				BLOCK_STATUS_READ_AND_UNPROCESSED) {
-			/* if the reading thread has not finished yet */
-			if (sd.reading_finished == 0) {
-				/*
-				 * we wait for it to signal
-				 * a block status change
-				 */
-				pthread_cond_wait(&sd.cv, &sd.mx);
-			} else {
-				/*
-				 * Otherwise we know that no more blocks
-				 * will be read, so we can safely unlock
-				 * the mutex and jump
-				 * to the thread joining part.
-				 */
-				pthread_mutex_unlock(&sd.mx);
-				goto thread_joining;
-			}
-		}
 		/*
-		 * we are still inside the critical section
-		 *
-		 * The current block is now ready to be processed!
+		 * we wait until the current block is ready to be processed
+		 * or until it is clear that no more blocks will be read
 		 */
+		if (sd_wait_for_block(block_to_process, 0, &sd) != 0) {
+			goto thread_joining;
+		}
+		/* The current block is now ready to be processed! */
 		/* if no more blocks will be read */
-		if (sd.reading_finished == 1) {
-			/*
-			 * We know that the reading thread has either
-			 * already finished or it will finish soon.
-			 * So, we can afford to keep the mutex locked
-			 * for a little longer without much worrying.
-			 *
-			 * if the current block is the last block
-			 */
+		if (sd_reading_finished(&sd) ==
+					READING_STATUS_COMPLETE) {
+			/* if the current block is the last block */
 			if (block_to_process == sd.final_block_number) {
 				/* we just process it */
 				ending_position = block_to_process *
@@ -1210,15 +1180,11 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				 */
 				tfsw->sw_block_size + 1;
 		}
-		pthread_mutex_unlock(&sd.mx);
 		/*
-		 * the end of the critical section
-		 *
 		 * Now we have the current block ready to be processed
 		 * and we know that its status can not change,
 		 * because this is the only processing thread.
-		 * So, we can end the critical section here
-		 * and continue to process the block normally.
+		 * So, we can continue to process the block normally.
 		 */
 		for (; i <= ending_position; ++i) {
 			/*
@@ -1231,6 +1197,31 @@ int stsw_slli_create_ukkonen (FILE *stream,
 			 * of the sliding window as well
 			 */
 			++tfsw->ap_window_size;
+			if ((benchmark == 3) && (stsw_slli_lz77_factor(i,
+						ending_position, &lz,
+						tfsw, stsw) > 0)) {
+				fprintf(stderr,	"Could not factorize "
+						"the text just before "
+						"the position %zu. "
+						"Exiting.\n", i);
+				/*
+				 * There was an error, so we need to terminate
+				 * the reading thread, if it is still running.
+				 * But at first, we have to wake it up,
+				 * because it might be sleeping.
+				 * We also have to raise the reading_finished
+				 * flag to force the reading thread
+				 * to terminate immediately.
+				 */
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
+				/*
+				 * we need to join with the reading thread
+				 * at first and just then return failure
+				 */
+				function_retval = 28;
+				goto thread_joining;
+			}
 			if (stsw_slli_ukkonen_prolong_suffixes(variation,
 						&starting_position, i,
 						&active_index, &active_node,
@@ -1239,8 +1230,6 @@ int stsw_slli_create_ukkonen (FILE *stream,
 						"the suffixes to end "
 						"at the position %zu. "
 						"Exiting.\n", i);
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1250,12 +1239,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1263,23 +1249,52 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				goto thread_joining;
 			}
 		}
+		if (block_metrics_record(ending_position - 1 -
+					block_to_process *
+					tfsw->sw_block_size,
+					(size_t)(0), stsw->branching_nodes,
+					(size_t)(0), stsw->tbranch_size,
+					stsw->tbdeleted_records,
+					sd_wait_time(1, &sd),
+					sd_wait_time(0, &sd),
+					bm) > 0) {
+			fprintf(stderr, "Error: Could not record "
+					"the metrics of the initial block. "
+					"Exiting!\n");
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 34;
+			goto thread_joining;
+		}
 	}
 	/* if the traversal type of benchmark has been requested */
 	if (benchmark == 2) {
-		fprintf(stream, "Initial suffix tree traversal:\n");
-		fprintf(stream, "The suffix tree is built over the initial "
-			"%zu characters\nof the input text.\n\n",
-			stsw->tleaf_last - stsw->tleaf_first + 1);
+		traversal_output_note(stream, traversal_format,
+				"Initial suffix tree traversal:\n"
+				"The suffix tree is built over the initial "
+				"%zu characters\nof the input text.\n\n",
+				stsw->tleaf_last - stsw->tleaf_first + 1);
 		/*
 		 * we traverse the suffix tree here,
 		 * because it has just grown to its maximum size
 		 */
 		if (stsw_slli_traverse(verbosity_level, stream, traversal_type,
-					tfsw, stsw) != 0) {
+					traversal_format, tfsw, stsw) != 0) {
 			fprintf(stderr, "Error: The initial suffix tree "
 					"traversal has failed. Exiting!\n");
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
 			/*
 			 * There was an error, so we need to terminate
 			 * the reading thread, if it is still running.
@@ -1289,12 +1304,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 			 * flag to force the reading thread
 			 * to terminate immediately.
 			 */
-			sd.reading_finished = 1;
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
 			/*
-			 * the end of the critical sectiom
-			 *
 			 * we need to join with the reading thread
 			 * at first and just then return failure
 			 */
@@ -1348,45 +1360,28 @@ int stsw_slli_create_ukkonen (FILE *stream,
 		if (block_to_process == tfsw->sw_blocks) {
 			block_to_process = 0;
 		}
-		/* the start of the critical section */
-		pthread_mutex_lock(&sd.mx);
-		/* while the current block is not ready to be processed */
-		while (tfsw->sw_block_flags[block_to_process] !=
-				BLOCK_STATUS_READ_AND_UNPROCESSED) {
-			/* if the reading thread has not finished yet */
-			if (sd.reading_finished == 0) {
-				/*
-				 * we wait for it to signal
-				 * a block status change
-				 */
-				pthread_cond_wait(&sd.cv, &sd.mx);
-			} else {
-				/*
-				 * Otherwise we know that no more blocks
-				 * will be read, so we can safely unlock
-				 * the mutex and jump
-				 * to the thread joining part.
-				 */
-				pthread_mutex_unlock(&sd.mx);
-				goto thread_joining;
-			}
-		}
 		/*
-		 * we are still inside the critical section
-		 *
-		 * The current block is now ready to be processed!
+		 * we wait until the current block is ready to be processed
+		 * or until it is clear that no more blocks will be read
 		 */
+		if (sd_wait_for_block(block_to_process, 0, &sd) != 0) {
+			goto thread_joining;
+		}
+		/* The current block is now ready to be processed! */
 		/* if no more blocks will be read */
-		if (sd.reading_finished == 1) {
-			/*
-			 * We know that the reading thread has either
-			 * already finished or it will finish soon.
-			 * So, we can afford to keep the mutex locked
-			 * for a little longer without much worrying.
-			 *
-			 * if the current block is the last block
-			 */
+		if (sd_reading_finished(&sd) ==
+					READING_STATUS_COMPLETE) {
+			/* if the current block is the last block */
 			if (block_to_process == sd.final_block_number) {
+				/*
+				 * If the input text ends exactly
+				 * at the block boundary, the final block
+				 * is empty and there is nothing left
+				 * to be processed.
+				 */
+				if (sd.final_block_characters == 0) {
+					goto thread_joining;
+				}
 				/* we just process it */
 				ending_position = block_to_process *
 					tfsw->sw_block_size +
@@ -1420,15 +1415,11 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				 */
 				tfsw->sw_block_size + 1;
 		}
-		pthread_mutex_unlock(&sd.mx);
 		/*
-		 * the end of the critical section
-		 *
 		 * Now we have the current block ready to be processed
 		 * and we know that its status can not change,
 		 * because this is the only processing thread.
-		 * So, we can end the critical section here
-		 * and continue to process the block normally.
+		 * So, we can continue to process the block normally.
 		 */
 		for (; i < ending_position; ++i) {
 			/* at first, we have to delete the longest suffix */
@@ -1442,8 +1433,6 @@ int stsw_slli_create_ukkonen (FILE *stream,
 						"%zu. Exiting.\n",
 						tfsw->ap_window_begin,
 						tfsw->ap_window_end);
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1453,12 +1442,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1474,6 +1460,31 @@ int stsw_slli_create_ukkonen (FILE *stream,
 			 * So, it does not change here and we don't
 			 * have to worry about adjusting it at all.
 			 */
+			if ((benchmark == 3) && (stsw_slli_lz77_factor(i,
+						ending_position, &lz,
+						tfsw, stsw) > 0)) {
+				fprintf(stderr,	"Could not factorize "
+						"the text just before "
+						"the position %zu. "
+						"Exiting.\n", i);
+				/*
+				 * There was an error, so we need to terminate
+				 * the reading thread, if it is still running.
+				 * But at first, we have to wake it up,
+				 * because it might be sleeping.
+				 * We also have to raise the reading_finished
+				 * flag to force the reading thread
+				 * to terminate immediately.
+				 */
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
+				/*
+				 * we need to join with the reading thread
+				 * at first and just then return failure
+				 */
+				function_retval = 29;
+				goto thread_joining;
+			}
 			if (stsw_slli_ukkonen_prolong_suffixes(variation,
 						&starting_position, i,
 						&active_index, &active_node,
@@ -1482,8 +1493,6 @@ int stsw_slli_create_ukkonen (FILE *stream,
 						"the suffixes to end "
 						"at the position %zu. "
 						"Exiting.\n", i);
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1493,12 +1502,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1559,8 +1565,6 @@ int stsw_slli_create_ukkonen (FILE *stream,
 					"%zu. Exiting.\n",
 					tfsw->ap_window_begin,
 					tfsw->ap_window_end);
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
 			/*
 			 * There was an error, so we need to terminate
 			 * the reading thread, if it is still running.
@@ -1570,12 +1574,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 			 * flag to force the reading thread
 			 * to terminate immediately.
 			 */
-			sd.reading_finished = 1;
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
 			/*
-			 * the end of the critical section
-			 *
 			 * we need to join with the reading thread
 			 * at first and just then return failure
 			 */
@@ -1599,6 +1600,31 @@ int stsw_slli_create_ukkonen (FILE *stream,
 		 * So, it does not change here and we don't
 		 * have to worry about adjusting it at all.
 		 */
+		if ((benchmark == 3) && (stsw_slli_lz77_factor(i,
+					ending_position, &lz,
+					tfsw, stsw) > 0)) {
+			fprintf(stderr,	"Could not factorize "
+					"the text just before "
+					"the position %zu. "
+					"Exiting.\n", i);
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 30;
+			goto thread_joining;
+		}
 		if (stsw_slli_ukkonen_prolong_suffixes(variation,
 					&starting_position, i,
 					&active_index, &active_node,
@@ -1607,8 +1633,6 @@ int stsw_slli_create_ukkonen (FILE *stream,
 					"the suffixes to end "
 					"at the position %zu. "
 					"Exiting.\n", i);
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
 			/*
 			 * There was an error, so we need to terminate
 			 * the reading thread, if it is still running.
@@ -1618,12 +1642,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 			 * flag to force the reading thread
 			 * to terminate immediately.
 			 */
-			sd.reading_finished = 1;
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
 			/*
-			 * the end of the critical section
-			 *
 			 * we need to join with the reading thread
 			 * at first and just then return failure
 			 */
@@ -1696,28 +1717,19 @@ int stsw_slli_create_ukkonen (FILE *stream,
 		if (tfsw->elm_method == 1) {
 			/*
 			 * We set the appropriate block flag.
-			 * Note that we can safely do it outside of
-			 * the critical section, because despite that
-			 * we are modifying the shared data,
-			 * the modifications we are making
-			 * do not influence the behaviour
-			 * of the reading thread.
+			 * The reading thread keeps waiting for this block,
+			 * because its status is still not unknown.
 			 */
-			tfsw->sw_block_flags[tfsw->sw_mrp_block] =
-				BLOCK_STATUS_STILL_IN_USE;
+			sd_set_block_status(tfsw->sw_mrp_block,
+				BLOCK_STATUS_STILL_IN_USE, &sd);
 		} else {
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
-			/* we set the appropriate block flag */
-			tfsw->sw_block_flags[tfsw->sw_mrp_block] =
-				BLOCK_STATUS_UNKNOWN;
 			/*
-			 * We signal that the status of the most recently
-			 * processed block has changed.
+			 * We set the appropriate block flag
+			 * and we wake up the reading thread,
+			 * if it is waiting for this block.
 			 */
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
-			/* the end of the critical section */
+			sd_set_block_status(tfsw->sw_mrp_block,
+				BLOCK_STATUS_UNKNOWN, &sd);
 		}
 		++blocks_processed;
 		if (verbosity_level > 0) {
@@ -1726,11 +1738,66 @@ int stsw_slli_create_ukkonen (FILE *stream,
 					tfsw->sw_mrp_block,
 					blocks_processed);
 		}
+		/* the bounded step of the compaction of the table tbranch */
+		if (stsw_slli_compact_tbranch(verbosity_level, &active_node,
+					tfsw, stsw) > 0) {
+			fprintf(stderr, "Error: The compaction "
+					"of the table tbranch "
+					"has failed. Exiting!\n");
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 38;
+			goto thread_joining;
+		}
+		if (block_metrics_record(ending_position - 1 -
+					block_to_process *
+					tfsw->sw_block_size,
+					(size_t)(0), stsw->branching_nodes,
+					(size_t)(0), stsw->tbranch_size,
+					stsw->tbdeleted_records,
+					sd_wait_time(1, &sd),
+					sd_wait_time(0, &sd),
+					bm) > 0) {
+			fprintf(stderr, "Error: Could not record "
+					"the metrics of the processed block. "
+					"Exiting!\n");
+			/*
+			 * There was an error, so we need to terminate
+			 * the reading thread, if it is still running.
+			 * But at first, we have to wake it up,
+			 * because it might be sleeping.
+			 * We also have to raise the reading_finished
+			 * flag to force the reading thread
+			 * to terminate immediately.
+			 */
+			sd_set_reading_finished(READING_STATUS_STOPPED,
+					&sd);
+			/*
+			 * we need to join with the reading thread
+			 * at first and just then return failure
+			 */
+			function_retval = 35;
+			goto thread_joining;
+		}
 		/* if the traversal type of benchmark has been requested */
 		if (benchmark == 2) {
-			fprintf(stream, "\nIntermediate suffix tree "
-					"traversal:\n");
-			fprintf(stream, "The suffix tree is built over "
+			traversal_output_note(stream, traversal_format,
+					"\nIntermediate suffix tree "
+					"traversal:\n"
+					"The suffix tree is built over "
 					"the %zu characters,\n"
 					"starting at the %zu.th "
 					"character of the input "
@@ -1743,12 +1810,11 @@ int stsw_slli_create_ukkonen (FILE *stream,
 			 */
 			if (stsw_slli_traverse(verbosity_level, stream,
 						traversal_type,
+						traversal_format,
 						tfsw, stsw) != 0) {
 				fprintf(stderr, "Error: The intermediate "
 						"suffix tree traversal "
 						"has failed. Exiting!\n");
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1758,12 +1824,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1791,8 +1854,6 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				fprintf(stderr, "Error: The batch update "
 						"of the edge labels "
 						"has failed. Exiting!\n");
-				/* the start of the critical section */
-				pthread_mutex_lock(&sd.mx);
 				/*
 				 * There was an error, so we need to terminate
 				 * the reading thread, if it is still running.
@@ -1802,12 +1863,9 @@ int stsw_slli_create_ukkonen (FILE *stream,
 				 * flag to force the reading thread
 				 * to terminate immediately.
 				 */
-				sd.reading_finished = 1;
-				pthread_cond_signal(&sd.cv);
-				pthread_mutex_unlock(&sd.mx);
+				sd_set_reading_finished(READING_STATUS_STOPPED,
+						&sd);
 				/*
-				 * the end of the critical section
-				 *
 				 * we need to join with the reading thread
 				 * at first and just then return failure
 				 */
@@ -1837,39 +1895,32 @@ int stsw_slli_create_ukkonen (FILE *stream,
 					block_to_release -
 					tfsw->ap_scale_factor;
 			}
-			/* the start of the critical section */
-			pthread_mutex_lock(&sd.mx);
-			/* we set the appropriate block flags */
+			/*
+			 * We set the appropriate block flags.
+			 * Each of them wakes up the reading thread,
+			 * if it is waiting for the respective block.
+			 */
 			if (block_to_release <= tfsw->sw_mrp_block) {
 				for (; block_to_release <= tfsw->sw_mrp_block;
 						++block_to_release) {
-					tfsw->sw_block_flags[
-						block_to_release] =
-						BLOCK_STATUS_UNKNOWN;
+					sd_set_block_status(block_to_release,
+						BLOCK_STATUS_UNKNOWN, &sd);
 				}
 			} else { /* block_to_release > tfsw->sw_mrp_block */
 				for (; block_to_release < tfsw->sw_blocks;
 						++block_to_release) {
-					tfsw->sw_block_flags[
-						block_to_release] =
-						BLOCK_STATUS_UNKNOWN;
+					sd_set_block_status(block_to_release,
+						BLOCK_STATUS_UNKNOWN, &sd);
 				}
 				/* here, block_to_release == tfsw->sw_blocks */
 				for (block_to_release = 0;
 						block_to_release <=
 						tfsw->sw_mrp_block;
 						++block_to_release) {
-					tfsw->sw_block_flags[
-						block_to_release] =
-						BLOCK_STATUS_UNKNOWN;
+					sd_set_block_status(block_to_release,
+						BLOCK_STATUS_UNKNOWN, &sd);
 				}
 			}
-			/*
-			 * We signal that the statuses of the blocks,
-			 * which have previously been still in use has changed.
-			 */
-			pthread_cond_signal(&sd.cv);
-			pthread_mutex_unlock(&sd.mx);
 		}
 	}
 thread_joining:
@@ -1877,13 +1928,10 @@ thread_joining:
 		printf("Thread joining begins\n");
 	}
 	/* we try to join with the reading thread */
-	pthread_join(reader, &thread_retval);
-	/* deallocation of the mutex attributes */
-	pthread_mutexattr_destroy(&mutex_attributes);
-	/* deallocation of the mutex itself */
-	pthread_mutex_destroy(&sd.mx);
-	/* deallocation of the condition variable */
-	pthread_cond_destroy(&sd.cv);
+	stream_thread_join(&reader, &thread_retval);
+	if (verbosity_level > 0) {
+		sd_print_wait_counters(&sd);
+	}
 	/* now we need to check for possible errors and return if necessary */
 	if (thread_retval != 0) {
 		fprintf(stderr, "Error: The reading thread "
@@ -2014,6 +2062,15 @@ thread_joining:
 		 * of the sliding window as well
 		 */
 		++tfsw->ap_window_size;
+		if ((benchmark == 3) && (stsw_slli_lz77_factor(i,
+					ending_position, &lz,
+					tfsw, stsw) > 0)) {
+			fprintf(stderr,	"Could not factorize "
+					"the text just before "
+					"the position %zu. "
+					"Exiting.\n", i);
+			return (31);
+		}
 		if (stsw_slli_ukkonen_prolong_suffixes(variation,
 					&starting_position, i,
 					&active_index, &active_node,
@@ -2040,6 +2097,18 @@ thread_joining:
 		max_branching_nodes = stsw->branching_nodes;
 		max_brn_ap_bti = ap_window_begin_text_idx;
 	}
+	if (block_metrics_record(ending_position - 1,
+				(size_t)(0), stsw->branching_nodes,
+				(size_t)(0), stsw->tbranch_size,
+				stsw->tbdeleted_records,
+				/* there is no reading thread */
+				0ULL, 0ULL,
+				bm) > 0) {
+		fprintf(stderr, "Error: Could not record "
+				"the metrics of the initial blocks. "
+				"Exiting!\n");
+		return (36);
+	}
 	/*
 	 * checking the return value from the latest call
 	 * to the text_file_read_blocks function
@@ -2053,16 +2122,17 @@ thread_joining:
 	}
 	/* if the traversal type of benchmark has been requested */
 	if (benchmark == 2) {
-		fprintf(stream, "Initial suffix tree traversal:\n");
-		fprintf(stream, "The suffix tree is built over the initial "
-			"%zu characters\nof the input text.\n\n",
-			stsw->tleaf_last - stsw->tleaf_first + 1);
+		traversal_output_note(stream, traversal_format,
+				"Initial suffix tree traversal:\n"
+				"The suffix tree is built over the initial "
+				"%zu characters\nof the input text.\n\n",
+				stsw->tleaf_last - stsw->tleaf_first + 1);
 		/*
 		 * we traverse the suffix tree here,
 		 * because it has just grown to its maximum size
 		 */
 		if (stsw_slli_traverse(verbosity_level, stream, traversal_type,
-					tfsw, stsw) != 0) {
+					traversal_format, tfsw, stsw) != 0) {
 			fprintf(stderr, "Error: The initial suffix tree "
 					"traversal has failed. Exiting!\n");
 			return (18);
@@ -2196,6 +2266,15 @@ thread_joining:
 			 * So, it does not change here and we don't
 			 * have to worry about adjusting it at all.
 			 */
+			if ((benchmark == 3) && (stsw_slli_lz77_factor(i,
+						ending_position, &lz,
+						tfsw, stsw) > 0)) {
+				fprintf(stderr,	"Could not factorize "
+						"the text just before "
+						"the position %zu. "
+						"Exiting.\n", i);
+				return (32);
+			}
 			if (stsw_slli_ukkonen_prolong_suffixes(variation,
 						&starting_position, i,
 						&active_index, &active_node,
@@ -2279,6 +2358,15 @@ thread_joining:
 		 * So, it does not change here and we don't
 		 * have to worry about adjusting it at all.
 		 */
+		if ((benchmark == 3) && (stsw_slli_lz77_factor(i,
+					ending_position, &lz,
+					tfsw, stsw) > 0)) {
+			fprintf(stderr,	"Could not factorize "
+					"the text just before "
+					"the position %zu. "
+					"Exiting.\n", i);
+			return (33);
+		}
 		if (stsw_slli_ukkonen_prolong_suffixes(variation,
 					&starting_position, i,
 					&active_index, &active_node,
@@ -2353,11 +2441,34 @@ thread_joining:
 					tfsw->sw_mrp_block,
 					blocks_processed);
 		}
+		/* the bounded step of the compaction of the table tbranch */
+		if (stsw_slli_compact_tbranch(verbosity_level, &active_node,
+					tfsw, stsw) > 0) {
+			fprintf(stderr, "Error: The compaction "
+					"of the table tbranch "
+					"has failed. Exiting!\n");
+			return (39);
+		}
+		if (block_metrics_record(ending_position - 1 -
+					block_to_process *
+					tfsw->sw_block_size,
+					(size_t)(0), stsw->branching_nodes,
+					(size_t)(0), stsw->tbranch_size,
+					stsw->tbdeleted_records,
+					/* there is no reading thread */
+					0ULL, 0ULL,
+					bm) > 0) {
+			fprintf(stderr, "Error: Could not record "
+					"the metrics of the processed block. "
+					"Exiting!\n");
+			return (37);
+		}
 		/* if the traversal type of benchmark has been requested */
 		if (benchmark == 2) {
-			fprintf(stream, "\nIntermediate suffix tree "
-					"traversal:\n");
-			fprintf(stream, "The suffix tree is built over "
+			traversal_output_note(stream, traversal_format,
+					"\nIntermediate suffix tree "
+					"traversal:\n"
+					"The suffix tree is built over "
 					"the %zu characters,\n"
 					"starting at the %zu.th "
 					"character of the input "
@@ -2370,6 +2481,7 @@ thread_joining:
 			 */
 			if (stsw_slli_traverse(verbosity_level, stream,
 						traversal_type,
+						traversal_format,
 						tfsw, stsw) != 0) {
 				fprintf(stderr, "Error: The intermediate "
 						"suffix tree traversal "
@@ -2590,5 +2702,8 @@ final_part:
 			 */
 			(stsw->max_tbdeleted_index + 1) *
 			sizeof (unsigned_integral_type));
+	if (benchmark == 3) {
+		lz77_print_stats(tfsw, &lz);
+	}
 	return (0);
 }
@@ -26,6 +26,7 @@
  * using the implementation type SLLI with backward pointers.
  */
 #include "stsw_slli_common.h"
+#include "arena.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -85,7 +86,7 @@ int stsw_slli_allocate (const int verbosity_level,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stsw->tleaf);
+	arena_free(stsw->tleaf);
 	stsw->tleaf = NULL;
 	if (verbosity_level > 1) {
 		printf("Trying to allocate memory for tleaf:\n"
@@ -102,7 +103,7 @@ int stsw_slli_allocate (const int verbosity_level,
 	 * The number of actually allocated leaf records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	stsw->tleaf = calloc(tfsw->max_ap_window_size + 1, stsw->lr_size);
+	stsw->tleaf = arena_calloc(tfsw->max_ap_window_size + 1, stsw->lr_size);
 	if (stsw->tleaf == NULL) {
 		perror("calloc(tleaf)");
 		/* resetting the errno */
@@ -134,7 +135,7 @@ int stsw_slli_allocate (const int verbosity_level,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stsw->tbranch);
+	arena_free(stsw->tbranch);
 	stsw->tbranch = NULL;
 	if (verbosity_level > 1) {
 		printf("Trying to allocate memory for tbranch:\n"
@@ -149,7 +150,7 @@ int stsw_slli_allocate (const int verbosity_level,
 	 * The number of actually allocated branch records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	stsw->tbranch = calloc(unit_size + 1, stsw->br_size);
+	stsw->tbranch = arena_calloc(unit_size + 1, stsw->br_size);
 	if (stsw->tbranch == NULL) {
 		perror("calloc(tbranch)");
 		/* resetting the errno */
@@ -199,7 +200,7 @@ int stsw_slli_allocate (const int verbosity_level,
 	 * it is always safe to delete the NULL pointer,
 	 * so we need not to check for it
 	 */
-	free(stsw->tbranch_deleted);
+	arena_free(stsw->tbranch_deleted);
 	stsw->tbranch_deleted = NULL;
 	if (verbosity_level > 1) {
 		printf("Trying to allocate memory for the array of indices\n"
@@ -218,7 +219,7 @@ int stsw_slli_allocate (const int verbosity_level,
 	 * will be deleted. That's why the size of this array needs to be
 	 * at least as large as the maximum number of branching nodes.
 	 */
-	stsw->tbranch_deleted = calloc(unit_size,
+	stsw->tbranch_deleted = arena_calloc(unit_size,
 			sizeof (unsigned_integral_type));
 	if (stsw->tbranch_deleted == NULL) {
 		perror("calloc(tbranch_deleted)");
@@ -350,7 +351,7 @@ int stsw_slli_reallocate (const int verbosity_level,
 	 * The number of actually allocated branch records is increased by one,
 	 * because of the 0.th record, which is never used.
 	 */
-	tmp_pointer = realloc(stsw->tbranch,
+	tmp_pointer = arena_realloc(stsw->tbranch,
 			(new_tbranch_size + 1) * stsw->br_size);
 	if (tmp_pointer == NULL) {
 		perror("realloc(tbranch)");
@@ -403,7 +404,7 @@ int stsw_slli_reallocate (const int verbosity_level,
 				sizeof (unsigned_integral_type));
 		printf(").\n");
 	}
-	tmp_pointer = realloc(stsw->tbranch_deleted,
+	tmp_pointer = arena_realloc(stsw->tbranch_deleted,
 		new_tbranch_size * sizeof (unsigned_integral_type));
 	if (tmp_pointer == NULL) {
 		perror("realloc(tbranch_deleted)");
@@ -432,6 +433,81 @@ int stsw_slli_reallocate (const int verbosity_level,
 	return (0);
 }
 
+/**
+ * A function which reallocates the memory for the suffix tree
+ * to make the table tbranch smaller. This is only possible
+ * after the compaction of the table tbranch, because none
+ * of the branching records in use, nor any of the vacant ones,
+ * may lie above the new size.
+ *
+ * @param
+ * verbosity_level	the desired level of messaging verbosity
+ * @param
+ * desired_tbranch_size	The requested size of the table tbranch
+ * 			(in the number of nodes, not including
+ * 			the leading 0.th node).
+ * @param
+ * stsw		the actual suffix tree
+ *
+ * @return	On successful reallocation, this function returns 0.
+ * 		If an error occurs, a positive error number is returned.
+ */
+int stsw_slli_shrink (const int verbosity_level,
+		size_t desired_tbranch_size,
+		suffix_tree_sliding_window_slli *stsw) {
+	void *tmp_pointer = NULL;
+	/*
+	 * The vacant records always lie below or at the highest index
+	 * in use, so it is enough to check the latter.
+	 */
+	if ((desired_tbranch_size < stsw->branching_nodes) ||
+			(desired_tbranch_size >= stsw->tbranch_size)) {
+		fprintf(stderr, "stsw_slli_shrink:\n"
+				"Error: The table tbranch of the size %zu "
+				"with %zu records in use\n"
+				"can not be shrunk to the size %zu!\n",
+				stsw->tbranch_size, stsw->branching_nodes,
+				desired_tbranch_size);
+		return (1);
+	}
+	if (verbosity_level > 1) {
+		fprintf(stderr, "\nShrinking the table tbranch "
+				"from %zu to %zu records.",
+				stsw->tbranch_size, desired_tbranch_size);
+	}
+	/*
+	 * The number of actually allocated branch records is increased by one,
+	 * because of the 0.th record, which is never used.
+	 */
+	tmp_pointer = arena_realloc(stsw->tbranch,
+			(desired_tbranch_size + 1) * stsw->br_size);
+	if (tmp_pointer == NULL) {
+		perror("realloc(tbranch)");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	} else {
+		/* at least on Mac OS X, the errno might have changed */
+		errno = 0;
+		stsw->tbranch = tmp_pointer;
+	}
+	stsw->tbranch_size = desired_tbranch_size;
+	tmp_pointer = arena_realloc(stsw->tbranch_deleted,
+		desired_tbranch_size * sizeof (unsigned_integral_type));
+	if (tmp_pointer == NULL) {
+		perror("realloc(tbranch_deleted)");
+		/* resetting the errno */
+		errno = 0;
+		return (3);
+	} else {
+		/* at least on Mac OS X, the errno might have changed */
+		errno = 0;
+		stsw->tbranch_deleted = tmp_pointer;
+	}
+	stsw->tbdeleted_size = desired_tbranch_size;
+	return (0);
+}
+
 /* supporting functions */
 
 /**
@@ -1670,6 +1746,21 @@ int stsw_slli_split_edge (signed_integral_type *parent,
 				"Error: Invalid number of child (0)!\n");
 		return (2); /* invalid number of child */
 	}
+	/*
+	 * If there are no vacant positions in the table tbranch
+	 * and it has been shrunk by the compaction, it has to grow again.
+	 */
+	if ((stsw->tbdeleted_records == 0) &&
+			(stsw->branching_nodes == stsw->tbranch_size)) {
+		if (stsw_slli_reallocate(0, stsw->tbranch_size +
+					(stsw->tbranch_size >> 1),
+					tfsw, stsw) > 0) {
+			fprintf(stderr,	"stsw_slli_split_edge:\n"
+					"Error: Could not enlarge "
+					"the table tbranch!\n");
+			return (3);
+		}
+	}
 	/* if there are no vacant positions in the table tbranch */
 	if (stsw->tbdeleted_records == 0) {
 		/* we insert the new node at the end of the table tbranch */
@@ -1696,7 +1787,7 @@ int stsw_slli_split_edge (signed_integral_type *parent,
 		 * In both cases, we can not split an edge nor create
 		 * a new branching node. So, in fact, it is a failure.
 		 */
-		return (3);
+		return (4);
 	/*
 	 * the negative value of the last_match_position means that
 	 * the mismatching character in the sliding window was "larger"
@@ -1779,7 +1870,7 @@ int stsw_slli_split_edge (signed_integral_type *parent,
 					"Error: The parent of the provided "
 					"child node (%d) is zero!\n",
 					(*child));
-			return (4);
+			return (5);
 		/* we must preserve the child's credit */
 		} else if (stsw->tbranch[(*child)].parent > 0) {
 			stsw->tbranch[(*child)].parent = new_branching_node;
@@ -1818,9 +1909,13 @@ int stsw_slli_split_edge (signed_integral_type *parent,
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
  * This function performs a simple traversal.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversal starts
@@ -1834,18 +1929,23 @@ int stsw_slli_split_edge (signed_integral_type *parent,
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stsw		the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int stsw_slli_simple_traverse_from (FILE *stream,
+int stsw_slli_simple_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
 		const text_file_sliding_window *tfsw,
+		traversal_stack *stack,
 		const suffix_tree_sliding_window_slli *stsw) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1858,42 +1958,65 @@ int stsw_slli_simple_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	child = stsw->tbranch[starting_node].first_child;
-	parents_depth = stsw->tbranch[starting_node].depth;
-	while (child != 0) {
-		if (child > 0) {
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node,
+				stsw->tbranch[starting_node].first_child,
+				0, stsw->tbranch[starting_node].depth) > 0) {
+		return (6);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		parents_depth = frame->depth;
+		if (child == 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+		} else if (child > 0) {
 			childs_depth = stsw->tbranch[child].depth;
 			childs_offset = stsw->tbranch[child].head_position;
 			if (stsw_validate_sw_offset(childs_offset,
 						tfsw) != 0) {
-				return (2);
+				if (stack->top == 1) {
+					return (2);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_parent = abs(stsw->tbranch[child].parent);
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild's parent as stored "
 						"in the child node (%d)\n"
 						"is not the same as "
 						"the actual parent (%d).\n",
-						childs_parent, starting_node);
+						childs_parent, parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0,
+			/*
+			 * there would be some overhead if we called
+			 * the next child function, so we do it simply
+			 */
+			frame->child = stsw->tbranch[child].branch_brother;
+			stsw_print_edge(output, 0,
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					(signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
 					childs_offset, tfsw);
-			stsw_slli_simple_traverse_from(stream, child,
-					log10bn, log10l, tfsw, stsw);
-			/*
-			 * there would be some overhead if we called
-			 * the next child function, so we do it simply
-			 */
-			child = stsw->tbranch[child].branch_brother;
+			/* descending to the child */
+			if (traversal_stack_push(stack, child,
+					stsw->tbranch[child].first_child,
+					0, childs_depth) > 0) {
+				return (6);
+			}
 		} else { /* child < 0 */
 			if (stsw_slli_get_leafs_depth(child, (size_t *)
 						(&childs_depth), stsw) > 0) {
@@ -1904,33 +2027,41 @@ int stsw_slli_simple_traverse_from (FILE *stream,
 						"(%d).\n", child);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (4);
+				if (stack->top == 1) {
+					return (4);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_offset = stsw_slli_get_leafs_sw_offset(child,
 					tfsw, stsw);
 			childs_parent = stsw->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild's parent as stored "
 						"in the child node (%d)\n"
 						"is not the same as "
 						"the actual parent (%d).\n",
-						childs_parent, starting_node);
+						childs_parent, parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (5);
+				if (stack->top == 1) {
+					return (5);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0,
+			/*
+			 * there would be some overhead if we called
+			 * the next child function, so we do it simply
+			 */
+			frame->child = stsw->tleaf[-child].next_brother;
+			stsw_print_edge(output, 0,
 					(signed_integral_type)(0),
 					child, (signed_integral_type)(0),
 					parents_depth,
 					childs_depth, log10bn, log10l,
 					childs_offset, tfsw);
-			/*
-			 * there would be some overhead if we called
-			 * the next child function, so we do it simply
-			 */
-			child = stsw->tleaf[-child].next_brother;
 		}
 	}
 	return (0);
@@ -1939,9 +2070,13 @@ int stsw_slli_simple_traverse_from (FILE *stream,
 /**
  * A function which traverses and prints the suffix tree
  * while starting from the given node.
+ * The traversal is iterative. The path from the starting node
+ * to the node currently being visited is kept on the explicit stack.
+ * If a child of some node turns out to be inconsistent,
+ * the traversal of the children of that node is terminated.
  *
  * @param
- * stream	the FILE * type stream to which the traversal progress
+ * output	the buffered output, to which the traversal progress
  * 		will be written
  * @param
  * starting_node	the node from which the traversal starts
@@ -1955,18 +2090,23 @@ int stsw_slli_simple_traverse_from (FILE *stream,
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
+ * stack	the explicit stack to be used by the traversal
+ * @param
  * stsw		the actual suffix tree which will be traversed
  *
  * @return	If we could successfully traverse and print the suffix tree
  * 		and if we could start from the given node, 0 is returned.
  * 		In case of an error, a positive error number is returned.
  */
-int stsw_slli_traverse_from (FILE *stream,
+int stsw_slli_traverse_from (traversal_output *output,
 		signed_integral_type starting_node,
 		size_t log10bn,
 		size_t log10l,
 		const text_file_sliding_window *tfsw,
+		traversal_stack *stack,
 		const suffix_tree_sliding_window_slli *stsw) {
+	traversal_frame *frame = NULL;
+	signed_integral_type parent = 0;
 	signed_integral_type child = 0;
 	/* the parent of the child as stored in the child node */
 	signed_integral_type childs_parent = 0;
@@ -1980,40 +2120,63 @@ int stsw_slli_traverse_from (FILE *stream,
 				"is %d!", starting_node);
 		return (1);
 	}
-	child = stsw->tbranch[starting_node].first_child;
-	parents_depth = stsw->tbranch[starting_node].depth;
-	while (child != 0) {
-		if (child > 0) {
+	stack->top = 0;
+	if (traversal_stack_push(stack, starting_node,
+				stsw->tbranch[starting_node].first_child,
+				0, stsw->tbranch[starting_node].depth) > 0) {
+		return (6);
+	}
+	while (stack->top > 0) {
+		frame = stack->frames + stack->top - 1;
+		parent = frame->node;
+		child = frame->child;
+		parents_depth = frame->depth;
+		if (child == 0) {
+			/* all the children of this node have been visited */
+			--stack->top;
+		} else if (child > 0) {
 			childs_suffix_link = stsw->tbranch[child].suffix_link;
 			childs_depth = stsw->tbranch[child].depth;
 			childs_offset = stsw->tbranch[child].head_position;
 			if (stsw_validate_sw_offset(childs_offset,
 						tfsw) != 0) {
-				return (2);
+				if (stack->top == 1) {
+					return (2);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_parent = abs(stsw->tbranch[child].parent);
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild's parent as stored "
 						"in the child node (%d)\n"
 						"is not the same as "
 						"the actual parent (%d).\n",
-						childs_parent, starting_node);
+						childs_parent, parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (3);
+				if (stack->top == 1) {
+					return (3);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0, starting_node, child,
-					childs_suffix_link, parents_depth,
-					childs_depth, log10bn, log10l,
-					childs_offset, tfsw);
-			stsw_slli_traverse_from(stream, child, log10bn, log10l,
-					tfsw, stsw);
 			/*
 			 * there would be some overhead if we called
 			 * the next child function, so we do it simply
 			 */
-			child = stsw->tbranch[child].branch_brother;
+			frame->child = stsw->tbranch[child].branch_brother;
+			stsw_print_edge(output, 0, parent, child,
+					childs_suffix_link, parents_depth,
+					childs_depth, log10bn, log10l,
+					childs_offset, tfsw);
+			/* descending to the child */
+			if (traversal_stack_push(stack, child,
+					stsw->tbranch[child].first_child,
+					0, childs_depth) > 0) {
+				return (6);
+			}
 		} else { /* child < 0 */
 			if (stsw_slli_get_leafs_depth(child, (size_t *)
 						(&childs_depth), stsw) > 0) {
@@ -2024,36 +2187,172 @@ int stsw_slli_traverse_from (FILE *stream,
 						"(%d).\n", child);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (4);
+				if (stack->top == 1) {
+					return (4);
+				}
+				--stack->top;
+				continue;
 			}
 			childs_offset = stsw_slli_get_leafs_sw_offset(child,
 					tfsw, stsw);
 			childs_parent = stsw->tleaf[-child].parent;
-			if (childs_parent != starting_node) {
+			if (childs_parent != parent) {
 				fprintf(stderr,	"Error: Something went wrong."
 						"\nChild's parent as stored "
 						"in the child node (%d)\n"
 						"is not the same as "
 						"the actual parent (%d).\n",
-						childs_parent, starting_node);
+						childs_parent, parent);
 				fprintf(stderr,	"The traversal of this branch "
 						"is terminated here.\n");
-				return (5);
+				if (stack->top == 1) {
+					return (5);
+				}
+				--stack->top;
+				continue;
 			}
-			stsw_print_edge(stream, 0, starting_node, child,
-					0, parents_depth,
-					childs_depth, log10bn, log10l,
-					childs_offset, tfsw);
 			/*
 			 * there would be some overhead if we called
 			 * the next child function, so we do it simply
 			 */
-			child = stsw->tleaf[-child].next_brother;
+			frame->child = stsw->tleaf[-child].next_brother;
+			stsw_print_edge(output, 0, parent, child,
+					0, parents_depth,
+					childs_depth, log10bn, log10l,
+					childs_offset, tfsw);
 		}
 	}
 	return (0);
 }
 
+/**
+ * A function which emits the greedy LZ77 factor starting at the character,
+ * which is just being added to the suffix tree, unless this character
+ * is still covered by the previously emitted factor.
+ * The match is the longest prefix of the text starting at this character,
+ * which can be spelled out from the root of the suffix tree.
+ * Its source is the head position of the node (or the offset of the leaf)
+ * at the end of the matching path. The edge label maintenance keeps
+ * these positions valid, so the source always precedes the factor.
+ * The match is followed by a single literal character.
+ *
+ * @param
+ * position	the position in the sliding window just after the character,
+ * 		which is just being added to the suffix tree
+ * @param
+ * ending_position	the position in the sliding window just after
+ * 			the last character, which can be used
+ * 			as the lookahead of the factorization
+ * @param
+ * lz		the factorization state
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ * @param
+ * stsw		the actual suffix tree
+ *
+ * @return	If the factor could be successfully emitted, or if it was not
+ * 		necessary to emit any, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stsw_slli_lz77_factor (size_t position,
+		size_t ending_position,
+		lz77_factorization *lz,
+		const text_file_sliding_window *tfsw,
+		const suffix_tree_sliding_window_slli *stsw) {
+	signed_integral_type parent = 1; /* we start at the root */
+	signed_integral_type child = 0;
+	/* the position of the first character of the factor */
+	size_t factor_position = 0;
+	/* the position of the next character of the factor to be matched */
+	size_t text_position = 0;
+	/* the position of the next character of the edge label to compare */
+	size_t edge_letter_index = 0;
+	/* the position of the source of the match */
+	size_t source_position = 0;
+	size_t childs_depth = 0;
+	size_t max_length = 0;
+	size_t length = 0;
+	size_t offset = 0;
+	/* if the current character is covered by the previous factor */
+	if (lz->pending > 0) {
+		--lz->pending;
+		return (0);
+	}
+	if (position == 1) {
+		factor_position = tfsw->total_window_size;
+	} else {
+		factor_position = position - 1;
+	}
+	/*
+	 * the literal following the match
+	 * has to be available in the sliding window as well
+	 */
+	max_length = ending_position - factor_position - 1;
+	text_position = factor_position;
+	/* length == stsw->tbranch[parent].depth at each iteration */
+	while ((length < max_length) &&
+			(stsw->tbranch[parent].first_child != 0)) {
+		if (stsw_slli_quick_branch_once(parent, &child, text_position,
+					tfsw, stsw) != 0) {
+			break; /* no edge starts with the desired letter */
+		}
+		if (child > 0) {
+			source_position = stsw->tbranch[child].head_position;
+			childs_depth = stsw->tbranch[child].depth;
+		} else { /* child < 0 */
+			source_position = stsw_slli_get_leafs_sw_offset(child,
+					tfsw, stsw);
+			/* the leaf edges end with the active part */
+			childs_depth = tfsw->ap_window_end - source_position;
+			if (tfsw->ap_window_end <= source_position) {
+				childs_depth += tfsw->total_window_size;
+			}
+		}
+		edge_letter_index = source_position + length;
+		if (edge_letter_index > tfsw->total_window_size) {
+			edge_letter_index -= tfsw->total_window_size;
+		}
+		while ((length < childs_depth) && (length < max_length) &&
+				(tfsw->text_window[edge_letter_index] ==
+				tfsw->text_window[text_position])) {
+			++length;
+			if (edge_letter_index == tfsw->total_window_size) {
+				edge_letter_index = 1;
+			} else {
+				++edge_letter_index;
+			}
+			if (text_position == tfsw->total_window_size) {
+				text_position = 1;
+			} else {
+				++text_position;
+			}
+		}
+		/* if the match ends on this edge or in a leaf */
+		if ((length < childs_depth) || (child < 0)) {
+			break;
+		}
+		parent = child;
+	}
+	if (length > 0) {
+		offset = factor_position - source_position;
+		if (factor_position < source_position) {
+			offset += tfsw->total_window_size;
+		}
+	}
+	if (lz77_emit_factor(offset, length,
+				tfsw->text_window[text_position], lz) > 0) {
+		fprintf(stderr, "stsw_slli_lz77_factor:\n"
+				"Error: Could not emit the factor "
+				"starting at the position %zu.\n",
+				factor_position);
+		return (1);
+	}
+	/* the characters of the match have yet to be added */
+	lz->pending = length;
+	return (0);
+}
+
 /* handling functions */
 
 /**
@@ -2067,6 +2366,9 @@ int stsw_slli_traverse_from (FILE *stream,
  * @param
  * traversal_type	the type of the traversal to perform
  * @param
+ * traversal_format	the format of the traversal output,
+ * 			either tf_text or tf_binary
+ * @param
  * tfsw		the actual sliding window containing the text
  * 		currently used by the suffix tree
  * @param
@@ -2078,8 +2380,13 @@ int stsw_slli_traverse_from (FILE *stream,
 int stsw_slli_traverse (const int verbosity_level,
 		FILE *stream,
 		int traversal_type,
+		int traversal_format,
 		const text_file_sliding_window *tfsw,
 		const suffix_tree_sliding_window_slli *stsw) {
+	/* the explicit stack of the traversal */
+	traversal_stack stack = {NULL, 0, 0};
+	/* the buffered output of the traversal */
+	traversal_output output;
 	signed_integral_type start_node = 1; /* the root */
 	/* the current number of branching nodes in the suffix tree */
 	size_t branching_nodes = stsw->branching_nodes;
@@ -2118,35 +2425,58 @@ int stsw_slli_traverse (const int verbosity_level,
 					"to the specified file.\n");
 		}
 	}
+	if (traversal_output_open(stream, traversal_format,
+				tfsw->tocode, &output) > 0) {
+		fprintf(stderr, "Error: Could not prepare "
+				"the traversal output. Exiting!\n");
+		return (4);
+	}
 	if (traversal_type == tt_detailed) {
-		fprintf(stream, "Suffix tree traversal BEGIN\n");
-		if (stsw_slli_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				tfsw->text_window,
+				tfsw->total_window_size + 1,
+				tfsw->total_window_size, &output);
+		if (stsw_slli_traverse_from(&output, start_node,
 					log10bn, log10l,
-					tfsw, stsw) > 0) {
+					tfsw, &stack, stsw) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (1);
 		}
-		fprintf(stream, "Suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else if (traversal_type == tt_simple) {
-		fprintf(stream, "Simple suffix tree traversal BEGIN\n");
-		if (stsw_slli_simple_traverse_from(stream, start_node,
+		traversal_output_begin(traversal_type, log10bn, log10l,
+				tfsw->text_window,
+				tfsw->total_window_size + 1,
+				tfsw->total_window_size, &output);
+		if (stsw_slli_simple_traverse_from(&output, start_node,
 					log10bn, log10l,
-					tfsw, stsw) > 0) {
+					tfsw, &stack, stsw) > 0) {
 			fprintf(stderr, "Error: The traversal "
 					"from the branching node\n"
 					"was unsuccessful. "
 					"Exiting!\n");
+			traversal_output_close(&output);
+			traversal_stack_free(&stack);
 			return (2);
 		}
-		fprintf(stream, "Simple suffix tree traversal END\n");
+		traversal_output_end(traversal_type, &output);
 	} else {
 		fprintf(stderr, "Error: Unknown traversal type (%d) "
 				"Exiting!\n", traversal_type);
+		traversal_output_close(&output);
 		return (3);
 	}
+	traversal_stack_free(&stack);
+	if (traversal_output_close(&output) > 0) {
+		fprintf(stderr, "Error: Could not write "
+				"the traversal output. Exiting!\n");
+		return (5);
+	}
 	if (verbosity_level > 2) {
 		if (stream != stdout) {
 			printf("Dump complete.\n");
@@ -2179,11 +2509,11 @@ int stsw_slli_delete (const int verbosity_level,
 	if (verbosity_level > 0) {
 		printf("Deleting the suffix tree\n");
 	}
-	free(stsw->tbranch_deleted);
+	arena_free(stsw->tbranch_deleted);
 	stsw->tbranch_deleted = NULL;
-	free(stsw->tbranch);
+	arena_free(stsw->tbranch);
 	stsw->tbranch = NULL;
-	free(stsw->tleaf);
+	arena_free(stsw->tleaf);
 	stsw->tleaf = NULL;
 	/*
 	 * maintaining the suffix tree struct
@@ -28,6 +28,7 @@
 #include "stsw_slli_sw.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 /* error-checking function */
 
@@ -191,6 +192,212 @@ int stsw_slli_path_update (signed_integral_type parent,
 	return (0); /* success */
 }
 
+#ifdef	STSW_USE_PTHREAD
+/**
+ * A function which updates the edge labels on the path
+ * from the specified branching node to the root,
+ * while the other worker threads might be updating
+ * the overlapping paths at the same time.
+ *
+ * The head positions are replaced by the atomic compare and swap
+ * using the same rule as in the serial stsw_slli_path_update.
+ * Each worker which replaces a head position continues
+ * with the new one towards the root. The first worker to visit
+ * a branching node continues even if it has not replaced
+ * its head position, so that the original head position
+ * is propagated in the same way as in the serial update.
+ * Any other worker stops early, because a newer head position
+ * has already been written and will be propagated by its writer.
+ *
+ * @param
+ * parent	The branching node, from which we want
+ * 		to start the updating of the edge labels.
+ * @param
+ * new_head_position	The head position, which will be assigned to the
+ * 			provided branching node, if necessary.
+ * @param
+ * task		the part of the batch update performed
+ * 		by the calling worker
+ *
+ * @return	If we could successfully update the branch from the provided
+ * 		branching node as far as necessary,
+ * 		this function returns zero (0).
+ * 		Otherwise, in case of any error,
+ * 		a positive error number is returned.
+ */
+int stsw_slli_concurrent_path_update (signed_integral_type parent,
+		unsigned_integral_type new_head_position,
+		batch_update_task *task) {
+	const text_file_sliding_window *tfsw = task->tfsw;
+	suffix_tree_sliding_window_slli *stsw = task->stsw;
+	unsigned_integral_type head_position = 0;
+	signed_integral_type grandpa = 0;
+	int first_visit = 0;
+	int replaced = 0;
+	/* if the number of the provided branching node is not valid */
+	if (parent <= 1) {
+		fprintf(stderr,	"stsw_slli_concurrent_path_update:\n"
+				"Error: We can only start the updating "
+				"from the non-root, branching node.\n"
+				"The provided node number, however, "
+				"is %d. Exiting!\n", parent);
+		return (1); /* a failure */
+	}
+	/* from now on, parent > 1 */
+	while (1) {
+		first_visit = (__atomic_exchange_n(&task->visited[parent],
+					1, __ATOMIC_RELAXED) == 0);
+		replaced = 0;
+		head_position = __atomic_load_n(
+				&stsw->tbranch[parent].head_position,
+				__ATOMIC_RELAXED);
+		while (stsw_is_newer_head_position(head_position,
+					new_head_position,
+					task->vp_window_begin, tfsw) != 0) {
+			/*
+			 * if the compare and swap fails,
+			 * head_position is reloaded and we try again
+			 */
+			if (__atomic_compare_exchange_n(
+						&stsw->tbranch[parent].
+						head_position,
+						&head_position,
+						new_head_position, 1,
+						__ATOMIC_RELAXED,
+						__ATOMIC_RELAXED)) {
+				replaced = 1;
+				break;
+			}
+		}
+		if (replaced == 0) {
+			/*
+			 * the newer head position is propagated
+			 * by the worker which has written it
+			 */
+			if (first_visit == 0) {
+				return (0); /* success */
+			}
+			new_head_position = head_position;
+		}
+		/*
+		 * the parents of the branching nodes
+		 * are not modified during the batch update
+		 */
+		grandpa = stsw->tbranch[parent].parent;
+		if (grandpa <= 0) {
+			fprintf(stderr,	"stsw_slli_concurrent_path"
+					"_update:\nError: The parent (%d) "
+					"of the branching node (%d)\n"
+					"is not a branching node. "
+					"Exiting!\n", grandpa, parent);
+			return (2); /* a failure */
+		/* if the parent of the 'parent' node is the root */
+		} else if (grandpa == 1) {
+			return (0); /* success */
+		}
+		parent = grandpa;
+	}
+}
+
+/**
+ * A function executed by each of the worker threads
+ * performing the batch update of the edge labels.
+ *
+ * @param
+ * arg		The void * type of the pointer to the batch_update_task,
+ * 		which describes the leaves to be processed.
+ *
+ * @return	This function always returns NULL. The result is stored
+ * 		in the retval member of the provided task.
+ */
+void *stsw_slli_batch_update_worker (void *arg) {
+	batch_update_task *task = arg;
+	suffix_tree_sliding_window_slli *stsw = task->stsw;
+	size_t i = task->first_leaf;
+	size_t processed = 0;
+	unsigned_integral_type leafs_sw_offset = task->first_sw_offset;
+	for (; processed < task->leaves; ++processed) {
+		if (stsw->tleaf[i].parent > 1) {
+			if (stsw_slli_concurrent_path_update(
+						stsw->tleaf[i].parent,
+						leafs_sw_offset, task) > 0) {
+				fprintf(stderr, "stsw_slli_batch_update"
+						"_worker:\n"
+						"Error: Could not update "
+						"the edge labels\n"
+						"on the path from the leaf "
+						"(-%zu) to the root. "
+						"Exiting!\n", i);
+				task->retval = 1;
+				return (NULL);
+			}
+		}
+		if (i == stsw->tleaf_size) {
+			i = 1;
+		} else {
+			++i;
+		}
+		if (leafs_sw_offset == task->tfsw->total_window_size) {
+			leafs_sw_offset = 1;
+		} else {
+			++leafs_sw_offset;
+		}
+	}
+	return (NULL);
+}
+
+/**
+ * A function which updates the edge labels in the provided suffix tree
+ * so that they point only to the currently active part of the sliding window,
+ * using tfsw->bu_workers threads. The result is identical
+ * to the one of the serial batch update.
+ *
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ * @param
+ * stsw		the actual suffix tree
+ *
+ * @return	The same as stsw_slli_edge_labels_batch_update.
+ */
+int stsw_slli_edge_labels_parallel_batch_update (
+		const text_file_sliding_window *tfsw,
+		suffix_tree_sliding_window_slli *stsw) {
+	size_t i = stsw->tleaf_first;
+	size_t leaves = 0;
+	int retval = 0;
+	/*
+	 * The serial update stops at the first leaf, which is not
+	 * present in the current suffix tree. So we need to find it
+	 * in advance to process exactly the same leaves.
+	 */
+	while (1) {
+		if (stsw->tleaf[i].parent == 0) {
+			retval = -1;
+			break;
+		}
+		++leaves;
+		if (i == stsw->tleaf_last) {
+			break;
+		} else if (i == stsw->tleaf_size) {
+			i = 1;
+		} else {
+			++i;
+		}
+	}
+	if (batch_update_run(stsw_slli_batch_update_worker,
+				stsw->tleaf_first, leaves,
+				stsw->tleaf_size, stsw->tbranch_size,
+				stsw, tfsw) > 0) {
+		fprintf(stderr, "stsw_slli_edge_labels_parallel_batch_update:"
+				"\nError: Could not update the edge labels. "
+				"Exiting!\n");
+		return (1);
+	}
+	return (retval);
+}
+#endif
+
 /* edge label maintenance handling functions */
 
 /**
@@ -199,6 +406,8 @@ int stsw_slli_path_update (signed_integral_type parent,
  *
  * This type of the edge label maintenance has originally been
  * suggested by M. Senft.
+ * If more than one batch update thread has been requested,
+ * the update is performed in parallel.
  *
  * @param
  * tfsw		the actual sliding window containing the text
@@ -220,6 +429,12 @@ int stsw_slli_edge_labels_batch_update (const text_file_sliding_window *tfsw,
 	size_t i = stsw->tleaf_first;
 	unsigned_integral_type leafs_sw_offset =
 		(unsigned_integral_type)(tfsw->ap_window_begin);
+#ifdef	STSW_USE_PTHREAD
+	if (tfsw->bu_workers > 1) {
+		return (stsw_slli_edge_labels_parallel_batch_update(tfsw,
+					stsw));
+	}
+#endif
 	if (stsw->tleaf_first > stsw->tleaf_last) {
 		for (; i <= stsw->tleaf_size; ++i) {
 			if (stsw->tleaf[i].parent > 1) {
@@ -1061,3 +1276,135 @@ dls_end:
 	}
 	return (0);
 }
+
+/* compaction function */
+
+/**
+ * A function which performs a single bounded step of the online compaction
+ * of the table tbranch.
+ *
+ * The deleted branching records are reused in the LIFO order, which,
+ * after a long time of sliding, leaves the branching nodes in use
+ * scattered across the whole table tbranch. If more than one eighth
+ * of the branching records below the highest index in use is vacant,
+ * at most tfsw->compaction_step of the highest records are either
+ * released, if they are vacant, or moved to the smallest vacant records.
+ * Then all the references to the moved branching nodes are patched
+ * by a single pass through the tables tbranch and tleaf.
+ * If less than a quarter of the table tbranch is in use afterwards,
+ * the table tbranch is shrunk to twice the number of the records in use.
+ *
+ * @param
+ * verbosity_level	the desired level of messaging verbosity
+ * @param
+ * active_node	the current active node, which will be updated
+ * 		if it has been moved
+ * @param
+ * tfsw		the actual sliding window containing the text
+ * 		currently used by the suffix tree
+ * @param
+ * stsw		the actual suffix tree
+ *
+ * @return	If this function call is successful, it returns 0.
+ * 		Otherwise, a positive error number is returned.
+ */
+int stsw_slli_compact_tbranch (const int verbosity_level,
+		signed_integral_type *active_node,
+		const text_file_sliding_window *tfsw,
+		suffix_tree_sliding_window_slli *stsw) {
+	/* the highest index of the branching record in use before this step */
+	size_t old_hwm = stsw->branching_nodes;
+	/* the highest index of the branching record in use after this step */
+	size_t new_hwm = 0;
+	/* the minimum size of the table tbranch we shrink to */
+	size_t min_tbranch_size = 1024;
+	size_t moved = 0;
+	size_t i = 0;
+	signed_integral_type node = 0;
+	signed_integral_type *remap = NULL;
+	if (tfsw->compaction_step == 0) {
+		return (0);
+	}
+	/* if not enough of the records are vacant, we do not compact */
+	if ((stsw->tbdeleted_records << 3) > stsw->branching_nodes) {
+		if (compaction_plan(tfsw->compaction_step,
+					stsw->tbranch_deleted,
+					&stsw->tbdeleted_records,
+					&stsw->branching_nodes, &remap) > 0) {
+			fprintf(stderr, "stsw_slli_compact_tbranch:\n"
+					"Error: Could not plan "
+					"the compaction!\n");
+			return (1);
+		}
+		new_hwm = stsw->branching_nodes;
+		/* moving the records */
+		for (i = new_hwm + 1; i <= old_hwm; ++i) {
+			node = remap[old_hwm - i];
+			if (node != 0) {
+				stsw->tbranch[node] = stsw->tbranch[i];
+				++moved;
+			}
+		}
+		/* patching the references among the branching nodes */
+		for (i = 1; i <= new_hwm; ++i) {
+			node = stsw->tbranch[i].parent;
+			/* we must preserve the credit */
+			if (node < 0) {
+				stsw->tbranch[i].parent = -compaction_remap(
+						-node, old_hwm, new_hwm,
+						remap);
+			} else {
+				stsw->tbranch[i].parent = compaction_remap(
+						node, old_hwm, new_hwm,
+						remap);
+			}
+			stsw->tbranch[i].first_child = compaction_remap(
+					stsw->tbranch[i].first_child,
+					old_hwm, new_hwm, remap);
+			stsw->tbranch[i].branch_brother = compaction_remap(
+					stsw->tbranch[i].branch_brother,
+					old_hwm, new_hwm, remap);
+			stsw->tbranch[i].suffix_link = compaction_remap(
+					stsw->tbranch[i].suffix_link,
+					old_hwm, new_hwm, remap);
+		}
+		/* patching the references from the leaves */
+		for (i = 1; i <= stsw->tleaf_size; ++i) {
+			stsw->tleaf[i].parent = compaction_remap(
+					stsw->tleaf[i].parent,
+					old_hwm, new_hwm, remap);
+			stsw->tleaf[i].next_brother = compaction_remap(
+					stsw->tleaf[i].next_brother,
+					old_hwm, new_hwm, remap);
+		}
+		(*active_node) = compaction_remap((*active_node),
+				old_hwm, new_hwm, remap);
+		free(remap);
+		/* the released records have to look like the deleted ones */
+		memset(stsw->tbranch + new_hwm + 1, 0,
+				(old_hwm - new_hwm) * stsw->br_size);
+		if (verbosity_level > 1) {
+			fprintf(stderr, "\nCompacted the table tbranch: "
+					"%zu records moved, %zu in use "
+					"(previously %zu), %zu vacant.",
+					moved, new_hwm, old_hwm,
+					stsw->tbdeleted_records);
+		}
+	}
+	if ((stsw->branching_nodes << 2) < stsw->tbranch_size) {
+		if ((stsw->branching_nodes << 1) > min_tbranch_size) {
+			min_tbranch_size = stsw->branching_nodes << 1;
+		}
+		if (min_tbranch_size < stsw->tbranch_size) {
+			if (stsw_slli_shrink(verbosity_level,
+						min_tbranch_size,
+						stsw) > 0) {
+				fprintf(stderr, "stsw_slli_compact_tbranch:\n"
+						"Error: Could not shrink "
+						"the table tbranch!\n");
+				return (2);
+			}
+		}
+	}
+	return (0);
+}
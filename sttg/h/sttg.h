@@ -0,0 +1,74 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Stress text generator header.
+ * This file contains the declarations of the functions,
+ * which generate the standard stress texts for the benchmarks
+ * of the suffix tree construction algorithms.
+ */
+#ifndef	SUFFIX_TREE_TEXT_GENERATOR_HEADER
+#define	SUFFIX_TREE_TEXT_GENERATOR_HEADER
+
+#include <stdio.h>
+
+/* constants */
+
+/* the largest supported alphabet size */
+
+extern const size_t sttg_max_sigma;
+
+/* the alphabet of the DNA-like texts */
+
+extern const char *sttg_dna_alphabet;
+
+/* the alphabet of the natural language-like texts */
+
+extern const char *sttg_zipf_alphabet;
+
+/* stress text generating functions */
+
+int sttg_generate_uniform (size_t sigma,
+		size_t length,
+		unsigned char *text);
+int sttg_generate_fibonacci (size_t length,
+		unsigned char *text);
+int sttg_generate_thue_morse (size_t length,
+		unsigned char *text);
+int sttg_generate_runs (size_t sigma,
+		size_t run_length,
+		size_t length,
+		unsigned char *text);
+int sttg_generate_dna (size_t length,
+		unsigned char *text);
+int sttg_generate_zipf (size_t vocabulary,
+		size_t length,
+		unsigned char *text);
+
+/* stress text writing functions */
+
+int sttg_write_symbol (size_t symbol,
+		FILE *stream);
+int sttg_write (const unsigned char *text,
+		size_t length,
+		const char *alphabet,
+		FILE *stream);
+
+#endif /* SUFFIX_TREE_TEXT_GENERATOR_HEADER */
@@ -0,0 +1,382 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * The stress text generator.
+ * This file contains the command line interface of the program,
+ * which generates the standard stress texts for the benchmarks
+ * of the st and the stsw.
+ */
+
+/*
+ * This file needs to be included in advance of the other include files
+ * as well as before any changes to the feature test macros are made,
+ * because some of the files it includes might rely on the initial values
+ * of the feature test macros.
+ */
+#include "sttg.h"
+
+/* feature test macros */
+
+#ifndef _DEFAULT_SOURCE
+
+/** This macro is necessary for the function srandom. */
+#define	_DEFAULT_SOURCE
+
+#endif
+
+/* if this macro is either undefined or its value is too small */
+#if (_POSIX_C_SOURCE - 0) < 2
+
+#undef _POSIX_C_SOURCE
+
+/**
+ * This macro is necessary for the function getopt
+ * and variables optarg and optind.
+ */
+#define	_POSIX_C_SOURCE 2
+
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Doxygen main page documentation */
+
+/**
+ * @page sttg Stress text generator
+ *
+ * @section Description
+ *
+ * This program generates the standard stress texts,
+ * on which the suffix tree construction algorithms
+ * are benchmarked by the <tt>make bench</tt>.
+ * The available texts are:
+ *
+ * \li	uniformly random text over an alphabet of the given size
+ * \li	prefix of the infinite Fibonacci word
+ * \li	prefix of the Thue-Morse sequence
+ * \li	long runs of the same character
+ * \li	DNA-like text generated by a Markov chain with repeats
+ * \li	natural language-like text following the Zipf's law
+ *
+ * The texts are written in the UTF-8 encoding. The alphabets
+ * with more than 94 characters contain non-ASCII characters,
+ * which can be processed only if the st and the stsw
+ * are compiled with the @c wchar_t as the @c character_type.
+ *
+ * @section Usage
+ *
+ * This program can be executed like this:
+ *
+@verbatim
+./sttg -g <generator> -n <length> [options]
+@endverbatim
+ *
+ * which prints the generated text of the given length
+ * (in characters) to the standard output. The same seed
+ * always produces the same text.
+ */
+
+/**
+ * A function, which prints the short usage text for this program.
+ *
+ * @param
+ * argv0	the argv[0], or the command used to run this program
+ *
+ * @return	This function always returns zero (0).
+ */
+int print_short_usage (const char *argv0) {
+	printf("Usage:\t%s -g <generator> -n <length> [options]\n\n",
+			argv0);
+	printf("This will generate the stress text of the type <generator>\n"
+		"consisting of <length> characters.\n\n");
+	return (0);
+}
+
+/**
+ * A function, which prints the help text for this program.
+ *
+ * @param
+ * argv0	the argv[0], or the command used to run this program
+ *
+ * @return	This function always returns zero (0).
+ */
+int print_help (const char *argv0) {
+	print_short_usage(argv0);
+	printf("Available generators are:\n"
+		"U\tuniformly random text over <sigma> characters\n"
+		"F\tFibonacci word\n"
+		"T\tThue-Morse sequence\n"
+		"R\tlong runs of the same character\n"
+		"\tover <sigma> characters\n"
+		"D\tDNA-like Markov text with repeats\n"
+		"Z\tnatural language-like text following the Zipf's law\n\n");
+	printf("Additional options:\n"
+		"-a <sigma>\t\tSpecifies the size of the alphabet\n"
+		"\t\t\tof the U and R texts, at most %zu.\n"
+		"\t\t\tThe default value is 4.\n"
+		"\t\t\tThe alphabets with more than 94 characters\n"
+		"\t\t\tcontain non-ASCII characters.\n"
+		"-r <length>\t\tSpecifies the average length of the runs\n"
+		"\t\t\tof the R text. The default value is 1000.\n"
+		"-v <words>\t\tSpecifies the number of the distinct words\n"
+		"\t\t\tof the Z text. The default value is 10000.\n"
+		"-s <seed>\t\tSpecifies the seed of the random number\n"
+		"\t\t\tgenerator. The default value is 1.\n"
+		"-d <filename>\t\tPrints the generated text to the file\n"
+		"\t\t\t'filename' instead of the standard output.\n"
+		"-h\t\t\tprint this help and exit\n",
+		sttg_max_sigma);
+	return (0);
+}
+
+/**
+ * A function, which prints the full usage text for this program.
+ *
+ * @param
+ * argv0	the argv[0], or the command used to run this program
+ *
+ * @return	This function always returns zero (0).
+ */
+int print_usage (const char *argv0) {
+	print_short_usage(argv0);
+	printf("For the list of available options, run: %s -h\n",
+			argv0);
+	return (0);
+}
+
+/**
+ * A function, which parses the numeric argument of a parameter.
+ *
+ * @param
+ * argument	the argument to parse
+ * @param
+ * parameter	the character of the parameter
+ * @param
+ * value	the place where the parsed value will be stored
+ *
+ * @return	If the argument has been successfully parsed,
+ * 		0 is returned. Otherwise, a positive error number
+ * 		is returned.
+ */
+int parse_size (const char *argument,
+		char parameter,
+		size_t *value) {
+	char *endptr = NULL;
+	unsigned long long parsed = strtoull(argument, &endptr, 0);
+	if (argument[0] == '\0' || argument[0] == '-' || (*endptr) != '\0') {
+		fprintf(stderr, "Unrecognized argument for the -%c "
+				"parameter!\n\n", parameter);
+		return (1);
+	}
+	if (errno != 0) {
+		perror("strtoull");
+		/* resetting the errno */
+		errno = 0;
+		return (2);
+	}
+	(*value) = (size_t)(parsed);
+	return (0);
+}
+
+/**
+ * The main function, which parses the command line options
+ * and generates the desired stress text.
+ *
+ * @param
+ * argc	the number of the command line arguments
+ * @param
+ * argv	the command line arguments
+ *
+ * @return	If the text has been successfully generated and written,
+ * 		EXIT_SUCCESS is returned. Otherwise, EXIT_FAILURE
+ * 		is returned.
+ */
+int main (int argc, char **argv) {
+	FILE *output = stdout;
+	char *output_filename = NULL;
+	unsigned char *text = NULL;
+	const char *alphabet = NULL;
+	size_t length = 0;
+	size_t sigma = 4;
+	size_t run_length = 1000;
+	size_t vocabulary = 10000;
+	size_t seed = 1;
+	int getopt_retval = 0;
+	int function_retval = EXIT_SUCCESS;
+	int generator_retval = 0;
+	int length_set = 0;
+	char generator = 0;
+	char c = 0;
+	if (argc == 1) {
+		print_usage(argv[0]);
+		return (EXIT_SUCCESS);
+	}
+	/* parsing the command line options */
+	while ((getopt_retval = getopt(argc, argv, "g:n:a:r:v:s:d:h")) !=
+			(-1)) {
+		c = (char)(getopt_retval);
+		switch (c) {
+			case 'g':
+				if (strlen(optarg) != 1 ||
+					strchr("UFTRDZ", optarg[0]) == NULL) {
+					fprintf(stderr, "Unrecognized "
+						"argument for the -g "
+						"parameter!\n\n");
+					return (EXIT_FAILURE);
+				}
+				generator = optarg[0];
+				break;
+			case 'n':
+				if (parse_size(optarg, c, &length) > 0) {
+					return (EXIT_FAILURE);
+				}
+				length_set = 1;
+				break;
+			case 'a':
+				if (parse_size(optarg, c, &sigma) > 0) {
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'r':
+				if (parse_size(optarg, c, &run_length) > 0) {
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'v':
+				if (parse_size(optarg, c, &vocabulary) > 0) {
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 's':
+				if (parse_size(optarg, c, &seed) > 0) {
+					return (EXIT_FAILURE);
+				}
+				break;
+			case 'd':
+				output_filename = optarg;
+				break;
+			case 'h':
+				print_help(argv[0]);
+				return (EXIT_SUCCESS);
+			case '?':
+				return (EXIT_FAILURE);
+		}
+	}
+	if (optind != argc) {
+		fprintf(stderr, "Too many parameters!\n\n");
+		print_usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+	if (generator == 0) {
+		fprintf(stderr, "The -g parameter is mandatory "
+				"and it is missing!\n\n");
+		print_usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+	if (length_set == 0) {
+		fprintf(stderr, "The -n parameter is mandatory "
+				"and it is missing!\n\n");
+		print_usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+	if (sigma == 0 || sigma > sttg_max_sigma) {
+		fprintf(stderr, "The alphabet size has to be between 1 "
+				"and %zu!\n", sttg_max_sigma);
+		return (EXIT_FAILURE);
+	}
+	if (run_length == 0 || vocabulary == 0) {
+		fprintf(stderr, "The arguments for the -r and -v parameters "
+				"have to be positive!\n");
+		return (EXIT_FAILURE);
+	}
+	/* command line options parsing complete */
+	text = malloc(length + 1);
+	if (text == NULL) {
+		perror("malloc(text)");
+		/* resetting the errno */
+		errno = 0;
+		return (EXIT_FAILURE);
+	}
+	srandom((unsigned int)(seed));
+	switch (generator) {
+		case 'U':
+			generator_retval = sttg_generate_uniform(sigma,
+					length, text);
+			break;
+		case 'F':
+			generator_retval = sttg_generate_fibonacci(length,
+					text);
+			break;
+		case 'T':
+			generator_retval = sttg_generate_thue_morse(length,
+					text);
+			break;
+		case 'R':
+			generator_retval = sttg_generate_runs(sigma,
+					run_length, length, text);
+			break;
+		case 'D':
+			generator_retval = sttg_generate_dna(length, text);
+			alphabet = sttg_dna_alphabet;
+			break;
+		case 'Z':
+			generator_retval = sttg_generate_zipf(vocabulary,
+					length, text);
+			alphabet = sttg_zipf_alphabet;
+			break;
+	}
+	if (generator_retval > 0) {
+		fprintf(stderr, "The generation of the text has failed!\n");
+		free(text);
+		return (EXIT_FAILURE);
+	}
+	if (output_filename != NULL &&
+			(output = fopen(output_filename, "w")) == NULL) {
+		perror(output_filename);
+		/* resetting the errno */
+		errno = 0;
+		free(text);
+		return (EXIT_FAILURE);
+	}
+	if (sttg_write(text, length, alphabet, output) > 0) {
+		fprintf(stderr, "The writing of the text has failed!\n");
+		function_retval = EXIT_FAILURE;
+	}
+	free(text);
+	if (output != stdout) {
+		if (fclose(output) != 0) {
+			perror(output_filename);
+			/* resetting the errno */
+			errno = 0;
+			function_retval = EXIT_FAILURE;
+		}
+	} else if (fflush(output) != 0) {
+		perror("fflush(stdout)");
+		/* resetting the errno */
+		errno = 0;
+		function_retval = EXIT_FAILURE;
+	}
+	return (function_retval);
+}
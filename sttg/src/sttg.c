@@ -0,0 +1,502 @@
+/*
+ * Copyright 2012 Peter Bašista
+ *
+ * This file is part of the stc.
+ * 
+ * stc is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Stress text generator implementation.
+ * This file contains the implementation of the functions,
+ * which generate the standard stress texts for the benchmarks
+ * of the suffix tree construction algorithms.
+ *
+ * The texts are generated as the sequences of the symbol indices,
+ * which are translated to the characters only when they are written.
+ */
+
+/* feature test macros */
+
+#ifndef _DEFAULT_SOURCE
+
+/** This macro is necessary for the function random. */
+#define	_DEFAULT_SOURCE
+
+#endif
+
+#include "sttg.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constants */
+
+/** the largest supported alphabet size */
+const size_t sttg_max_sigma = 256;
+
+/** the alphabet of the DNA-like texts */
+const char *sttg_dna_alphabet = "ACGT";
+
+/**
+ * the alphabet of the natural language-like texts,
+ * the word separators followed by the lowercase letters
+ */
+const char *sttg_zipf_alphabet = " \nabcdefghijklmnopqrstuvwxyz";
+
+/**
+ * the printable ASCII characters, which represent the first symbols
+ * of the texts without a specific alphabet
+ */
+static const char sttg_printable[] = "abcdefghijklmnopqrstuvwxyz"
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+	"!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+
+/**
+ * the Unicode code point of the first symbol,
+ * which does not fit into the printable ASCII characters
+ */
+static const unsigned long sttg_first_code_point = 0xA1;
+
+/**
+ * the probabilities (in per mille) of the next nucleotide
+ * in the DNA-like texts given the previous one, which roughly
+ * follow the dinucleotide frequencies of the human genome,
+ * including the depletion of the CpG dinucleotides
+ */
+static const unsigned int sttg_dna_transitions[4][4] = {
+	{330, 170, 240, 260},
+	{350, 260, 50, 340},
+	{290, 210, 250, 250},
+	{220, 200, 250, 330}
+};
+
+/**
+ * the probability (in per mille) that the DNA-like text
+ * continues with a mutated copy of its earlier segment
+ * at any given position is 1 / sttg_dna_repeat_rate
+ */
+static const size_t sttg_dna_repeat_rate = 2000;
+
+/** the shortest mutated copy of an earlier segment in the DNA-like texts */
+static const size_t sttg_dna_repeat_min = 100;
+
+/** the range of the lengths of the mutated copies above the shortest one */
+static const size_t sttg_dna_repeat_range = 1000;
+
+/** the probability (in per mille) of the mutation of a copied nucleotide */
+static const unsigned int sttg_dna_mutation = 20;
+
+/**
+ * the frequencies (in per mille) of the lowercase letters
+ * in the English texts
+ */
+static const unsigned int sttg_letter_frequencies[26] = {
+	82, 15, 28, 43, 127, 22, 20, 61, 70, 2, 8, 40, 24,
+	67, 75, 19, 1, 60, 63, 91, 28, 10, 24, 2, 20, 1
+};
+
+/** the longest word of the natural language-like texts */
+static const size_t sttg_max_word_length = 12;
+
+/**
+ * the average number of the words on a single line
+ * of the natural language-like texts
+ */
+static const size_t sttg_words_per_line = 16;
+
+/* stress text generating functions */
+
+/**
+ * A function which returns a random number
+ * from the interval [0, upper_bound - 1].
+ *
+ * @param
+ * upper_bound	the upper bound for the generated number,
+ * 		which needs to be positive
+ *
+ * @return	The generated random number.
+ */
+static size_t sttg_random (size_t upper_bound) {
+	unsigned long long value = (unsigned long long)(random());
+	if (upper_bound > (size_t)(RAND_MAX)) {
+		value = (value << 31) | (unsigned long long)(random());
+	}
+	return ((size_t)(value % upper_bound));
+}
+
+/**
+ * A function which generates the text of the provided length,
+ * whose characters are chosen uniformly at random
+ * from the alphabet of the provided size.
+ *
+ * @param
+ * sigma	the size of the alphabet
+ * @param
+ * length	the length of the generated text
+ * @param
+ * text		the place where the symbol indices will be stored
+ *
+ * @return	If the text has been successfully generated, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int sttg_generate_uniform (size_t sigma,
+		size_t length,
+		unsigned char *text) {
+	size_t i = 0;
+	if (sigma == 0 || sigma > sttg_max_sigma) {
+		return (1);
+	}
+	for (i = 0; i < length; ++i) {
+		text[i] = (unsigned char)(sttg_random(sigma));
+	}
+	return (0);
+}
+
+/**
+ * A function which generates the prefix of the provided length
+ * of the infinite Fibonacci word over the alphabet {a, b}.
+ * It makes use of the fact that every finite Fibonacci word
+ * is a prefix of the next one.
+ *
+ * @param
+ * length	the length of the generated text
+ * @param
+ * text		the place where the symbol indices will be stored
+ *
+ * @return	This function always returns zero (0).
+ */
+int sttg_generate_fibonacci (size_t length,
+		unsigned char *text) {
+	/* the lengths of the two latest Fibonacci words */
+	size_t previous = 1;
+	size_t current = 2;
+	size_t copied = 0;
+	if (length > 0) {
+		text[0] = 0;
+	}
+	if (length > 1) {
+		text[1] = 1;
+	}
+	while (current < length) {
+		copied = previous;
+		if (copied > length - current) {
+			copied = length - current;
+		}
+		memcpy(text + current, text, copied);
+		previous = current;
+		current += copied;
+	}
+	return (0);
+}
+
+/**
+ * A function which generates the prefix of the provided length
+ * of the Thue-Morse sequence over the alphabet {a, b}.
+ *
+ * @param
+ * length	the length of the generated text
+ * @param
+ * text		the place where the symbol indices will be stored
+ *
+ * @return	This function always returns zero (0).
+ */
+int sttg_generate_thue_morse (size_t length,
+		unsigned char *text) {
+	size_t i = 0;
+	size_t bits = 0;
+	unsigned char parity = 0;
+	for (i = 0; i < length; ++i) {
+		parity = 0;
+		for (bits = i; bits != 0; bits &= bits - 1) {
+			parity ^= 1;
+		}
+		text[i] = parity;
+	}
+	return (0);
+}
+
+/**
+ * A function which generates the text consisting of the long runs
+ * of the same character. Every run consists of a different character
+ * than the previous one and its length is chosen uniformly at random,
+ * so that the average length of the runs is the provided run_length.
+ *
+ * @param
+ * sigma	the size of the alphabet
+ * @param
+ * run_length	the average length of the runs
+ * @param
+ * length	the length of the generated text
+ * @param
+ * text		the place where the symbol indices will be stored
+ *
+ * @return	If the text has been successfully generated, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int sttg_generate_runs (size_t sigma,
+		size_t run_length,
+		size_t length,
+		unsigned char *text) {
+	size_t i = 0;
+	size_t run = 0;
+	size_t symbol = 0;
+	if (sigma == 0 || sigma > sttg_max_sigma) {
+		return (1);
+	}
+	if (run_length == 0) {
+		return (2);
+	}
+	while (i < length) {
+		if (i == 0) {
+			symbol = sttg_random(sigma);
+		} else if (sigma > 1) {
+			symbol = (symbol + 1 + sttg_random(sigma - 1)) % sigma;
+		}
+		run = 1 + sttg_random(2 * run_length - 1);
+		for (; run > 0 && i < length; --run, ++i) {
+			text[i] = (unsigned char)(symbol);
+		}
+	}
+	return (0);
+}
+
+/**
+ * A function which generates the DNA-like text over the alphabet
+ * {A, C, G, T}. The nucleotides are generated by the first order
+ * Markov chain, which is occasionally interrupted by the mutated copies
+ * of the earlier segments of the text, resembling the repeats
+ * present in the real genomes.
+ *
+ * @param
+ * length	the length of the generated text
+ * @param
+ * text		the place where the symbol indices will be stored
+ *
+ * @return	This function always returns zero (0).
+ */
+int sttg_generate_dna (size_t length,
+		unsigned char *text) {
+	size_t i = 0;
+	size_t source = 0;
+	size_t end = 0;
+	unsigned int previous = 0;
+	unsigned int next = 0;
+	unsigned int draw = 0;
+	while (i < length) {
+		if (i > sttg_dna_repeat_min &&
+				sttg_random(sttg_dna_repeat_rate) == 0) {
+			source = sttg_random(i - sttg_dna_repeat_min);
+			end = i + sttg_dna_repeat_min +
+				sttg_random(sttg_dna_repeat_range);
+			if (end > length) {
+				end = length;
+			}
+			for (; i < end; ++i, ++source) {
+				if (sttg_random(1000) < sttg_dna_mutation) {
+					text[i] = (unsigned char)
+						(sttg_random(4));
+				} else {
+					text[i] = text[source];
+				}
+			}
+			previous = text[i - 1];
+			continue;
+		}
+		draw = (unsigned int)(sttg_random(1000));
+		for (next = 0; next < 3; ++next) {
+			if (draw < sttg_dna_transitions[previous][next]) {
+				break;
+			}
+			draw -= sttg_dna_transitions[previous][next];
+		}
+		text[i++] = (unsigned char)(next);
+		previous = next;
+	}
+	return (0);
+}
+
+/**
+ * A function which generates the natural language-like text.
+ * It consists of the words from a random vocabulary of the provided size,
+ * whose letters follow the English letter frequencies.
+ * The words are chosen according to the Zipf's law,
+ * so that the probability of the k-th most frequent word
+ * is proportional to 1 / k.
+ *
+ * @param
+ * vocabulary	the number of the distinct words
+ * @param
+ * length	the length of the generated text
+ * @param
+ * text		the place where the symbol indices will be stored
+ *
+ * @return	If the text has been successfully generated, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int sttg_generate_zipf (size_t vocabulary,
+		size_t length,
+		unsigned char *text) {
+	/* the letters of all the words of the vocabulary */
+	unsigned char *letters = NULL;
+	/* the lengths of the words of the vocabulary */
+	size_t *lengths = NULL;
+	/* the cumulative probabilities of the words */
+	double *cumulative = NULL;
+	double sum = 0;
+	double draw = 0;
+	size_t i = 0;
+	size_t j = 0;
+	size_t low = 0;
+	size_t high = 0;
+	size_t middle = 0;
+	unsigned int letter = 0;
+	unsigned int frequency = 0;
+	if (vocabulary == 0) {
+		return (1);
+	}
+	letters = malloc(vocabulary * sttg_max_word_length);
+	lengths = malloc(vocabulary * sizeof (size_t));
+	cumulative = malloc(vocabulary * sizeof (double));
+	if (letters == NULL || lengths == NULL || cumulative == NULL) {
+		perror("malloc(vocabulary)");
+		/* resetting the errno */
+		errno = 0;
+		free(letters);
+		free(lengths);
+		free(cumulative);
+		return (2);
+	}
+	for (i = 0; i < vocabulary; ++i) {
+		lengths[i] = 1 + sttg_random(sttg_max_word_length);
+		for (j = 0; j < lengths[i]; ++j) {
+			frequency = (unsigned int)(sttg_random(1000));
+			for (letter = 0; letter < 25; ++letter) {
+				if (frequency <
+					sttg_letter_frequencies[letter]) {
+					break;
+				}
+				frequency -= sttg_letter_frequencies[letter];
+			}
+			/* skipping the word separators */
+			letters[i * sttg_max_word_length + j] =
+				(unsigned char)(letter + 2);
+		}
+		sum += 1.0 / (double)(i + 1);
+		cumulative[i] = sum;
+	}
+	i = 0;
+	while (i < length) {
+		/* binary search for the first cumulative value above draw */
+		draw = (double)(random()) / ((double)(RAND_MAX) + 1.0) * sum;
+		low = 0;
+		high = vocabulary - 1;
+		while (low < high) {
+			middle = low + (high - low) / 2;
+			if (cumulative[middle] > draw) {
+				high = middle;
+			} else {
+				low = middle + 1;
+			}
+		}
+		for (j = 0; j < lengths[low] && i < length; ++j, ++i) {
+			text[i] = letters[low * sttg_max_word_length + j];
+		}
+		if (i < length) {
+			text[i++] = (sttg_random(sttg_words_per_line) == 0) ?
+				1 : 0;
+		}
+	}
+	free(letters);
+	free(lengths);
+	free(cumulative);
+	return (0);
+}
+
+/* stress text writing functions */
+
+/**
+ * A function which writes a single symbol of a text
+ * without a specific alphabet in the UTF-8 encoding.
+ * The first symbols are written as the printable ASCII characters,
+ * starting with the lowercase letters, so that the small alphabets
+ * remain readable. The remaining symbols are written
+ * as the consecutive Unicode characters starting
+ * at the sttg_first_code_point.
+ *
+ * @param
+ * symbol	the index of the symbol to write
+ * @param
+ * stream	the stream to which the symbol will be written
+ *
+ * @return	If the symbol has been successfully written, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int sttg_write_symbol (size_t symbol,
+		FILE *stream) {
+	/* the number of the printable characters without the final '\0' */
+	const size_t printable = sizeof (sttg_printable) - 1;
+	unsigned long code_point = 0;
+	if (symbol < printable) {
+		if (putc(sttg_printable[symbol], stream) == EOF) {
+			return (1);
+		}
+		return (0);
+	}
+	/* all the supported symbols fit into two bytes of the UTF-8 */
+	code_point = sttg_first_code_point +
+		(unsigned long)(symbol - printable);
+	if (putc((int)(0xC0 | (code_point >> 6)), stream) == EOF ||
+			putc((int)(0x80 | (code_point & 0x3F)),
+				stream) == EOF) {
+		return (2);
+	}
+	return (0);
+}
+
+/**
+ * A function which writes the generated text to the provided stream.
+ *
+ * @param
+ * text		the symbol indices of the text
+ * @param
+ * length	the length of the text
+ * @param
+ * alphabet	the characters representing the symbols,
+ * 		or NULL if the text has no specific alphabet
+ * 		and its symbols should be written by the sttg_write_symbol
+ * @param
+ * stream	the stream to which the text will be written
+ *
+ * @return	If the text has been successfully written, 0 is returned.
+ * 		Otherwise, a positive error number is returned.
+ */
+int sttg_write (const unsigned char *text,
+		size_t length,
+		const char *alphabet,
+		FILE *stream) {
+	size_t i = 0;
+	for (i = 0; i < length; ++i) {
+		if (alphabet != NULL) {
+			if (putc(alphabet[text[i]], stream) == EOF) {
+				return (1);
+			}
+		} else if (sttg_write_symbol(text[i], stream) > 0) {
+			return (2);
+		}
+	}
+	return (0);
+}